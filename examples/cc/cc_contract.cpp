@@ -0,0 +1,171 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+// Time the contractions of the CCD residual (see ccd.cpp) that require
+// permuted arguments. Each contraction is evaluated directly, where the
+// argument tiles are packed from their original layout, and in two steps,
+// where the argument is first permuted into a temporary array, as is
+// required by a permute-then-GEMM (TTGT) evaluation.
+
+namespace {
+
+  typedef TiledArray::TArrayD array_type;
+
+  /// Report the average time of an evaluation
+  template <typename Op>
+  void run(TiledArray::World& world, const char* name, const char* path,
+      const long repeat, const double gflop, Op&& op)
+  {
+    op(); // warm up
+    world.gop.fence();
+    const double start = madness::wall_time();
+    for(long r = 0l; r < repeat; ++r)
+      op();
+    world.gop.fence();
+    const double time = (madness::wall_time() - start) / double(repeat);
+
+    if(world.rank() == 0)
+      std::cout << std::setw(8) << name << std::setw(10) << path
+                << "   average time=" << std::setw(12) << time
+                << "   GFLOPS=" << gflop / time << "\n";
+  }
+
+  /// Make a tiled range with the given extents and block size
+  TiledArray::TiledRange make_trange(std::initializer_list<long> extents,
+      const long block_size)
+  {
+    std::vector<TiledArray::TiledRange1> ranges;
+    for(long extent : extents) {
+      std::vector<long> blocking;
+      for(long i = 0l; i < extent; i += block_size)
+        blocking.push_back(i);
+      blocking.push_back(extent);
+      ranges.emplace_back(blocking.begin(), blocking.end());
+    }
+    return TiledArray::TiledRange(ranges.begin(), ranges.end());
+  }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if(argc < 4) {
+      std::cout << "Usage: " << argv[0] << " occupied virtual block_size [repetitions]\n";
+      return 0;
+    }
+    const long o = atol(argv[1]);
+    const long v = atol(argv[2]);
+    const long block_size = atol(argv[3]);
+    if((o <= 0) || (v <= 0) || (block_size <= 0)) {
+      std::cerr << "Error: sizes must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 5 ? atol(argv[4]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: coupled-cluster contraction test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of nodes     = " << world.size()
+                << "\nOccupied size       = " << o
+                << "\nVirtual size        = " << v
+                << "\nBlock size          = " << block_size
+                << "\n";
+
+    // Construct and initialize arrays
+    array_type t_vvoo(world, make_trange({v, v, o, o}, block_size));
+    array_type v_voov(world, make_trange({v, o, o, v}, block_size));
+    array_type v_oooo(world, make_trange({o, o, o, o}, block_size));
+    array_type v_vvvv(world, make_trange({v, v, v, v}, block_size));
+    t_vvoo.fill(1.0);
+    v_voov.fill(1.0);
+    v_oooo.fill(1.0);
+    v_vvvv.fill(1.0);
+    array_type r_vvoo, temp1, temp2;
+    world.gop.fence();
+
+    const double o2v2 = double(o * o) * double(v * v);
+
+    // Ring term: v_voov("p1,h3,h1,p3") * t_vvoo("p2,p3,h2,h3")
+    const double ring_gflop = 2.0 * o2v2 * double(o * v) / 1.0e9;
+    run(world, "ring", "direct", repeat, ring_gflop, [&] () {
+      r_vvoo("p1,p2,h1,h2") = v_voov("p1,h3,h1,p3") * t_vvoo("p2,p3,h2,h3");
+    });
+    run(world, "ring", "permuted", repeat, ring_gflop, [&] () {
+      temp1("p1,h1,h3,p3") = v_voov("p1,h3,h1,p3");
+      temp2("h3,p3,p2,h2") = t_vvoo("p2,p3,h2,h3");
+      r_vvoo("p1,h1,p2,h2") = temp1("p1,h1,h3,p3") * temp2("h3,p3,p2,h2");
+    });
+
+    // Particle ladder term: t_vvoo("p3,p4,h1,h2") * v_vvvv("p1,p2,p3,p4")
+    const double ladder_gflop = 2.0 * o2v2 * double(v * v) / 1.0e9;
+    run(world, "ladder", "direct", repeat, ladder_gflop, [&] () {
+      r_vvoo("p1,p2,h1,h2") = t_vvoo("p3,p4,h1,h2") * v_vvvv("p1,p2,p3,p4");
+    });
+    run(world, "ladder", "permuted", repeat, ladder_gflop, [&] () {
+      temp1("p3,p4,p1,p2") = v_vvvv("p1,p2,p3,p4");
+      r_vvoo("h1,h2,p1,p2") = t_vvoo("p3,p4,h1,h2") * temp1("p3,p4,p1,p2");
+    });
+
+    // Hole ladder term: v_oooo("h3,h4,h1,h2") * t_vvoo("p1,p2,h3,h4")
+    const double hole_gflop = 2.0 * o2v2 * double(o * o) / 1.0e9;
+    run(world, "hole", "direct", repeat, hole_gflop, [&] () {
+      r_vvoo("p1,p2,h1,h2") = v_oooo("h3,h4,h1,h2") * t_vvoo("p1,p2,h3,h4");
+    });
+    run(world, "hole", "permuted", repeat, hole_gflop, [&] () {
+      temp1("h1,h2,h3,h4") = v_oooo("h3,h4,h1,h2");
+      r_vvoo("h1,h2,p1,p2") = temp1("h1,h2,h3,h4") * t_vvoo("p1,p2,h3,h4");
+    });
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
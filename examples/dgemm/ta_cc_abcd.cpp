@@ -65,7 +65,8 @@ void rand_fill_array(TA::DistArray<Tile, Policy>& array);
 template <typename T>
 void cc_abcd(madness::World& world,
              const TA::TiledRange1& trange_occ,
-             const TA::TiledRange1& trange_uocc, long repeat);
+             const TA::TiledRange1& trange_uocc, long repeat,
+             std::size_t ooc_bytes);
 
 int main(int argc, char** argv) {
   int rc = 0;
@@ -80,7 +81,8 @@ int main(int argc, char** argv) {
       std::cout << "Mocks t2(i,a,j,b) * v(a,b,c,d) term in CC amplitude eqs"
                 << std::endl
                 << "Usage: " << argv[0] << " occ_size occ_nblocks uocc_size "
-                   "uocc_nblocks [repetitions] [use_complex]" << std::endl;
+                   "uocc_nblocks [repetitions] [use_complex] [ooc_memory_MB]"
+                << std::endl;
       return 0;
     }
     const long n_occ = atol(argv[1]);
@@ -117,6 +119,13 @@ int main(int argc, char** argv) {
       return 1;
     }
     const bool use_complex = (argc >= 7 ? to_bool(argv[6]) : false);
+    // Keep at most this many MB of v in memory on each process, and store the
+    // rest in the current directory; zero keeps v in memory
+    const long ooc_memory = (argc >= 8 ? atol(argv[7]) : 0l);
+    if (ooc_memory < 0) {
+      std::cerr << "Error: ooc_memory_MB must not be negative.\n";
+      return 1;
+    }
 
     if(world.rank() == 0)
       std::cout << "TiledArray: CC T2.V term test..."
@@ -127,6 +136,7 @@ int main(int argc, char** argv) {
                 << "\nuocc size           = " << n_uocc
                 << "\nuocc nblocks        = " << nblk_uocc
                 << "\nComplex             = " << (use_complex ? "true" : "false")
+                << "\nOut-of-core memory  = " << ooc_memory << " MB"
                 << "\n";
 
     // Construct TiledRange1's
@@ -136,9 +146,11 @@ int main(int argc, char** argv) {
     auto trange_uocc = TA::TiledRange1(tiling_uocc.begin(), tiling_uocc.end());
 
     if (use_complex)
-      cc_abcd<std::complex<double>>(world, trange_occ, trange_uocc, repeat);
+      cc_abcd<std::complex<double>>(world, trange_occ, trange_uocc, repeat,
+          ooc_memory * 1048576ul);
     else
-      cc_abcd<double>(world, trange_occ, trange_uocc, repeat);
+      cc_abcd<double>(world, trange_occ, trange_uocc, repeat,
+          ooc_memory * 1048576ul);
 
     TA::finalize();
 
@@ -165,7 +177,8 @@ int main(int argc, char** argv) {
 template <typename T>
 void cc_abcd(TA::World& world,
              const TA::TiledRange1& trange_occ,
-             const TA::TiledRange1& trange_uocc, long repeat) {
+             const TA::TiledRange1& trange_uocc, long repeat,
+             std::size_t ooc_bytes) {
 
   TA::TiledRange trange_oovv(
       {trange_occ, trange_occ, trange_uocc, trange_uocc});
@@ -187,6 +200,8 @@ void cc_abcd(TA::World& world,
   TA::TArrayD t2(world, trange_oovv);
   TA::TArrayD v(world, trange_vvvv);
   TA::TArrayD t2_v;
+  if (ooc_bytes)
+    v.enable_out_of_core(".", ooc_bytes);
   // To validate, fill input tensors with random data, otherwise just with 1s
   if (do_validate) {
     rand_fill_array(t2);
@@ -245,6 +260,13 @@ void cc_abcd(TA::World& world,
               << total_time / static_cast<double>(repeat)
               << " sec\nAverage GFLOPS      = "
               << total_gflop_rate / static_cast<double>(repeat) << "\n";
+
+  if (ooc_bytes) {
+    const TA::OutOfCoreStatistics stats = v.out_of_core_statistics();
+    std::cout << "Rank " << world.rank() << " v out-of-core hit rate = "
+              << stats.hit_rate() << "   MB read = "
+              << double(stats.bytes_read) / 1048576.0 << "\n";
+  }
 }
 
 template <typename LeftTile, typename RightTile, typename Policy, typename Op>
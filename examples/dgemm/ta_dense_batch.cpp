@@ -0,0 +1,139 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+// Compare contractions that evaluate each tile pair with its own GEMM
+// (batch size 1) to contractions that pack the tile pairs that contribute to
+// the same result tile into batched GEMMs, for a range of tile sizes. Batching
+// is most effective for small tiles, where the overhead of each GEMM call is
+// large compared to the work it does.
+
+TiledArray::TiledRange1 make_trange1(const long size, const long block_size) {
+  std::vector<long> blocking;
+  for(long i = 0l; i < size; i += block_size)
+    blocking.push_back(i);
+  blocking.push_back(size);
+  return TiledArray::TiledRange1(blocking.begin(), blocking.end());
+}
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if(argc < 2) {
+      std::cout << "Usage: " << argv[0] << " matrix_size [repetitions] [batch_size]\n";
+      return 0;
+    }
+    const long matrix_size = atol(argv[1]);
+    if (matrix_size <= 0) {
+      std::cerr << "Error: matrix size must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 3 ? atol(argv[2]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+    const long batch_size = (argc >= 4 ? atol(argv[3]) :
+        long(TiledArray::detail::ContractReduceBase<TiledArray::TensorD,
+        TiledArray::TensorD, TiledArray::TensorD, double>::default_batch_size));
+    if (batch_size <= 0) {
+      std::cerr << "Error: batch size must be greater than zero.\n";
+      return 1;
+    }
+
+    const double gflop = 2.0 * double(matrix_size) * double(matrix_size)
+        * double(matrix_size) / 1.0e9;
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: batched tile GEMM test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of nodes     = " << world.size()
+                << "\nMatrix size         = " << matrix_size << "x" << matrix_size
+                << "\nBatch size          = " << batch_size
+                << "\n";
+
+    const long block_sizes[] = { 16l, 24l, 32l, 48l, 64l, 96l, 128l, 256l };
+    for(long block_size : block_sizes) {
+      if(block_size > matrix_size)
+        break;
+
+      const TiledArray::TiledRange1 tr1 = make_trange1(matrix_size, block_size);
+      const TiledArray::TiledRange trange({tr1, tr1});
+
+      TiledArray::TArrayD a(world, trange);
+      TiledArray::TArrayD b(world, trange);
+      a.fill_random();
+      b.fill_random();
+
+      // Time the contraction without and with batching
+      double time[2] = { 0.0, 0.0 };
+      const unsigned int batch[2] = { 1u, (unsigned int)batch_size };
+      TiledArray::TArrayD c[2];
+      for(int i = 0; i < 2; ++i) {
+        world.gop.fence();
+        for(long r = 0l; r < repeat; ++r) {
+          const double start = madness::wall_time();
+          c[i]("m,n") = (a("m,k") * b("k,n")).set_contraction_batch_size(batch[i]);
+          world.gop.fence();
+          time[i] += madness::wall_time() - start;
+        }
+      }
+
+      // Check the batched result against the unbatched result
+      const double error = (c[1]("m,n") - c[0]("m,n")).norm().get()
+          / c[0]("m,n").norm().get();
+
+      if(world.rank() == 0)
+        std::cout << "block size=" << block_size
+                  << "   unbatched GFLOPS=" << gflop * double(repeat) / time[0]
+                  << "   batched GFLOPS=" << gflop * double(repeat) / time[1]
+                  << "   speedup=" << time[0] / time[1]
+                  << "   relative error=" << error << "\n";
+    }
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
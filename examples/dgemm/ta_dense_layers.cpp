@@ -0,0 +1,147 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <cmath>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+// Compare the 2D (SUMMA) contraction with layered (2.5D) contractions of a
+// dense MxK by KxN matrix product. Layered contractions are most effective
+// when K is large compared to M and N, and the number of processes is large.
+
+TiledArray::TiledRange1 make_trange1(const long size, const long block_size) {
+  std::vector<long> blocking;
+  for(long i = 0l; i < size; i += block_size)
+    blocking.push_back(i);
+  blocking.push_back(size);
+  return TiledArray::TiledRange1(blocking.begin(), blocking.end());
+}
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if(argc < 5) {
+      std::cout << "Usage: " << argv[0] << " M N K block_size [repetitions] [max_layers]\n";
+      return 0;
+    }
+    const long M = atol(argv[1]);
+    const long N = atol(argv[2]);
+    const long K = atol(argv[3]);
+    const long block_size = atol(argv[4]);
+    if (M <= 0 || N <= 0 || K <= 0) {
+      std::cerr << "Error: matrix sizes must be greater than zero.\n";
+      return 1;
+    }
+    if (block_size <= 0) {
+      std::cerr << "Error: block size must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 6 ? atol(argv[5]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+    const long K_blocks = (K + block_size - 1l) / block_size;
+    const long max_layers = std::min(K_blocks, (argc >= 7 ? atol(argv[6]) :
+        std::max(1l, long(std::cbrt(double(world.size())) + 1e-6))));
+    if (max_layers <= 0) {
+      std::cerr << "Error: maximum number of layers must be greater than zero.\n";
+      return 1;
+    }
+
+    const double gflop = 2.0 * double(M) * double(N) * double(K) / 1.0e9;
+
+    const TiledArray::TiledRange1 trM = make_trange1(M, block_size);
+    const TiledArray::TiledRange1 trN = make_trange1(N, block_size);
+    const TiledArray::TiledRange1 trK = make_trange1(K, block_size);
+
+    const std::size_t auto_layers = TiledArray::detail::ProcGrid::optimal_layers(
+        world.size(), trM.tile_extent(), trN.tile_extent(), trK.tile_extent(),
+        M, N, K);
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: layered dense matrix multiply test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of nodes     = " << world.size()
+                << "\nMatrix sizes        = " << M << "x" << K << " * " << K << "x" << N
+                << "\nBlock size          = " << block_size
+                << "\nMaximum layers      = " << max_layers
+                << "\nCost model layers   = " << auto_layers
+                << "\n";
+
+    TiledArray::TArrayD a(world, TiledArray::TiledRange({trM, trK}));
+    TiledArray::TArrayD b(world, TiledArray::TiledRange({trK, trN}));
+    a.fill_random();
+    b.fill_random();
+
+    // Compute the 2D reference result
+    TiledArray::TArrayD c_ref;
+    c_ref("m,n") = (a("m,k") * b("k,n")).set_contraction_layers(1);
+    const double norm_ref = c_ref("m,n").norm().get();
+
+    for(long layers = 1l; layers <= max_layers; ++layers) {
+      TiledArray::TArrayD c;
+      double total_time = 0.0;
+
+      world.gop.fence();
+      for(long i = 0l; i < repeat; ++i) {
+        const double start = madness::wall_time();
+        c("m,n") = (a("m,k") * b("k,n")).set_contraction_layers(layers);
+        world.gop.fence();
+        total_time += madness::wall_time() - start;
+      }
+
+      // Check the result against the 2D contraction
+      const double error = (c("m,n") - c_ref("m,n")).norm().get() / norm_ref;
+
+      if(world.rank() == 0)
+        std::cout << "layers=" << layers
+                  << "   average time=" << total_time / double(repeat)
+                  << "   GFLOPS=" << gflop * double(repeat) / total_time
+                  << "   relative error=" << error << "\n";
+    }
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
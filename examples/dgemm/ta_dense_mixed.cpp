@@ -0,0 +1,150 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <cmath>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+// Compare the throughput and accuracy of double precision contractions, of
+// single precision contractions, and of mixed precision contractions, where
+// the arguments are stored and communicated in single precision and the
+// products are accumulated in, and stored as, double precision tiles. The
+// errors are relative to the double precision result.
+
+TiledArray::TiledRange1 make_trange1(const long size, const long block_size) {
+  std::vector<long> blocking;
+  for(long i = 0l; i < size; i += block_size)
+    blocking.push_back(i);
+  blocking.push_back(size);
+  return TiledArray::TiledRange1(blocking.begin(), blocking.end());
+}
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if(argc < 3) {
+      std::cout << "Usage: " << argv[0] << " matrix_size block_size [repetitions]\n";
+      return 0;
+    }
+    const long matrix_size = atol(argv[1]);
+    const long block_size = atol(argv[2]);
+    if (matrix_size <= 0) {
+      std::cerr << "Error: matrix size must be greater than zero.\n";
+      return 1;
+    }
+    if (block_size <= 0) {
+      std::cerr << "Error: block size must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    const double gflop = 2.0 * double(matrix_size) * double(matrix_size)
+        * double(matrix_size) / 1.0e9;
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: mixed precision matrix multiply test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of nodes     = " << world.size()
+                << "\nMatrix size         = " << matrix_size << "x" << matrix_size
+                << "\nBlock size          = " << block_size << "x" << block_size
+                << "\n";
+
+    const TiledArray::TiledRange1 tr1 = make_trange1(matrix_size, block_size);
+    const TiledArray::TiledRange trange({tr1, tr1});
+
+    // Initialize the single and double precision arguments with the same
+    // elements, up to the single precision rounding
+    auto init = [=] (const TiledArray::Range::index& i) {
+      return std::sin(double(i[0] * matrix_size + i[1]));
+    };
+    TiledArray::TArrayD ad(world, trange), bd(world, trange);
+    TiledArray::TArrayF af(world, trange), bf(world, trange);
+    ad.init_elements(init);
+    bd.init_elements(init);
+    af.init_elements(init);
+    bf.init_elements(init);
+
+    // Time the double, single, and mixed precision contractions
+    const char* names[3] = { "double", "single", "mixed" };
+    double time[3] = { 0.0, 0.0, 0.0 };
+    TiledArray::TArrayD cd, cm;
+    TiledArray::TArrayF cf;
+    for(int i = 0; i < 3; ++i) {
+      world.gop.fence();
+      for(long r = 0l; r < repeat; ++r) {
+        const double start = madness::wall_time();
+        switch(i) {
+          case 0: cd("m,n") = ad("m,k") * bd("k,n"); break;
+          case 1: cf("m,n") = af("m,k") * bf("k,n"); break;
+          case 2:
+            cm("m,n") = TiledArray::result_as<TiledArray::TensorD>(
+                af("m,k") * bf("k,n"));
+            break;
+        }
+        world.gop.fence();
+        time[i] += madness::wall_time() - start;
+      }
+    }
+
+    // Compute the errors relative to the double precision result
+    TiledArray::TArrayD cfd = TiledArray::to_new_tile_type(cf,
+        [] (const TiledArray::TensorF& tile) { return TiledArray::TensorD(tile); });
+    const double norm = cd("m,n").norm().get();
+    const double error[3] = { 0.0,
+        (cfd("m,n") - cd("m,n")).norm().get() / norm,
+        (cm("m,n") - cd("m,n")).norm().get() / norm };
+
+    if(world.rank() == 0)
+      for(int i = 0; i < 3; ++i)
+        std::cout << names[i] << "   time=" << time[i] / double(repeat)
+                  << "   GFLOPS=" << gflop * double(repeat) / time[i]
+                  << "   relative error=" << error[i] << "\n";
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
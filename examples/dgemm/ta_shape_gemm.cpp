@@ -0,0 +1,170 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+// Contract the shapes with dense norm matrices, i.e. scale copies of the
+// argument norms by the inner tile sizes and multiply them with Tensor::gemm.
+// This is the reference that SparseShape::gemm is compared against.
+TiledArray::Tensor<float> dense_shape_gemm(const TiledArray::SparseShape<float>& left,
+    const TiledArray::SparseShape<float>& right, const TiledArray::TiledRange& trange,
+    const TiledArray::math::GemmHelper& gemm_helper)
+{
+  const TiledArray::TiledRange1& k_range = trange.data()[1];
+  const std::size_t K = k_range.tiles_range().second - k_range.tiles_range().first;
+  const std::size_t M = left.data().size() / K;
+  const std::size_t N = right.data().size() / K;
+
+  TiledArray::Tensor<float> a = left.data().clone();
+  TiledArray::Tensor<float> b = right.data().clone();
+  for(std::size_t k = 0ul; k < K; ++k) {
+    const float size = k_range.tile(k).second - k_range.tile(k).first;
+    for(std::size_t m = 0ul; m < M; ++m)
+      a[m * K + k] *= size;
+    for(std::size_t n = 0ul; n < N; ++n)
+      b[k * N + n] *= size;
+  }
+
+  return a.gemm(b, 1.0f, gemm_helper);
+}
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if(argc < 3) {
+      std::cout << "Compares SparseShape::gemm with a dense evaluation of the shape contraction.\n"
+                << "Usage: " << argv[0] << " num_tiles fill_fraction [repetitions]\n";
+      return 0;
+    }
+    const long num_tiles = atol(argv[1]);
+    const double fill = atof(argv[2]);
+    if(num_tiles <= 0) {
+      std::cerr << "Error: number of tiles must be greater than zero.\n";
+      return 1;
+    }
+    if(fill <= 0.0 || fill > 1.0) {
+      std::cerr << "Error: fill fraction must be in the range (0, 1].\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 4);
+    if(repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: shape contraction test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of threads  = " << madness::ThreadPool::size() + 1
+                << "\nTile grid          = " << num_tiles << "x" << num_tiles
+                << "\nFill fraction      = " << fill << "\n";
+
+    // Construct TiledRange with 10 elements per tile
+    std::vector<unsigned int> blocking;
+    blocking.reserve(num_tiles + 1);
+    for(long i = 0l; i <= num_tiles; ++i)
+      blocking.push_back(i * 10);
+
+    std::vector<TiledArray::TiledRange1> blocking2(2,
+        TiledArray::TiledRange1(blocking.begin(), blocking.end()));
+
+    TiledArray::TiledRange
+      trange(blocking2.begin(), blocking2.end());
+
+    // Construct random norms with the requested fill fraction
+    TiledArray::Tensor<float>
+        a_tile_norms(trange.tiles_range(), 0.0),
+        b_tile_norms(trange.tiles_range(), 0.0);
+    world.srand(42);
+    for(std::size_t i = 0ul; i < a_tile_norms.size(); ++i) {
+      if(world.rand() % 1000 < fill * 1000)
+        a_tile_norms[i] = 1.0f + world.rand() % 100;
+      if(world.rand() % 1000 < fill * 1000)
+        b_tile_norms[i] = 1.0f + world.rand() % 100;
+    }
+    TiledArray::SparseShape<float>
+        a_shape(a_tile_norms, trange),
+        b_shape(b_tile_norms, trange);
+
+    TiledArray::math::GemmHelper gemm_helper(madness::cblas::NoTrans,
+        madness::cblas::NoTrans, 2u, 2u, 2u);
+
+    // Time the dense evaluation
+    double dense_time = 0.0;
+    TiledArray::Tensor<float> dense_norms;
+    for(int i = 0; i < repeat; ++i) {
+      const double start = madness::wall_time();
+      dense_norms = dense_shape_gemm(a_shape, b_shape, trange, gemm_helper);
+      dense_time += madness::wall_time() - start;
+    }
+
+    // Time the sparse evaluation
+    double sparse_time = 0.0;
+    TiledArray::SparseShape<float> c_shape;
+    for(int i = 0; i < repeat; ++i) {
+      const double start = madness::wall_time();
+      c_shape = a_shape.gemm(b_shape, 1.0, gemm_helper);
+      sparse_time += madness::wall_time() - start;
+    }
+
+    // Compare the results
+    float max_error = 0.0f;
+    for(std::size_t i = 0ul; i < dense_norms.size(); ++i) {
+      float expected = dense_norms[i];
+      if(expected < TiledArray::SparseShape<float>::threshold())
+        expected = 0.0f;
+      const float error = std::abs(c_shape[i] - expected) / std::max(expected, 1.0f);
+      max_error = std::max(max_error, error);
+    }
+
+    if(world.rank() == 0)
+      std::cout << "Result sparsity          = " << c_shape.sparsity()
+                << "\nAverage dense wall time  = " << dense_time / double(repeat)
+                << "\nAverage sparse wall time = " << sparse_time / double(repeat)
+                << "\nSpeedup                  = " << dense_time / sparse_time
+                << "\nMaximum relative error   = " << max_error << "\n";
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
@@ -0,0 +1,137 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+// Compare the construction of a distributed SparseShape, which exchanges only
+// the non-zero tile norms of each process, with a max all-reduce of the dense
+// tile norm tensor. Each process holds the norms of the tiles it owns, so run
+// with increasing numbers of processes and fill fractions.
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if(argc < 3) {
+      std::cout << "Compares the construction of a distributed SparseShape with a dense all-reduce.\n"
+                << "Usage: " << argv[0] << " num_tiles fill_fraction [repetitions]\n";
+      return 0;
+    }
+    const long num_tiles = atol(argv[1]);
+    const double fill = atof(argv[2]);
+    if(num_tiles <= 0) {
+      std::cerr << "Error: number of tiles must be greater than zero.\n";
+      return 1;
+    }
+    if(fill <= 0.0 || fill > 1.0) {
+      std::cerr << "Error: fill fraction must be in the range (0, 1].\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 10);
+    if(repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: sparse shape construction test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of nodes    = " << world.size()
+                << "\nTile grid          = " << num_tiles << "x" << num_tiles
+                << "x" << num_tiles << "x" << num_tiles
+                << "\nFill fraction      = " << fill << "\n";
+
+    // Construct a rank-4 TiledRange with 10 elements per tile
+    std::vector<unsigned int> blocking;
+    blocking.reserve(num_tiles + 1);
+    for(long i = 0l; i <= num_tiles; ++i)
+      blocking.push_back(i * 10);
+    const TiledArray::TiledRange1 trange1(blocking.begin(), blocking.end());
+    const TiledArray::TiledRange trange({trange1, trange1, trange1, trange1});
+
+    // Construct random norms of the local tiles with the requested fill
+    // fraction
+    TiledArray::detail::BlockedPmap pmap(world, trange.tiles_range().volume());
+    TiledArray::Tensor<float> tile_norms(trange.tiles_range(), 0.0f);
+    world.srand(42);
+    std::size_t nonzero = 0ul;
+    for(std::size_t i = 0ul; i < tile_norms.size(); ++i) {
+      const bool is_nonzero = (world.rand() % 1000 < fill * 1000);
+      const float norm = 1000.0f + world.rand() % 100;
+      if(is_nonzero && pmap.is_local(i)) {
+        tile_norms[i] = norm;
+        ++nonzero;
+      }
+    }
+    world.gop.sum(nonzero);
+
+    // Time the dense all-reduce of the norms
+    double dense_time = 0.0;
+    for(int i = 0; i < repeat; ++i) {
+      world.gop.fence();
+      const double start = madness::wall_time();
+      TiledArray::Tensor<float> norms = tile_norms.clone();
+      world.gop.max(norms.data(), norms.size());
+      TiledArray::SparseShape<float> shape(norms, trange);
+      dense_time += madness::wall_time() - start;
+    }
+
+    // Time the shape constructor
+    double sparse_time = 0.0;
+    for(int i = 0; i < repeat; ++i) {
+      world.gop.fence();
+      const double start = madness::wall_time();
+      TiledArray::SparseShape<float> shape(world, tile_norms, trange);
+      sparse_time += madness::wall_time() - start;
+    }
+
+    if(world.rank() == 0)
+      std::cout << "Non-zero tiles     = " << nonzero << " of "
+                << tile_norms.size()
+                << "\nDense all-reduce   = " << dense_time / double(repeat) << " s"
+                << "\nSparse all-gather  = " << sparse_time / double(repeat) << " s"
+                << "\nSpeedup            = " << dense_time / sparse_time << "\n";
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
@@ -0,0 +1,180 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <complex>
+#include <tiledarray.h>
+#include <TiledArray/math/simd.h>
+#include <TiledArray/version.h>
+
+// Compare the throughput of the explicit SIMD kernels at each supported
+// instruction set level with the generic vector operations (loop unwinding
+// of element-wise lambdas) for the primitives used by tensor arithmetic.
+
+namespace {
+
+  namespace simd = TiledArray::math::simd;
+
+  /// Report the average time and bandwidth of an operation
+  template <typename Op>
+  void run(const char* type, const char* op_name, const char* path,
+      const long repeat, const double gbytes, Op&& op)
+  {
+    op(); // warm up
+    const double start = madness::wall_time();
+    for(long r = 0l; r < repeat; ++r)
+      op();
+    const double time = (madness::wall_time() - start) / double(repeat);
+
+    std::cout << std::setw(14) << type << std::setw(14) << op_name
+              << std::setw(10) << path
+              << "   average time=" << std::setw(12) << time
+              << "   GB/s=" << gbytes / time << "\n";
+  }
+
+  template <typename T>
+  void benchmark(const char* type, const std::size_t n, const long repeat) {
+    typedef typename simd::detail::real_type<T>::type real_type;
+    std::vector<T> x(n, T(1)), y(n, T(2));
+    const double gb = double(n * sizeof(T)) / 1.0e9;
+    const real_type a = 1.0000001;
+    real_type sum = 0;
+
+    // Generic vector operations
+    run(type, "scale", "generic", repeat, 2.0 * gb, [&] () {
+      TiledArray::math::inplace_vector_op(
+          [a] (T& MADNESS_RESTRICT l) { l *= a; }, n, y.data());
+    });
+    run(type, "axpy", "generic", repeat, 3.0 * gb, [&] () {
+      TiledArray::math::inplace_vector_op(
+          [a] (T& MADNESS_RESTRICT l, const T r) { l += a * r; }, n, y.data(), x.data());
+    });
+    run(type, "add_to", "generic", repeat, 3.0 * gb, [&] () {
+      TiledArray::math::inplace_vector_op(
+          [a] (T& MADNESS_RESTRICT l, const T r) { (l += r) *= a; }, n, y.data(), x.data());
+    });
+    run(type, "squared_norm", "generic", repeat, gb, [&] () {
+      real_type result = 0;
+      TiledArray::math::reduce_op(
+          [] (real_type& MADNESS_RESTRICT res, const T arg) { res += std::norm(arg); },
+          [] (real_type& MADNESS_RESTRICT res, const real_type arg) { res += arg; },
+          real_type(0), n, result, y.data());
+      sum += result;
+    });
+    run(type, "dot", "generic", repeat, 2.0 * gb, [&] () {
+      T result = 0;
+      TiledArray::math::reduce_op(
+          [] (T& MADNESS_RESTRICT res, const T l, const T r) { res += l * r; },
+          [] (T& MADNESS_RESTRICT res, const T arg) { res += arg; },
+          T(0), n, result, x.data(), y.data());
+      sum += std::abs(result);
+    });
+
+    // SIMD kernels
+    const simd::Level level = simd::level();
+    for(simd::Level l : { simd::Level::generic, simd::Level::neon,
+        simd::Level::avx2, simd::Level::avx512 })
+    {
+      if(! simd::supported(l) || (l > simd::max_level()))
+        continue;
+      simd::set_level(l);
+      const char* name = simd::level_name(l);
+
+      run(type, "scale", name, repeat, 2.0 * gb,
+          [&] () { simd::scale_to(n, a, y.data()); });
+      run(type, "axpy", name, repeat, 3.0 * gb,
+          [&] () { simd::axpy(n, a, x.data(), y.data()); });
+      run(type, "add_to", name, repeat, 3.0 * gb,
+          [&] () { simd::add_to(n, x.data(), y.data(), a); });
+      run(type, "squared_norm", name, repeat, gb,
+          [&] () { sum += simd::squared_norm(n, y.data()); });
+      run(type, "dot", name, repeat, 2.0 * gb,
+          [&] () { sum += std::abs(simd::dot(n, x.data(), y.data())); });
+    }
+    simd::set_level(level);
+
+    // Keep the reductions from being optimized away
+    if(sum < real_type(0))
+      std::cout << sum << "\n";
+  }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if(argc < 2) {
+      std::cout << "Usage: " << argv[0] << " vector_size [repetitions]\n";
+      return 0;
+    }
+    const long n = atol(argv[1]);
+    if (n <= 0) {
+      std::cerr << "Error: vector size must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 3 ? atol(argv[2]) : 100);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    if(world.rank() == 0) {
+      std::cout << "TiledArray: SIMD vector kernel test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nVector size         = " << n
+                << "\nSIMD level          = " << simd::level_name(simd::level())
+                << "\n";
+
+      benchmark<float>("float", n, repeat);
+      benchmark<double>("double", n, repeat);
+      benchmark<std::complex<float> >("complex<float>", n, repeat);
+      benchmark<std::complex<double> >("complex<double>", n, repeat);
+    }
+
+    world.gop.fence();
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
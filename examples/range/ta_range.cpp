@@ -0,0 +1,167 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <numeric>
+#include <cmath>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+// Measure the throughput of the range operations that are performed for each
+// tile: range construction, copy, and permutation, TiledRange::tile(), and
+// construction of small tiles.
+
+namespace {
+
+  /// Report the average time of an operation
+  template <typename Op>
+  void run(const unsigned int rank, const char* op_name, const long repeat,
+      const std::size_t n, Op&& op)
+  {
+    op(); // warm up
+    const double start = madness::wall_time();
+    for(long r = 0l; r < repeat; ++r)
+      op();
+    const double time = (madness::wall_time() - start) / double(repeat);
+
+    std::cout << std::setw(6) << rank << std::setw(12) << op_name
+              << "   ns/op=" << std::setw(10) << 1.0e9 * time / double(n)
+              << "   Mop/s=" << 1.0e-6 * double(n) / time << "\n";
+  }
+
+  void benchmark(const unsigned int rank, const std::size_t ntiles,
+      const std::size_t tile_size, const long repeat)
+  {
+    // Tile the range of each dimension so there are about ntiles tiles
+    const std::size_t ntiles1 = std::max<std::size_t>(2ul,
+        std::size_t(std::round(std::pow(double(ntiles), 1.0 / double(rank)))));
+    std::vector<std::size_t> blocking;
+    for(std::size_t i = 0ul; i <= ntiles1; ++i)
+      blocking.push_back(i * tile_size);
+    const std::vector<TiledArray::TiledRange1>
+        ranges(rank, TiledArray::TiledRange1(blocking.begin(), blocking.end()));
+    const TiledArray::TiledRange trange(ranges.begin(), ranges.end());
+    const std::size_t n = trange.tiles_range().volume();
+
+    const TiledArray::Range::index lobound(rank, tile_size);
+    const TiledArray::Range::index upbound(rank, tile_size * 2ul);
+    const TiledArray::Range range(lobound, upbound);
+    std::vector<unsigned int> p(rank);
+    std::iota(p.rbegin(), p.rend(), 0u);
+    const TiledArray::Permutation perm(p.begin(), p.end());
+
+    std::size_t sum = 0ul;
+    run(rank, "construct", repeat, n, [&] () {
+      for(std::size_t i = 0ul; i < n; ++i) {
+        TiledArray::Range r(lobound, upbound);
+        sum += r.volume();
+      }
+    });
+    run(rank, "copy", repeat, n, [&] () {
+      for(std::size_t i = 0ul; i < n; ++i) {
+        TiledArray::Range r(range);
+        sum += r.volume();
+      }
+    });
+    run(rank, "permute", repeat, n, [&] () {
+      for(std::size_t i = 0ul; i < n; ++i) {
+        TiledArray::Range r = perm * range;
+        sum += r.volume();
+      }
+    });
+    run(rank, "tile", repeat, n, [&] () {
+      for(std::size_t i = 0ul; i < n; ++i)
+        sum += trange.tile(i).volume();
+    });
+    run(rank, "tensor", repeat, n, [&] () {
+      for(std::size_t i = 0ul; i < n; ++i) {
+        TiledArray::TensorD t(trange.tile(i));
+        sum += t.size();
+      }
+    });
+
+    // Keep the operations from being optimized away
+    if(sum == 0ul)
+      std::cout << sum << "\n";
+  }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    const long ntiles = (argc >= 2 ? atol(argv[1]) : 4096l);
+    if (ntiles <= 0) {
+      std::cerr << "Error: number of tiles must be greater than zero.\n";
+      return 1;
+    }
+    const long tile_size = (argc >= 3 ? atol(argv[2]) : 2l);
+    if (tile_size <= 0) {
+      std::cerr << "Error: tile size must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 100l);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    if(world.rank() == 0) {
+      std::cout << "TiledArray: range throughput test..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of tiles     = " << ntiles
+                << "\nTile size           = " << tile_size
+                << "\nInline rank limit   = " << TiledArray::Range::max_inline_rank
+                << "\n";
+
+      for(unsigned int rank = 2u; rank <= TiledArray::Range::max_inline_rank + 2u; rank += 2u)
+        benchmark(rank, ntiles, tile_size, repeat);
+    }
+
+    world.gop.fence();
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
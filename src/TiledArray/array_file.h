@@ -0,0 +1,519 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  array_file.h
+ *  Apr 16, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_ARRAY_FILE_H__INCLUDED
+#define TILEDARRAY_ARRAY_FILE_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/parallel_io.h>
+#include <TiledArray/tensor/tensor_map.h>
+#include <madness/world/buffer_archive.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// The fixed size header of an array file
+    struct ArrayFileHeader {
+      char magic[8]; ///< File signature, \c "TAARRAY"
+      std::uint64_t version; ///< Format version
+      std::uint64_t element_size; ///< The size of a tile element in bytes
+      std::uint64_t element_hash; ///< The type hash of the tile elements
+      std::uint64_t shape_hash; ///< The type hash of the shape
+      std::uint64_t metadata_bytes; ///< The size of the serialized metadata
+      std::uint64_t ntiles; ///< The number of tiles
+      std::uint64_t reserved; ///< Unused
+
+      static constexpr std::uint64_t current_version = 1ul;
+      static constexpr std::uint64_t alignment = 64ul; ///< Tile data alignment
+
+      /// The file offset of the tile index, which follows the metadata
+      std::uint64_t index_offset() const {
+        return (sizeof(ArrayFileHeader) + metadata_bytes + 7ul) & ~std::uint64_t(7ul);
+      }
+
+      /// Round \c offset up to the tile data alignment
+      static std::uint64_t align(const std::uint64_t offset) {
+        return (offset + alignment - 1ul) & ~(alignment - 1ul);
+      }
+    }; // struct ArrayFileHeader
+
+    static_assert(sizeof(ArrayFileHeader) == 64ul,
+        "The array file header must be 64 bytes.");
+
+    /// A read-only memory mapping of an array file
+    class ArrayFileMapping {
+      const unsigned char* data_; ///< The mapped file
+      std::size_t size_; ///< The size of the file in bytes
+
+    public:
+      ArrayFileMapping(const ArrayFileMapping&) = delete;
+      ArrayFileMapping& operator=(const ArrayFileMapping&) = delete;
+
+      /// Map a file into memory
+
+      /// \param name The file name
+      /// \throw TiledArray::Exception When the file cannot be mapped
+      explicit ArrayFileMapping(const std::string& name) :
+        data_(nullptr), size_(0ul)
+      {
+        const int fd = ::open(name.c_str(), O_RDONLY);
+        if(fd < 0)
+          TA_EXCEPTION("Unable to open the array file.");
+        struct stat st;
+        if(::fstat(fd, &st) != 0) {
+          ::close(fd);
+          TA_EXCEPTION("Unable to query the size of the array file.");
+        }
+        size_ = st.st_size;
+        void* data = (size_ > 0ul ?
+            ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED);
+        ::close(fd);
+        if(data == MAP_FAILED)
+          TA_EXCEPTION("Unable to map the array file.");
+        data_ = static_cast<const unsigned char*>(data);
+      }
+
+      ~ArrayFileMapping() {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+      }
+
+      /// Mapped data accessor
+      const unsigned char* data() const { return data_; }
+
+      /// File size accessor
+      std::size_t size() const { return size_; }
+    }; // class ArrayFileMapping
+
+    /// Create an array file and write its header, metadata, and index
+
+    /// \param name The file name
+    /// \param header The file header
+    /// \param metadata The serialized tiled range and shape
+    /// \param offsets The tile offsets
+    /// \param file_size The size of the file in bytes
+    /// \return 0 on success, or an error status for
+    /// \c throw_array_file_error()
+    inline int create_array_file(const std::string& name,
+        const ArrayFileHeader& header, const std::vector<unsigned char>& metadata,
+        const std::vector<std::uint64_t>& offsets, const std::uint64_t file_size)
+    {
+      const int fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if(fd < 0)
+        return 1;
+      int status = 0;
+      if(::ftruncate(fd, off_t(file_size)) != 0) {
+        status = 2;
+      } else {
+        try {
+          write_at(fd, &header, sizeof(header), 0ul);
+          write_at(fd, metadata.data(), metadata.size(), sizeof(header));
+          write_at(fd, offsets.data(), offsets.size() * sizeof(std::uint64_t),
+              header.index_offset());
+        } catch(...) {
+          status = 3;
+        }
+      }
+      ::close(fd);
+      return status;
+    }
+
+    /// Throw the exception of an error status of \c write_array_file()
+
+    /// \param status The error status
+    /// \throw TiledArray::Exception When \c status is not 0
+    inline void throw_array_file_error(const int status) {
+      switch(status) {
+        case 0:
+          break;
+        case 1:
+          TA_EXCEPTION("Unable to create the array file.");
+        case 2:
+          TA_EXCEPTION("Unable to resize the array file.");
+        case 3:
+          TA_EXCEPTION("Unable to write the array file.");
+        default:
+          TA_EXCEPTION("Unable to open the array file.");
+      }
+    }
+
+  } // namespace detail
+
+  /// Write an array to an indexed array file
+
+  /// The array file has a fixed size header, the serialized tiled range and
+  /// shape, an index with the file offset of each tile, and the tile data.
+  /// The elements of each non-zero tile are stored contiguously, in the
+  /// order of the tile range, at an aligned offset, so tiles can be read
+  /// independently, and in place, from a memory mapping of the file (see
+  /// \c ArrayFile ). Every process computes the offsets from the tiled range
+  /// and shape, and writes its local tiles directly to the file, which must
+  /// be on a file system that is shared by all processes. The data is stored
+  /// in the byte order of the writer.
+  /// \tparam Tile The tile type, which must be a tensor with contiguous
+  /// storage of trivially copyable elements
+  /// \tparam Policy The array policy type
+  /// \param array The array to be written
+  /// \param name The file name
+  /// \note This is a collective operation.
+  template <typename Tile, typename Policy>
+  inline void write_array_file(const DistArray<Tile, Policy>& array,
+      const std::string& name)
+  {
+    typedef DistArray<Tile, Policy> array_type;
+    typedef typename array_type::element_type element_type;
+    typedef typename array_type::shape_type shape_type;
+    static_assert(detail::is_contiguous_tensor_v<Tile>,
+        "Array files require tiles with contiguous storage.");
+    static_assert(std::is_trivially_copyable<element_type>::value,
+        "Array files require trivially copyable tile elements.");
+
+    World& world = array.world();
+    const auto& trange = array.trange();
+    const std::size_t ntiles = trange.tiles_range().volume();
+
+    // Compute the layout of the file
+    detail::ArrayFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::strncpy(header.magic, "TAARRAY", sizeof(header.magic));
+    header.version = detail::ArrayFileHeader::current_version;
+    header.element_size = sizeof(element_type);
+    header.element_hash = typeid(element_type).hash_code();
+    header.shape_hash = typeid(shape_type).hash_code();
+    header.metadata_bytes = detail::serialized_size(trange) +
+        detail::serialized_size(array.shape());
+    header.ntiles = ntiles;
+
+    std::vector<std::uint64_t> offsets(ntiles, 0ul);
+    std::uint64_t offset = detail::ArrayFileHeader::align(
+        header.index_offset() + ntiles * sizeof(std::uint64_t));
+    for(std::size_t ord = 0ul; ord < ntiles; ++ord) {
+      if(array.is_zero(ord))
+        continue;
+      offsets[ord] = offset;
+      offset = detail::ArrayFileHeader::align(offset +
+          trange.make_tile_range(ord).volume() * sizeof(element_type));
+    }
+    const std::uint64_t file_size = offset;
+
+    // Create the file, and write the header, metadata, and index. The
+    // status of rank 0 is broadcast, so all processes throw together instead
+    // of waiting for rank 0 in the next collective operation.
+    int status = 0;
+    if(world.rank() == 0) {
+      std::vector<unsigned char> metadata(header.metadata_bytes);
+      madness::archive::BufferOutputArchive oar(metadata.data(), metadata.size());
+      oar & trange & array.shape();
+      status = detail::create_array_file(name, header, metadata, offsets,
+          file_size);
+    }
+    world.gop.broadcast(status, 0);
+    detail::throw_array_file_error(status);
+
+    // Write the local tiles as they become available
+    const int fd = ::open(name.c_str(), O_WRONLY);
+    status = (fd < 0 ? 4 : 0);
+    world.gop.max(status);
+    if(status != 0) {
+      if(fd >= 0)
+        ::close(fd);
+      detail::throw_array_file_error(status);
+    }
+    std::shared_ptr<std::atomic<int> > failed =
+        std::make_shared<std::atomic<int> >(0);
+    // The local tiles are taken from the process map, since the local
+    // iterator skips the tiles that are not stored by an array with a tile
+    // symmetry, and find() computes them from their canonical tiles.
+    for(const std::size_t ord : *array.pmap()) {
+      if(array.is_zero(ord))
+        continue;
+      const std::uint64_t tile_offset = offsets[ord];
+      world.taskq.add([fd,tile_offset,failed] (const Tile& tile) {
+        try {
+          detail::write_at(fd, tile.data(),
+              tile.range().volume() * sizeof(element_type), tile_offset);
+        } catch(...) {
+          *failed = 3;
+        }
+      }, array.find(ord));
+    }
+    world.gop.fence();
+    ::close(fd);
+    status = *failed;
+    world.gop.max(status);
+    detail::throw_array_file_error(status);
+  }
+
+  /// An array file that is mapped into memory
+
+  /// An \c ArrayFile provides random access to the tiles of an array that
+  /// was written with \c write_array_file() . Tiles can be viewed in place,
+  /// without copying them, with \c tile() , and an array, or a block of it,
+  /// can be read with any process map and any number of processes, where
+  /// each process reads only its local tiles.
+  class ArrayFile {
+  public:
+    typedef std::size_t size_type; ///< Size type
+
+  private:
+    std::shared_ptr<const detail::ArrayFileMapping> mapping_; ///< The file mapping
+    detail::ArrayFileHeader header_; ///< The file header
+    TiledRange trange_; ///< The tiled range of the array
+    const std::uint64_t* offsets_; ///< The tile offsets
+
+    /// Check that a tile is stored in the mapped file
+
+    /// \param ord The tile ordinal
+    /// \param volume The number of elements in the tile
+    /// \return The file offset of the tile
+    /// \throw TiledArray::Exception When the tile is zero, or its data is
+    /// not inside the file
+    std::uint64_t tile_offset(const size_type ord, const size_type volume) const {
+      const std::uint64_t offset = offsets_[ord];
+      if(offset == 0ul)
+        TA_EXCEPTION("The tile is zero.");
+      const std::uint64_t data_offset = header_.index_offset() +
+          header_.ntiles * sizeof(std::uint64_t);
+      if((offset < data_offset) || (offset > mapping_->size()) ||
+          (volume * header_.element_size > mapping_->size() - offset))
+        TA_EXCEPTION("The array file is truncated or corrupt.");
+      return offset;
+    }
+
+    /// Check the element and shape types of an array
+    template <typename Array>
+    void check_type() const {
+      typedef typename Array::element_type element_type;
+      TA_USER_ASSERT((header_.element_size == sizeof(element_type)) &&
+          (header_.element_hash == typeid(element_type).hash_code()),
+          "The element type of the array file does not match the array.");
+      TA_USER_ASSERT(header_.shape_hash ==
+          typeid(typename Array::shape_type).hash_code(),
+          "The shape type of the array file does not match the array.");
+    }
+
+    /// Read the local tiles of an array
+
+    /// \param result The array that receives the tiles
+    /// \param file_ord Maps the tile ordinals of \c result to the tile
+    /// ordinals of the file
+    template <typename Array, typename Op>
+    void read_tiles(Array& result, const Op& file_ord) const {
+      typedef typename Array::value_type value_type;
+      typedef typename Array::element_type element_type;
+
+      World& world = result.world();
+      for(auto it = result.begin(); it != result.end(); ++it) {
+        const size_type ord = it.ordinal();
+        auto range = result.trange().make_tile_range(ord);
+        const std::uint64_t offset = tile_offset(file_ord(ord), range.volume());
+        std::shared_ptr<const detail::ArrayFileMapping> mapping = mapping_;
+        result.set(ord, world.taskq.add([mapping,offset,range] () {
+          const element_type* data = reinterpret_cast<const element_type*>(
+              mapping->data() + offset);
+          value_type tile(range);
+          std::copy(data, data + range.volume(), tile.data());
+          return tile;
+        }));
+      }
+    }
+
+  public:
+    ArrayFile(const ArrayFile&) = delete;
+    ArrayFile& operator=(const ArrayFile&) = delete;
+
+    /// Open an array file
+
+    /// \param name The file name
+    /// \throw TiledArray::Exception When the file cannot be mapped, or is
+    /// not an array file
+    explicit ArrayFile(const std::string& name) :
+      mapping_(std::make_shared<detail::ArrayFileMapping>(name)),
+      header_(), trange_(), offsets_(nullptr)
+    {
+      if(mapping_->size() < sizeof(header_))
+        TA_EXCEPTION("The file is not an array file.");
+      std::memcpy(&header_, mapping_->data(), sizeof(header_));
+      if(std::strncmp(header_.magic, "TAARRAY", sizeof(header_.magic)) != 0)
+        TA_EXCEPTION("The file is not an array file.");
+      if(header_.version != detail::ArrayFileHeader::current_version)
+        TA_EXCEPTION("The array file version is not supported.");
+      if(mapping_->size() < header_.index_offset() +
+          header_.ntiles * sizeof(std::uint64_t))
+        TA_EXCEPTION("The array file is truncated.");
+
+      madness::archive::BufferInputArchive iar(
+          mapping_->data() + sizeof(header_), header_.metadata_bytes);
+      iar & trange_;
+      offsets_ = reinterpret_cast<const std::uint64_t*>(
+          mapping_->data() + header_.index_offset());
+      TA_ASSERT(trange_.tiles_range().volume() == header_.ntiles);
+    }
+
+    /// Tiled range accessor
+
+    /// \return The tiled range of the array in the file
+    const TiledRange& trange() const { return trange_; }
+
+    /// Shape accessor
+
+    /// \tparam Shape The shape type of the array in the file
+    /// \return The shape of the array in the file
+    template <typename Shape>
+    Shape shape() const {
+      TA_USER_ASSERT(header_.shape_hash == typeid(Shape).hash_code(),
+          "The shape type of the array file does not match.");
+      madness::archive::BufferInputArchive iar(
+          mapping_->data() + sizeof(header_), header_.metadata_bytes);
+      TiledRange trange;
+      Shape result;
+      iar & trange & result;
+      return result;
+    }
+
+    /// Check for a zero tile
+
+    /// \param ord The tile ordinal
+    /// \return \c true if the tile is not stored in the file
+    bool is_zero(const size_type ord) const {
+      TA_ASSERT(ord < header_.ntiles);
+      return offsets_[ord] == 0ul;
+    }
+
+    /// A view of a tile in the file
+
+    /// The view references the mapped file, so no data is copied, and it is
+    /// valid while this object exists.
+    /// \tparam T The element type of the array in the file
+    /// \param ord The ordinal of a non-zero tile
+    /// \return A read-only tensor view of the tile
+    template <typename T>
+    TensorConstMap<T> tile(const size_type ord) const {
+      TA_USER_ASSERT((header_.element_size == sizeof(T)) &&
+          (header_.element_hash == typeid(T).hash_code()),
+          "The element type of the array file does not match.");
+      TA_ASSERT(ord < header_.ntiles);
+      auto range = trange_.make_tile_range(ord);
+      const std::uint64_t offset = tile_offset(ord, range.volume());
+      return make_const_map(reinterpret_cast<const T*>(
+          mapping_->data() + offset), std::move(range));
+    }
+
+    /// Read the array
+
+    /// Each process reads only the tiles that are local under \c pmap .
+    /// \tparam Array The array type
+    /// \param world The world of the result array
+    /// \param pmap The process map of the result array, or null for the
+    /// default process map
+    /// \return The array in the file
+    /// \note This is a collective operation.
+    template <typename Array>
+    Array read(World& world,
+        const std::shared_ptr<typename Array::pmap_interface>& pmap = nullptr) const
+    {
+      check_type<Array>();
+      Array result(world, trange_,
+          shape<typename Array::shape_type>(), pmap);
+      read_tiles(result, [] (const size_type ord) { return ord; });
+      return result;
+    }
+
+    /// Read a block of the array
+
+    /// The result contains the tiles in the range
+    /// <tt>[lower_bound, upper_bound)</tt> of the array in the file, and its
+    /// tiled range is shifted so that it starts at zero, like the result of
+    /// a block expression. Each process reads only the tiles that are local
+    /// under \c pmap .
+    /// \tparam Array The array type
+    /// \tparam Index The tile index type
+    /// \param world The world of the result array
+    /// \param lower_bound The lower bound of the tile block
+    /// \param upper_bound The upper bound of the tile block
+    /// \param pmap The process map of the result array, or null for the
+    /// default process map
+    /// \return The block of the array in the file
+    /// \note This is a collective operation.
+    template <typename Array, typename Index>
+    Array read_block(World& world, const Index& lower_bound,
+        const Index& upper_bound,
+        const std::shared_ptr<typename Array::pmap_interface>& pmap = nullptr) const
+    {
+      check_type<Array>();
+      const unsigned int rank = trange_.tiles_range().rank();
+      TA_USER_ASSERT(lower_bound.size() == rank && upper_bound.size() == rank,
+          "The rank of the block bounds does not match the array file.");
+
+      // Copy and shift the tiling of the block
+      std::vector<TiledRange1> trange_data;
+      trange_data.reserve(rank);
+      std::vector<std::size_t> trange1_data;
+      for(unsigned int d = 0u; d < rank; ++d) {
+        const std::size_t lower_d = lower_bound[d];
+        const std::size_t upper_d = upper_bound[d];
+        TA_USER_ASSERT((trange_.data()[d].tiles_range().first <= lower_d) &&
+            (lower_d < upper_d) &&
+            (upper_d <= trange_.data()[d].tiles_range().second),
+            "The block is not in the tile range of the array file.");
+        const auto base_d = trange_.data()[d].tile(lower_d).first;
+        trange1_data.emplace_back(0ul);
+        for(auto i = lower_d; i < upper_d; ++i)
+          trange1_data.emplace_back(trange_.data()[d].tile(i).second - base_d);
+        trange_data.emplace_back(trange1_data.begin(), trange1_data.end());
+        trange1_data.resize(0ul);
+      }
+
+      Array result(world, TiledRange(trange_data.begin(), trange_data.end()),
+          shape<typename Array::shape_type>().block(lower_bound, upper_bound),
+          pmap);
+
+      // Map the block tile ordinals to the file tile ordinals
+      const auto& file_tiles = trange_.tiles_range();
+      const auto& block_tiles = result.trange().tiles_range();
+      std::vector<std::size_t> lower(lower_bound.begin(), lower_bound.end());
+      read_tiles(result, [&] (const size_type ord) {
+        auto index = block_tiles.idx(ord);
+        for(unsigned int d = 0u; d < rank; ++d)
+          index[d] += lower[d];
+        return file_tiles.ordinal(index);
+      });
+      return result;
+    }
+
+  }; // class ArrayFile
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ARRAY_FILE_H__INCLUDED
@@ -30,6 +30,7 @@
 #include <TiledArray/distributed_storage.h>
 #include <TiledArray/transform_iterator.h>
 #include <TiledArray/type_traits.h>
+#include <TiledArray/symm/tile_symmetry.h>
 
 namespace TiledArray {
   namespace detail {
@@ -271,7 +272,7 @@ namespace TiledArray {
             array_->pmap()->end();
         do {
           ++it_;
-        } while((it_ != end) && array_->is_zero(*it_));
+        } while((it_ != end) && (array_->is_zero(*it_) || ! array_->is_canonical(*it_)));
       }
 
     public:
@@ -410,6 +411,45 @@ namespace TiledArray {
 
     }; // class TensorIterator
 
+    /// Unpack a canonical tile
+
+    /// \tparam Arg The tile type
+    /// \param tile The canonical tile
+    /// \param perm The permutation of the canonical tile
+    /// \param sign The sign of the canonical tile
+    /// \return <tt>sign * permute(tile, perm)</tt>
+    template <typename Arg>
+    inline auto unpack_tile(const Arg& tile, const Permutation& perm,
+        const int sign, int) ->
+        decltype(Arg(tile.permute(perm)), Arg(tile.scale(sign, perm)))
+    {
+      return (sign == 1 ? Arg(tile.permute(perm)) : Arg(tile.scale(sign, perm)));
+    }
+
+    /// Unpack a canonical \c Tile
+
+    /// \tparam T The tensor type of the tile
+    /// \param tile The canonical tile
+    /// \param perm The permutation of the canonical tile
+    /// \param sign The sign of the canonical tile
+    /// \return <tt>sign * permute(tile, perm)</tt>
+    template <typename T>
+    inline auto unpack_tile(const Tile<T>& tile, const Permutation& perm,
+        const int sign, int) ->
+        decltype(Tile<T>(unpack_tile(tile.tensor(), perm, sign, 0)))
+    {
+      return Tile<T>(unpack_tile(tile.tensor(), perm, sign, 0));
+    }
+
+    /// Unpack a canonical tile that cannot be permuted
+
+    /// \throw TiledArray::Exception Always
+    template <typename Arg>
+    inline Arg unpack_tile(const Arg& tile, const Permutation&, const int, long) {
+      TA_EXCEPTION("The tiles of an array with a tile symmetry must support permute and scale.");
+      return tile;
+    }
+
     /// Tensor implementation and base for other tensor implementation objects
 
     /// This implementation object holds the data for tensor object, which
@@ -444,6 +484,7 @@ namespace TiledArray {
     private:
 
       storage_type data_; ///< Tile container
+      std::shared_ptr<const symmetry::TileSymmetry> symmetry_; ///< Tile symmetry (may be null)
 
     public:
 
@@ -459,7 +500,7 @@ namespace TiledArray {
       ArrayImpl(World& world, const trange_type& trange, const shape_type& shape,
           const std::shared_ptr<pmap_interface>& pmap) :
         TensorImpl_(world, trange, shape, pmap),
-        data_(world, trange.tiles_range().volume(), pmap)
+        data_(world, trange.tiles_range().volume(), pmap), symmetry_()
       { }
 
       /// Virtual destructor
@@ -469,12 +510,25 @@ namespace TiledArray {
 
       /// \tparam Index The index type
       /// \param i The tile index
-      /// \return A \c future to tile \c i
+      /// \return A \c future to tile \c i ; non-canonical tiles are
+      /// computed from their canonical tile
       /// \throw TiledArray::Exception When tile \c i is zero
       template <typename Index>
       future get(const Index& i) const {
         TA_ASSERT(! TensorImpl_::is_zero(i));
-        return data_.get(TensorImpl_::trange().tiles_range().ordinal(i));
+        const auto& tiles_range = TensorImpl_::trange().tiles_range();
+        if(is_canonical(i))
+          return data_.get(tiles_range.ordinal(i));
+
+        // Permute the canonical tile
+        const symmetry::TileSymmetry::Canonical canonical =
+            symmetry_->canonical(tiles_range.idx(tiles_range.ordinal(i)));
+        TA_ASSERT(! TensorImpl_::is_zero(canonical.index));
+        return TensorImpl_::world().taskq.add(
+            [] (const value_type& tile, const Permutation& perm, const int sign)
+            { return detail::unpack_tile(tile, perm, sign, 0); },
+            data_.get(tiles_range.ordinal(canonical.index)), canonical.perm,
+            canonical.sign);
       }
 
       /// Tile future accessor
@@ -497,10 +551,41 @@ namespace TiledArray {
       /// \tparam Value The value type
       /// \param i The index of the tile to be set
       /// \param value The object tat contains the tile value
+      /// \note Non-canonical tiles are not stored, so they are ignored.
       template <typename Index, typename Value>
       void set(const Index& i, const Value& value) {
         TA_ASSERT(! TensorImpl_::is_zero(i));
-        data_.set(TensorImpl_::trange().tiles_range().ordinal(i), value);
+        if(is_canonical(i))
+          data_.set(TensorImpl_::trange().tiles_range().ordinal(i), value);
+      }
+
+      /// Set the tile symmetry
+
+      /// \param symmetry The tile symmetry
+      void set_symmetry(const std::shared_ptr<const symmetry::TileSymmetry>& symmetry) {
+        symmetry_ = symmetry;
+      }
+
+      /// Tile symmetry accessor
+
+      /// \return A pointer to the tile symmetry, which is null when the tiles
+      /// have no symmetry
+      const std::shared_ptr<const symmetry::TileSymmetry>& symmetry() const {
+        return symmetry_;
+      }
+
+      /// Check for canonical tiles
+
+      /// \tparam Index The index type
+      /// \param i The tile index or ordinal
+      /// \return \c true if tile \c i is stored, i.e. there is no tile
+      /// symmetry or \c i is the canonical tile of its orbit
+      template <typename Index>
+      bool is_canonical(const Index& i) const {
+        if(! symmetry_)
+          return true;
+        const auto& tiles_range = TensorImpl_::trange().tiles_range();
+        return symmetry_->is_canonical(tiles_range.idx(tiles_range.ordinal(i)));
       }
 
       /// Array begin iterator
@@ -510,9 +595,9 @@ namespace TiledArray {
         // Get the pmap iterator
         typename pmap_interface::const_iterator it = TensorImpl_::pmap()->begin();
 
-        // Find the first non-zero iterator
+        // Find the first non-zero, canonical iterator
         const typename pmap_interface::const_iterator end = TensorImpl_::pmap()->end();
-        while((it != end) && TensorImpl_::is_zero(*it)) ++it;
+        while((it != end) && (TensorImpl_::is_zero(*it) || ! is_canonical(*it))) ++it;
 
         // Construct and return the iterator
         return iterator(this, it);
@@ -525,9 +610,9 @@ namespace TiledArray {
         // Get the pmap iterator
         typename pmap_interface::const_iterator it = TensorImpl_::pmap()->begin();
 
-        // Find the fist non-zero iterator
+        // Find the fist non-zero, canonical iterator
         const typename pmap_interface::const_iterator end = TensorImpl_::pmap()->end();
-        while((it != end) && TensorImpl_::is_zero(*it)) ++it;
+        while((it != end) && (TensorImpl_::is_zero(*it) || ! is_canonical(*it))) ++it;
 
         // Construct and return the iterator
         return const_iterator(this, it);
@@ -552,6 +637,16 @@ namespace TiledArray {
       /// \return A const reference to this object unique id
       const madness::uniqueidT& id() const { return data_.id(); }
 
+      /// Tile container accessor
+
+      /// \return A reference to the distributed tile container
+      storage_type& storage() { return data_; }
+
+      /// Tile container accessor
+
+      /// \return A const reference to the distributed tile container
+      const storage_type& storage() const { return data_; }
+
     }; // class ArrayImpl
 
 
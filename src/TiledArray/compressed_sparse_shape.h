@@ -0,0 +1,1157 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2019  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  compressed_sparse_shape.h
+ *  Oct 17, 2019
+ *
+ */
+
+#ifndef TILEDARRAY_COMPRESSED_SPARSE_SHAPE_H__INCLUDED
+#define TILEDARRAY_COMPRESSED_SPARSE_SHAPE_H__INCLUDED
+
+#include <TiledArray/sparse_shape.h>
+#include <TiledArray/math/sparse_gemm.h>
+#include <algorithm>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Frobenius-norm-based sparse shape that stores only non-zero tile norms
+
+  /// \c CompressedSparseShape has the same semantics and interface as
+  /// \c SparseShape , i.e. it holds the *scaled* (per-element) Frobenius norms
+  /// of the tiles and screens them with \c SparseShape<T>::threshold() , but
+  /// the norms are stored as a list of (ordinal, norm) pairs sorted by the
+  /// tile ordinal. Only tiles with a norm above the threshold are stored, so
+  /// the memory required by the shape is proportional to the number of
+  /// non-zero tiles instead of the volume of the tile range. All shape
+  /// arithmetic (\c add , \c mult , \c gemm , \c perm , \c block , ...) is
+  /// performed directly on the compressed data.
+  ///
+  /// The price of compression is that random access to a tile norm (via
+  /// \c operator[] or \c is_zero ) is \f$ O(\log n_{\rm nz}) \f$ instead of
+  /// \f$ O(1) \f$ , and that \c data() and \c tile_norms() return a dense
+  /// copy of the norms rather than a reference.
+  /// Arrays with this shape use \c CompressedSparsePolicy .
+  /// \tparam T The sparse element value type
+  template <typename T>
+  class CompressedSparseShape {
+  public:
+    typedef CompressedSparseShape<T> CompressedSparseShape_; ///< This object type
+    typedef T value_type; ///< The norm value type
+    typedef Range::size_type size_type;  ///< Size type
+
+  private:
+
+    // T must be a numeric type
+    static_assert(std::is_floating_point<T>::value,
+        "CompressedSparseShape template type T must be a floating point type");
+
+    // Internal typedefs
+    typedef detail::ValArray<value_type> vector_type;
+    typedef std::pair<size_type, value_type> datum_type;
+
+    Range range_; ///< The tile range
+    std::vector<size_type> ordinals_; ///< Sorted ordinals of the non-zero tiles
+    std::vector<value_type> norms_; ///< Scaled norms of the non-zero tiles
+    std::shared_ptr<vector_type> size_vectors_; ///< Tile size information; size_vectors_.get()[d][i] reports the size of i-th tile in dimension d
+
+    static std::shared_ptr<vector_type>
+    initialize_size_vectors(const TiledRange& trange) {
+      // Allocate memory for size vectors
+      const unsigned int dim = trange.tiles_range().rank();
+      std::shared_ptr<vector_type> size_vectors(new vector_type[dim],
+          std::default_delete<vector_type[]>());
+
+      // Initialize the size vectors
+      for(unsigned int i = 0ul; i != dim; ++i) {
+        const size_type n = trange.data()[i].tiles_range().second - trange.data()[i].tiles_range().first;
+
+        size_vectors.get()[i] = vector_type(n, & (* trange.data()[i].begin()),
+            [] (const TiledRange1::range_type& tile)
+            { return value_type(tile.second - tile.first); });
+      }
+
+      return size_vectors;
+    }
+
+    /// Convert an ordinal into zero-based coordinates
+
+    /// \param range The range of the ordinal
+    /// \param ord The ordinal index
+    /// \param[out] idx The zero-based coordinate index of \c ord
+    static void coordinates(const Range& range, size_type ord,
+        size_type* MADNESS_RESTRICT const idx)
+    {
+      const auto* MADNESS_RESTRICT const extent = range.extent_data();
+      for(int d = int(range.rank()) - 1; d >= 0; --d) {
+        idx[d] = ord % extent[d];
+        ord /= extent[d];
+      }
+    }
+
+    /// Convert zero-based coordinates into an ordinal
+
+    /// \param range The range of the index
+    /// \param idx The zero-based coordinate index
+    /// \return The ordinal index of \c idx in \c range
+    static size_type ordinal(const Range& range,
+        const size_type* MADNESS_RESTRICT const idx)
+    {
+      const auto* MADNESS_RESTRICT const extent = range.extent_data();
+      size_type ord = 0ul;
+      for(unsigned int d = 0u; d < range.rank(); ++d)
+        ord = ord * extent[d] + idx[d];
+      return ord;
+    }
+
+    /// Tile volume accessor
+
+    /// \param size_vectors The tile size vectors
+    /// \param rank The number of dimensions
+    /// \param idx The zero-based coordinate index of the tile
+    /// \return The number of elements in the tile
+    static value_type volume(const vector_type* MADNESS_RESTRICT const size_vectors,
+        const unsigned int rank, const size_type* MADNESS_RESTRICT const idx)
+    {
+      value_type result = 1;
+      for(unsigned int d = 0u; d < rank; ++d)
+        result *= size_vectors[d][idx[d]];
+      return result;
+    }
+
+    /// Fused size vector
+
+    /// \param size_vectors The first size vector to be fused
+    /// \param n The number of size vectors to be fused
+    /// \return The outer product of the \c n size vectors, in row-major order
+    static std::vector<value_type>
+    fused_sizes(const vector_type* size_vectors, const unsigned int n) {
+      std::vector<value_type> result(1, value_type(1));
+      for(unsigned int d = 0u; d < n; ++d) {
+        const vector_type& sizes = size_vectors[d];
+        std::vector<value_type> next;
+        next.reserve(result.size() * sizes.size());
+        for(const value_type x : result)
+          for(size_type i = 0ul; i < sizes.size(); ++i)
+            next.push_back(x * sizes[i]);
+        result.swap(next);
+      }
+      return result;
+    }
+
+    /// Compress a dense norm tensor
+
+    /// \param norms The norms of every tile in \c range_
+    /// \param scale If \c true , the norms are divided by the tile volume
+    void compress(const value_type* MADNESS_RESTRICT const norms, const bool scale) {
+      const unsigned int rank = range_.rank();
+      const size_type n = range_.volume();
+      const value_type threshold = SparseShape<T>::threshold();
+      std::vector<size_type> idx(rank, 0ul);
+      const auto* MADNESS_RESTRICT const extent = range_.extent_data();
+
+      for(size_type ord = 0ul; ord < n; ++ord) {
+        value_type norm = norms[ord];
+        if(scale)
+          norm /= volume(size_vectors_.get(), rank, idx.data());
+        if(norm >= threshold) {
+          ordinals_.push_back(ord);
+          norms_.push_back(norm);
+        }
+
+        // Increment the coordinate index
+        for(int d = int(rank) - 1; d >= 0; --d) {
+          if(++idx[d] < extent[d])
+            break;
+          idx[d] = 0ul;
+        }
+      }
+    }
+
+    /// Assign the compressed data from a list of (ordinal, norm) pairs
+
+    /// The data is sorted by ordinal, duplicate entries are combined with
+    /// \c max , and entries below the threshold are dropped.
+    /// \param data The (ordinal, norm) pairs
+    void assign(std::vector<datum_type>& data) {
+      std::sort(data.begin(), data.end(),
+          [] (const datum_type& l, const datum_type& r) { return l.first < r.first; });
+
+      const value_type threshold = SparseShape<T>::threshold();
+      ordinals_.clear();
+      norms_.clear();
+      ordinals_.reserve(data.size());
+      norms_.reserve(data.size());
+      for(const datum_type& datum : data) {
+        if(! ordinals_.empty() && (ordinals_.back() == datum.first)) {
+          norms_.back() = std::max(norms_.back(), datum.second);
+        } else if(datum.second >= threshold) {
+          ordinals_.push_back(datum.first);
+          norms_.push_back(datum.second);
+        }
+      }
+    }
+
+    /// Gather the non-zero norms of all processes
+
+    /// Only the (ordinal, norm) pairs of non-zero tiles are exchanged (see
+    /// \c detail::allgather_sparse ), and norms of tiles that are stored by
+    /// more than one process are max-reduced.
+    /// \param world The world where the shape will live
+    void allgather_max(World& world) {
+      std::vector<size_type> ordinals(ordinals_);
+      std::vector<value_type> norms(norms_);
+      const size_type total = detail::allgather_sparse(world, ordinals, norms);
+
+      std::vector<datum_type> data;
+      data.reserve(total);
+      for(size_type i = 0ul; i < total; ++i)
+        data.emplace_back(ordinals[i], norms[i]);
+      assign(data);
+    }
+
+    std::shared_ptr<vector_type> perm_size_vectors(const Permutation& perm) const {
+      const unsigned int n = range_.rank();
+
+      // Allocate memory for the contracted size vectors
+      std::shared_ptr<vector_type> result_size_vectors(new vector_type[n],
+          std::default_delete<vector_type[]>());
+
+      // Initialize the size vectors
+      for(unsigned int i = 0u; i < n; ++i) {
+        const unsigned int perm_i = perm[i];
+        result_size_vectors.get()[perm_i] = size_vectors_.get()[i];
+      }
+
+      return result_size_vectors;
+    }
+
+    CompressedSparseShape(const Range& range, std::vector<size_type>&& ordinals,
+        std::vector<value_type>&& norms,
+        const std::shared_ptr<vector_type>& size_vectors) :
+      range_(range), ordinals_(std::move(ordinals)), norms_(std::move(norms)),
+      size_vectors_(size_vectors)
+    { }
+
+    /// Apply an element-wise operation to the non-zero norms
+
+    /// \tparam Op The operation type, <tt>value_type(value_type)</tt>
+    /// \param op The operation; results below the threshold are dropped
+    /// \return A new shape with the same range
+    template <typename Op>
+    CompressedSparseShape_ unary(const Op& op) const {
+      TA_ASSERT(! empty());
+      const value_type threshold = SparseShape<T>::threshold();
+      std::vector<size_type> ordinals;
+      std::vector<value_type> norms;
+      ordinals.reserve(ordinals_.size());
+      norms.reserve(norms_.size());
+      for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+        const value_type norm = op(norms_[i]);
+        if(norm >= threshold) {
+          ordinals.push_back(ordinals_[i]);
+          norms.push_back(norm);
+        }
+      }
+
+      return CompressedSparseShape_(range_, std::move(ordinals),
+          std::move(norms), size_vectors_);
+    }
+
+    /// Merge the non-zero norms of two shapes
+
+    /// \tparam Union If \c true , the result contains the union of the
+    /// non-zero tiles of both shapes, otherwise their intersection.
+    /// \tparam Op The operation type,
+    /// <tt>value_type(size_type ordinal, value_type left, value_type right)</tt>
+    /// \param other The right-hand shape
+    /// \param op The operation; missing norms are passed as zero and results
+    /// below the threshold are dropped
+    /// \return A new shape with the same range
+    template <bool Union, typename Op>
+    CompressedSparseShape_ merge(const CompressedSparseShape_& other, const Op& op) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(range_ == other.range_);
+
+      const value_type threshold = SparseShape<T>::threshold();
+      std::vector<size_type> ordinals;
+      std::vector<value_type> norms;
+      if(Union) {
+        ordinals.reserve(ordinals_.size() + other.ordinals_.size());
+        norms.reserve(ordinals_.size() + other.ordinals_.size());
+      }
+
+      auto push = [&] (const size_type ord, const value_type left,
+          const value_type right)
+      {
+        const value_type norm = op(ord, left, right);
+        if(norm >= threshold) {
+          ordinals.push_back(ord);
+          norms.push_back(norm);
+        }
+      };
+
+      size_type l = 0ul, r = 0ul;
+      const size_type nl = ordinals_.size(), nr = other.ordinals_.size();
+      while((l < nl) && (r < nr)) {
+        if(ordinals_[l] < other.ordinals_[r]) {
+          if(Union)
+            push(ordinals_[l], norms_[l], value_type(0));
+          ++l;
+        } else if(other.ordinals_[r] < ordinals_[l]) {
+          if(Union)
+            push(other.ordinals_[r], value_type(0), other.norms_[r]);
+          ++r;
+        } else {
+          push(ordinals_[l], norms_[l], other.norms_[r]);
+          ++l;
+          ++r;
+        }
+      }
+      if(Union) {
+        for(; l < nl; ++l)
+          push(ordinals_[l], norms_[l], value_type(0));
+        for(; r < nr; ++r)
+          push(other.ordinals_[r], value_type(0), other.norms_[r]);
+      }
+
+      return CompressedSparseShape_(range_, std::move(ordinals),
+          std::move(norms), size_vectors_);
+    }
+
+  public:
+
+    /// Default constructor
+
+    /// Construct a shape with no data.
+    CompressedSparseShape() :
+      range_(), ordinals_(), norms_(), size_vectors_()
+    { }
+
+    /// "Dense" Constructor
+
+    /// This constructor set the tile norms to the same value.
+    /// \param tile_norm the value of the (per-element) norm for every tile
+    /// \param trange The tiled range of the tensor
+    /// \note this ctor *does not* scale tile norms
+    /// \note if @c tile_norm is less than the threshold then all tile norms are set to zero
+    CompressedSparseShape(const value_type& tile_norm, const TiledRange& trange) :
+      range_(trange.tiles_range()), ordinals_(), norms_(),
+      size_vectors_(initialize_size_vectors(trange))
+    {
+      if(tile_norm >= SparseShape<T>::threshold()) {
+        const size_type n = range_.volume();
+        ordinals_.resize(n);
+        for(size_type i = 0ul; i < n; ++i)
+          ordinals_[i] = i;
+        norms_.resize(n, tile_norm);
+      }
+    }
+
+    /// "Dense" constructor
+
+    /// This constructor will scale the tile norms, i.e. multiply each tile norm
+    /// byt the inverse of its volume, and only store the norms that are
+    /// above the threshold.
+    /// \param tile_norms The Frobenius norm of tiles by default
+    /// \param trange The tiled range of the tensor
+    /// \param do_not_scale if true, assume that the tile norms in \c tile_norms are already scaled
+    CompressedSparseShape(const Tensor<value_type>& tile_norms,
+        const TiledRange& trange, bool do_not_scale = false) :
+      range_(trange.tiles_range()), ordinals_(), norms_(),
+      size_vectors_(initialize_size_vectors(trange))
+    {
+      TA_ASSERT(! tile_norms.empty());
+      TA_ASSERT(tile_norms.range() == trange.tiles_range());
+
+      compress(tile_norms.data(), ! do_not_scale);
+    }
+
+    /// "Sparse" constructor
+
+    /// This constructor uses tile norms given as a sparse tensor,
+    /// represented as a sequence of {index,value_type} data.
+    /// The tile norms are scaled by the inverse of the corresponding tile's volumes.
+    /// \tparam SparseNormSequence the sequence of \c std::pair<index,value_type> objects,
+    ///         where \c index is a directly-addressable sequence indices.
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    template <typename SparseNormSequence,
+              typename = std::enable_if_t<
+                  TiledArray::detail::has_member_function_begin_anyreturn<
+                      std::decay_t<SparseNormSequence>>::value &&
+                  TiledArray::detail::has_member_function_end_anyreturn<
+                      std::decay_t<SparseNormSequence>>::value>>
+    CompressedSparseShape(const SparseNormSequence& tile_norms,
+        const TiledRange& trange) :
+      range_(trange.tiles_range()), ordinals_(), norms_(),
+      size_vectors_(initialize_size_vectors(trange))
+    {
+      const unsigned int rank = range_.rank();
+      const auto* MADNESS_RESTRICT const lobound = range_.lobound_data();
+      std::vector<size_type> idx(rank, 0ul);
+      std::vector<datum_type> data;
+      for(const auto& pair_idx_norm : tile_norms) {
+        for(unsigned int d = 0u; d < rank; ++d)
+          idx[d] = pair_idx_norm.first[d] - lobound[d];
+        data.emplace_back(ordinal(range_, idx.data()), pair_idx_norm.second /
+            volume(size_vectors_.get(), rank, idx.data()));
+      }
+      assign(data);
+    }
+
+    /// Collective "dense" constructor
+
+    /// This constructor uses tile norms given as a dense tensor.
+    /// The local tile norms are compressed first, then the non-zero norms
+    /// are gathered from all processes and max-reduced, so that only the
+    /// non-zero tile norms are communicated.
+    /// \param world The world where the shape will live
+    /// \param tile_norms The Frobenius norm of tiles by default; expected to contain nonzeros
+    ///        for this rank's subset of tiles, or be replicated.
+    /// \param trange The tiled range of the tensor
+    /// \param do_not_scale if true, assume that the tile norms in \c tile_norms are already scaled
+    CompressedSparseShape(World& world, const Tensor<value_type>& tile_norms,
+        const TiledRange& trange, bool do_not_scale = false) :
+      CompressedSparseShape(tile_norms, trange, do_not_scale)
+    {
+      allgather_max(world);
+    }
+
+    /// Collective "sparse" constructor
+
+    /// This constructor uses tile norms given as a sparse tensor,
+    /// represented as a sequence of {index,value_type} data.
+    /// The tile norms are scaled to per-element norms by dividing each
+    /// norm by the tile's volume.
+    /// Lastly, the non-zero norms are gathered from all processes and
+    /// max-reduced.
+    /// \tparam SparseNormSequence the sequence of \c std::pair<index,value_type> objects,
+    ///         where \c index is a directly-addressable sequence of integers.
+    /// \param world The world where the shape will live
+    /// \param tile_norms The Frobenius norm of tiles; expected to contain nonzeros
+    ///        for this rank's subset of tiles, or be replicated.
+    /// \param trange The tiled range of the tensor
+    template <typename SparseNormSequence>
+    CompressedSparseShape(World& world, const SparseNormSequence& tile_norms,
+        const TiledRange& trange) :
+      CompressedSparseShape(tile_norms, trange)
+    {
+      allgather_max(world);
+    }
+
+    /// Conversion constructor
+
+    /// \param other The shape to be compressed
+    /// \param trange The tiled range of \c other
+    CompressedSparseShape(const SparseShape<T>& other, const TiledRange& trange) :
+      CompressedSparseShape(other.data(), trange, true)
+    { }
+
+    /// Validate shape range
+
+    /// \return \c true when range matches the range of this shape
+    bool validate(const Range& range) const {
+      if(empty())
+        return false;
+      return (range == range_);
+    }
+
+    /// Tile norm accessor
+
+    /// \tparam Index The index type
+    /// \param index The index of the tile norm to retrieve
+    /// \return The norm of the tile at \c index
+    template <typename Index>
+    value_type operator[](const Index& index) const {
+      TA_ASSERT(! empty());
+      const size_type ord = range_.ordinal(index);
+      const auto it = std::lower_bound(ordinals_.begin(), ordinals_.end(), ord);
+      return ((it != ordinals_.end()) && (*it == ord) ?
+          norms_[it - ordinals_.begin()] : value_type(0));
+    }
+
+    /// Check that a tile is zero
+
+    /// \tparam Index The type of the index
+    /// \return \c true if the tile at \c i is zero
+    template <typename Index>
+    bool is_zero(const Index& i) const {
+      return operator[](i) < SparseShape<T>::threshold();
+    }
+
+    /// Check density
+
+    /// \return false
+    static constexpr bool is_dense() { return false; }
+
+    /// Sparsity of the shape
+
+    /// \return The fraction of tiles that are zero.
+    float sparsity() const {
+      TA_ASSERT(! empty());
+      return float(range_.volume() - ordinals_.size()) / float(range_.volume());
+    }
+
+    /// Number of non-zero tiles
+
+    /// \return The number of tiles whose norm is stored by this shape
+    size_type nnz() const { return ordinals_.size(); }
+
+    /// Threshold accessor
+
+    /// The threshold is shared with \c SparseShape<T> .
+    /// \return The current threshold
+    static value_type threshold() { return SparseShape<T>::threshold(); }
+
+    /// Set threshold to \c thresh
+
+    /// \param thresh The new threshold
+    static void threshold(const value_type thresh) { SparseShape<T>::threshold(thresh); }
+
+    /// Tile range accessor
+
+    /// \return A const reference to the tile range of this shape
+    const Range& range() const { return range_; }
+
+    /// Transform the norm tensor with an operation
+
+    /// \return A deep copy of the norms of the object having
+    /// performed the operation Op.
+    /// Op should take a const ref to a Tensor<T> and return a Tensor<T>
+    /// \note The norms are expanded into a dense tensor for \c op .
+    template <typename Op>
+    CompressedSparseShape_ transform(Op&& op) const {
+      const Tensor<T> new_norms = op(data());
+      TA_ASSERT(new_norms.range() == range_);
+      CompressedSparseShape_ result(range_, std::vector<size_type>(),
+          std::vector<value_type>(), size_vectors_);
+      result.compress(new_norms.data(), false);
+      return result;
+    }
+
+    /// Data accessor
+
+    /// \return A dense \c Tensor that holds the scaled (per-element) Frobenius
+    /// norms of tiles
+    Tensor<value_type> data() const {
+      Tensor<value_type> result(range_, value_type(0));
+      for(size_type i = 0ul; i < ordinals_.size(); ++i)
+        result.data()[ordinals_[i]] = norms_[i];
+      return result;
+    }
+
+    /// Data accessor
+
+    /// \return A dense \c Tensor that holds the Frobenius norms of tiles
+    Tensor<value_type> tile_norms() const {
+      const unsigned int rank = range_.rank();
+      std::vector<size_type> idx(rank, 0ul);
+      Tensor<value_type> result(range_, value_type(0));
+      for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+        coordinates(range_, ordinals_[i], idx.data());
+        result.data()[ordinals_[i]] =
+            norms_[i] * volume(size_vectors_.get(), rank, idx.data());
+      }
+      return result;
+    }
+
+    /// Initialization check
+
+    /// \return \c true when this shape has been initialized.
+    bool empty() const { return ! size_vectors_; }
+
+    /// Compute union of two shapes
+
+    /// \param mask_shape The input shape, hard zeros are used to mask the output.
+    /// \return A shape that is masked by the mask.
+    CompressedSparseShape_ mask(const CompressedSparseShape_& mask_shape) const {
+      return merge<false>(mask_shape,
+          [] (const size_type, const value_type left, const value_type)
+          { return left; });
+    }
+
+    /// Update sub-block of shape
+
+    /// Update a sub-block shape information with another shape object.
+    /// \tparam Index The bound index type
+    /// \param lower_bound The lower bound of the sub-block to be updated
+    /// \param upper_bound The upper bound of the sub-block to be updated
+    /// \param other The shape that will be used to update the sub-block
+    /// \return A new sparse shape object where the specified sub-block contains the data
+    /// result_tile_norms of \c other.
+    template <typename Index>
+    CompressedSparseShape_ update_block(const Index& lower_bound,
+        const Index& upper_bound, const CompressedSparseShape_& other) const
+    {
+      TA_ASSERT(! empty());
+      const unsigned int rank = range_.rank();
+      const auto* MADNESS_RESTRICT const lower = detail::data(lower_bound);
+      const auto* MADNESS_RESTRICT const upper = detail::data(upper_bound);
+      const auto* MADNESS_RESTRICT const lobound = range_.lobound_data();
+      std::vector<size_type> idx(rank, 0ul);
+      std::vector<datum_type> data;
+      data.reserve(ordinals_.size() + other.ordinals_.size());
+
+      // Keep the norms outside of the block
+      for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+        coordinates(range_, ordinals_[i], idx.data());
+        bool inside = true;
+        for(unsigned int d = 0u; (d < rank) && inside; ++d)
+          inside = (idx[d] + lobound[d] >= size_type(lower[d])) &&
+                   (idx[d] + lobound[d] < size_type(upper[d]));
+        if(! inside)
+          data.emplace_back(ordinals_[i], norms_[i]);
+      }
+
+      // Insert the norms of other into the block
+      for(size_type i = 0ul; i < other.ordinals_.size(); ++i) {
+        coordinates(other.range_, other.ordinals_[i], idx.data());
+        for(unsigned int d = 0u; d < rank; ++d)
+          idx[d] += lower[d] - lobound[d];
+        data.emplace_back(ordinal(range_, idx.data()), other.norms_[i]);
+      }
+
+      CompressedSparseShape_ result(range_, std::vector<size_type>(),
+          std::vector<value_type>(), size_vectors_);
+      result.assign(data);
+      return result;
+    }
+
+    /// Bitwise comparison
+
+    /// \param other a CompressedSparseShape object
+    /// \return true if this object and @c other object are bitwise identical
+    bool operator==(const CompressedSparseShape_& other) const {
+      bool equal = (range_ == other.range_) && (ordinals_ == other.ordinals_);
+      if (equal) {
+        const unsigned int dim = range_.rank();
+        for(unsigned d=0; d!=dim && equal; ++d)
+          equal = (size_vectors_.get()[d] == other.size_vectors_.get()[d]);
+        equal = equal && (norms_ == other.norms_);
+      }
+      return equal;
+    }
+
+  private:
+
+    /// Create a copy of a sub-block of the shape
+
+    /// \tparam Index The upper and lower bound array type
+    /// \tparam Op The norm operation type
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    /// \param op The operation that is applied to the norms of the sub-block
+    template <typename Index, typename Op>
+    CompressedSparseShape_ block_op(const Index& lower_bound,
+        const Index& upper_bound, const Op& op) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(detail::size(lower_bound) == range_.rank());
+      TA_ASSERT(detail::size(upper_bound) == range_.rank());
+
+      // Get the number dimensions of the shape
+      const unsigned int rank = range_.rank();
+      const auto* MADNESS_RESTRICT const lower = detail::data(lower_bound);
+      const auto* MADNESS_RESTRICT const upper = detail::data(upper_bound);
+      const auto* MADNESS_RESTRICT const lobound = range_.lobound_data();
+
+      std::shared_ptr<vector_type> size_vectors(new vector_type[rank],
+          std::default_delete<vector_type[]>());
+      std::vector<size_type> extent(rank, 0ul);
+      for(unsigned int d = 0u; d < rank; ++d) {
+        // Check that the input indices are in range
+        TA_ASSERT(lower[d] < upper[d]);
+        TA_ASSERT(size_type(upper[d]) <= range_.upbound(d));
+
+        extent[d] = upper[d] - lower[d];
+        size_vectors.get()[d] = vector_type(extent[d],
+            size_vectors_.get()[d].data() + lower[d]);
+      }
+      Range result_range(extent);
+
+      // The block preserves the row-major order of the tiles, so the result
+      // ordinals are sorted.
+      const value_type threshold = SparseShape<T>::threshold();
+      std::vector<size_type> idx(rank, 0ul);
+      std::vector<size_type> ordinals;
+      std::vector<value_type> norms;
+      for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+        coordinates(range_, ordinals_[i], idx.data());
+        bool inside = true;
+        for(unsigned int d = 0u; (d < rank) && inside; ++d) {
+          const size_type x = idx[d] + lobound[d];
+          inside = (x >= size_type(lower[d])) && (x < size_type(upper[d]));
+          idx[d] = x - lower[d];
+        }
+        if(! inside)
+          continue;
+
+        const value_type norm = op(norms_[i]);
+        if(norm >= threshold) {
+          ordinals.push_back(ordinal(result_range, idx.data()));
+          norms.push_back(norm);
+        }
+      }
+
+      return CompressedSparseShape_(result_range, std::move(ordinals),
+          std::move(norms), size_vectors);
+    }
+
+  public:
+
+    /// Create a copy of a sub-block of the shape
+
+    /// \tparam Index The upper and lower bound array type
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    template <typename Index>
+    CompressedSparseShape_ block(const Index& lower_bound,
+        const Index& upper_bound) const
+    {
+      return block_op(lower_bound, upper_bound,
+          [] (const value_type norm) { return norm; });
+    }
+
+    /// Create a scaled sub-block of the shape
+
+    /// \tparam Index The upper and lower bound array type
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    template <typename Index, typename Factor>
+    CompressedSparseShape_ block(const Index& lower_bound,
+        const Index& upper_bound, const Factor factor) const
+    {
+      const value_type abs_factor = to_abs_factor(factor);
+      return block_op(lower_bound, upper_bound,
+          [abs_factor] (const value_type norm) { return norm * abs_factor; });
+    }
+
+    /// Create a copy of a sub-block of the shape
+
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    template <typename Index>
+    CompressedSparseShape_ block(const Index& lower_bound,
+        const Index& upper_bound, const Permutation& perm) const
+    {
+      return block(lower_bound, upper_bound).perm(perm);
+    }
+
+    /// Create a copy of a sub-block of the shape
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    template <typename Index, typename Factor>
+    CompressedSparseShape_ block(const Index& lower_bound,
+        const Index& upper_bound, const Factor factor,
+        const Permutation& perm) const
+    {
+      return block(lower_bound, upper_bound, factor).perm(perm);
+    }
+
+    /// Create a permuted shape of this shape
+
+    /// \param perm The permutation to be applied
+    /// \return A new, permuted shape
+    CompressedSparseShape_ perm(const Permutation& perm) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(perm.dim() == range_.rank());
+
+      const unsigned int rank = range_.rank();
+      const Range result_range(perm, range_);
+      std::vector<size_type> idx(rank, 0ul), result_idx(rank, 0ul);
+      std::vector<datum_type> data;
+      data.reserve(ordinals_.size());
+      for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+        coordinates(range_, ordinals_[i], idx.data());
+        for(unsigned int d = 0u; d < rank; ++d)
+          result_idx[perm[d]] = idx[d];
+        data.emplace_back(ordinal(result_range, result_idx.data()), norms_[i]);
+      }
+
+      CompressedSparseShape_ result(result_range, std::vector<size_type>(),
+          std::vector<value_type>(), perm_size_vectors(perm));
+      result.assign(data);
+      return result;
+    }
+
+    /// Scale shape
+
+    /// Construct a new scaled shape as:
+    /// \f[
+    /// {(\rm{result})}_{ij...} = |(\rm{factor})| (\rm{this})_{ij...}
+    /// \f]
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param factor The scaling factor
+    /// \return A new, scaled shape
+    template <typename Factor>
+    CompressedSparseShape_ scale(const Factor factor) const {
+      const value_type abs_factor = to_abs_factor(factor);
+      return unary([abs_factor] (const value_type norm) { return norm * abs_factor; });
+    }
+
+    /// Scale and permute shape
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param factor The scaling factor
+    /// \param perm The permutation that will be applied to this tensor.
+    /// \return A new, scaled-and-permuted shape
+    template <typename Factor>
+    CompressedSparseShape_ scale(const Factor factor, const Permutation& perm) const {
+      return scale(factor).perm(perm);
+    }
+
+    /// Add shapes
+
+    /// Construct a new sum of shapes as:
+    /// \f[
+    /// {(\rm{result})}_{ij...} = (\rm{this})_{ij...} + (\rm{other})_{ij...}
+    /// \f]
+    /// \param other The shape to be added to this shape
+    /// \return A sum of shapes
+    CompressedSparseShape_ add(const CompressedSparseShape_& other) const {
+      return merge<true>(other,
+          [] (const size_type, const value_type left, const value_type right)
+          { return left + right; });
+    }
+
+    /// Add and permute shapes
+
+    /// \param other The shape to be added to this shape
+    /// \param perm The permutation that is applied to the result
+    /// \return the new shape, equals \c this + \c other
+    CompressedSparseShape_ add(const CompressedSparseShape_& other,
+        const Permutation& perm) const
+    {
+      return add(other).perm(perm);
+    }
+
+    /// Add and scale shapes
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param other The shape to be added to this shape
+    /// \param factor The scaling factor
+    /// \return A scaled sum of shapes
+    template <typename Factor>
+    CompressedSparseShape_ add(const CompressedSparseShape_& other,
+        const Factor factor) const
+    {
+      const value_type abs_factor = to_abs_factor(factor);
+      return merge<true>(other,
+          [abs_factor] (const size_type, const value_type left,
+              const value_type right)
+          { return (left + right) * abs_factor; });
+    }
+
+    /// Add, scale, and permute shapes
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param other The shape to be added to this shape
+    /// \param factor The scaling factor
+    /// \param perm The permutation that is applied to the result
+    /// \return A scaled and permuted sum of shapes
+    template <typename Factor>
+    CompressedSparseShape_ add(const CompressedSparseShape_& other,
+        const Factor factor, const Permutation& perm) const
+    {
+      return add(other, factor).perm(perm);
+    }
+
+    /// Add a constant to the shape
+
+    /// \note Adding a constant generally makes every tile non-zero, so the
+    /// cost and the size of the result are proportional to the volume of the
+    /// tile range.
+    /// \param value The constant that is added to every element
+    /// \return The new shape
+    CompressedSparseShape_ add(value_type value) const {
+      TA_ASSERT(! empty());
+      value = std::abs(value);
+      const unsigned int rank = range_.rank();
+      const size_type n = range_.volume();
+      const value_type threshold = SparseShape<T>::threshold();
+      const auto* MADNESS_RESTRICT const extent = range_.extent_data();
+      std::vector<size_type> idx(rank, 0ul);
+      std::vector<size_type> ordinals;
+      std::vector<value_type> norms;
+
+      for(size_type ord = 0ul, i = 0ul; ord < n; ++ord) {
+        value_type norm = value_type(0);
+        if((i < ordinals_.size()) && (ordinals_[i] == ord))
+          norm = norms_[i++];
+        norm += value / std::sqrt(volume(size_vectors_.get(), rank, idx.data()));
+        if(norm >= threshold) {
+          ordinals.push_back(ord);
+          norms.push_back(norm);
+        }
+
+        // Increment the coordinate index
+        for(int d = int(rank) - 1; d >= 0; --d) {
+          if(++idx[d] < extent[d])
+            break;
+          idx[d] = 0ul;
+        }
+      }
+
+      return CompressedSparseShape_(range_, std::move(ordinals),
+          std::move(norms), size_vectors_);
+    }
+
+    CompressedSparseShape_ add(const value_type value, const Permutation& perm) const {
+      return add(value).perm(perm);
+    }
+
+    CompressedSparseShape_ subt(const CompressedSparseShape_& other) const {
+      return add(other);
+    }
+
+    CompressedSparseShape_ subt(const CompressedSparseShape_& other,
+        const Permutation& perm) const
+    {
+      return add(other, perm);
+    }
+
+    template <typename Factor>
+    CompressedSparseShape_ subt(const CompressedSparseShape_& other,
+        const Factor factor) const
+    {
+      return add(other, factor);
+    }
+
+    template <typename Factor>
+    CompressedSparseShape_ subt(const CompressedSparseShape_& other,
+        const Factor factor, const Permutation& perm) const
+    {
+      return add(other, factor, perm);
+    }
+
+    CompressedSparseShape_ subt(const value_type value) const {
+      return add(value);
+    }
+
+    CompressedSparseShape_ subt(const value_type value, const Permutation& perm) const {
+      return add(value, perm);
+    }
+
+    CompressedSparseShape_ mult(const CompressedSparseShape_& other) const {
+      return mult(other, value_type(1));
+    }
+
+    CompressedSparseShape_ mult(const CompressedSparseShape_& other,
+        const Permutation& perm) const
+    {
+      return mult(other).perm(perm);
+    }
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    template <typename Factor>
+    CompressedSparseShape_ mult(const CompressedSparseShape_& other,
+        const Factor factor) const
+    {
+      const value_type abs_factor = to_abs_factor(factor);
+      const unsigned int rank = range_.rank();
+      const vector_type* const size_vectors = size_vectors_.get();
+      const Range& range = range_;
+      std::vector<size_type> idx(rank, 0ul);
+      return merge<false>(other,
+          [&] (const size_type ord, const value_type left, const value_type right) {
+            coordinates(range, ord, idx.data());
+            return left * right * abs_factor *
+                volume(size_vectors, rank, idx.data());
+          });
+    }
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    template <typename Factor>
+    CompressedSparseShape_ mult(const CompressedSparseShape_& other,
+        const Factor factor, const Permutation& perm) const
+    {
+      return mult(other, factor).perm(perm);
+    }
+
+    /// Contract shapes
+
+    /// The norms of the arguments are treated as sparse M-by-K and K-by-N
+    /// matrices, and the product is computed row by row with a sparse
+    /// accumulator, so the cost is proportional to the number of non-zero
+    /// tile-pair products rather than to \f$ M N K \f$ . Large products are
+    /// evaluated in parallel.
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    template <typename Factor>
+    CompressedSparseShape_ gemm(const CompressedSparseShape_& other,
+        const Factor factor, const math::GemmHelper& gemm_helper) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+
+      const value_type abs_factor = to_abs_factor(factor);
+      const value_type threshold = SparseShape<T>::threshold();
+      integer M = 0, N = 0, K = 0;
+      gemm_helper.compute_matrix_sizes(M, N, K, range_, other.range_);
+
+      // Allocate memory for the contracted size vectors
+      std::shared_ptr<vector_type> result_size_vectors(new vector_type[gemm_helper.result_rank()],
+          std::default_delete<vector_type[]>());
+
+      // Initialize the result size vectors
+      unsigned int x = 0ul;
+      for(unsigned int i = gemm_helper.left_outer_begin(); i < gemm_helper.left_outer_end(); ++i, ++x)
+        result_size_vectors.get()[x] = size_vectors_.get()[i];
+      for(unsigned int i = gemm_helper.right_outer_begin(); i < gemm_helper.right_outer_end(); ++i, ++x)
+        result_size_vectors.get()[x] = other.size_vectors_.get()[i];
+
+      const Range result_range =
+          gemm_helper.make_result_range<Range>(range_, other.range_);
+
+      // Compute the number of inner ranks
+      const unsigned int k_rank = gemm_helper.left_inner_end() - gemm_helper.left_inner_begin();
+
+      std::vector<size_type> ordinals;
+      std::vector<value_type> norms;
+
+      if(k_rank > 0u) {
+        // The squared inner tile sizes convert per-element norms to tile norms
+        std::vector<value_type> k_weights =
+            fused_sizes(size_vectors_.get() + gemm_helper.left_inner_begin(), k_rank);
+        for(value_type& k_weight : k_weights)
+          k_weight *= k_weight;
+
+        // Sort the left-hand norms into rows (m) and the right-hand norms
+        // into rows (k), i.e. compressed sparse row matrices.
+        const math::SparseMatrix<value_type> left(M, K, ordinals_, norms_,
+            gemm_helper.left_op() != madness::cblas::NoTrans);
+        const math::SparseMatrix<value_type> right(K, N, other.ordinals_,
+            other.norms_, gemm_helper.right_op() != madness::cblas::NoTrans);
+
+        // Each row block collects its non-zero norms separately, and the
+        // blocks are concatenated in order.
+        const std::vector<size_type> partition =
+            math::sparse_gemm_partition(left, right);
+        std::vector<std::vector<size_type> > block_ordinals(partition.size() - 1ul);
+        std::vector<std::vector<value_type> > block_norms(partition.size() - 1ul);
+        math::sparse_gemm(left, right, k_weights.data(), partition,
+            [=,&block_ordinals,&block_norms] (const size_type block,
+                const size_type m, std::vector<size_type>& columns,
+                const value_type* const accumulator)
+            {
+              std::sort(columns.begin(), columns.end());
+              for(const size_type n : columns) {
+                const value_type norm = accumulator[n] * abs_factor;
+                if(norm >= threshold) {
+                  block_ordinals[block].push_back(m * N + n);
+                  block_norms[block].push_back(norm);
+                }
+              }
+            });
+
+        for(size_type b = 0ul; b < block_ordinals.size(); ++b) {
+          ordinals.insert(ordinals.end(), block_ordinals[b].begin(), block_ordinals[b].end());
+          norms.insert(norms.end(), block_norms[b].begin(), block_norms[b].end());
+        }
+
+      } else {
+
+        // This is an outer product, so the inputs can be used directly
+        for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+          for(size_type j = 0ul; j < other.ordinals_.size(); ++j) {
+            const value_type norm = norms_[i] * other.norms_[j] * abs_factor;
+            if(norm >= threshold) {
+              ordinals.push_back(ordinals_[i] * N + other.ordinals_[j]);
+              norms.push_back(norm);
+            }
+          }
+        }
+      }
+
+      return CompressedSparseShape_(result_range, std::move(ordinals),
+          std::move(norms), result_size_vectors);
+    }
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    template <typename Factor>
+    CompressedSparseShape_ gemm(const CompressedSparseShape_& other,
+        const Factor factor, const math::GemmHelper& gemm_helper,
+        const Permutation& perm) const
+    {
+      return gemm(other, factor, gemm_helper).perm(perm);
+    }
+
+    template <typename Archive,
+        typename std::enable_if<madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+    void serialize(const Archive& ar) {
+      ar & range_ & ordinals_ & norms_;
+      const unsigned int dim = range_.rank();
+      // allocate size_vectors_
+      size_vectors_ = std::shared_ptr<vector_type>(new vector_type[dim],
+          std::default_delete<vector_type[]>());
+      for(unsigned d=0; d!=dim; ++d)
+        ar & size_vectors_.get()[d];
+    }
+
+    template <typename Archive,
+        typename std::enable_if<madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+    void serialize(const Archive& ar) const {
+      ar & range_ & ordinals_ & norms_;
+      const unsigned int dim = range_.rank();
+      for(unsigned d=0; d!=dim; ++d)
+        ar & size_vectors_.get()[d];
+    }
+
+  private:
+    template <typename Factor>
+    static value_type to_abs_factor(const Factor factor) {
+      using std::abs;
+      const auto cast_abs_factor = static_cast<value_type>(abs(factor));
+      TA_ASSERT(std::isfinite(cast_abs_factor));
+      return cast_abs_factor;
+    }
+
+  }; // class CompressedSparseShape
+
+  /// Add the shape to an output stream
+
+  /// \tparam T the numeric type supporting the type of \c shape
+  /// \param os The output stream
+  /// \param shape the CompressedSparseShape<T> object
+  /// \return A reference to the output stream
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os,
+      const CompressedSparseShape<T>& shape)
+  {
+    os << "CompressedSparseShape<" << typeid(T).name() << ">:" << std::endl
+       << shape.data() << std::endl;
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_COMPRESSED_SPARSE_SHAPE_H__INCLUDED
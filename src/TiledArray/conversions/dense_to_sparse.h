@@ -3,6 +3,7 @@
 #define TILEDARRAY_DENSETOSPARSE_H__INCLUDED
 
 #include "../dist_array.h"
+#include "../policies/sparse_policy.h"
 
 namespace TiledArray {
 
@@ -10,34 +11,43 @@ namespace TiledArray {
 
   /// If the input array is dense then create a copy by checking the norms of the
   /// tiles in the dense array and then cloning the significant tiles into the
-  /// sparse array.
-  template <typename Tile>
-  DistArray<Tile, SparsePolicy>
+  /// sparse array. The sparse array has the tile symmetry of the dense array.
+  /// \tparam Policy The policy of the sparse array, e.g. \c SparsePolicy or
+  /// \c CompressedSparsePolicy
+  template <typename Policy = SparsePolicy, typename Tile,
+      typename = typename std::enable_if<is_sparse_policy<Policy>::value>::type>
+  DistArray<Tile, Policy>
   to_sparse(DistArray<Tile, DensePolicy> const &dense_array) {
-      typedef DistArray<Tile, SparsePolicy> ArrayType;  // return type
+      typedef DistArray<Tile, Policy> ArrayType;  // return type
 
       // Constructing a tensor to hold the norm of each tile in the Dense Array
       TiledArray::Tensor<float> tile_norms(dense_array.trange().tiles_range(), 0.0);
 
-      const auto end = dense_array.end();
-      const auto begin = dense_array.begin();
-      for (auto it = begin; it != end; ++it) {
-          // write the norm of each local tile to the tensor
-          tile_norms[it.ordinal()] = it->get().norm();
+      // write the norm of each local tile to the tensor; the local tiles are
+      // taken from the process map, since the local iterator skips the tiles
+      // that are not stored by an array with a tile symmetry
+      for (const auto ord : *dense_array.pmap()) {
+          tile_norms[ord] = dense_array.find(ord).get().norm();
       }
 
       // Construct a sparse shape the constructor will handle communicating the
       // norms of the local tiles to the other nodes
-      TiledArray::SparseShape<float> shape(dense_array.world(), tile_norms,
+      typename ArrayType::shape_type shape(dense_array.world(), tile_norms,
                                            dense_array.trange());
 
+      // Keep the process map of the dense array, so the local tiles are set
+      // without communication
       ArrayType sparse_array(dense_array.world(), dense_array.trange(),
-                             shape);
+                             shape, dense_array.pmap());
+      if (dense_array.symmetry())
+          sparse_array.set_symmetry(*dense_array.symmetry());
 
       // Loop over the local dense tiles and if that tile is in the
       // sparse_array set the sparse array tile with a clone so as not to hold
-      // a pointer to the original tile.
-      for (auto it = begin; it != end; ++it) {
+      // a pointer to the original tile. With a tile symmetry, only the
+      // canonical tiles are stored.
+      const auto end = dense_array.end();
+      for (auto it = dense_array.begin(); it != end; ++it) {
           const auto ord = it.ordinal();
           if (!sparse_array.is_zero(ord)) {
               sparse_array.set(ord, it->get().clone());
@@ -48,9 +58,10 @@ namespace TiledArray {
   }
 
   /// If the array is already sparse return a copy of the array.
-  template <typename Tile>
-  DistArray<Tile, SparsePolicy>
-  to_sparse(DistArray<Tile, SparsePolicy> const &sparse_array) {
+  template <typename Tile, typename Policy,
+      typename = typename std::enable_if<is_sparse_policy<Policy>::value>::type>
+  DistArray<Tile, Policy>
+  to_sparse(DistArray<Tile, Policy> const &sparse_array) {
       return sparse_array;
   }
 
@@ -26,7 +26,10 @@
 #ifndef TILEDARRAY_CONVERSIONS_FOREACH_H__INCLUDED
 #define TILEDARRAY_CONVERSIONS_FOREACH_H__INCLUDED
 
+#include <TiledArray/parallel_io.h>
+#include <TiledArray/shape.h>
 #include <TiledArray/type_traits.h>
+#include <deque>
 
 /// Forward declarations
 namespace Eigen {
@@ -114,6 +117,19 @@ namespace TiledArray {
             [](const bool val) -> bool {return val;});
       }
 
+      /// The number of tiles that foreach reads ahead of its tasks
+
+      /// Tiles of arrays that are stored out of core are read back when they
+      /// are requested, so their read-ahead is bounded by \c io_window() to
+      /// keep them within the memory budget of the arrays.
+      /// \return The read-ahead window, or 0 for no bound
+      template <typename... Arrays>
+      inline std::size_t foreach_window(const Arrays&... arrays) {
+        const std::initializer_list<bool> out_of_core = {arrays.is_out_of_core()...};
+        return (std::any_of(out_of_core.begin(), out_of_core.end(),
+            [](const bool val) -> bool {return val;}) ? io_window() : 0ul);
+      }
+
       template <typename I, typename A>
       Future<typename A::value_type> get_sparse_tile(const I& index, const A& array) {
         return (!array.is_zero(index)? array.find(index)
@@ -154,6 +170,8 @@ namespace TiledArray {
       };
 
       // Iterate over local tiles of arg
+      const std::size_t window = foreach_window(arg, args...);
+      std::deque<Future<typename result_array_type::value_type> > pending;
       for (auto index: *(arg.pmap())) {
         // Spawn a task to evaluate the tile
         Future<typename result_array_type::value_type> tile =
@@ -161,6 +179,15 @@ namespace TiledArray {
 
         // Store result tile
         result.set(index, tile);
+
+        // Wait for the oldest task before reading more out-of-core tiles
+        if(window) {
+          pending.push_back(tile);
+          if(pending.size() >= window) {
+            pending.front().get();
+            pending.pop_front();
+          }
+        }
       }
 
       return result;
@@ -169,16 +196,17 @@ namespace TiledArray {
     /// base implementation of sparse TiledArray::foreach
 
     /// \note can't autodeduce \c ResultTile from \c void \c Op(ResultTile,ArgTile)
-    template <bool inplace = false, typename Op,
+    /// \tparam Policy The sparse policy of the arrays
+    template <typename Policy, bool inplace = false, typename Op,
         typename ResultTile, typename ArgTile, typename... ArgTiles>
-    inline DistArray<ResultTile, SparsePolicy> foreach (Op&& op, const ShapeReductionMethod shape_reduction,
-        const_if_t<not inplace, DistArray<ArgTile, SparsePolicy>>& arg,
-        const DistArray<ArgTiles, SparsePolicy>&... args) {
+    inline DistArray<ResultTile, Policy> foreach (Op&& op, const ShapeReductionMethod shape_reduction,
+        const_if_t<not inplace, DistArray<ArgTile, Policy>>& arg,
+        const DistArray<ArgTiles, Policy>&... args) {
 
       TA_USER_ASSERT(detail::compare_trange(arg, args...), "Tiled ranges of args must match");
 
-      typedef DistArray<ArgTile, SparsePolicy> arg_array_type;
-      typedef DistArray<ResultTile, SparsePolicy> result_array_type;
+      typedef DistArray<ArgTile, Policy> arg_array_type;
+      typedef DistArray<ResultTile, Policy> result_array_type;
 
       typedef typename arg_array_type::value_type arg_value_type;
       typedef typename result_array_type::value_type result_value_type;
@@ -210,6 +238,14 @@ namespace TiledArray {
 
       World& world = arg.world();
 
+      // Wait for the oldest task before reading more out-of-core tiles
+      const std::size_t window = foreach_window(arg, args...);
+      std::size_t done = 0ul;
+      auto bound_window = [&tiles,&done,window] () {
+        if(window && (tiles.size() - done >= window))
+          tiles[done++].second.get();
+      };
+
       switch (shape_reduction) {
       case ShapeReductionMethod::Intersect:
         // Get local tile index iterator
@@ -220,6 +256,7 @@ namespace TiledArray {
               args.find(index)...);
           ++task_count;
           tiles.emplace_back(index, std::move(result_tile));
+          bound_window();
         }
         break;
       case ShapeReductionMethod::Union:
@@ -231,6 +268,7 @@ namespace TiledArray {
               detail::get_sparse_tile(index, args)...);
           ++task_count;
           tiles.emplace_back(index, std::move(result_tile));
+          bound_window();
         }
         break;
       default:
@@ -374,23 +412,27 @@ namespace TiledArray {
   /// object.
   /// \tparam Op Tile operation
   /// \tparam Tile The tile type of the array
+  /// \tparam Policy The sparse policy of the array, e.g. \c SparsePolicy or
+  /// \c CompressedSparsePolicy
   /// \param op The tile function
   /// \param arg The argument array
-  template <typename ResultTile, typename ArgTile, typename Op,
-            typename = typename std::enable_if<!std::is_same<ResultTile,ArgTile>::value>::type>
-  inline DistArray<ResultTile, SparsePolicy>
-  foreach(const DistArray<ArgTile, SparsePolicy> arg, Op&& op) {
-    return detail::foreach<false, Op, ResultTile, ArgTile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
+  template <typename ResultTile, typename ArgTile, typename Op, typename Policy,
+            typename = typename std::enable_if<!std::is_same<ResultTile,ArgTile>::value
+                && is_sparse_policy<Policy>::value>::type>
+  inline DistArray<ResultTile, Policy>
+  foreach(const DistArray<ArgTile, Policy> arg, Op&& op) {
+    return detail::foreach<Policy, false, Op, ResultTile, ArgTile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
   }
 
   /// Apply a function to each tile of a sparse Array
 
   /// Specialization of foreach<ResultTile,ArgTile,Op> for
   /// the case \c ResultTile == \c ArgTile
-  template <typename Tile, typename Op>
-  inline DistArray<Tile, SparsePolicy>
-  foreach(const DistArray<Tile, SparsePolicy>& arg, Op&& op) {
-    return detail::foreach<false, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
+  template <typename Tile, typename Op, typename Policy,
+            typename = typename std::enable_if<is_sparse_policy<Policy>::value>::type>
+  inline DistArray<Tile, Policy>
+  foreach(const DistArray<Tile, Policy>& arg, Op&& op) {
+    return detail::foreach<Policy, false, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
   }
 
 
@@ -420,6 +462,7 @@ namespace TiledArray {
   /// object.
   /// \tparam Op Tile operation
   /// \tparam Tile The tile type of the array
+  /// \tparam Policy The sparse policy of the array
   /// \param op The mutating tile function
   /// \param arg The argument array to be modified
   /// \param fence A flag that indicates fencing behavior. If \c true this
@@ -433,10 +476,11 @@ namespace TiledArray {
   /// of a tile is held in a \c std::shared_ptr. If you need to ensure other
   /// copies of the data are not modified or this behavior causes problems in
   /// your application, use the \c TiledArray::foreach function instead.
-  template <typename Tile, typename Op,
-      typename = typename std::enable_if<! TiledArray::detail::is_array<typename std::decay<Op>::type>::value>::type>
+  template <typename Tile, typename Op, typename Policy,
+      typename = typename std::enable_if<! TiledArray::detail::is_array<typename std::decay<Op>::type>::value
+          && is_sparse_policy<Policy>::value>::type>
   inline void
-  foreach_inplace(DistArray<Tile, SparsePolicy>& arg, Op&& op, bool fence = true) {
+  foreach_inplace(DistArray<Tile, Policy>& arg, Op&& op, bool fence = true) {
 
     // The tile data is being modified in place, which means we may need to
     // fence to ensure no other threads are using the data.
@@ -444,7 +488,7 @@ namespace TiledArray {
       arg.world().gop.fence();
 
     // Set the arg with the new array
-    arg = detail::foreach<true, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
+    arg = detail::foreach<Policy, true, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
   }
 
   /// Apply a function to each tile of dense Arrays
@@ -485,31 +529,35 @@ namespace TiledArray {
   /// Apply a function to each tile of sparse Arrays
   /// The following function takes two input tiles
   template <typename ResultTile, typename LeftTile, typename RightTile, typename Op,
-            typename = typename std::enable_if<!std::is_same<ResultTile, LeftTile>::value>::type>
-  inline DistArray<ResultTile, SparsePolicy>
-  foreach(const DistArray<LeftTile, SparsePolicy>& left,
-      const DistArray<RightTile, SparsePolicy>& right, Op&& op,
+            typename Policy,
+            typename = typename std::enable_if<!std::is_same<ResultTile, LeftTile>::value
+                && is_sparse_policy<Policy>::value>::type>
+  inline DistArray<ResultTile, Policy>
+  foreach(const DistArray<LeftTile, Policy>& left,
+      const DistArray<RightTile, Policy>& right, Op&& op,
       const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect) {
-    return detail::foreach<false, Op, ResultTile, LeftTile, RightTile>(std::forward<Op>(op),
+    return detail::foreach<Policy, false, Op, ResultTile, LeftTile, RightTile>(std::forward<Op>(op),
         shape_reduction, left, right);
   }
 
   /// Specialization of foreach<ResultTile,ArgTile,Op> for
   /// the case \c ResultTile == \c ArgTile
-  template <typename LeftTile, typename RightTile, typename Op>
-  inline DistArray<LeftTile, SparsePolicy>
-  foreach(const DistArray<LeftTile, SparsePolicy>& left,
-      const DistArray<RightTile, SparsePolicy>& right, Op&& op,
+  template <typename LeftTile, typename RightTile, typename Op, typename Policy,
+            typename = typename std::enable_if<is_sparse_policy<Policy>::value>::type>
+  inline DistArray<LeftTile, Policy>
+  foreach(const DistArray<LeftTile, Policy>& left,
+      const DistArray<RightTile, Policy>& right, Op&& op,
       const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect) {
-    return detail::foreach<false, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
+    return detail::foreach<Policy, false, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
         shape_reduction, left, right);
   }
 
   /// This function takes two input tiles and put result into the left tile
-  template <typename LeftTile, typename RightTile, typename Op>
+  template <typename LeftTile, typename RightTile, typename Op, typename Policy,
+            typename = typename std::enable_if<is_sparse_policy<Policy>::value>::type>
   inline void
-  foreach_inplace(DistArray<LeftTile, SparsePolicy>& left,
-      const DistArray<RightTile, SparsePolicy>& right, Op&& op,
+  foreach_inplace(DistArray<LeftTile, Policy>& left,
+      const DistArray<RightTile, Policy>& right, Op&& op,
       const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect,
       bool fence = true) {
 
@@ -519,7 +567,7 @@ namespace TiledArray {
       left.world().gop.fence();
 
     // Set the arg with the new array
-    left = detail::foreach<true, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
+    left = detail::foreach<Policy, true, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
         shape_reduction, left, right);
   }
 
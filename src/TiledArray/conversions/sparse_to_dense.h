@@ -30,9 +30,10 @@
 
 namespace TiledArray {
 
-  template <typename Tile>
+  template <typename Tile, typename Policy,
+      typename = typename std::enable_if<is_sparse_policy<Policy>::value>::type>
   DistArray<Tile, DensePolicy>
-  to_dense(DistArray<Tile, SparsePolicy> const& sparse_array) {
+  to_dense(DistArray<Tile, Policy> const& sparse_array) {
       typedef DistArray<Tile, DensePolicy> ArrayType;
       ArrayType dense_array(sparse_array.world(), sparse_array.trange());
 
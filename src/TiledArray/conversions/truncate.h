@@ -46,10 +46,12 @@ namespace TiledArray {
   /// Truncate a sparse Array
 
   /// \tparam Tile The tile type of the array
+  /// \tparam Policy The sparse policy of the array
   /// \param[in,out] array The array object to be truncated
-  template <typename Tile>
-  inline void truncate(DistArray<Tile, SparsePolicy>& array) {
-    typedef typename DistArray<Tile, SparsePolicy>::value_type value_type;
+  template <typename Tile, typename Policy,
+      typename = typename std::enable_if<is_sparse_policy<Policy>::value>::type>
+  inline void truncate(DistArray<Tile, Policy>& array) {
+    typedef typename DistArray<Tile, Policy>::value_type value_type;
     array =
         foreach(array, [] (value_type& result_tile, const value_type& arg_tile) {
           typename detail::scalar_type<value_type>::type arg_tile_norm = norm(arg_tile);
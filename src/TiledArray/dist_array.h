@@ -21,11 +21,15 @@
 #define TILEDARRAY_ARRAY_H__INCLUDED
 
 #include <cstdlib>
+#include <deque>
 
 #include <madness/world/parallel_archive.h>
 
+#include <TiledArray/parallel_io.h>
 #include <TiledArray/replicator.h>
 #include <TiledArray/pmap/replicated_pmap.h>
+#include <TiledArray/sparse_shape.h>
+#include <TiledArray/tile_codec.h>
 //#include <TiledArray/tensor.h>
 #include <TiledArray/policies/dense_policy.h>
 #include <TiledArray/array_impl.h>
@@ -128,6 +132,41 @@ namespace TiledArray {
       }
     }
 
+    /// Default process map of a policy that uses the shape of the array
+
+    /// \param world The world where the array will live
+    /// \param trange The tiled range of the array
+    /// \param shape The shape of the array
+    /// \return The default process map of \c Policy for \c shape
+    template <typename P = Policy>
+    static auto default_pmap(World& world, const trange_type& trange,
+        const shape_type& shape, int) ->
+        decltype(P::default_pmap(world, trange, shape))
+    { return P::default_pmap(world, trange, shape); }
+
+    /// Default process map of a policy that only uses the number of tiles
+
+    /// \param world The world where the array will live
+    /// \param trange The tiled range of the array
+    /// \return The default process map of \c Policy
+    template <typename P = Policy>
+    static std::shared_ptr<pmap_interface>
+    default_pmap(World& world, const trange_type& trange, const shape_type&, long)
+    { return P::default_pmap(world, trange.tiles_range().volume()); }
+
+    /// Zero threshold of a shape type that has one
+
+    /// \return The threshold of \c S
+    template <typename S>
+    static auto shape_threshold(const S*) -> decltype(double(S::threshold()))
+    { return double(S::threshold()); }
+
+    /// Zero threshold of a shape type without one
+
+    /// \return The \c SparseShape<float> threshold
+    static double shape_threshold(const void*)
+    { return double(SparseShape<float>::threshold()); }
+
     /// Sparse array initialization
 
     /// \param world The world where the array will live.
@@ -140,9 +179,15 @@ namespace TiledArray {
     {
       // User level validation of input
 
+      // Validate the shape
+      TA_USER_ASSERT(! shape.empty(),
+          "Array::Array() -- The shape is not initialized.");
+      TA_USER_ASSERT(shape.validate(trange.tiles_range()),
+          "Array::Array() -- The range of the shape is not equal to the tiles range.");
+
       if(! pmap) {
-        // Construct a default process map
-        pmap = Policy::default_pmap(world, trange.tiles_range().volume());
+        // Construct a default process map, which may depend on the shape
+        pmap = default_pmap(world, trange, shape, 0);
       } else {
         // Validate the process map
         TA_USER_ASSERT(pmap->size() == trange.tiles_range().volume(),
@@ -153,12 +198,6 @@ namespace TiledArray {
             "Array::Array() -- The number of processes in the process map is not equal to that of the world object.");
       }
 
-      // Validate the shape
-      TA_USER_ASSERT(! shape.empty(),
-          "Array::Array() -- The shape is not initialized.");
-      TA_USER_ASSERT(shape.validate(trange.tiles_range()),
-          "Array::Array() -- The range of the shape is not equal to the tiles range.");
-
       return std::shared_ptr<impl_type>(new impl_type(world, trange, shape, pmap), lazy_deleter);
     }
 
@@ -494,7 +533,7 @@ namespace TiledArray {
       const auto end = pimpl_->pmap()->end();
       for(; it != end; ++it) {
         const auto index = *it;
-        if(! pimpl_->is_zero(index)) {
+        if(! pimpl_->is_zero(index) && pimpl_->is_canonical(index)) {
           if (skip_set) {
             auto fut = find(index);
             if (fut.probe())
@@ -748,6 +787,7 @@ namespace TiledArray {
         // Construct a replicated array
         auto pmap = std::make_shared<detail::ReplicatedPmap>(world(), size());
         DistArray_ result = DistArray_(world(), trange(), shape(), pmap);
+        result.pimpl_->set_symmetry(pimpl_->symmetry());
 
         // Create the replicator object that will do an all-to-all broadcast of
         // the local tile data.
@@ -768,12 +808,210 @@ namespace TiledArray {
     /// \note This function is a no-op for dense arrays.
     void truncate() { TiledArray::truncate(*this); }
 
+    /// Enable caching of remote tiles
+
+    /// Remote tiles returned by \c find() are kept in a local,
+    /// least-recently-used cache so that repeated requests for the same tile
+    /// send a single message. Concurrent requests for a tile share one
+    /// in-flight future. The cache is discarded at every global fence, so
+    /// tiles that their owner modified in place are fetched again.
+    /// \param max_bytes The maximum number of bytes held by the cache on
+    /// this process; zero disables the cache
+    /// \note Cached tiles are shared by all requesters and must not be
+    /// modified in place.
+    void enable_remote_cache(const std::size_t max_bytes) {
+      check_pimpl();
+      pimpl_->storage().enable_remote_cache(max_bytes);
+    }
+
+    /// Disable caching of remote tiles
+    void disable_remote_cache() {
+      check_pimpl();
+      pimpl_->storage().disable_remote_cache();
+    }
+
+    /// Discard all cached remote tiles on this process
+    void clear_remote_cache() {
+      check_pimpl();
+      pimpl_->storage().clear_remote_cache();
+    }
+
+    /// Remote tile cache hit counter
+
+    /// \return The number of remote tile requests served from the cache
+    std::size_t remote_cache_hits() const {
+      check_pimpl();
+      return pimpl_->storage().remote_cache_hits();
+    }
+
+    /// Remote tile cache miss counter
+
+    /// \return The number of remote tile requests that were sent to the
+    /// owner while the cache was enabled
+    std::size_t remote_cache_misses() const {
+      check_pimpl();
+      return pimpl_->storage().remote_cache_misses();
+    }
+
+    /// Remote tile cache size
+
+    /// \return The number of bytes held by cached remote tiles
+    std::size_t remote_cache_bytes() const {
+      check_pimpl();
+      return pimpl_->storage().remote_cache_bytes();
+    }
+
+    /// Store the local tiles out of core
+
+    /// Local tiles are written to a node-local file in \c directory once they
+    /// are set, and at most \c max_bytes bytes of them are kept in memory.
+    /// The least recently used tiles are evicted from memory, and read back
+    /// from the file when they are requested with \c find() , or when a
+    /// prefetch hint is given with \c prefetch() . Contractions give prefetch
+    /// hints for the tiles of their next step, and \c foreach reads at most
+    /// \c TA_IO_WINDOW tiles (see \c detail::io_window() ) ahead of its tasks.
+    /// \param directory The directory of the node-local file
+    /// \param max_bytes The byte budget of the local tiles in memory on this
+    /// process
+    /// \note This function must be called before any tile is set.
+    /// \note Tiles may be read back from the file, so they must not be
+    /// modified in place.
+    void enable_out_of_core(const std::string& directory,
+        const std::size_t max_bytes)
+    {
+      check_pimpl();
+      pimpl_->storage().enable_out_of_core(directory, max_bytes);
+    }
+
+    /// Out-of-core storage query
+
+    /// \return \c true if the local tiles are stored out of core
+    bool is_out_of_core() const {
+      check_pimpl();
+      return pimpl_->storage().is_out_of_core();
+    }
+
+    /// Prefetch hint
+
+    /// Start reading tile \c i into memory, if it is local and stored out of
+    /// core, so it is available when it is requested. This function has no
+    /// effect on other tiles.
+    /// \tparam Index The index type
+    /// \param i The tile index
+    template <typename Index>
+    void prefetch(const Index& i) const {
+      check_index(i);
+      if(is_zero(i))
+        return;
+      const auto& tiles_range = pimpl_->trange().tiles_range();
+      if(pimpl_->is_canonical(i))
+        pimpl_->storage().prefetch(tiles_range.ordinal(i));
+      else
+        pimpl_->storage().prefetch(tiles_range.ordinal(pimpl_->symmetry()->
+            canonical(tiles_range.idx(tiles_range.ordinal(i))).index));
+    }
+
+    /// Out-of-core storage statistics
+
+    /// \return The tile request hits and misses, and the bytes read and
+    /// written, by the out-of-core storage on this process
+    OutOfCoreStatistics out_of_core_statistics() const {
+      check_pimpl();
+      return pimpl_->storage().out_of_core_statistics();
+    }
+
+    /// Select the compression of tiles sent to other processes
+
+    /// Tiles are compressed when they are sent by remote \c find() and
+    /// \c set() calls, and by the broadcasts of contractions with this array
+    /// as an argument. \c TileCodec::lossless shuffles the bytes of the
+    /// elements and compresses them with a fast LZ coder.
+    /// \c TileCodec::lossy first truncates the precision of floating point
+    /// elements, and sets elements smaller than \c tolerance to zero, so
+    /// each element is sent with an absolute error smaller than
+    /// \c tolerance . The compression ratio and time are reported by
+    /// \c codec_statistics() .
+    /// \param codec The codec
+    /// \param tolerance The absolute error bound of \c TileCodec::lossy ;
+    /// when it is zero, the threshold of \c shape_type is used, or the
+    /// \c SparseShape<float> threshold when the shape has no threshold
+    /// \note This does not communicate, but it must be called on all
+    /// processes with the same arguments before any tile is sent. It has no
+    /// effect on tiles that are not \c Tensor objects with arithmetic
+    /// elements.
+    void set_codec(const TileCodec codec, const double tolerance = 0.0) {
+      check_pimpl();
+      CodecSettings settings;
+      settings.codec = codec;
+      settings.tolerance = (tolerance > 0.0 ? tolerance :
+          shape_threshold(static_cast<const shape_type*>(nullptr)));
+      pimpl_->storage().set_codec(settings);
+    }
+
+    /// Tile compression settings accessor
+
+    /// \return The compression of tiles sent to other processes
+    const CodecSettings& codec() const {
+      check_pimpl();
+      return pimpl_->storage().codec();
+    }
+
+    /// Set the permutational symmetry of the tiles
+
+    /// Only the canonical tile of each orbit of \c symmetry is stored and
+    /// communicated. \c find() returns the other tiles by permuting, and
+    /// changing the sign of, the canonical tile, and \c set() ignores them.
+    /// When a contraction is assigned to an array with a tile symmetry, the
+    /// result has the same symmetry, and only its canonical tiles are
+    /// computed.
+    /// \param symmetry The tile symmetry
+    /// \throw TiledArray::Exception When \c symmetry permutes dimensions
+    /// with different tilings
+    /// \note This is a collective operation, which must be called before any
+    /// tile is set. The shape must have the symmetry, and the elements of the
+    /// canonical tiles on the diagonal of the group must have the symmetry.
+    void set_symmetry(const symmetry::TileSymmetry& symmetry) {
+      check_pimpl();
+      if(! symmetry.is_compatible(trange()))
+        TA_EXCEPTION("The tile symmetry is not compatible with the tiled range.");
+      pimpl_->set_symmetry(
+          std::make_shared<const symmetry::TileSymmetry>(symmetry));
+    }
+
+    /// Tile symmetry accessor
+
+    /// \return A pointer to the tile symmetry, which is null when the tiles
+    /// have no symmetry
+    const std::shared_ptr<const symmetry::TileSymmetry>& symmetry() const {
+      check_pimpl();
+      return pimpl_->symmetry();
+    }
+
+    /// Check for canonical tiles
+
+    /// \tparam Index The index type
+    /// \param i The tile index or ordinal
+    /// \return \c true if tile \c i is stored, i.e. the array has no tile
+    /// symmetry or \c i is the canonical tile of its orbit
+    template <typename Index>
+    bool is_canonical(const Index& i) const {
+      check_index(i);
+      return pimpl_->is_canonical(i);
+    }
+
     /// Check if the array is initialized
 
     /// \return \c false if the array has been default initialized, otherwise
     /// \c true.
     bool is_initialized() const { return static_cast<bool>(pimpl_); }
 
+    /// Check if the array shares its implementation
+
+    /// \return \c true if no other array object, e.g. a copy of this array
+    /// or an expression argument, shares the implementation and tiles of this
+    /// array, otherwise \c false
+    bool is_unique() const { return pimpl_.use_count() == 1l; }
+
     /// serialize local contents of a DistArray to an Archive object
 
     /// @note use Parallel{Input,Output}Archive for parallel serialization
@@ -784,11 +1022,15 @@ namespace TiledArray {
       // serialize array type, world size, rank, and pmap type to be able
       // to ensure same data type and same data distribution expected
       ar& typeid(*this).hash_code()& world().size() & world().rank() & trange() &
-          shape() & typeid(pmap().get()).hash_code();
-      int64_t count = 0;
-      for (auto it = begin(); it != end(); ++it) ++count;
-      ar& count;
-      for (auto it = begin(); it != end(); ++it) ar & it->get();
+          shape() & typeid(*pmap()).hash_code();
+      // write all local, non-zero tiles in the order of the local iterator
+      // of the deserialized array, which has no tile symmetry, so the tiles
+      // that are not stored by an array with a tile symmetry are included
+      std::vector<size_type> ords;
+      for (const auto ord : *pmap())
+        if (!is_zero(ord)) ords.push_back(ord);
+      ar& int64_t(ords.size());
+      for (const auto ord : ords) ar & find(ord).get();
     }
 
     /// deserialize local contents of a DistArray from an Archive object
@@ -815,14 +1057,12 @@ namespace TiledArray {
       shape_type shape;
       ar& trange& shape;
 
-      // use default pmap, ensure it's the same pmap used to serialize
-      auto volume = trange.tiles_range().volume();
-      auto pmap =
-          detail::policy_t<DistArray_>::default_pmap(
-              world, volume);
+      // use default pmap, which may depend on the shape, and ensure it's the
+      // same pmap type used to serialize
+      auto pmap = default_pmap(world, trange, shape, 0);
       size_t pmap_hash_code = 0;
       ar& pmap_hash_code;
-      if (pmap_hash_code != typeid(pmap.get()).hash_code())
+      if (pmap_hash_code != typeid(*pmap).hash_code())
         TA_EXCEPTION("DistArray::serialize: source DistArray pmap != this DistArray pmap");
       pimpl_.reset(
           new impl_type(world, std::move(trange), std::move(shape), pmap));
@@ -848,16 +1088,23 @@ namespace TiledArray {
     ///       MADWorld archives.
     /// @note This is a collective operation that fences before and after
     ///       completion, if @c ar.dofence() is true
+    /// @note Each I/O node reads the tiles of its clients from its own file,
+    ///       so using more I/O nodes (see \c ParallelInputArchive )
+    ///       increases the aggregate bandwidth. Tiles are sent to their
+    ///       owners asynchronously while the next tile is read.
+    /// @return The I/O statistics of this process
     template <typename Archive>
-    void load(World& world, Archive& ar) {
+    IOStatistics load(World& world, Archive& ar) {
 
       auto me = world.rank();
       const Tag tag = world.mpi.unique_tag();  // for broadcasting metadata
+      IOStatistics stats;
 
       if (ar.dofence()) world.gop.fence();
 
       if (ar.is_io_node()) {  // on each io node ...
 
+        const double start = madness::wall_time();
         auto& localar = ar.local_archive();
 
         // make sure source data matches the expected type
@@ -889,9 +1136,9 @@ namespace TiledArray {
           }
         }
 
-        // use default pmap
+        // use default pmap, which may depend on the shape
         auto volume = trange.tiles_range().volume();
-        auto pmap = detail::policy_t<DistArray_>::default_pmap(world, volume);
+        auto pmap = default_pmap(world, trange, shape, 0);
         pimpl_.reset(
             new impl_type(world, std::move(trange), std::move(shape), pmap));
 
@@ -901,8 +1148,11 @@ namespace TiledArray {
           if (!is_zero(ord)) {
             auto owner_rank = pmap->owner(ord);
             if (ar.io_node(owner_rank) == me) {
+              int64_t tile_bytes = 0;
               Tile tile;
-              localar& tile;
+              localar& tile_bytes& tile;
+              stats.bytes += tile_bytes;
+              ++stats.tiles;
               this->set(ord, std::move(tile));
               --count;
             }
@@ -911,6 +1161,7 @@ namespace TiledArray {
         if (count != 0)
           TA_EXCEPTION(
               "DistArray::load: # of tiles in archive != # of tiles expected");
+        stats.seconds = madness::wall_time() - start;
       }
       else {  // non-I/O node still needs to initialize metadata
 
@@ -924,60 +1175,83 @@ namespace TiledArray {
         madness::archive::MPIInputArchive source(world, p);
         source & trange & shape;
 
-        // use default pmap
-        auto volume = trange.tiles_range().volume();
-        auto pmap = detail::policy_t<DistArray_>::default_pmap(world, volume);
+        // use default pmap, which may depend on the shape
+        auto pmap = default_pmap(world, trange, shape, 0);
         pimpl_.reset(
             new impl_type(world, std::move(trange), std::move(shape), pmap));
       }
 
       if (ar.dofence()) world.gop.fence();
+      return stats;
     }
 
     /// Stores this array to an Archive object
 
+    /// Each I/O node writes the tiles of its clients to its own file, so
+    /// using more I/O nodes (see \c ParallelOutputArchive ) increases the
+    /// aggregate bandwidth. The tiles are written in order, but an I/O node
+    /// requests and serializes up to \c TA_IO_WINDOW tiles (see
+    /// \c detail::io_window() ) ahead of the tile it is writing, so the
+    /// transfer of remote tiles and their serialization overlap with the
+    /// writes. Each tile is preceded by its size in bytes, so \c load()
+    /// reports the I/O volume without serializing the tiles again.
     /// @tparam Archive a parallel MADWorld Archive type
     /// @param ar an Archive object that will contain this object's data
+    /// @return The I/O statistics of this process
     ///
     /// @note The & operator for serializing will only work with parallel
     ///       MADWorld archives.
     /// @note this is a collective operation that fences before and after
     ///       completion if @c ar.dofence() is true
     template <typename Archive>
-    void store(Archive& ar) const {
+    IOStatistics store(Archive& ar) const {
 
       auto me = world().rank();
+      IOStatistics stats;
 
       if (ar.dofence()) world().gop.fence();
 
       if (ar.is_io_node()) {  // on each io node ...
+        const double start = madness::wall_time();
         auto& localar = ar.local_archive();
         // ... store metadata first ...
         localar& typeid(*this).hash_code() & ar.num_io_clients()
                & trange() & shape();
-        // ... then loop over tiles and dump the data from ranks
-        // assigned to this I/O node in order ...
+        // ... then dump the data from ranks assigned to this I/O node in
+        // order ...
         // for sanity check dump tile count assigned to this I/O node
         const auto volume = trange().tiles_range().volume();
-        int64_t count = 0;
+        std::vector<size_type> ords;
         for (size_t ord=0; ord!=volume; ++ord) {
           if (!is_zero(ord)) {
             const auto owner_rank = pmap()->owner(ord);
-            if (ar.io_node(owner_rank) == me) {
-              ++count;
-            }
-          }
-        }
-        localar& count;
-        for (size_t ord=0; ord!=volume; ++ord) {
-          if (!is_zero(ord)) {
-            auto owner_rank = pmap()->owner(ord);
             if (ar.io_node(owner_rank) == me)
-              localar & find(ord).get();
+              ords.push_back(ord);
           }
         }
+        localar& int64_t(ords.size());
+
+        // ... keeping a window of tiles in flight that are fetched and
+        // serialized by tasks while the oldest one is written
+        const std::size_t window = detail::io_window();
+        std::deque<Future<std::vector<unsigned char> > > pending;
+        auto next = ords.cbegin();
+        while (next != ords.cend() || !pending.empty()) {
+          for (; next != ords.cend() && pending.size() < window; ++next)
+            pending.push_back(world().taskq.add(
+                & detail::serialize_to_buffer<value_type>, find(*next)));
+
+          const std::vector<unsigned char>& buffer = pending.front().get();
+          localar& int64_t(buffer.size());
+          localar.store(buffer.data(), buffer.size());
+          stats.bytes += buffer.size();
+          ++stats.tiles;
+          pending.pop_front();
+        }
+        stats.seconds = madness::wall_time() - start;
       }  // am I an I/O node?
       if (ar.dofence()) world().gop.fence();
+      return stats;
     }
 
    private:
@@ -1090,16 +1364,33 @@ static inline void store(const ParallelOutputArchive& ar, const TiledArray::Dist
 };
 }
 
+/// Store an array to a parallel archive
+
+/// \param x The array
+/// \param name The archive name
+/// \param nio The number of I/O nodes, each of which writes one file
+/// \return The I/O statistics of this process
 template <class Tile, class Policy>
-void save(const TiledArray::DistArray<Tile,Policy>& x, const std::string name) {
-  archive::ParallelOutputArchive ar2(x.world(), name.c_str(), 1);
-  ar2 & x;
+TiledArray::IOStatistics save(const TiledArray::DistArray<Tile,Policy>& x,
+    const std::string name, const int nio = 1)
+{
+  archive::ParallelOutputArchive ar2(x.world(), name.c_str(), nio);
+  return x.store(ar2);
 }
 
+/// Load an array from a parallel archive
+
+/// \param x The array
+/// \param name The archive name
+/// \param nio The number of I/O nodes, which must match the number that was
+/// used to save the array
+/// \return The I/O statistics of this process
 template <class Tile, class Policy>
-void load(TiledArray::DistArray<Tile,Policy>& x, const std::string name) {
-  archive::ParallelInputArchive ar2(x.world(), name.c_str(), 1);
-  ar2 & x;
+TiledArray::IOStatistics load(TiledArray::DistArray<Tile,Policy>& x,
+    const std::string name, const int nio = 1)
+{
+  archive::ParallelInputArchive ar2(x.world(), name.c_str(), nio);
+  return x.load(x.world(), ar2);
 }
 
 }
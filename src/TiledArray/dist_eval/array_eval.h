@@ -239,6 +239,24 @@ namespace TiledArray {
         return eval_tile(tile, consumable_tile);
       }
 
+      /// Prefetch hint
+
+      /// Forward the hint to the array, which reads the tile into memory if
+      /// it is stored out of core.
+      /// \param i The index of a tile that will be requested soon
+      virtual void prefetch_tile(size_type i) const {
+        size_type array_index = DistEvalImpl_::perm_index_to_source(i);
+        if(block_range_.rank())
+          array_index = block_range_.ordinal(array_index);
+        if(array_.is_local(array_index))
+          array_.prefetch(array_index);
+      }
+
+      /// Tile compression settings
+
+      /// \return The compression settings of the array
+      virtual CodecSettings codec() const { return array_.codec(); }
+
       /// Discard a tile that is not needed
 
       /// This function handles the cleanup for tiles that are not needed in
@@ -20,6 +20,7 @@
 #ifndef TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
 #define TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
 
+#include <deque>
 #include <vector>
 
 #include <TiledArray/config.h>
@@ -28,6 +29,7 @@
 #include <TiledArray/reduce_task.h>
 #include <TiledArray/type_traits.h>
 #include <TiledArray/shape.h>
+#include <TiledArray/symm/tile_symmetry.h>
 
 //#define TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL 1
 //#define TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE 1
@@ -36,8 +38,447 @@
 //#define TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE 1
 
 namespace TiledArray {
+
+  /// Runtime statistics of a SUMMA contraction
+
+  /// These are collected on each process; see \c TiledArray::summa_stats() .
+  struct SummaStats {
+    std::size_t initial_depth = 0ul; ///< The initial number of concurrent iterations
+    std::size_t depth = 0ul; ///< The current number of concurrent iterations
+    std::size_t min_depth = 0ul; ///< The smallest number of concurrent iterations
+    std::size_t max_depth = 0ul; ///< The largest number of concurrent iterations
+    std::size_t steps = 0ul; ///< The number of completed iterations
+    std::size_t throttled = 0ul; ///< The number of iterations delayed by the depth or memory limit
+    std::size_t peak_bytes = 0ul; ///< The peak size of the broadcast buffers of the contraction
+    std::size_t node_peak_bytes = 0ul; ///< The peak size of the broadcast buffers of all contractions
+    std::size_t memory_budget = 0ul; ///< The memory budget of this process (0 = unlimited)
+  }; // struct SummaStats
+
   namespace detail {
 
+    /// Process-wide memory budget for SUMMA broadcast buffers
+
+    /// All SUMMA contractions that run concurrently on a process share this
+    /// budget. The budget is initialized from the \c TA_SUMMA_MAX_MEMORY
+    /// environment variable (e.g. "2 GiB"; the minimum is 100 MiB); when the
+    /// variable is not set, the memory is not limited. It can be changed at
+    /// runtime with \c TiledArray::set_summa_memory_budget() .
+    class SummaMemory {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      size_type budget_; ///< The memory budget in bytes (0 = unlimited)
+      size_type live_ = 0ul; ///< The number of bytes in live broadcast buffers
+      size_type peak_ = 0ul; ///< The peak value of \c live_
+      SummaStats stats_; ///< Statistics of the last completed contraction
+      mutable madness::Spinlock mutex_; ///< Guards the data of this object
+
+      SummaMemory() : budget_(init_budget()) { }
+
+      /// Convert a memory size string into bytes
+
+      /// \param str A memory size, with an optional unit (KB, KiB, MB, MiB,
+      /// GB, or GiB); the default unit is bytes
+      /// \return The memory size in bytes
+      static double parse_memory(const char* str) {
+        std::stringstream ss(str);
+        double memory = 0.0;
+        if(ss >> memory) {
+          std::string unit;
+          if(ss >> unit) { // Failure == assume bytes
+            if(unit == "KB" || unit == "kB") {
+              memory *= 1000.0;
+            } else if(unit == "KiB" || unit == "kiB") {
+              memory *= 1024.0;
+            } else if(unit == "MB") {
+              memory *= 1000000.0;
+            } else if(unit == "MiB") {
+              memory *= 1048576.0;
+            } else if(unit == "GB") {
+              memory *= 1000000000.0;
+            } else if(unit == "GiB") {
+              memory *= 1073741824.0;
+            }
+          }
+        }
+        return memory;
+      }
+
+      /// Initialize the memory budget
+      static size_type init_budget() {
+        const char* max_memory = getenv("TA_SUMMA_MAX_MEMORY");
+        if(max_memory)
+          return std::max(parse_memory(max_memory), 104857600.0); // Minimum 100 MiB
+        return 0ul;
+      }
+
+    public:
+
+      /// The memory budget of this process
+
+      /// \return The singleton memory budget object
+      static SummaMemory& instance() {
+        static SummaMemory memory;
+        return memory;
+      }
+
+      /// Memory budget accessor
+
+      /// \return The maximum number of bytes in SUMMA broadcast buffers of
+      /// this process, or 0 if the memory is not limited
+      size_type budget() const { return budget_; }
+
+      /// Set the memory budget
+
+      /// \param budget The maximum number of bytes in SUMMA broadcast
+      /// buffers of this process, or 0 for no limit
+      void budget(const size_type budget) {
+        madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+        budget_ = budget;
+      }
+
+      /// Live buffer bytes accessor
+
+      /// \return The number of bytes in live broadcast buffers
+      size_type live() const { return live_; }
+
+      /// Peak buffer bytes accessor
+
+      /// \return The peak number of bytes in live broadcast buffers
+      size_type peak() const { return peak_; }
+
+      /// Check that additional buffers fit in the budget
+
+      /// \param bytes The size of the additional buffers
+      /// \return \c true if \c bytes more bytes fit in the budget
+      bool fits(const size_type bytes) const {
+        return (budget_ == 0ul) || (live_ + bytes <= budget_);
+      }
+
+      /// Record the allocation of broadcast buffers
+
+      /// \param bytes The size of the buffers
+      void acquire(const size_type bytes) {
+        madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+        live_ += bytes;
+        peak_ = std::max(peak_, live_);
+      }
+
+      /// Record the release of broadcast buffers
+
+      /// \param bytes The size of the buffers
+      void release(const size_type bytes) {
+        madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+        TA_ASSERT(live_ >= bytes);
+        live_ -= bytes;
+      }
+
+      /// Statistics accessor
+
+      /// \return The statistics of the last contraction that completed on
+      /// this process
+      SummaStats stats() const {
+        madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+        SummaStats stats = stats_;
+        stats.node_peak_bytes = peak_;
+        stats.memory_budget = budget_;
+        return stats;
+      }
+
+      /// Record the statistics of a completed contraction
+
+      /// \param stats The final statistics of the contraction
+      void stats(const SummaStats& stats) {
+        madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+        stats_ = stats;
+      }
+
+      /// Reset the statistics and the peak buffer bytes
+      void reset() {
+        madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+        stats_ = SummaStats();
+        peak_ = live_;
+      }
+
+    }; // class SummaMemory
+
+
+    /// Adaptive control of the number of concurrent SUMMA iterations
+
+    /// A SUMMA contraction starts with an initial depth, which is the number
+    /// of iterations that are evaluated concurrently. Before an iteration may
+    /// start, it must be admitted by the controller, which holds it back while
+    /// the number of iterations in flight is at the depth limit, or while the
+    /// broadcast buffers of another iteration would not fit in the memory
+    /// budget of \c SummaMemory . At least one iteration is always admitted, so
+    /// the contraction makes progress with any budget. The depth limit is
+    /// tuned at runtime: after every \c depth completed iterations, the rate
+    /// of completed tile contractions is compared with that of the previous
+    /// period, and the depth is moved one step in the direction that
+    /// increases the rate (i.e. raised while the pipeline is starved for
+    /// data) without exceeding the memory budget or the maximum depth.
+    class SummaController {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      size_type depth_ = 1ul; ///< The current depth limit
+      size_type max_depth_ = 1ul; ///< The upper bound of the depth limit
+      size_type pipeline_ = 1ul; ///< The number of step tasks scheduled ahead
+      size_type inflight_ = 0ul; ///< The number of admitted iterations that have not completed
+      size_type active_ = 0ul; ///< The number of started iterations that have not completed
+      size_type live_ = 0ul; ///< The bytes in broadcast buffers of active iterations
+      size_type step_bytes_ = 0ul; ///< The expected bytes in the buffers of one iteration
+      std::deque<madness::CallbackInterface*> pending_; ///< Iterations waiting for admission
+      bool finished_ = false; ///< All iterations are scheduled
+      bool published_ = false; ///< The final statistics have been recorded
+
+      // Completion rate tracking
+      size_type period_steps_ = 0ul; ///< Iterations completed in this period
+      size_type period_pairs_ = 0ul; ///< Tile contractions completed in this period
+      double period_start_ = 0.0; ///< The start time of this period
+      double last_rate_ = 0.0; ///< The rate of the last period
+      int direction_ = 1; ///< The direction of the next depth change
+
+      SummaStats stats_; ///< Statistics of this contraction
+      mutable madness::Spinlock mutex_; ///< Guards the data of this object
+
+      /// Check if the iteration at the front of the queue may start
+
+      /// \return \c true if the next iteration may start
+      bool admissible() const {
+        if(finished_ || (inflight_ == 0ul))
+          return true;
+        return (inflight_ < depth_) &&
+            SummaMemory::instance().fits(step_bytes_ * (inflight_ - active_ + 1ul));
+      }
+
+      /// Collect the iterations that may start
+
+      /// \param[out] admitted The callbacks of the admitted iterations
+      void admit(std::vector<madness::CallbackInterface*>& admitted) {
+        while(! pending_.empty() && admissible()) {
+          admitted.push_back(pending_.front());
+          pending_.pop_front();
+          ++inflight_;
+        }
+      }
+
+      /// Queue an iteration for admission
+
+      /// \param next The callback of the iteration
+      /// \param[out] admitted The callbacks of the admitted iterations
+      void push(madness::CallbackInterface* const next,
+          std::vector<madness::CallbackInterface*>& admitted)
+      {
+        pending_.push_back(next);
+        admit(admitted);
+        if(! pending_.empty())
+          ++stats_.throttled; // next is delayed
+      }
+
+      /// Check if the final statistics should be recorded
+
+      /// The statistics are recorded in \c SummaMemory once, when all
+      /// iterations have been scheduled and completed, so concurrent
+      /// contractions never record partial statistics.
+      /// \return \c true if the contraction has just completed
+      bool publish() {
+        if(published_ || ! finished_ || (active_ != 0ul))
+          return false;
+        published_ = true;
+        stats_.depth = depth_;
+        return true;
+      }
+
+      /// Notify admitted iterations
+      static void notify(const std::vector<madness::CallbackInterface*>& admitted) {
+        for(madness::CallbackInterface* callback : admitted)
+          callback->notify();
+      }
+
+      /// Adjust the depth limit at the end of a rate measurement period
+      void tune() {
+        const double now = madness::wall_time();
+        const double rate = double(period_pairs_) / std::max(now - period_start_, 1.0e-9);
+
+        // Move the depth in the direction that improves the completion rate,
+        // and reverse the direction when the rate declines.
+        int step = 0;
+        if(last_rate_ == 0.0 || rate > last_rate_ * 1.05) {
+          step = direction_;
+        } else if(rate < last_rate_ * 0.95) {
+          direction_ = -direction_;
+          step = direction_;
+        }
+
+        // Reduce the depth when the buffers do not fit in the memory budget.
+        if(! SummaMemory::instance().fits(0ul))
+          step = -1;
+
+        if((step > 0) && (depth_ < max_depth_) &&
+            SummaMemory::instance().fits(step_bytes_ * (inflight_ - active_ + 1ul)))
+          ++depth_;
+        else if((step < 0) && (depth_ > 1ul))
+          --depth_;
+
+        stats_.min_depth = std::min(stats_.min_depth, depth_);
+        stats_.max_depth = std::max(stats_.max_depth, depth_);
+
+        last_rate_ = rate;
+        period_start_ = now;
+        period_steps_ = 0ul;
+        period_pairs_ = 0ul;
+      }
+
+    public:
+
+      SummaController() { }
+
+      SummaController(const SummaController&) = delete;
+      SummaController& operator=(const SummaController&) = delete;
+
+      /// Initialize the controller
+
+      /// \param depth The initial depth, which is the number of iterations
+      /// that are scheduled without admission
+      /// \param max_depth The upper bound of the depth
+      /// \param step_bytes The expected size of the broadcast buffers of one
+      /// iteration
+      void init(const size_type depth, const size_type max_depth,
+          const size_type step_bytes)
+      {
+        madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+        depth_ = std::max(depth, size_type(1));
+        max_depth_ = std::max(max_depth, depth_);
+        pipeline_ = depth_;
+        inflight_ = depth_;
+        step_bytes_ = step_bytes;
+        period_start_ = madness::wall_time();
+        stats_.initial_depth = stats_.depth = stats_.min_depth =
+            stats_.max_depth = depth_;
+      }
+
+      /// Start an iteration
+
+      /// \param bytes The size of the broadcast buffers of the iteration
+      /// \return \c true if an additional step task should be scheduled to
+      /// raise the number of iterations that can run concurrently
+      bool start(const size_type bytes) {
+        SummaMemory::instance().acquire(bytes);
+
+        madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+        ++active_;
+        live_ += bytes;
+        stats_.peak_bytes = std::max(stats_.peak_bytes, live_);
+        if(depth_ > pipeline_) {
+          ++pipeline_;
+          return true;
+        }
+        return false;
+      }
+
+      /// Complete an iteration
+
+      /// \param bytes The size of the broadcast buffers of the iteration
+      /// \param pairs The number of tile contractions in the iteration
+      /// \param next The callback of an iteration that waits for admission,
+      /// or \c nullptr
+      void complete(const size_type bytes, const size_type pairs,
+          madness::CallbackInterface* const next)
+      {
+        SummaMemory::instance().release(bytes);
+
+        std::vector<madness::CallbackInterface*> admitted;
+        SummaStats stats;
+        bool done = false;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+          TA_ASSERT(active_ > 0ul);
+          TA_ASSERT(inflight_ >= active_);
+          --active_;
+          --inflight_;
+          live_ -= bytes;
+
+          // Update the expected buffer size of an iteration with the mean
+          // size of completed iterations (the initial estimate counts as one)
+          step_bytes_ = (step_bytes_ * (stats_.steps + 1ul) + bytes) / (stats_.steps + 2ul);
+          ++stats_.steps;
+
+          ++period_steps_;
+          period_pairs_ += pairs;
+          if(! finished_ && (period_steps_ >= depth_))
+            tune();
+
+          if(next)
+            push(next, admitted);
+          else
+            admit(admitted);
+
+          stats_.depth = depth_;
+          done = publish();
+          stats = stats_;
+        }
+
+        if(done)
+          SummaMemory::instance().stats(stats);
+        notify(admitted);
+      }
+
+      /// Request admission of an iteration
+
+      /// \param next The callback of the iteration
+      void enqueue(madness::CallbackInterface* const next) {
+        std::vector<madness::CallbackInterface*> admitted;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+          push(next, admitted);
+        }
+        notify(admitted);
+      }
+
+      /// Admit all remaining iterations
+
+      /// This is called when the last iteration has been scheduled, so the
+      /// remaining step tasks can run to completion.
+      void finish() {
+        std::vector<madness::CallbackInterface*> admitted;
+        SummaStats stats;
+        bool done = false;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+          finished_ = true;
+          admit(admitted);
+          done = publish();
+          stats = stats_;
+        }
+
+        if(done)
+          SummaMemory::instance().stats(stats);
+        notify(admitted);
+      }
+
+      /// Depth accessor
+
+      /// \return The current number of concurrent iterations
+      size_type depth() const { return depth_; }
+
+      /// Statistics accessor
+
+      /// \return The statistics of this contraction
+      SummaStats stats() const {
+        madness::ScopedMutex<madness::Spinlock> locker(&mutex_);
+        SummaStats stats = stats_;
+        stats.depth = depth_;
+        stats.node_peak_bytes = SummaMemory::instance().peak();
+        stats.memory_budget = SummaMemory::instance().budget();
+        return stats;
+      }
+
+    }; // class SummaController
+
+
     /// \brief Distributed contraction evaluator implementation
 
     /// \tparam Left The left-hand argument evaluator type
@@ -48,7 +489,11 @@ namespace TiledArray {
     /// dimensional cyclic distribution, and that the row phase of the left-hand
     /// argument and the column phase of the right-hand argument are equal to
     /// the number of rows and columns, respectively, in the \c ProcGrid object
-    /// passed to the constructor.
+    /// passed to the constructor. If the process grid is layered, each layer
+    /// evaluates the contraction over its own slab of the inner dimension, and
+    /// the partial result tiles are summed on layer 0, which stores all result
+    /// tiles (i.e. a split-K contraction); the arguments must then be
+    /// distributed with the layered process maps given by \c ProcGrid .
     template <typename Left, typename Right, typename Op, typename Policy>
     class Summa :
         public DistEvalImpl<typename Op::result_type, Policy>,
@@ -70,7 +515,6 @@ namespace TiledArray {
       typedef Op op_type; ///< Tile evaluation operator type
 
     private:
-      static size_type max_memory_; ///< Maximum memory used per node
       static size_type max_depth_; ///< Maximum number of concurrent SUMMA iterations
 
       // Arguments and operation
@@ -85,9 +529,14 @@ namespace TiledArray {
       // Dimension information
       const size_type k_; ///< Number of tiles in the inner dimension
       const ProcGrid proc_grid_; ///< Process grid for this contraction
+      const size_type k_begin_; ///< First inner tile of this process's layer
+      const size_type k_end_; ///< End of the inner tiles of this process's layer
 
       // Contraction results
       ReducePairTask<op_type>* reduce_tasks_; ///< A pointer to the reduction tasks
+      std::shared_ptr<const symmetry::TileSymmetry> symmetry_; ///< The symmetry of the result tiles
+
+      SummaController controller_; ///< Controls the number of concurrent iterations
 
       // Constants used to iterate over columns and rows of left_ and right_, respectively.
       const size_type left_start_local_; ///< The starting point of left column iterator ranges (just add k for specific columns)
@@ -102,6 +551,14 @@ namespace TiledArray {
       typedef Future<typename left_type::eval_type> left_future; ///< Future to a left-hand argument tile
       typedef std::pair<size_type, right_future> row_datum; ///< Datum element type for a right-hand argument row
       typedef std::pair<size_type, left_future> col_datum; ///< Datum element type for a left-hand argument column
+      typedef typename std::decay<typename op_type::first_argument_type>::type
+          left_argument_type; ///< The left-hand tile type of the tile operation
+      typedef typename std::decay<typename op_type::second_argument_type>::type
+          right_argument_type; ///< The right-hand tile type of the tile operation
+      typedef std::pair<size_type, Future<left_argument_type> >
+          col_argument; ///< A left-hand argument tile of the tile operation
+      typedef std::pair<size_type, Future<right_argument_type> >
+          row_argument; ///< A right-hand argument tile of the tile operation
 
       static constexpr const bool trace_tasks =
 #ifdef TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
@@ -121,42 +578,10 @@ namespace TiledArray {
       // Static variable initialization ----------------------------------------
 
 
-      /// Initialize max_memory_ limit for SUMMA
-      static size_type init_max_memory() {
-        const char* max_memory = getenv("TA_SUMMA_MAX_MEMORY");
-        if(max_memory) {
-            // Convert the string into bytes
-            std::stringstream ss(max_memory);
-            double memory = 0.0;
-            if(ss >> memory) {
-                if(memory > 0.0) {
-                    std::string unit;
-                    if(ss >> unit) { // Failure == assume bytes
-                        if(unit == "KB" || unit == "kB") {
-                          memory *= 1000.0;
-                        } else if(unit == "KiB" || unit == "kiB") {
-                          memory *= 1024.0;
-                        } else if(unit == "MB") {
-                          memory *= 1000000.0;
-                        } else if(unit == "MiB") {
-                          memory *= 1048576.0;
-                        } else if(unit == "GB") {
-                          memory *= 1000000000.0;
-                        } else if(unit == "GiB") {
-                          memory *= 1073741824.0;
-                        }
-                    }
-                }
-            }
-
-            memory = std::max(memory, 104857600.0); // Minimum 100 MiB
-            return memory;
-        }
-
-        return 0ul;
-      }
-
+      /// Initialize max_depth_ limit for SUMMA
 
+      /// \return The maximum number of concurrent SUMMA iterations given by
+      /// the \c TA_SUMMA_MAX_DEPTH environment variable, or 0 if it is not set
       static size_type init_max_depth() {
         const char* max_depth = getenv("TA_SUMMA_MAX_DEPTH");
         if(max_depth)
@@ -534,6 +959,25 @@ namespace TiledArray {
         TA_ASSERT(vec.size() > 0ul);
       }
 
+      /// Give prefetch hints for the non-zero tiles of a vector of \c arg
+
+      /// \tparam Arg The argument type
+      /// \param[in] arg The owner of the input tiles
+      /// \param[in] index The index of the first tile of the vector
+      /// \param[in] end The end of the range of tiles of the vector
+      /// \param[in] stride The stride between tile indices of the vector
+      /// \return \c true if the vector is local, i.e. hints were given
+      template <typename Arg>
+      bool prefetch_vector(Arg& arg, size_type index, const size_type end,
+          const size_type stride) const
+      {
+        if(! arg.is_local(index)) return false;
+        for(; index < end; index += stride)
+          if(! arg.shape().is_zero(index))
+            arg.prefetch(index);
+        return true;
+      }
+
       /// Collect non-zero tiles from column \c k of \c left_
 
       /// \param[in] k The column to be retrieved
@@ -541,6 +985,15 @@ namespace TiledArray {
       void get_col(const size_type k, std::vector<col_datum>& col) const {
         col.reserve(proc_grid_.local_rows());
         get_vector(left_, left_start_local_ + k, left_end_, left_stride_local_, col);
+
+        // Give hints for the tiles of the next step in which this process
+        // owns a column, so out-of-core tiles are read while this step is
+        // computed. The owners of the columns cycle with the process columns.
+        const size_type last = std::min(k + 1ul + proc_grid_.proc_cols(), k_end_);
+        for(size_type next = k + 1ul; next < last; ++next)
+          if(prefetch_vector(left_, left_start_local_ + next, left_end_,
+              left_stride_local_))
+            break;
       }
 
       /// Collect non-zero tiles from row \c k of \c right_
@@ -556,6 +1009,84 @@ namespace TiledArray {
         begin += proc_grid_.rank_col();
 
         get_vector(right_, begin, end, right_stride_local_, row);
+
+        // Give hints for the tiles of the next step in which this process
+        // owns a row; the owners of the rows cycle with the process rows.
+        const size_type last = std::min(k + 1ul + proc_grid_.proc_rows(), k_end_);
+        for(size_type next = k + 1ul; next < last; ++next) {
+          const size_type offset = (next - k) * proc_grid_.cols();
+          if(prefetch_vector(right_, begin + offset, end + offset,
+              right_stride_local_))
+            break;
+        }
+      }
+
+      /// Broadcast a tile
+
+      /// \tparam T The tile type
+      /// \param[in] key The broadcast key
+      /// \param[in,out] tile The tile, which is set on processes other than
+      /// the root when the broadcast is complete
+      /// \param[in] group_root The root process of the broadcast
+      /// \param[in] group The process group where the tile will be broadcast
+      template <typename T>
+      void bcast_tile(const madness::DistributedID& key, Future<T>& tile,
+          const ProcessID group_root, const madness::Group& group,
+          const CodecSettings&, std::false_type) const
+      {
+        TensorImpl_::world().gop.bcast(key, tile, group_root, group);
+      }
+
+      /// Broadcast a compressed tile
+
+      /// The root compresses the tile with \c codec , and the other processes
+      /// decode it when it arrives.
+      /// \tparam T The tile type
+      /// \param[in] key The broadcast key
+      /// \param[in,out] tile The tile, which is replaced by the future of the
+      /// decoded tile on processes other than the root
+      /// \param[in] group_root The root process of the broadcast
+      /// \param[in] group The process group where the tile will be broadcast
+      /// \param[in] codec The compression settings
+      template <typename T>
+      void bcast_tile(const madness::DistributedID& key, Future<T>& tile,
+          const ProcessID group_root, const madness::Group& group,
+          const CodecSettings& codec, std::true_type) const
+      {
+        if(! codec.enabled()) {
+          bcast_tile(key, tile, group_root, group, codec, std::false_type());
+          return;
+        }
+
+        World& world = TensorImpl_::world();
+        Future<CompressedTile<T> > compressed;
+        if(group.rank() == group_root)
+          compressed = world.taskq.add([codec] (const T& value) {
+            return CompressedTile<T>(value, codec);
+          }, tile, madness::TaskAttributes::hipri());
+        world.gop.bcast(key, compressed, group_root, group);
+        if(group.rank() != group_root)
+          tile = world.taskq.add([] (const CompressedTile<T>& value) {
+            return value.decode();
+          }, compressed, madness::TaskAttributes::hipri());
+      }
+
+      /// Broadcast a tile, compressed if \c codec is enabled
+
+      /// \tparam T The tile type
+      /// \param[in] key The broadcast key
+      /// \param[in,out] tile The tile, which is set on processes other than
+      /// the root when the broadcast is complete
+      /// \param[in] group_root The root process of the broadcast
+      /// \param[in] group The process group where the tile will be broadcast
+      /// \param[in] codec The compression settings of the argument
+      template <typename T>
+      void bcast_tile(const madness::DistributedID& key, Future<T>& tile,
+          const ProcessID group_root, const madness::Group& group,
+          const CodecSettings& codec) const
+      {
+        bcast_tile(key, tile, group_root, group, codec,
+            std::integral_constant<bool, is_compressible_tile<T>::value>());
       }
 
       /// Broadcast tiles from \c arg
@@ -565,11 +1096,13 @@ namespace TiledArray {
       /// \param[in] group The process group where the tiles will be broadcast
       /// \param[in] group_root The root process of the broadcast
       /// \param[in] key_offset The broadcast key offset value
+      /// \param[in] codec The compression settings of the argument
       /// \param[out] vec The vector that will hold broadcast tiles
       template <typename Datum>
       void bcast(const size_type start, const size_type stride,
           const madness::Group& group, const ProcessID group_root,
-          const size_type key_offset, std::vector<Datum>& vec) const
+          const size_type key_offset, const CodecSettings& codec,
+          std::vector<Datum>& vec) const
       {
         TA_ASSERT(vec.size() != 0ul);
         TA_ASSERT(group.size() > 0);
@@ -592,7 +1125,7 @@ namespace TiledArray {
 
           // Broadcast the tile
           const madness::DistributedID key(DistEvalImpl_::id(), index + key_offset);
-          TensorImpl_::world().gop.bcast(key, it->second, group_root, group);
+          bcast_tile(key, it->second, group_root, group, codec);
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
           ss  << index << " ";
@@ -613,7 +1146,7 @@ namespace TiledArray {
       ProcessID get_row_group_root(const size_type k, const madness::Group& row_group) const {
         ProcessID group_root = k % proc_grid_.proc_cols();
         if(! right_.shape().is_dense() && row_group.size() < static_cast<ProcessID>(proc_grid_.proc_cols())) {
-          const ProcessID world_root = proc_grid_.rank_row() * proc_grid_.proc_cols() + group_root;
+          const ProcessID world_root = proc_grid_.map_col(group_root);
           group_root = row_group.rank(world_root);
         }
         return group_root;
@@ -622,7 +1155,7 @@ namespace TiledArray {
       ProcessID get_col_group_root(const size_type k, const madness::Group& col_group) const {
         ProcessID group_root = k % proc_grid_.proc_rows();
         if(! left_.shape().is_dense() && col_group.size() < static_cast<ProcessID>(proc_grid_.proc_rows())) {
-          const ProcessID world_root = group_root * proc_grid_.proc_cols() + proc_grid_.rank_col();
+          const ProcessID world_root = proc_grid_.map_row(group_root);
           group_root = col_group.rank(world_root);
         }
         return group_root;
@@ -637,7 +1170,8 @@ namespace TiledArray {
         if (!row_group.empty()) {
           // Broadcast column k of left_.
           ProcessID group_root = get_row_group_root(k, row_group);
-          bcast(left_start_local_ + k, left_stride_local_, row_group, group_root, 0ul, col);
+          bcast(left_start_local_ + k, left_stride_local_, row_group, group_root,
+              0ul, left_.codec(), col);
         }
       }
 
@@ -653,7 +1187,8 @@ namespace TiledArray {
 
           // Broadcast row k of right_.
           bcast(k * proc_grid_.cols() + proc_grid_.rank_col(),
-                right_stride_local_, col_group, group_root, left_.size(), row);
+                right_stride_local_, col_group, group_root, left_.size(),
+                right_.codec(), row);
         }
       }
 
@@ -691,7 +1226,7 @@ namespace TiledArray {
               // Broadcast the tile
               const madness::DistributedID key(DistEvalImpl_::id(), index);
               auto tile = get_tile(left_, index);
-              TensorImpl_::world().gop.bcast(key, tile, group_root, row_group);
+              bcast_tile(key, tile, group_root, row_group, left_.codec());
             } else {
               // Discard the tile
               left_.discard(index);
@@ -736,7 +1271,7 @@ namespace TiledArray {
               // Broadcast the tile
               const madness::DistributedID key(DistEvalImpl_::id(), index + left_.size());
               auto tile = get_tile(right_, index);
-              TensorImpl_::world().gop.bcast(key, tile, group_root, col_group);
+              bcast_tile(key, tile, group_root, col_group, right_.codec());
             } else {
               // Discard the tile
               right_.discard(index);
@@ -755,12 +1290,12 @@ namespace TiledArray {
       /// non-zero tiles in this processes column.
       /// \param k The first row to search
       /// \return The first row, greater than or equal to \c k with non-zero
-      /// tiles, or \c k_ if none is found.
+      /// tiles, or \c k_end_ if none is found.
       size_type iterate_row(size_type k) const {
         // Iterate over k's until a non-zero tile is found or the end of the
-        // matrix is reached.
+        // layer's slab is reached.
         size_type end = k * proc_grid_.cols();
-        for(; k < k_; ++k) {
+        for(; k < k_end_; ++k) {
           // Search for non-zero tiles in row k of right
           size_type i = end + proc_grid_.rank_col();
           end += proc_grid_.cols();
@@ -779,11 +1314,11 @@ namespace TiledArray {
       /// checks for non-zero tiles in this process's row.
       /// \param k The first column to test for non-zero tiles
       /// \return The first column, greater than or equal to \c k, that contains
-      /// a non-zero tile. If no non-zero tile is not found, return \c k_.
+      /// a non-zero tile. If no non-zero tile is not found, return \c k_end_.
       size_type iterate_col(size_type k) const {
         // Iterate over k's until a non-zero tile is found or the end of the
-        // matrix is reached.
-        for(; k < k_; ++k)
+        // layer's slab is reached.
+        for(; k < k_end_; ++k)
           // Search row k for non-zero tiles
           for(size_type i = left_start_local_ + k; i < left_end_; i += left_stride_local_)
             if(! left_.shape().is_zero(i))
@@ -849,14 +1384,31 @@ namespace TiledArray {
       }
 
 
+      /// Check for result tiles that are evaluated
+
+      /// When the result has a tile symmetry, only its canonical tiles are
+      /// evaluated, since the other tiles are not stored.
+      /// \param index The (unpermuted) index of the result tile
+      /// \return \c true if the tile at \c index is evaluated
+      bool is_canonical(const size_type index) const {
+        if(! symmetry_)
+          return true;
+        const auto& tiles_range = TensorImpl_::trange().tiles_range();
+        return symmetry_->is_canonical(
+            tiles_range.idx(DistEvalImpl_::perm_index_to_target(index)));
+      }
+
+
       // Initialization functions ----------------------------------------------
 
       /// Initialize reduce tasks and construct broadcast groups
       size_type initialize(const DenseShape&) {
-        // Construct static broadcast groups for dense arguments
-        const madness::DistributedID col_did(DistEvalImpl_::id(), 0ul);
+        // Construct static broadcast groups for dense arguments; each layer
+        // has its own groups.
+        const size_type layer = proc_grid_.rank_layer();
+        const madness::DistributedID col_did(DistEvalImpl_::id(), layer);
         col_group_ = proc_grid_.make_col_group(col_did);
-        const madness::DistributedID row_did(DistEvalImpl_::id(), k_);
+        const madness::DistributedID row_did(DistEvalImpl_::id(), k_ + layer);
         row_group_ = proc_grid_.make_row_group(row_did);
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
@@ -877,14 +1429,38 @@ namespace TiledArray {
         reduce_tasks_ = alloc.allocate(proc_grid_.local_size());
 
         // Iterate over all local tiles
-        const size_type n = proc_grid_.local_size();
-        for(size_type t = 0ul; t < n; ++t) {
-          // Initialize the reduction task
-          ReducePairTask<op_type>* MADNESS_RESTRICT const reduce_task = reduce_tasks_ + t;
-          new(reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+        if(! symmetry_) {
+          const size_type n = proc_grid_.local_size();
+          for(size_type t = 0ul; t < n; ++t) {
+            // Initialize the reduction task
+            ReducePairTask<op_type>* MADNESS_RESTRICT const reduce_task = reduce_tasks_ + t;
+            new(reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+          }
+
+          return proc_grid_.local_size();
+        }
+
+        // With a tile symmetry, construct empty tasks for non-canonical tiles
+        size_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
+        size_type row_end = row_start + proc_grid_.cols();
+        row_start += proc_grid_.rank_col();
+        const size_type col_stride = proc_grid_.proc_rows() * proc_grid_.cols();
+        const size_type row_stride = proc_grid_.proc_cols();
+        const size_type end = TensorImpl_::size();
+        size_type tile_count = 0ul;
+        ReducePairTask<op_type>* MADNESS_RESTRICT reduce_task = reduce_tasks_;
+        for(; row_start < end; row_start += col_stride, row_end += col_stride) {
+          for(size_type index = row_start; index < row_end; index += row_stride, ++reduce_task) {
+            if(is_canonical(index)) {
+              new(reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+              ++tile_count;
+            } else {
+              new(reduce_task) ReducePairTask<op_type>();
+            }
+          }
         }
 
-        return proc_grid_.local_size();
+        return tile_count;
       }
 
       /// Initialize reduce tasks
@@ -920,8 +1496,9 @@ namespace TiledArray {
 
             // Initialize the reduction task
 
-            // Skip zero tiles
-            if(! shape.is_zero(DistEvalImpl_::perm_index_to_target(index))) {
+            // Skip zero and non-canonical tiles
+            if(! shape.is_zero(DistEvalImpl_::perm_index_to_target(index))
+                && is_canonical(index)) {
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
               ss << index << " ";
@@ -961,6 +1538,80 @@ namespace TiledArray {
 
       // Finalize functions ----------------------------------------------------
 
+      /// Reduction operation that sums the partial results of each layer
+
+      /// Empty partial results, which are sent by layers that did not
+      /// contribute to a tile, are skipped.
+      class LayerReduce {
+      public:
+        typedef value_type result_type; ///< The reduction result type
+        typedef value_type argument_type; ///< The reduction argument type
+
+        /// Create an empty result object
+        result_type operator()() const { return result_type(); }
+
+        /// Post process the result (no operation, passthrough)
+        const result_type& operator()(const result_type& result) const {
+          return result;
+        }
+
+        /// Add a partial result to \c result
+        void operator()(result_type& result, const result_type& arg) const {
+          using TiledArray::empty;
+          using TiledArray::add_to;
+          if(empty(arg))
+            return;
+          if(empty(result))
+            result = arg;
+          else
+            add_to(result, arg);
+        }
+      }; // class LayerReduce
+
+      /// Set a result tile
+
+      /// With a single layer, the result of \c reduce_task is the result tile.
+      /// Otherwise, the partial result of this layer is sent to the
+      /// corresponding process of layer 0, where the partial results of all
+      /// layers are summed.
+      /// \param index The (unpermuted) index of the result tile
+      /// \param perm_index The permuted index of the result tile
+      /// \param reduce_task The reduce task for the result tile
+      void set_tile(const size_type index, const size_type perm_index,
+          ReducePairTask<op_type>* const reduce_task)
+      {
+        if(proc_grid_.layers() == 1u) {
+          DistEvalImpl_::set_tile(perm_index, reduce_task->submit());
+          return;
+        }
+
+        // The layer keys are offset past the keys of the argument broadcasts
+        // and of the result tiles (see DistEvalImpl::set_tile).
+        World& world = TensorImpl_::world();
+        const madness::DistributedID key(DistEvalImpl_::id(),
+            left_.size() + right_.size() + TensorImpl_::size() + index);
+
+        if(proc_grid_.rank_layer() > 0) {
+          // Send the partial result to layer 0; layers that have no
+          // contributions to this tile send an empty tile.
+          const ProcessID dest = proc_grid_.map_layer(0u);
+          if(reduce_task->count() > 0)
+            world.gop.send(dest, key, reduce_task->submit());
+          else
+            world.gop.send(dest, key, value_type());
+        } else {
+          // Sum the partial results of all layers
+          ReduceTask<LayerReduce> layer_sum(world);
+          if(reduce_task->count() > 0)
+            layer_sum.add(reduce_task->submit());
+          for(size_type layer = 1u; layer < proc_grid_.layers(); ++layer)
+            layer_sum.add(world.gop.template recv<value_type>(
+                proc_grid_.map_layer(layer), key));
+
+          DistEvalImpl_::set_tile(perm_index, layer_sum.submit());
+        }
+      }
+
       /// Set the result tiles, destroy reduce tasks, and destroy broadcast groups
       void finalize(const DenseShape&) {
         // Initialize iteration variables
@@ -978,10 +1629,10 @@ namespace TiledArray {
             row_start < end; row_start += col_stride, row_end += col_stride) {
           for(size_type index = row_start; index < row_end; index += row_stride, ++reduce_task) {
 
-
             // Set the result tile
-            DistEvalImpl_::set_tile(DistEvalImpl_::perm_index_to_target(index),
-                reduce_task->submit());
+            if(is_canonical(index))
+              set_tile(index, DistEvalImpl_::perm_index_to_target(index),
+                  reduce_task);
 
             // Destroy the reduce task
             reduce_task->~ReducePairTask<op_type>();
@@ -1019,15 +1670,15 @@ namespace TiledArray {
             // Compute the permuted index
             const size_type perm_index = DistEvalImpl_::perm_index_to_target(index);
 
-            // Skip zero tiles
-            if(! shape.is_zero(perm_index)) {
+            // Skip zero and non-canonical tiles
+            if(! shape.is_zero(perm_index) && is_canonical(index)) {
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
               ss << index << " ";
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
 
               // Set the result tile
-              DistEvalImpl_::set_tile(perm_index, reduce_task->submit());
+              set_tile(index, perm_index, reduce_task);
             }
 
             // Destroy the reduce task
@@ -1086,10 +1737,14 @@ namespace TiledArray {
       /// \param col A column of tiles from the left-hand argument
       /// \param row A row of tiles from the right-hand argument
       /// \param task The task that depends on tile contraction tasks
-      void contract(const DenseShape&, const size_type,
-          const std::vector<col_datum>& col, const std::vector<row_datum>& row,
+      /// \return The number of scheduled tile contractions
+      size_type contract(const DenseShape&, const size_type,
+          const std::vector<col_argument>& col,
+          const std::vector<row_argument>& row,
           madness::TaskInterface* const task)
       {
+        size_type count = 0ul;
+
         // Iterate over the row
         for(size_type i = 0ul; i < col.size(); ++i) {
           // Compute the local, result-tile offset
@@ -1099,14 +1754,19 @@ namespace TiledArray {
           for(size_type j = 0ul; j < row.size(); ++j) {
             const size_type reduce_task_index = reduce_task_offset + row[j].first;
 
+            // Skip non-canonical tiles
+            if(symmetry_ && ! reduce_tasks_[reduce_task_index])
+              continue;
+
             // Schedule task for contraction pairs
             if(task)
               task->inc();
-            const left_future left = col[i].second;
-            const right_future right = row[j].second;
-            reduce_tasks_[reduce_task_index].add(left, right, task);
+            reduce_tasks_[reduce_task_index].add(col[i].second, row[j].second, task);
+            ++count;
           }
         }
+
+        return count;
       }
 
       /// Schedule local contraction tasks for \c col and \c row tile pairs
@@ -1117,11 +1777,15 @@ namespace TiledArray {
       /// \param col A column of tiles from the left-hand argument
       /// \param row A row of tiles from the right-hand argument
       /// \param task The task that depends on tile contraction tasks
+      /// \return The number of scheduled tile contractions
       template <typename Shape>
-      void contract(const Shape&, const size_type,
-          const std::vector<col_datum>& col, const std::vector<row_datum>& row,
+      size_type contract(const Shape&, const size_type,
+          const std::vector<col_argument>& col,
+          const std::vector<row_argument>& row,
           madness::TaskInterface* const task)
       {
+        size_type count = 0ul;
+
         // Iterate over the row
         for(size_type i = 0ul; i < col.size(); ++i) {
           // Compute the local, result-tile offset
@@ -1142,11 +1806,12 @@ namespace TiledArray {
               else
                 task->inc();
             }
-            const left_future left = col[i].second;
-            const right_future right = row[j].second;
-            reduce_tasks_[reduce_task_index].add(left, right, task);
+            reduce_tasks_[reduce_task_index].add(col[i].second, row[j].second, task);
+            ++count;
           }
         }
+
+        return count;
       }
 
 #define TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
@@ -1163,10 +1828,12 @@ namespace TiledArray {
       /// \param col A column of tiles from the left-hand argument
       /// \param row A row of tiles from the right-hand argument
       /// \param task The task that depends on the tile contraction tasks
+      /// \return The number of scheduled tile contractions
       template <typename T>
-      typename std::enable_if<std::is_floating_point<T>::value>::type
+      typename std::enable_if<std::is_floating_point<T>::value, size_type>::type
       contract(const SparseShape<T>&, const size_type k,
-          const std::vector<col_datum>& col, const std::vector<row_datum>& row,
+          const std::vector<col_argument>& col,
+          const std::vector<row_argument>& row,
           madness::TaskInterface* const task)
       {
         // Cache row shape data.
@@ -1178,6 +1845,7 @@ namespace TiledArray {
 
         const size_type col_start = left_start_local_ + k;
         const float threshold_k = TensorImpl_::shape().threshold() / typename SparseShape<T>::value_type(k_);
+        size_type count = 0ul;
         // Iterate over the row
         for(size_type i = 0ul; i != col.size(); ++i) {
           // Compute the local, result-tile offset
@@ -1201,14 +1869,101 @@ namespace TiledArray {
             if(task)
               task->inc();
             reduce_tasks_[reduce_task_index].add(col[i].second, row[j].second, task);
+            ++count;
           }
         }
+
+        return count;
       }
 #endif // TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
 
-      void contract(const size_type k, const std::vector<col_datum>& col,
+      size_type contract(const size_type k, const std::vector<col_datum>& col,
           const std::vector<row_datum>& row, madness::TaskInterface* const task)
-      { contract(TensorImpl_::shape(), k, col, row, task); }
+      {
+        return contract(TensorImpl_::shape(), k,
+            convert_arguments<left_argument_type>(col),
+            convert_arguments<right_argument_type>(row), task);
+      }
+
+      /// Argument tiles that have the argument type of the tile operation
+
+      /// \tparam Arg The argument type of the tile operation
+      /// \tparam T The tile type
+      /// \param tiles The tiles of a column or row
+      /// \return \c tiles
+      template <typename Arg, typename T>
+      static typename std::enable_if<std::is_same<Arg, T>::value,
+          const std::vector<std::pair<size_type, Future<T> > >&>::type
+      convert_arguments(const std::vector<std::pair<size_type, Future<T> > >& tiles)
+      { return tiles; }
+
+      /// Convert argument tiles to the argument type of the tile operation
+
+      /// Each tile is converted once, when it is received, and the converted
+      /// tile is shared by all contractions of the SUMMA iteration, e.g.
+      /// single precision tiles are converted to the double precision tiles of
+      /// a mixed precision contraction.
+      /// \tparam Arg The argument type of the tile operation
+      /// \tparam T The tile type
+      /// \param tiles The tiles of a column or row
+      /// \return The converted tiles
+      template <typename Arg, typename T>
+      typename std::enable_if<! std::is_same<Arg, T>::value,
+          std::vector<std::pair<size_type, Future<Arg> > > >::type
+      convert_arguments(const std::vector<std::pair<size_type, Future<T> > >& tiles) const {
+        std::vector<std::pair<size_type, Future<Arg> > > result;
+        result.reserve(tiles.size());
+        for(const auto& tile : tiles)
+          result.emplace_back(tile.first, TensorImpl_::world().taskq.add(
+              [] (const T& value) -> Arg { return Arg(value); }, tile.second,
+              madness::TaskAttributes::hipri()));
+        return result;
+      }
+
+
+      // SUMMA step completion task --------------------------------------------
+
+
+      /// SUMMA step completion task
+
+      /// This task runs when the tile contractions of a SUMMA iteration are
+      /// complete. It releases the broadcast buffers of the iteration from the
+      /// iteration controller, which in turn admits waiting iterations.
+      class StepCompleteTask : public madness::TaskInterface {
+      private:
+        std::shared_ptr<Summa_> owner_; ///< The parent object for this task
+        const size_type bytes_; ///< The broadcast buffer size of the iteration
+        size_type pairs_ = 0ul; ///< The number of tile contractions of the iteration
+        madness::TaskInterface* next_; ///< The step task that waits for this iteration
+
+      public:
+        /// Constructor
+
+        /// \param owner The parent object for this task
+        /// \param bytes The broadcast buffer size of the iteration
+        /// \param next The step task that waits for this iteration
+        StepCompleteTask(const std::shared_ptr<Summa_>& owner,
+            const size_type bytes, madness::TaskInterface* const next) :
+#ifdef TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
+          madness::TaskInterface(1ul, "StepCompleteTask ctor", madness::TaskAttributes::hipri()),
+#else
+          madness::TaskInterface(1ul, madness::TaskAttributes::hipri()),
+#endif
+          owner_(owner), bytes_(bytes), next_(next)
+        { }
+
+        virtual ~StepCompleteTask() { }
+
+        /// Set the number of tile contractions of the iteration
+
+        /// \param pairs The number of tile contractions
+        void pairs(const size_type pairs) { pairs_ = pairs; }
+
+        virtual void run(const madness::TaskThreadEnv&) {
+          owner_->controller_.complete(bytes_, pairs_, next_);
+        }
+
+      }; // class StepCompleteTask
 
 
       // SUMMA step task -------------------------------------------------------
@@ -1299,8 +2054,9 @@ namespace TiledArray {
         void make_next_step_tasks(Derived* task, size_type depth) {
           TA_ASSERT(depth > 0);
           // Set the depth to be no greater than the maximum number steps
-          if(depth > owner_->k_)
-            depth = owner_->k_;
+          const size_type steps = owner_->k_end_ - owner_->k_begin_;
+          if(depth > steps)
+            depth = steps;
 
           // Spawn n=depth step tasks
           for(; depth > 0ul; --depth) {
@@ -1319,11 +2075,21 @@ namespace TiledArray {
           printf("step:  start rank=%i k=%lu\n", owner_->world().rank(), k);
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
 
-          if(k < owner_->k_) {
+          if(k < owner_->k_end_) {
+            // Start the iteration; when the controller raises the number of
+            // concurrent iterations, an additional step task is appended to
+            // the pipeline and submitted for admission.
+            const size_type bytes = owner_->step_bytes(col_, row_);
+            Derived* tail = static_cast<Derived*>(tail_step_task_);
+            if(owner_->controller_.start(bytes)) {
+              tail = new Derived(tail, 1);
+              owner_->controller_.enqueue(tail);
+            }
+
             // Initialize next tail task and submit next task
             TA_ASSERT(next_step_task_);
             next_step_task_->tail_step_task_ =
-                new Derived(static_cast<Derived*>(tail_step_task_), 1);  // <- ndep=1, will control its scheduling by this task
+                new Derived(tail, 1);  // <- ndep=1, will be admitted by the controller when the next step completes
             // submit next step task ... even if it's same as tail_step_task_ it is safe to submit
             // because its ndep > 0 (see StepTask::make_next_step_tasks)
             TA_ASSERT(tail_step_task_->ndep() > 0);
@@ -1336,15 +2102,20 @@ namespace TiledArray {
             world_.taskq.add(owner_, & Summa_::bcast_row, k, row_, col_group,
                              madness::TaskAttributes::hipri());
 
-            // Submit tasks for the contraction of col and row tiles.
-            owner_->contract(k, col_, row_, tail_step_task_);
+            // Submit tasks for the contraction of col and row tiles. When
+            // they are complete, the controller releases the broadcast buffers
+            // of this iteration and admits the tail task.
+            TA_ASSERT(tail_step_task_);
+            StepCompleteTask* const complete_task =
+                new StepCompleteTask(owner_, bytes, tail_step_task_);
+            complete_task->pairs(owner_->contract(k, col_, row_, complete_task));
+            world_.taskq.add(complete_task);
 
             // Notify task dependencies
-            TA_ASSERT(tail_step_task_);
             if (trace_tasks)
-              tail_step_task_->notify_debug("StepTask nth ctor");
+              complete_task->notify_debug("StepCompleteTask ctor");
             else
-              tail_step_task_->notify();
+              complete_task->notify();
             finalize_task_->notify();
 
           } else if(finalize_task_) {
@@ -1352,6 +2123,9 @@ namespace TiledArray {
             // tasks have completed.
             finalize_task_->notify();
 
+            // Admit the remaining step tasks, which have nothing to do
+            owner_->controller_.finish();
+
             // Cleanup any remaining step tasks
             StepTask* step_task = next_step_task_;
             while(step_task) {
@@ -1382,7 +2156,8 @@ namespace TiledArray {
 
       public:
         DenseStepTask(const std::shared_ptr<Summa_>& owner, const size_type depth) :
-          StepTask(owner, owner->k_ + 1ul), k_(0)
+          StepTask(owner, owner->k_end_ - owner->k_begin_ + 1ul),
+          k_(owner->k_begin_)
         {
           StepTask::make_next_step_tasks(this, depth);
           StepTask::spawn_get_row_col_tasks(k_);
@@ -1392,7 +2167,7 @@ namespace TiledArray {
           StepTask(parent, ndep), k_(parent->k_ + 1ul)
         {
           // Spawn tasks to get k-th row and column tiles
-          if(k_ < owner_->k_)
+          if(k_ < owner_->k_end_)
             StepTask::spawn_get_row_col_tasks(k_);
         }
 
@@ -1421,7 +2196,7 @@ namespace TiledArray {
           k = owner_->iterate_sparse(k + offset);
           k_.set(k);
 
-          if(k < owner_->k_) {
+          if(k < owner_->k_end_) {
             // NOTE: The order of task submissions is dependent on the order in
             // which we want the tasks to complete.
 
@@ -1459,13 +2234,13 @@ namespace TiledArray {
           else
             madness::DependencyInterface::inc();
           world_.taskq.add(this, & SparseStepTask::iterate_task,
-              0ul, 0ul, madness::TaskAttributes::hipri());
+              owner->k_begin_, 0ul, madness::TaskAttributes::hipri());
         }
 
         SparseStepTask(SparseStepTask* const parent, const int ndep) :
           StepTask(parent, ndep)
         {
-          if(parent->k_.probe() && (parent->k_.get() >= owner_->k_)) {
+          if(parent->k_.probe() && (parent->k_.get() >= owner_->k_end_)) {
             // Avoid running extra tasks if not needed.
             k_.set(parent->k_.get());
             TA_ASSERT(ndep == 1);  // ensure that this does not get executed immediately
@@ -1502,18 +2277,23 @@ namespace TiledArray {
       /// \param k The number of tiles in the inner dimension
       /// \param proc_grid The process grid that defines the layout of the tiles
       ///                  during the contraction evaluation
+      /// \param symmetry The tile symmetry of the result; when it is not null,
+      ///                 only the canonical result tiles are evaluated
       /// \note The trange, shape, and pmap refer to the final,
       ///       permuted, state for the result, NOT to the result during
       ///       the SUMMA evaluation.
       Summa(const left_type& left, const right_type& right,
           World& world, const trange_type trange, const shape_type& shape,
           const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
-          const op_type& op, const size_type k, const ProcGrid& proc_grid) :
+          const op_type& op, const size_type k, const ProcGrid& proc_grid,
+          const std::shared_ptr<const symmetry::TileSymmetry>& symmetry = nullptr) :
         DistEvalImpl_(world, trange, shape, pmap, perm),
         left_(left), right_(right), op_(op),
         row_group_(), col_group_(),
         k_(k), proc_grid_(proc_grid),
-        reduce_tasks_(NULL),
+        k_begin_(proc_grid.layer_inner_begin(k)),
+        k_end_(proc_grid.layer_inner_end(k)),
+        reduce_tasks_(NULL), symmetry_(symmetry),
         left_start_local_(proc_grid_.rank_row() * k),
         left_end_(left.size()),
         left_stride_(k),
@@ -1557,53 +2337,79 @@ namespace TiledArray {
       /// \param i The index of the tile
       virtual void discard_tile(size_type i) const { get_tile(i); }
 
+      /// Runtime statistics accessor
+
+      /// \return The iteration depth and broadcast buffer statistics of this
+      /// contraction on this process
+      SummaStats stats() const { return controller_.stats(); }
+
     private:
 
+      /// Average size of a tile of the left-hand argument
+
+      /// \return The average number of bytes in a left-hand tile
+      size_type left_tile_bytes() const {
+        return (left_.trange().elements_range().volume() / left_.trange().tiles_range().volume()) *
+            sizeof(typename numeric_type<typename left_type::eval_type>::type);
+      }
+
+      /// Average size of a tile of the right-hand argument
+
+      /// \return The average number of bytes in a right-hand tile
+      size_type right_tile_bytes() const {
+        return (right_.trange().elements_range().volume() / right_.trange().tiles_range().volume()) *
+            sizeof(typename numeric_type<typename right_type::eval_type>::type);
+      }
+
+      /// Estimate the broadcast buffer size of a SUMMA iteration
+
+      /// \param left_sparsity The fraction of zero tiles in the left-hand matrix
+      /// \param right_sparsity The fraction of zero tiles in the right-hand matrix
+      /// \return The average number of bytes in the column and row tiles
+      /// received by this process in one iteration
+      size_type iteration_bytes(const float left_sparsity, const float right_sparsity) const {
+        return left_tile_bytes() * proc_grid_.local_rows() * (1.0f - left_sparsity) +
+            right_tile_bytes() * proc_grid_.local_cols() * (1.0f - right_sparsity);
+      }
+
+      /// Broadcast buffer size of a SUMMA iteration
+
+      /// \param col The column of left-hand tiles of the iteration
+      /// \param row The row of right-hand tiles of the iteration
+      /// \return The number of bytes in the column and row tiles
+      size_type step_bytes(const std::vector<col_datum>& col,
+          const std::vector<row_datum>& row) const
+      {
+        return left_tile_bytes() * col.size() + right_tile_bytes() * row.size();
+      }
+
       /// Adjust iteration depth based on memory constraints
 
       /// \param depth The unbounded iteration depth
       /// \param left_sparsity The fraction of zero tiles in the left-hand matrix
       /// \param right_sparsity The fraction of zero tiles in the right-hand matrix
-      /// \return The memory bounded iteration depth
-      /// \thorw TiledArray::Exception When the memory bounded iteration depth
-      /// is less than 1.
+      /// \return The memory bounded iteration depth, which is at least 1
       size_type mem_bound_depth(size_type depth, const float left_sparsity, const float right_sparsity) {
 
         // Check if a memory bound has been set
-        const size_type available_memory = max_memory_;
+        const size_type available_memory = SummaMemory::instance().budget();
         if(available_memory) {
 
           // Compute the average memory requirement per iteration of this process
-          const std::size_t local_memory_per_iter_left =
-              (left_.trange().elements_range().volume() / left_.trange().tiles_range().volume()) *
-              sizeof(typename numeric_type<typename left_type::eval_type>::type) *
-              proc_grid_.local_rows() * (1.0f - left_sparsity);
-          const std::size_t local_memory_per_iter_right =
-              (right_.trange().elements_range().volume() / right_.trange().tiles_range().volume()) *
-              sizeof(typename numeric_type<typename right_type::eval_type>::type) *
-              proc_grid_.local_cols() * (1.0f - right_sparsity);
+          const size_type local_memory_per_iter =
+              std::max(iteration_bytes(left_sparsity, right_sparsity), size_type(1));
 
           // Compute the maximum number of iterations based on available memory
-          const size_type mem_bound_depth =
-              ((local_memory_per_iter_left + local_memory_per_iter_right) /
-              available_memory);
+          const size_type mem_bound_depth = available_memory / local_memory_per_iter;
 
           // Check if the memory bounded depth is less than the optimal depth
           if(depth > mem_bound_depth) {
-
-            // Adjust the depth based on the available memory
-            switch(mem_bound_depth) {
-              case 0:
-                // When memory bound depth is
-                TA_EXCEPTION("Insufficient memory available for SUMMA");
-                break;
-              case 1:
-                if(TensorImpl_::world().rank() == 0)
-                  printf("!! WARNING TiledArray: Memory constraints limit the SUMMA depth depth to 1.\n"
-                         "!! WARNING TiledArray: Performance may be slow.\n");
-              default:
-                depth = mem_bound_depth;
-            }
+            // Adjust the depth based on the available memory; one iteration
+            // is always allowed, so that the contraction can make progress.
+            if((mem_bound_depth <= 1ul) && (TensorImpl_::world().rank() == 0))
+              printf("!! WARNING TiledArray: Memory constraints limit the SUMMA depth depth to 1.\n"
+                     "!! WARNING TiledArray: Performance may be slow.\n");
+            depth = std::max(mem_bound_depth, size_type(1));
           }
         }
 
@@ -1634,6 +2440,11 @@ namespace TiledArray {
         if(proc_grid_.local_size() > 0ul) {
           tile_count = initialize();
 
+          // Only layer 0 sets result tiles; other layers send their partial
+          // results to layer 0.
+          if(proc_grid_.rank_layer() > 0)
+            tile_count = 0ul;
+
           // depth controls the number of simultaneous SUMMA iterations
           // that are scheduled.
 
@@ -1645,8 +2456,8 @@ namespace TiledArray {
           // Construct the first SUMMA iteration task
           if(TensorImpl_::shape().is_dense()) {
             // We cannot have more iterations than there are blocks in the k
-            // dimension
-            if(depth > k_) depth = k_;
+            // dimension of this layer
+            if(depth > (k_end_ - k_begin_)) depth = k_end_ - k_begin_;
 
             // Modify the number of concurrent iterations based on the available
             // memory.
@@ -1656,6 +2467,10 @@ namespace TiledArray {
             if(max_depth_)
               depth = std::min(depth, max_depth_);
 
+            // The controller adjusts the depth at runtime
+            controller_.init(depth, (max_depth_ ? max_depth_ : k_end_ - k_begin_),
+                iteration_bytes(0.0f, 0.0f));
+
             TensorImpl_::world().taskq.add(new DenseStepTask(shared_from_this(),
                                                              depth));
           } else {
@@ -1673,8 +2488,8 @@ namespace TiledArray {
             depth = float(depth) * (1.0f - 1.35638f * std::log2(frac_non_zero)) + 0.5f;
 
             // We cannot have more iterations than there are blocks in the k
-            // dimension
-            if(depth > k_) depth = k_;
+            // dimension of this layer
+            if(depth > (k_end_ - k_begin_)) depth = k_end_ - k_begin_;
 
             // Modify the number of concurrent iterations based on the available
             // memory and sparsity of the argument tensors.
@@ -1684,6 +2499,10 @@ namespace TiledArray {
             if(max_depth_)
               depth = std::min(depth, max_depth_);
 
+            // The controller adjusts the depth at runtime
+            controller_.init(depth, (max_depth_ ? max_depth_ : k_end_ - k_begin_),
+                iteration_bytes(left_sparsity, right_sparsity));
+
             TensorImpl_::world().taskq.add(new SparseStepTask(shared_from_this(),
                                                               depth));
           }
@@ -1713,12 +2532,47 @@ namespace TiledArray {
     typename Summa<Left, Right, Op, Policy>::size_type
     Summa<Left, Right, Op, Policy>::max_depth_ =
         Summa<Left, Right, Op, Policy>::init_max_depth();
-
-    template <typename Left, typename Right, typename Op, typename Policy>
-    typename Summa<Left, Right, Op, Policy>::size_type
-    Summa<Left, Right, Op, Policy>::max_memory_ =
-        Summa<Left, Right, Op, Policy>::init_max_memory();
   } // namespace detail
+
+  /// Set the memory budget of SUMMA contractions
+
+  /// The budget bounds the total size of the broadcast buffers of all SUMMA
+  /// contractions that run concurrently on this process. The number of
+  /// concurrent iterations of each contraction is reduced, down to one, to
+  /// stay within the budget. The default is given by the
+  /// \c TA_SUMMA_MAX_MEMORY environment variable.
+  /// \param bytes The memory budget in bytes, or 0 for no limit
+  inline void set_summa_memory_budget(const std::size_t bytes) {
+    detail::SummaMemory::instance().budget(bytes);
+  }
+
+  /// SUMMA memory budget accessor
+
+  /// \return The memory budget of SUMMA contractions on this process in
+  /// bytes, or 0 if there is no limit
+  inline std::size_t summa_memory_budget() {
+    return detail::SummaMemory::instance().budget();
+  }
+
+  /// Statistics of the last completed SUMMA contraction
+
+  /// The statistics are recorded when a contraction has completed all of its
+  /// iterations on this process, so they are never those of a contraction
+  /// that is still running. The statistics of a running contraction are
+  /// available from its evaluator, see \c detail::Summa::stats() .
+  /// \return The iteration depth and broadcast buffer statistics of the
+  /// SUMMA contraction that completed last on this process;
+  /// \c node_peak_bytes is the peak over all contractions since the last
+  /// call to \c reset_summa_stats()
+  inline SummaStats summa_stats() {
+    return detail::SummaMemory::instance().stats();
+  }
+
+  /// Reset the SUMMA statistics of this process
+  inline void reset_summa_stats() {
+    detail::SummaMemory::instance().reset();
+  }
+
 }  // namespace TiledArray
 
 #endif // TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
@@ -23,8 +23,10 @@
 #include <TiledArray/tensor_impl.h>
 #include <TiledArray/permutation.h>
 #include <TiledArray/perm_index.h>
+#include <TiledArray/tile_codec.h>
 #include <TiledArray/type_traits.h>
 #include <TiledArray/config.h>
+#include <atomic>
 #ifdef TILEDARRAY_HAS_CUDA
 #include <TiledArray/external/cuda.h>
 #include <TiledArray/cuda/cuda_task_fn.h>
@@ -69,6 +71,22 @@ namespace TiledArray {
 
       volatile int task_count_; ///< Total number of local tasks
       madness::AtomicInt set_counter_; ///< The number of tiles set by this node
+      madness::AtomicInt done_counter_; ///< Reaches zero when \c done_ is set
+      Future<bool> done_; ///< Set when all local tiles have been set
+
+      /// Set \c done_ when all local tiles have been set
+
+      /// \c done_ is set by exactly one caller, which is either \c eval() or
+      /// the notification of the last tile.
+      /// \param set_count The number of tiles that have been set
+      void check_done(const int set_count) {
+        if((set_count == task_count_) && done_counter_.dec_and_test()) {
+          // Set a copy since this object may be released by a task that
+          // depends on done_ before set() returns
+          Future<bool> done = done_;
+          done.set(true);
+        }
+      }
 
     protected:
 
@@ -109,9 +127,12 @@ namespace TiledArray {
         source_to_target_(),
         target_to_source_(),
         task_count_(-1),
-        set_counter_()
+        set_counter_(),
+        done_counter_(),
+        done_()
       {
         set_counter_ = 0;
+        done_counter_ = 1;
 
         if(perm) {
           Permutation inv_perm(-perm);
@@ -142,6 +163,21 @@ namespace TiledArray {
       /// \param i The index of the tile
       virtual void discard_tile(size_type i) const = 0;
 
+      /// Prefetch hint
+
+      /// Tell this object that tile \c i will be requested soon, so it may
+      /// start fetching its inputs. The default implementation does nothing.
+      /// \param i The index of the tile
+      virtual void prefetch_tile(size_type) const { }
+
+      /// Tile compression settings
+
+      /// The codec that is used when the tiles of this object are broadcast
+      /// to other processes. The default implementation returns
+      /// \c TileCodec::none .
+      /// \return The compression settings of the tiles
+      virtual CodecSettings codec() const { return CodecSettings(); }
+
       /// Set tensor value
 
       /// This will store \c value at ordinal index \c i . Typically, this
@@ -173,7 +209,7 @@ namespace TiledArray {
       }
 
       /// Tile set notification
-      virtual void notify() { set_counter_++; }
+      virtual void notify() { check_done(++set_counter_); }
 
       /// Wait for all tiles to be assigned
       void wait() const {
@@ -230,8 +266,19 @@ namespace TiledArray {
         TA_ASSERT(task_count_ == -1);
         task_count_ = this->internal_eval();
         TA_ASSERT(task_count_ >= 0);
+
+        // Tiles may have been set before the task count was known
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        check_done(set_counter_);
       }
 
+      /// Local completion accessor
+
+      /// \return A future that is set when all tiles of this tensor that are
+      /// evaluated by this process have been set, i.e. when \c wait() would
+      /// return
+      const Future<bool>& done() const { return done_; }
+
     }; // class DistEvalImpl
 
 
@@ -357,6 +404,16 @@ namespace TiledArray {
       /// \param i The index of the tile
       virtual void discard(size_type i) const { pimpl_->discard_tile(i); }
 
+      /// Prefetch hint
+
+      /// \param i The index of a tile that will be requested soon
+      void prefetch(size_type i) const { pimpl_->prefetch_tile(i); }
+
+      /// Tile compression settings accessor
+
+      /// \return The compression used when tiles of this object are broadcast
+      CodecSettings codec() const { return pimpl_->codec(); }
+
       /// World object accessor
 
       /// \return A reference to the world object
@@ -370,6 +427,11 @@ namespace TiledArray {
       /// Wait for all local tiles to be evaluated
       void wait() const { pimpl_->wait(); }
 
+      /// Local completion accessor
+
+      /// \return A future that is set when all local tiles have been evaluated
+      const Future<bool>& done() const { return pimpl_->done(); }
+
     }; // class DistEval
 
   }  // namespace detail
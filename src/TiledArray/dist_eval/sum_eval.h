@@ -0,0 +1,281 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  sum_eval.h
+ *  Apr 21, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUM_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUM_EVAL_H__INCLUDED
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/reduce_task.h>
+#include <TiledArray/tile_interface/cast.h>
+#include <TiledArray/tile_op/tile_interface.h>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// N-ary sum, distributed tensor evaluator
+
+    /// This object is used to evaluate the tiles of a sum of any number of
+    /// distributed evaluators. Each result tile is the reduction of the tiles
+    /// of the terms with the same index, which are added to the result tile
+    /// as they are evaluated, in any order, and released once they have been
+    /// added. The terms are not evaluated into intermediate tensors, and
+    /// unlike a tree of binary sums, a term tile does not wait for the tiles
+    /// of the other terms before it is added.
+    /// \note The terms must have the tiled range, the process map, and the
+    /// index order of the result, and their tiles are owned by the sum, i.e.
+    /// they may be modified in place.
+    /// \tparam Tile The output tile type
+    /// \tparam Policy The tensor policy class
+    template <typename Tile, typename Policy>
+    class SumEvalImpl :
+      public DistEvalImpl<Tile, Policy>,
+      public std::enable_shared_from_this<SumEvalImpl<Tile, Policy> >
+    {
+    public:
+      typedef SumEvalImpl<Tile, Policy> SumEvalImpl_; ///< This object type
+      typedef DistEvalImpl<Tile, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef typename DistEvalImpl_::eval_type eval_type; ///< Tile evaluation type
+
+      using std::enable_shared_from_this<SumEvalImpl_>::shared_from_this;
+
+      /// A term of the sum
+
+      /// This interface hides the tile type of the distributed evaluator of a
+      /// term, which may be a lazy tile type.
+      class Term {
+      public:
+        virtual ~Term() { }
+
+        /// Evaluate the tiles of the term
+        virtual void eval() = 0;
+
+        /// Wait for the tasks of the term
+        virtual void wait() const = 0;
+
+        /// Check for zero tiles
+
+        /// \param i The index of the tile
+        /// \return \c true if tile \c i of the term is zero
+        virtual bool is_zero(size_type i) const = 0;
+
+        /// Get a tile of the term
+
+        /// \param i The index of the tile
+        /// \return A future to tile \c i , converted to \c value_type
+        virtual Future<value_type> get(size_type i) const = 0;
+
+        /// Discard a tile that is not needed
+
+        /// \param i The index of the tile
+        virtual void discard(size_type i) const = 0;
+
+        /// The tiled range of the term
+        virtual const trange_type& trange() const = 0;
+
+        /// The process map of the term
+        virtual const std::shared_ptr<pmap_interface>& pmap() const = 0;
+      }; // class Term
+
+    private:
+
+      /// The term of a distributed evaluator
+
+      /// \tparam T The tile type of the distributed evaluator
+      template <typename T>
+      class DistEvalTerm : public Term {
+        DistEval<T, Policy> arg_; ///< The distributed evaluator of the term
+
+        /// Convert a tile of the term that has the result tile type
+        template <typename U,
+            typename std::enable_if<std::is_same<U, value_type>::value>::type* = nullptr>
+        Future<value_type> convert(const Future<U>& tile) const { return tile; }
+
+        /// Convert a (lazy) tile of the term to the result tile type
+        template <typename U,
+            typename std::enable_if<! std::is_same<U, value_type>::value>::type* = nullptr>
+        Future<value_type> convert(const Future<U>& tile) const {
+          return arg_.world().taskq.add(TiledArray::Cast<value_type, U>(), tile);
+        }
+
+      public:
+        /// Constructor
+
+        /// \param arg The distributed evaluator of the term
+        DistEvalTerm(const DistEval<T, Policy>& arg) : arg_(arg) { }
+
+        virtual ~DistEvalTerm() { }
+
+        virtual void eval() { arg_.eval(); }
+        virtual void wait() const { arg_.wait(); }
+        virtual bool is_zero(size_type i) const { return arg_.is_zero(i); }
+        virtual Future<value_type> get(size_type i) const { return convert(arg_.get(i)); }
+        virtual void discard(size_type i) const { arg_.discard(i); }
+        virtual const trange_type& trange() const { return arg_.trange(); }
+        virtual const std::shared_ptr<pmap_interface>& pmap() const { return arg_.pmap(); }
+      }; // class DistEvalTerm
+
+      /// Reduction operation that adds the tiles of the terms
+
+      /// The first tile that is reduced becomes the result tile, and the
+      /// following tiles are added to it in place.
+      class SumOp {
+      public:
+        typedef value_type result_type; ///< The result tile type
+        typedef value_type argument_type; ///< The term tile type
+
+        /// Create an empty result tile
+        result_type operator()() const { return result_type(); }
+
+        /// Post processing step
+        const result_type& operator()(const result_type& result) const {
+          using TiledArray::empty;
+          TA_ASSERT(! empty(result));
+          return result;
+        }
+
+        /// Add a term tile, or a partial sum, to \c result
+        void operator()(result_type& result, const argument_type& arg) const {
+          using TiledArray::empty;
+          if(empty(result)) {
+            result = arg;
+          } else {
+            using TiledArray::add_to;
+            add_to(result, arg);
+          }
+        }
+      }; // class SumOp
+
+      std::vector<std::shared_ptr<Term> > terms_; ///< The terms of the sum
+
+    public:
+
+      /// Construct a term of a sum
+
+      /// \tparam T The tile type of the distributed evaluator
+      /// \param arg The distributed evaluator of the term
+      /// \return A pointer to the term
+      template <typename T>
+      static std::shared_ptr<Term> make_term(const DistEval<T, Policy>& arg) {
+        return std::make_shared<DistEvalTerm<T> >(arg);
+      }
+
+      /// Construct an N-ary sum evaluator
+
+      /// \param terms The terms of the sum
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range object
+      /// \param shape The tensor shape object, which must include the non-zero
+      /// tiles of the terms
+      /// \param pmap The tile-process map
+      SumEvalImpl(const std::vector<std::shared_ptr<Term> >& terms,
+          World& world, const trange_type& trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap) :
+        DistEvalImpl_(world, trange, shape, pmap, Permutation()),
+        terms_(terms)
+      {
+        TA_ASSERT(! terms_.empty());
+        for(const auto& term : terms_) {
+          TA_ASSERT(term->trange() == trange);
+          TA_ASSERT(term->pmap() == pmap);
+        }
+      }
+
+      virtual ~SumEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::world().gop.template recv<value_type>(
+            TensorImpl_::owner(i), key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the terms of this distributed evaluator
+      /// and submit the reductions of the tiles of this distributed evaluator.
+      /// It will block until the tasks for the terms are evaluated (not for
+      /// the tasks of this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        // Evaluate the terms
+        for(const auto& term : terms_)
+          term->eval();
+
+        size_type task_count = 0ul;
+
+        for(const auto index : *TensorImpl_::pmap()) {
+          if(! TensorImpl_::is_zero(index)) {
+            // Reduce the non-zero tiles of the terms as they are evaluated
+            ReduceTask<SumOp> reduce_task(TensorImpl_::world());
+            for(const auto& term : terms_)
+              if(! term->is_zero(index))
+                reduce_task.add(term->get(index));
+            TA_ASSERT(reduce_task.count() > 0);
+
+            DistEvalImpl_::set_tile(index, reduce_task.submit());
+            ++task_count;
+          } else {
+            // Cleanup unused tiles
+            for(const auto& term : terms_)
+              if(! term->is_zero(index))
+                term->discard(index);
+          }
+        }
+
+        // Wait for the terms to be evaluated, and process tasks while waiting.
+        for(const auto& term : terms_)
+          term->wait();
+
+        return task_count;
+      }
+
+    }; // class SumEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUM_EVAL_H__INCLUDED
@@ -20,11 +20,404 @@
 #ifndef TILEDARRAY_DISTRIBUTED_STORAGE_H__INCLUDED
 #define TILEDARRAY_DISTRIBUTED_STORAGE_H__INCLUDED
 
+#include <atomic>
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <TiledArray/parallel_io.h>
 #include <TiledArray/pmap/pmap.h>
+#include <TiledArray/tile_codec.h>
 
 namespace TiledArray {
+
+  /// Out-of-core tile storage statistics
+
+  /// The statistics of the local tiles of an array stored out of core (see
+  /// \c DistArray::enable_out_of_core() ) on one process.
+  struct OutOfCoreStatistics {
+    std::size_t hits = 0ul; ///< Requests for tiles that were in memory
+    std::size_t misses = 0ul; ///< Requests for tiles that were read from disk
+    std::size_t bytes_read = 0ul; ///< The number of bytes read from disk
+    std::size_t bytes_written = 0ul; ///< The number of bytes written to disk
+    std::size_t resident_bytes = 0ul; ///< The size of the tiles held in memory
+
+    /// Hit rate
+
+    /// \return The fraction of tile requests that were served from memory,
+    /// or zero if there were no requests
+    double hit_rate() const {
+      return (hits + misses ? double(hits) / double(hits + misses) : 0.0);
+    }
+  }; // struct OutOfCoreStatistics
+
   namespace detail {
 
+    /// Estimate the memory footprint of a tile held by a remote tile cache
+
+    /// This overload is selected for tiles that provide \c size() and
+    /// \c value_type , e.g. \c Tensor .
+    /// \tparam T The tile type
+    /// \param t The tile
+    /// \return The approximate number of bytes held by \c t
+    template <typename T>
+    inline auto remote_cache_tile_bytes(const T& t, int) ->
+        decltype(t.size() * sizeof(typename T::value_type))
+    { return sizeof(T) + t.size() * sizeof(typename T::value_type); }
+
+    /// Estimate the memory footprint of a tile held by a remote tile cache
+
+    /// Fallback for tile types that do not expose their size.
+    /// \tparam T The tile type
+    /// \return \c sizeof(T)
+    template <typename T>
+    inline std::size_t remote_cache_tile_bytes(const T&, long) {
+      return sizeof(T);
+    }
+
+    /// Byte-bounded, least-recently-used cache of remote elements
+
+    /// Each entry holds the future returned by the first request for a remote
+    /// element, so concurrent requests for the same element share one
+    /// in-flight future. The size of an entry is accounted for once the
+    /// future has been set, at which point the least recently used entries
+    /// are evicted until the cache fits in its byte budget. Evicted futures
+    /// remain valid for the tasks that already hold them.
+    /// \tparam T The element type
+    template <typename T>
+    class RemoteCache : private madness::Spinlock {
+    public:
+      typedef RemoteCache<T> RemoteCache_; ///< This object type
+      typedef std::size_t size_type; ///< size type
+      typedef size_type key_type; ///< element key type
+      typedef Future<T> future; ///< Element future type
+
+    private:
+
+      struct Entry {
+        future value; ///< The cached element
+        size_type bytes; ///< The size of the element, zero while in flight
+        size_type stamp; ///< Identifies this insertion
+        typename std::list<key_type>::iterator lru; ///< Position in the LRU list
+      }; // struct Entry
+
+      const size_type max_bytes_; ///< The byte budget of this cache
+      size_type bytes_; ///< The number of bytes currently held
+      size_type stamp_; ///< Insertion counter
+      std::list<key_type> lru_; ///< Keys, most recently used first
+      std::unordered_map<key_type, Entry> entries_; ///< Cache entries
+
+      /// Update the entry size once its element has arrived
+      class Arrived : public madness::CallbackInterface {
+        std::weak_ptr<RemoteCache_> cache_; ///< The cache that owns the entry
+        key_type key_; ///< The element key
+        size_type stamp_; ///< The entry stamp
+        future value_; ///< The future we are waiting on
+
+      public:
+        Arrived(const std::shared_ptr<RemoteCache_>& cache, const key_type key,
+            const size_type stamp, const future& value) :
+          cache_(cache), key_(key), stamp_(stamp), value_(value)
+        { }
+
+        virtual ~Arrived() { }
+
+        virtual void notify() {
+          std::shared_ptr<RemoteCache_> cache = cache_.lock();
+          if(cache)
+            cache->arrived(key_, stamp_,
+                remote_cache_tile_bytes(value_.get(), 0));
+          delete this;
+        }
+      }; // class Arrived
+
+      void erase(typename std::unordered_map<key_type, Entry>::iterator it) {
+        bytes_ -= it->second.bytes;
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+      }
+
+      void arrived(const key_type key, const size_type stamp, const size_type bytes) {
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        auto it = entries_.find(key);
+        if((it == entries_.end()) || (it->second.stamp != stamp))
+          return; // The entry was evicted or invalidated in the meantime
+
+        it->second.bytes = bytes;
+        bytes_ += bytes;
+
+        // Evict least recently used entries, but always keep the newest one
+        while((bytes_ > max_bytes_) && (lru_.size() > 1u))
+          erase(entries_.find(lru_.back()));
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param max_bytes The maximum number of bytes held by the cache
+      explicit RemoteCache(const size_type max_bytes) :
+        madness::Spinlock(), max_bytes_(max_bytes), bytes_(0ul), stamp_(0ul),
+        lru_(), entries_()
+      { }
+
+      /// Find or insert an element
+
+      /// \param key The element key
+      /// \param[out] value The cached future, or a new, unset future when
+      /// the element was not in the cache
+      /// \return \c true if \c key was found in the cache, otherwise \c false,
+      /// in which case the caller is responsible for setting \c value .
+      bool find_or_insert(const key_type key, future& value) {
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        auto it = entries_.find(key);
+        if(it != entries_.end()) {
+          lru_.splice(lru_.begin(), lru_, it->second.lru);
+          value = it->second.value;
+          return true;
+        }
+
+        lru_.push_front(key);
+        entries_.emplace(key, Entry{value, 0ul, ++stamp_, lru_.begin()});
+        return false;
+      }
+
+      /// Account for the size of a newly inserted element when it arrives
+
+      /// \param self A shared pointer to this cache
+      /// \param key The element key
+      /// \param value The future returned by \c find_or_insert
+      static void track(const std::shared_ptr<RemoteCache_>& self,
+          const key_type key, const future& value)
+      {
+        size_type stamp = 0ul;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(self.get());
+          auto it = self->entries_.find(key);
+          if(it == self->entries_.end())
+            return;
+          stamp = it->second.stamp;
+        }
+        const_cast<future&>(value).register_callback(
+            new Arrived(self, key, stamp, value));
+      }
+
+      /// Remove an element from the cache
+
+      /// \param key The element key
+      void invalidate(const key_type key) {
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        auto it = entries_.find(key);
+        if(it != entries_.end())
+          erase(it);
+      }
+
+      /// Byte budget accessor
+
+      /// \return The maximum number of bytes held by the cache
+      size_type max_bytes() const { return max_bytes_; }
+
+      /// Cached bytes accessor
+
+      /// \return The number of bytes held by elements that have arrived
+      size_type bytes() {
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        return bytes_;
+      }
+
+      /// Number of cached elements, including those in flight
+      size_type size() {
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        return entries_.size();
+      }
+
+    }; // class RemoteCache
+
+    /// Node-local file storage of elements with a byte-bounded memory cache
+
+    /// Each element is written to a node-local file once it has been set, and
+    /// the elements that are held in memory are tracked in a
+    /// least-recently-used list. When the elements in memory exceed the byte
+    /// budget, the least recently used ones are evicted, i.e. their futures
+    /// are dropped by the owning container, and they are read back from the
+    /// file on the next request. The file is unlinked when it is created, so
+    /// it is removed when this object is destroyed.
+    /// \tparam T The element type, which must be serializable
+    template <typename T>
+    class OutOfCoreCache : private madness::Spinlock {
+    public:
+      typedef OutOfCoreCache<T> OutOfCoreCache_; ///< This object type
+      typedef std::size_t size_type; ///< size type
+      typedef size_type key_type; ///< element key type
+
+    private:
+
+      /// The location of an element in the file
+      struct Slot {
+        std::uint64_t offset; ///< File offset
+        size_type size; ///< Serialized size
+      }; // struct Slot
+
+      /// An element held in memory
+      struct Resident {
+        size_type bytes; ///< The size of the element
+        typename std::list<key_type>::iterator lru; ///< Position in the LRU list
+      }; // struct Resident
+
+      int fd_; ///< The file descriptor
+      std::atomic<std::uint64_t> end_; ///< The end of the file
+      const size_type max_bytes_; ///< The byte budget of the memory cache
+      size_type bytes_; ///< The number of bytes held in memory
+      std::unordered_map<key_type, Slot> slots_; ///< Elements in the file
+      std::list<key_type> lru_; ///< Keys in memory, most recently used first
+      std::unordered_map<key_type, Resident> resident_; ///< Elements in memory
+      std::atomic<size_type> hits_; ///< Number of requests served from memory
+      std::atomic<size_type> misses_; ///< Number of requests read from the file
+      std::atomic<size_type> bytes_read_; ///< Number of bytes read
+      std::atomic<size_type> bytes_written_; ///< Number of bytes written
+
+      /// Add an element to the memory cache and evict elements over budget
+
+      /// \param key The element key
+      /// \param bytes The size of the element
+      /// \param[out] evicted The keys of the evicted elements
+      void insert_resident(const key_type key, const size_type bytes,
+          std::vector<key_type>& evicted)
+      {
+        if(resident_.find(key) != resident_.end())
+          return;
+        lru_.push_front(key);
+        resident_.emplace(key, Resident{bytes, lru_.begin()});
+        bytes_ += bytes;
+
+        // Evict least recently used elements, but always keep the newest one
+        while((bytes_ > max_bytes_) && (lru_.size() > 1u)) {
+          auto it = resident_.find(lru_.back());
+          bytes_ -= it->second.bytes;
+          evicted.push_back(it->first);
+          lru_.pop_back();
+          resident_.erase(it);
+        }
+      }
+
+    public:
+
+      OutOfCoreCache(const OutOfCoreCache_&) = delete;
+      OutOfCoreCache_& operator=(const OutOfCoreCache_&) = delete;
+
+      /// Constructor
+
+      /// \param directory The directory of the node-local file
+      /// \param max_bytes The maximum number of bytes held in memory
+      /// \throw TiledArray::Exception When the file cannot be created
+      OutOfCoreCache(const std::string& directory, const size_type max_bytes) :
+        madness::Spinlock(), fd_(-1), end_(0ul), max_bytes_(max_bytes),
+        bytes_(0ul), slots_(), lru_(), resident_(), hits_(0ul), misses_(0ul),
+        bytes_read_(0ul), bytes_written_(0ul)
+      {
+        std::string name = directory + "/ta_tiles.XXXXXX";
+        std::vector<char> buffer(name.begin(), name.end());
+        buffer.push_back('\0');
+        fd_ = ::mkstemp(buffer.data());
+        if(fd_ < 0)
+          TA_EXCEPTION("Unable to create the out-of-core tile file.");
+        ::unlink(buffer.data());
+      }
+
+      ~OutOfCoreCache() { ::close(fd_); }
+
+      /// Check if an element is stored in the file
+
+      /// \param key The element key
+      /// \return \c true if the element has been written
+      bool stored(const key_type key) {
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        return slots_.find(key) != slots_.end();
+      }
+
+      /// Record a request for an element that is read from the file
+      void miss() { ++misses_; }
+
+      /// Record a request for an element that is in memory
+
+      /// \param key The element key
+      void hit(const key_type key) {
+        ++hits_;
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        auto it = resident_.find(key);
+        if(it != resident_.end())
+          lru_.splice(lru_.begin(), lru_, it->second.lru);
+      }
+
+      /// Write an element to the file
+
+      /// \param key The element key
+      /// \param value The element
+      /// \return The keys of the elements that were evicted from memory
+      std::vector<key_type> write(const key_type key, const T& value) {
+        const std::vector<unsigned char> buffer = serialize_to_buffer(value);
+        const std::uint64_t offset = end_.fetch_add(buffer.size());
+        write_at(fd_, buffer.data(), buffer.size(), offset);
+        bytes_written_ += buffer.size();
+
+        std::vector<key_type> evicted;
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        slots_[key] = Slot{offset, buffer.size()};
+        insert_resident(key, remote_cache_tile_bytes(value, 0), evicted);
+        return evicted;
+      }
+
+      /// Read an element from the file
+
+      /// \param key The key of an element that has been written
+      /// \return The element
+      T read(const key_type key) {
+        Slot slot;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(this);
+          TA_ASSERT(slots_.find(key) != slots_.end());
+          slot = slots_[key];
+        }
+        std::vector<unsigned char> buffer(slot.size);
+        read_at(fd_, buffer.data(), buffer.size(), slot.offset);
+        bytes_read_ += buffer.size();
+
+        T value;
+        madness::archive::BufferInputArchive iar(buffer.data(), buffer.size());
+        iar & value;
+        return value;
+      }
+
+      /// Add an element that was read from the file to the memory cache
+
+      /// \param key The element key
+      /// \param value The element
+      /// \return The keys of the elements that were evicted from memory
+      std::vector<key_type> loaded(const key_type key, const T& value) {
+        std::vector<key_type> evicted;
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        insert_resident(key, remote_cache_tile_bytes(value, 0), evicted);
+        return evicted;
+      }
+
+      /// Statistics accessor
+
+      /// \return The access statistics of this cache
+      OutOfCoreStatistics statistics() {
+        OutOfCoreStatistics result;
+        result.hits = hits_;
+        result.misses = misses_;
+        result.bytes_read = bytes_read_;
+        result.bytes_written = bytes_written_;
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        result.resident_bytes = bytes_;
+        return result;
+      }
+
+    }; // class OutOfCoreCache
+
     /// Distributed storage container.
 
     /// Each element in this container is owned by a single node, but any node
@@ -54,24 +447,57 @@ namespace TiledArray {
       typedef madness::ConcurrentHashMap<key_type, future> container_type; ///< Local container type
       typedef typename container_type::accessor accessor; ///< Local element accessor type
       typedef typename container_type::const_accessor const_accessor; ///< Local element const accessor type
+      typedef RemoteCache<value_type> cache_type; ///< Remote element cache type
+      typedef OutOfCoreCache<value_type> out_of_core_type; ///< Out-of-core element storage type
+      typedef std::integral_constant<bool,
+          is_compressible_tile<value_type>::value> compressible; ///< \c std::true_type if elements can be compressed
 
     private:
 
       const size_type max_size_; ///< The maximum number of elements that can be stored by this container
       std::shared_ptr<pmap_interface> pmap_; ///< The process map that defines the element distribution
       mutable container_type data_; ///< The local data container
+      size_type cache_max_bytes_; ///< Remote cache byte budget, zero when disabled
+      mutable std::weak_ptr<cache_type> cache_; ///< Remote cache for the current fence epoch
+      mutable madness::Spinlock cache_mutex_; ///< Guards \c cache_
+      mutable std::atomic<size_type> cache_hits_; ///< Number of remote cache hits
+      mutable std::atomic<size_type> cache_misses_; ///< Number of remote cache misses
+      std::shared_ptr<out_of_core_type> out_of_core_; ///< Out-of-core storage of local elements
+      CodecSettings codec_; ///< Compression of elements sent to other processes
 
       // not allowed
       DistributedStorage(const DistributedStorage_&);
       DistributedStorage_& operator=(const DistributedStorage_&);
 
-      future get_local(const size_type i) const {
+      future get_local(const size_type i, const bool count_hit = true) const {
         TA_ASSERT(pmap_->is_local(i));
 
         // Return the local element.
         const_accessor acc;
-        data_.insert(acc, i);
-        return acc->second;
+        const bool inserted = data_.insert(acc, i);
+        future result = acc->second;
+        acc.release();
+
+        // Read elements that were evicted from memory back from the file.
+        // Prefetch hints are not counted, so a requested element is counted
+        // once: as a miss if it is read or still being read, and as a hit if
+        // it is in memory.
+        if(out_of_core_) {
+          if(inserted) {
+            if(out_of_core_->stored(i)) {
+              load(i, result);
+              if(count_hit)
+                out_of_core_->miss();
+            }
+          } else if(count_hit) {
+            if(result.probe())
+              out_of_core_->hit(i);
+            else if(out_of_core_->stored(i))
+              out_of_core_->miss();
+          }
+        }
+
+        return result;
       }
 
       void set_handler(const size_type i, const value_type& value) {
@@ -84,6 +510,43 @@ namespace TiledArray {
 #endif // NDEBUG
 
         f.set(value);
+        if(out_of_core_)
+          spill(i, f);
+      }
+
+      /// Drop the futures of elements that were evicted from memory
+
+      /// \param keys The keys of the evicted elements
+      void evict(const std::vector<size_type>& keys) {
+        for(const size_type key : keys)
+          data_.erase(key);
+      }
+
+      /// Write a local element to the out-of-core file when it is set
+
+      /// \param i The element key
+      /// \param f The future of the element
+      void spill(const size_type i, const future& f) {
+        DistributedStorage_* self = this;
+        std::shared_ptr<out_of_core_type> out_of_core = out_of_core_;
+        get_world().taskq.add([self,out_of_core,i] (const value_type& value) {
+          self->evict(out_of_core->write(i, value));
+        }, f);
+      }
+
+      /// Read a local element from the out-of-core file
+
+      /// \param i The element key
+      /// \param result The future that will hold the element
+      void load(const size_type i, future result) const {
+        DistributedStorage_* self = const_cast<DistributedStorage_*>(this);
+        std::shared_ptr<out_of_core_type> out_of_core = out_of_core_;
+        get_world().taskq.add([self,out_of_core,i,result] () mutable {
+          value_type value = out_of_core->read(i);
+          const std::vector<size_type> evicted = out_of_core->loaded(i, value);
+          result.set(std::move(value));
+          self->evict(evicted);
+        }, madness::TaskAttributes::hipri());
       }
 
       void get_handler(const size_type i, const typename future::remote_refT& ref) {
@@ -92,11 +555,107 @@ namespace TiledArray {
         remote_f.set(f);
       }
 
+      /// Send a compressed element to the process that requested it
+
+      /// \tparam Compressed The compressed element type
+      /// \param i The element key
+      /// \param ref A remote reference to the compressed element future
+      template <typename Compressed>
+      void get_compressed_handler(const size_type i,
+          const typename Future<Compressed>::remote_refT& ref)
+      {
+        future f = get_local(i);
+        Future<Compressed> remote_f(ref);
+        const CodecSettings codec = codec_;
+        get_world().taskq.add([remote_f,codec] (const value_type& value) mutable {
+          remote_f.set(Compressed(value, codec));
+        }, f, madness::TaskAttributes::hipri());
+      }
+
+      /// Set a compressed element sent by another process
+
+      /// The element is decoded and set as if by \c set_handler() .
+      /// \tparam Compressed The compressed element type
+      /// \param i The element key
+      /// \param value The compressed element
+      template <typename Compressed>
+      void set_compressed_handler(const size_type i, const Compressed& value) {
+        set_handler(i, value.decode());
+      }
+
+      /// Remote cache accessor
+
+      /// The cache is owned by the world's deferred cleanup list, so it is
+      /// discarded at the next global fence. Elements that were modified in
+      /// place by their owner before the fence are then fetched again. A new
+      /// cache is started on the first remote request after the fence.
+      /// \param create Create a new cache if there is none
+      /// \return A shared pointer to the cache, which is null when the cache
+      /// is disabled, or when there is none and \c create is \c false
+      std::shared_ptr<cache_type> remote_cache(const bool create) const {
+        if(! cache_max_bytes_)
+          return std::shared_ptr<cache_type>();
+        madness::ScopedMutex<madness::Spinlock> locker(&cache_mutex_);
+        std::shared_ptr<cache_type> cache = cache_.lock();
+        if(! cache && create) {
+          cache = std::make_shared<cache_type>(cache_max_bytes_);
+          madness::detail::deferred_cleanup(get_world(), cache);
+          cache_ = cache;
+        }
+        return cache;
+      }
+
+      void get_remote(const size_type i, const future& result) const {
+        get_remote(i, result, compressible());
+      }
+
+      void get_remote(const size_type i, const future& result, std::false_type) const {
+        // Send a request to the owner of i for the element.
+        WorldObject_::task(owner(i), & DistributedStorage_::get_handler, i,
+            result.remote_ref(get_world()), madness::TaskAttributes::hipri());
+      }
+
+      void get_remote(const size_type i, future result, std::true_type) const {
+        if(! codec_.enabled()) {
+          get_remote(i, result, std::false_type());
+          return;
+        }
+
+        // Request the compressed element, and decode it when it arrives
+        Future<CompressedTile<value_type> > compressed;
+        WorldObject_::task(owner(i),
+            & DistributedStorage_::template get_compressed_handler<CompressedTile<value_type> >,
+            i, compressed.remote_ref(get_world()), madness::TaskAttributes::hipri());
+        get_world().taskq.add([result] (const CompressedTile<value_type>& value) mutable {
+          result.set(value.decode());
+        }, compressed, madness::TaskAttributes::hipri());
+      }
+
+      void invalidate_remote_cache(const size_type i) {
+        std::shared_ptr<cache_type> cache = remote_cache(false);
+        if(cache)
+          cache->invalidate(i);
+      }
+
       void set_remote(const size_type i, const value_type& value) {
+        set_remote(i, value, compressible());
+      }
+
+      void set_remote(const size_type i, const value_type& value, std::false_type) {
         WorldObject_::task(owner(i), & DistributedStorage_::set_handler,
             i, value, madness::TaskAttributes::hipri());
       }
 
+      void set_remote(const size_type i, const value_type& value, std::true_type) {
+        if(codec_.enabled())
+          WorldObject_::task(owner(i),
+              & DistributedStorage_::template set_compressed_handler<CompressedTile<value_type> >,
+              i, CompressedTile<value_type>(value, codec_),
+              madness::TaskAttributes::hipri());
+        else
+          set_remote(i, value, std::false_type());
+      }
+
       struct DelayedSet : public madness::CallbackInterface {
        private:
         DistributedStorage_& ds_;  ///< A reference to the owning object
@@ -130,7 +689,9 @@ namespace TiledArray {
           const std::shared_ptr<pmap_interface>& pmap) :
         WorldObject_(world), max_size_(max_size),
         pmap_(pmap),
-        data_((max_size / world.size()) + 11)
+        data_((max_size / world.size()) + 11),
+        cache_max_bytes_(0ul), cache_(), cache_mutex_(), cache_hits_(0ul),
+        cache_misses_(0ul)
       {
         // Check that the process map is appropriate for this storage object
         TA_ASSERT(pmap_);
@@ -193,18 +754,139 @@ namespace TiledArray {
       /// \throw TiledArray::Exception If \c i is greater than or equal to \c max_size() .
       future get(size_type i) const {
         TA_ASSERT(i < max_size_);
-        if(is_local(i)) {
+        if(is_local(i))
           return get_local(i);
-        } else {
-          // Send a request to the owner of i for the element.
-          future result;
-          WorldObject_::task(owner(i), & DistributedStorage_::get_handler, i,
-              result.remote_ref(get_world()), madness::TaskAttributes::hipri());
 
-          return result;
+        future result;
+        std::shared_ptr<cache_type> cache = remote_cache(true);
+        if(cache) {
+          // Share the future of an earlier request for i, if there is one.
+          if(cache->find_or_insert(i, result)) {
+            cache_hits_++;
+            return result;
+          }
+
+          cache_misses_++;
+          cache_type::track(cache, i, result);
         }
+
+        get_remote(i, result);
+        return result;
+      }
+
+      /// Enable caching of remote elements
+
+      /// When enabled, elements fetched from other nodes with \c get() are
+      /// kept in a local, least-recently-used cache that holds at most
+      /// \c max_bytes bytes, so that repeated requests for the same element
+      /// require one message instead of one per request. Entries are removed
+      /// by \c set() , and the cache is discarded at every global fence, so
+      /// elements that their owner modifies in place between fences are
+      /// fetched again after the next fence.
+      /// \param max_bytes The byte budget of the cache; zero disables it
+      /// \note Elements returned from the cache are shared with other
+      /// requesters, so they must not be modified in place.
+      /// \note This function is not thread safe with respect to \c get() .
+      void enable_remote_cache(const size_type max_bytes) {
+        madness::ScopedMutex<madness::Spinlock> locker(&cache_mutex_);
+        cache_max_bytes_ = max_bytes;
+        cache_.reset();
+      }
+
+      /// Disable caching of remote elements and discard cached elements
+      void disable_remote_cache() { enable_remote_cache(0ul); }
+
+      /// Discard all cached remote elements on this process
+
+      /// Futures that were returned by \c get() remain valid.
+      void clear_remote_cache() {
+        madness::ScopedMutex<madness::Spinlock> locker(&cache_mutex_);
+        cache_.reset();
+      }
+
+      /// Remote cache byte budget accessor
+
+      /// \return The maximum number of bytes held by the remote cache, or
+      /// zero if the cache is disabled.
+      size_type remote_cache_max_bytes() const { return cache_max_bytes_; }
+
+      /// Remote cache size
+
+      /// \return The number of bytes held by remote elements that have
+      /// arrived and are still in the cache
+      size_type remote_cache_bytes() const {
+        std::shared_ptr<cache_type> cache = remote_cache(false);
+        return (cache ? cache->bytes() : 0ul);
+      }
+
+      /// Remote cache hit counter
+
+      /// \return The number of remote requests served from the cache
+      size_type remote_cache_hits() const { return cache_hits_; }
+
+      /// Remote cache miss counter
+
+      /// \return The number of remote requests sent while the cache was enabled
+      size_type remote_cache_misses() const { return cache_misses_; }
+
+      /// Store the local elements out of core
+
+      /// Local elements are written to a node-local file in \c directory once
+      /// they are set, and at most \c max_bytes bytes of them are kept in
+      /// memory. Elements that were evicted from memory are read back from
+      /// the file by a task when they are requested, or when a prefetch hint
+      /// is given with \c prefetch() .
+      /// \param directory The directory of the node-local file
+      /// \param max_bytes The byte budget of the local elements in memory
+      /// \note This function must be called before any local element is set.
+      /// \note Elements may be read back from the file, so they must not be
+      /// modified in place.
+      void enable_out_of_core(const std::string& directory,
+          const size_type max_bytes)
+      {
+        TA_USER_ASSERT(data_.size() == 0ul,
+            "Out-of-core storage must be enabled before tiles are set.");
+        out_of_core_ = std::make_shared<out_of_core_type>(directory, max_bytes);
       }
 
+      /// Check if local elements are stored out of core
+
+      /// \return \c true if \c enable_out_of_core() has been called
+      bool is_out_of_core() const { return static_cast<bool>(out_of_core_); }
+
+      /// Prefetch hint
+
+      /// Start reading element \c i from the out-of-core file, if it is local
+      /// and not in memory, so it is available when it is requested.
+      /// \param i The element that will be requested
+      void prefetch(const size_type i) const {
+        TA_ASSERT(i < max_size_);
+        if(out_of_core_ && is_local(i))
+          get_local(i, false);
+      }
+
+      /// Out-of-core storage statistics
+
+      /// \return The access statistics of the out-of-core storage on this
+      /// process, which are zero if it is not enabled
+      OutOfCoreStatistics out_of_core_statistics() const {
+        return (out_of_core_ ? out_of_core_->statistics() : OutOfCoreStatistics());
+      }
+
+      /// Set the compression of elements sent to other processes
+
+      /// The codec applies to the elements that are sent by remote \c get()
+      /// and \c set() calls. It has no effect when the elements are not
+      /// compressible tiles (see \c is_compressible_tile ).
+      /// \param codec The codec settings
+      /// \note This must be called on all processes with the same settings.
+      void set_codec(const CodecSettings& codec) { codec_ = codec; }
+
+      /// Compression settings accessor
+
+      /// \return The compression of elements sent to other processes
+      const CodecSettings& codec() const { return codec_; }
+
       /// Set element \c i with \c value
 
       /// \param i The element to be set
@@ -213,10 +895,12 @@ namespace TiledArray {
       /// \throw madness::MadnessException If \c i has already been set.
       void set(size_type i, const value_type& value) {
         TA_ASSERT(i < max_size_);
-        if(is_local(i))
+        if(is_local(i)) {
           set_handler(i, value);
-        else
+        } else {
+          invalidate_remote_cache(i);
           set_remote(i, value);
+        }
       }
 
       /// Set element \c i with a \c Future \c f
@@ -244,8 +928,13 @@ namespace TiledArray {
 #endif // NDEBUG
             // Set the future
             existing_f.set(f);
+          } else {
+            acc.release();
           }
+          if(out_of_core_)
+            spill(i, f);
         } else {
+          invalidate_remote_cache(i);
           if(f.probe()) {
             set_remote(i, f);
           } else {
@@ -169,6 +169,19 @@ namespace TiledArray {
         ExprEngine_::init_struct(target_vars);
       }
 
+      /// Reinitialize result tensor structure for new argument data
+
+      /// This function will rebind the leaves of the left- and right-hand
+      /// engines to the arrays of \c expr and recompute the shape of the
+      /// left-hand, right-hand, and result tensor.
+      /// \param expr The expression of this engine
+      template <typename D>
+      void reinit_struct(const Expr<D>& expr) {
+        left_.reinit_struct(expr.derived().left());
+        right_.reinit_struct(expr.derived().right());
+        ExprEngine_::init_shape();
+      }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
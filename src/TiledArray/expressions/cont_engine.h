@@ -35,8 +35,8 @@ namespace TiledArray {
   namespace expressions {
 
     // Forward declarations
-    template <typename, typename> class MultExpr;
-    template <typename, typename, typename> class ScalMultExpr;
+    template <typename, typename, typename = void> class MultExpr;
+    template <typename, typename, typename, typename = void> class ScalMultExpr;
 
     /// Multiplication expression engine
 
@@ -61,10 +61,26 @@ namespace TiledArray {
           value_type; ///< The result tile type
       typedef typename EngineTrait<Derived>::scalar_type
           scalar_type; ///< Tile scalar type
+      typedef typename eval_trait<typename left_type::value_type>::type
+          left_eval_type; ///< The left-hand argument tile type
+      typedef typename eval_trait<typename right_type::value_type>::type
+          right_eval_type; ///< The right-hand argument tile type
+
+      // Argument tensors with a different element type than the result, e.g.
+      // the single precision arguments of a double precision result, are
+      // converted to the result type once per tile, so the products are
+      // accumulated in the precision of the result.
+      typedef typename std::conditional<
+          TiledArray::detail::is_mixed_precision<left_eval_type, value_type>::value,
+          value_type, left_eval_type>::type
+          left_argument_type; ///< The left-hand tile type of the contraction
+      typedef typename std::conditional<
+          TiledArray::detail::is_mixed_precision<right_eval_type, value_type>::value,
+          value_type, right_eval_type>::type
+          right_argument_type; ///< The right-hand tile type of the contraction
       typedef TiledArray::detail::ContractReduce<value_type,
-          typename eval_trait<typename left_type::value_type>::type,
-          typename eval_trait<typename right_type::value_type>::type,
-          scalar_type> op_type; ///< The tile operation type
+          left_argument_type, right_argument_type, scalar_type>
+          op_type; ///< The tile operation type
       typedef typename EngineTrait<Derived>::policy
           policy; ///< The result policy type
       typedef typename EngineTrait<Derived>::dist_eval_type
@@ -132,9 +148,10 @@ namespace TiledArray {
 
       /// \tparam L The left-hand argument expression type
       /// \tparam R The right-hand argument expression type
+      /// \tparam T The expression result tile type
       /// \param expr The parent expression
-      template <typename L, typename R>
-      ContEngine(const MultExpr<L, R>& expr) :
+      template <typename L, typename R, typename T>
+      ContEngine(const MultExpr<L, R, T>& expr) :
         BinaryEngine_(expr), factor_(1), left_vars_(), right_vars_(),
         left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
         proc_grid_(), K_(1u)
@@ -145,9 +162,10 @@ namespace TiledArray {
       /// \tparam L The left-hand argument expression type
       /// \tparam R The right-hand argument expression type
       /// \tparam S The expression scalar type
+      /// \tparam T The expression result tile type
       /// \param expr The parent expression
-      template <typename L, typename R, typename S>
-      ContEngine(const ScalMultExpr<L, R, S>& expr) :
+      template <typename L, typename R, typename S, typename T>
+      ContEngine(const ScalMultExpr<L, R, S, T>& expr) :
         BinaryEngine_(expr), factor_(expr.factor()), left_vars_(), right_vars_(),
         left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
         proc_grid_(), K_(1u)
@@ -358,10 +376,25 @@ namespace TiledArray {
       /// for the result tensor as well as the tile operation.
       /// \param target_vars The target variable list for the result tensor
       void init_struct(const VariableList& target_vars) {
+        // Arguments that are permuted to fit the GEMM are contracted directly
+        // from their original tile layout, when the tile types support it,
+        // instead of forming permuted copies of the argument tiles.
+        const bool fuse_left = op_type::fuse_permute &&
+            (left_op_ == permute_to_no_trans) && (left_vars_ != left_.vars());
+        const bool fuse_right = op_type::fuse_permute &&
+            (right_op_ == permute_to_no_trans) && (right_vars_ != right_.vars());
+        if(fuse_left)
+          left_.permute_tiles(false);
+        if(fuse_right)
+          right_.permute_tiles(false);
+
         // Initialize children
         left_.init_struct(left_vars_);
         right_.init_struct(right_vars_);
 
+        const Permutation left_perm = (fuse_left ? left_.perm() : Permutation());
+        const Permutation right_perm = (fuse_right ? right_.perm() : Permutation());
+
         // Initialize the tile operation in this function because it is used to
         // evaluate the tiled range and shape.
 
@@ -371,17 +404,24 @@ namespace TiledArray {
             (right_op_ == trans ? madness::cblas::Trans : madness::cblas::NoTrans);
 
 
+        // Select the maximum number of tile pairs that are contracted together
+        const std::size_t batch_size =
+            (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->batch_size ?
+            ExprEngine_::override_ptr_->batch_size :
+            op_type::default_batch_size);
+
         if(target_vars != vars_) {
           // Initialize permuted structure
           perm_ = ExprEngine_::make_perm(target_vars);
           op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
-              right_vars_.dim(), (permute_tiles_ ? perm_ : Permutation()));
+              right_vars_.dim(), (permute_tiles_ ? perm_ : Permutation()),
+              batch_size, left_perm, right_perm);
           trange_ = ContEngine_::make_trange(perm_);
           shape_ = ContEngine_::make_shape(perm_);
         } else {
           // Initialize non-permuted structure
           op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
-              right_vars_.dim());
+              right_vars_.dim(), Permutation(), batch_size, left_perm, right_perm);
           trange_ = ContEngine_::make_trange();
           shape_ = ContEngine_::make_shape();
         }
@@ -414,21 +454,32 @@ namespace TiledArray {
             right_.trange().elements_range().extent_data();
 
         // Compute the fused sizes of the contraction
-        size_type M = 1ul, m = 1ul, N = 1ul, n = 1ul;
+        size_type M = 1ul, m = 1ul, N = 1ul, n = 1ul, k = 1ul;
         unsigned int i = 0u;
         for(; i < left_outer_rank; ++i) {
           M *= left_tiles_size[i];
           m *= left_element_size[i];
         }
-        for(; i < left_rank; ++i)
+        for(; i < left_rank; ++i) {
           K_ *= left_tiles_size[i];
+          k *= left_element_size[i];
+        }
         for(i = inner_rank; i < right_rank; ++i) {
           N *= right_tiles_size[i];
           n *= right_element_size[i];
         }
 
+        // Select the number of process grid layers, which is either set by the
+        // user or minimizes the communication cost.
+        size_type layers =
+            (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->layers ?
+            ExprEngine_::override_ptr_->layers :
+            TiledArray::detail::ProcGrid::optimal_layers(world->size(), M, N,
+                K_, m, n, k));
+        layers = std::min(layers, K_);
+
         // Construct the process grid.
-        proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+        proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n, layers);
 
         // Initialize children
         left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
@@ -534,7 +585,8 @@ namespace TiledArray {
 
         std::shared_ptr<impl_type> pimpl =
             std::make_shared<impl_type>(left, right, *world_, trange_, shape_,
-                                        pmap_, perm_, op_, K_, proc_grid_);
+                                        pmap_, perm_, op_, K_, proc_grid_,
+                                        ExprEngine_::symmetry_);
 
         return dist_eval_type(pimpl);
       }
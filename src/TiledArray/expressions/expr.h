@@ -28,6 +28,7 @@
 
 #include "expr_engine.h"
 #include "../reduce_task.h"
+#include "../tile_interface/add.h"
 #include "../tile_interface/cast.h"
 #include "../tile_interface/scale.h"
 #include "../tile_op/shift.h"
@@ -49,11 +50,14 @@ namespace TiledArray {
     template <typename, bool> class TsrExpr;
     template <typename, bool> class BlkTsrExpr;
     template <typename> struct is_aliased;
+    template <typename, typename> class ExprPlan;
+    template <typename> class ProductPlan;
 
     template <typename Engine>
     struct EngineParamOverride {
 
-      EngineParamOverride() : world(nullptr), pmap(), shape(nullptr) {}
+      EngineParamOverride() : world(nullptr), pmap(), shape(nullptr), layers(0u),
+        batch_size(0u) {}
 
       typedef typename EngineTrait<Engine>::policy policy; ///< The result policy type
       typedef typename EngineTrait<Engine>::shape_type shape_type; ///< Tensor shape type
@@ -62,6 +66,8 @@ namespace TiledArray {
        World* world;
        std::shared_ptr<pmap_interface> pmap;
        const shape_type* shape;
+       unsigned int layers; ///< Number of contraction process grid layers (0 = automatic)
+       unsigned int batch_size; ///< Maximum number of tile pairs contracted together (0 = default)
     };
 
     /// \brief type trait checks if T has array() member
@@ -104,6 +110,113 @@ namespace TiledArray {
           override_type; ///< Expression engine parameters
       std::shared_ptr<override_type> override_ptr_;
 
+      template <typename, typename>
+      friend class ExprPlan;
+
+      /// Initialize the engine of this expression for assignment to \c tsr
+
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param engine The engine of this expression
+      /// \param tsr The tensor to be assigned
+      template <typename A, bool Alias>
+      void init_engine(engine_type& engine, const TsrExpr<A, Alias>& tsr) const {
+        // Get the target world
+        // 1. result's world is assigned, use it
+        // 2. if this expression's world was assigned by set_world(), use it
+        // 3. otherwise revert to the TA default for the MADNESS world
+        const auto has_set_world = override_ptr_ && override_ptr_->world;
+        World& world = (tsr.array().is_initialized() ?
+            tsr.array().world() :
+            (has_set_world ? *override_ptr_->world : TiledArray::get_default_world()));
+
+        // Get the output process map.
+        // If result's pmap is assigned use it as the initial guess
+        // it will be assigned in engine.init
+        std::shared_ptr<typename TsrExpr<A, Alias>::array_type::pmap_interface> pmap;
+        if(tsr.array().is_initialized())
+          pmap = tsr.array().pmap();
+
+        // Get result variable list.
+        VariableList target_vars(tsr.vars());
+
+        engine.init(world, pmap, target_vars);
+
+        // Only the canonical tiles of a result with a tile symmetry are
+        // evaluated
+        if(tsr.array().is_initialized())
+          engine.init_symmetry(tsr.array().symmetry());
+      }
+
+      /// Launch the evaluation of an initialized engine and assign the result to \c tsr
+
+      /// The tiles of \c tsr are futures that are set as the evaluation
+      /// progresses. The returned distributed evaluator must be kept alive
+      /// until all of its local tiles have been set (see
+      /// \c DistEval::done() ).
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param engine The initialized engine of this expression
+      /// \param tsr The tensor to be assigned
+      /// \return The distributed evaluator of this expression
+      template <typename A, bool Alias>
+      typename engine_type::dist_eval_type
+      launch_engine_to(const engine_type& engine, TsrExpr<A, Alias>& tsr) const {
+        // Create the distributed evaluator from this expression
+        typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+        dist_eval.eval();
+
+        // Create the result array
+        A result(dist_eval.world(), dist_eval.trange(),
+            dist_eval.shape(), dist_eval.pmap());
+        if(engine.symmetry())
+          result.set_symmetry(*engine.symmetry());
+
+        // Move the data from dist_eval into the result array. There is no
+        // communication in this step.
+        for(const auto index : *dist_eval.pmap()) {
+          if(! dist_eval.is_zero(index) && result.is_canonical(index))
+            set_tile(result, index, dist_eval.get(index));
+        }
+
+        // Swap the new array with the result array object.
+        result.swap(tsr.array());
+
+        return dist_eval;
+      }
+
+      /// Start the evaluation of an initialized engine and assign the result to \c tsr
+
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param engine The initialized engine of this expression
+      /// \param tsr The tensor to be assigned
+      /// \return A future that is set when this process has evaluated all of
+      /// its tiles of the result
+      template <typename A, bool Alias>
+      Future<bool> eval_engine_to_async(const engine_type& engine,
+          TsrExpr<A, Alias>& tsr) const
+      {
+        // The distributed evaluator is held by a task until all of its local
+        // tiles have been set.
+        typename engine_type::dist_eval_type dist_eval =
+            launch_engine_to(engine, tsr);
+        return dist_eval.world().taskq.add(
+            [dist_eval] (const bool) { return true; }, dist_eval.done());
+      }
+
+      /// Evaluate an initialized engine and assign the result to \c tsr
+
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param engine The initialized engine of this expression
+      /// \param tsr The tensor to be assigned
+      template <typename A, bool Alias>
+      void eval_engine_to(const engine_type& engine, TsrExpr<A, Alias>& tsr) const {
+        // Wait for child expressions of dist_eval
+        launch_engine_to(engine, tsr).wait();
+      }
+
     public:
       /// \param shape the shape to use for the result
      /// \internal \c shape is taken by const reference, but converted to a
@@ -141,6 +254,38 @@ namespace TiledArray {
         return derived();
       }
 
+      /// Set the number of process grid layers of a contraction
+
+      /// The inner dimension of the contraction is split among the layers,
+      /// and the result is summed on the first layer (see \c ProcGrid ).
+      /// \param layers the number of process grid layers used to evaluate a
+      /// contraction; 1 selects the 2D (SUMMA) algorithm, and 0 (the default)
+      /// selects the number of layers with a communication cost model.
+      /// \note This has no effect on expressions that are not contractions.
+      Expr<Derived>& set_contraction_layers(const unsigned int layers) {
+        if (override_ptr_) {
+          override_ptr_->layers = layers;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->layers = layers;
+        }
+        return derived();
+      }
+      /// \param batch_size the maximum number of tile pairs that contribute to
+      /// the same result tile that are contracted together, with a single
+      /// GEMM when the tiles are small; 1 contracts each pair separately, and
+      /// 0 (the default) selects the default batch size.
+      /// \note This has no effect on expressions that are not contractions.
+      Expr<Derived>& set_contraction_batch_size(const unsigned int batch_size) {
+        if (override_ptr_) {
+          override_ptr_->batch_size = batch_size;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->batch_size = batch_size;
+        }
+        return derived();
+      }
+
     private:
 
       /// Task function used to evaluate a lazy tile and apply an op
@@ -350,6 +495,48 @@ namespace TiledArray {
       }
 #endif
 
+      /// Convert a future tile that has the type of the array tiles
+
+      /// \tparam Tile The array tile type
+      /// \param tile The tile
+      /// \return \c tile
+      template <typename Tile>
+      static Future<Tile> convert_tile(World&, const Future<Tile>& tile) {
+        return tile;
+      }
+
+      /// Convert a future (lazy) tile to the type of the array tiles
+
+      /// Spawn a task to evaluate the tile.
+      /// \tparam Tile The array tile type
+      /// \tparam T The tile type
+      /// \param world The world where the task is run
+      /// \param tile The tile
+      /// \return The converted tile
+      template <typename Tile, typename T,
+          typename std::enable_if<! std::is_same<Tile, T>::value>::type* = nullptr>
+      static Future<Tile> convert_tile(World& world, const Future<T>& tile) {
+        return world.taskq.add(TiledArray::Cast<Tile, T>(), tile);
+      }
+
+      /// Task function used to add a tile to an array tile
+
+      /// \tparam Tile The array tile type
+      /// \param target The array tile
+      /// \param arg The tile that is added, which is owned by this task
+      /// \param in_place \c true if \c target may be modified
+      /// \return The sum of \c target and \c arg
+      template <typename Tile>
+      static Tile accumulate_tile(Tile& target, Tile& arg, const bool in_place) {
+        using TiledArray::add_to;
+        if(in_place) {
+          add_to(target, arg);
+          return target;
+        }
+        add_to(arg, target);
+        return arg;
+      }
+
      public:
 
       // Compiler generated functions
@@ -370,7 +557,12 @@ namespace TiledArray {
 
       /// This expression is evaluated in parallel in distributed environments,
       /// where the content of \c tsr will be replaced by the results of the
-      /// evaluated tensor expression.
+      /// evaluated tensor expression. The products of a sum of products of
+      /// arrays are evaluated in the order with the smallest estimated cost,
+      /// and sub-products shared by several terms are evaluated once, when
+      /// that is cheaper than the expression as written, and the terms of
+      /// such a sum of more than two terms are accumulated directly into the
+      /// result tiles (see \c ProductPlan ).
       /// \tparam A The array type
       /// \tparam Alias Tile alias flag
       /// \param tsr The tensor to be assigned
@@ -379,48 +571,149 @@ namespace TiledArray {
         static_assert(! is_lazy_tile<typename A::value_type>::value,
             "Assignment to an array of lazy tiles is not supported.");
 
-        // Get the target world
-        // 1. result's world is assigned, use it
-        // 2. if this expression's world was assigned by set_world(), use it
-        // 3. otherwise revert to the TA default for the MADNESS world
-        const auto has_set_world = override_ptr_ && override_ptr_->world;
-        World& world = (tsr.array().is_initialized() ?
-            tsr.array().world() :
-            (has_set_world ? *override_ptr_->world : TiledArray::get_default_world()));
+        // Evaluate the products in a cheaper order, or with shared
+        // sub-products, and accumulate long sums directly, when possible
+        if(! override_ptr_) {
+          eval_to(tsr, ProductPlan<A>(tsr, derived()));
+          return;
+        }
 
-        // Get the output process map.
-        // If result's pmap is assigned use it as the initial guess
-        // it will be assigned in engine.init
-        std::shared_ptr<typename TsrExpr<A, Alias>::array_type::pmap_interface> pmap;
-        if(tsr.array().is_initialized())
-          pmap = tsr.array().pmap();
+        // Construct the expression engine
+        engine_type engine(derived());
+        init_engine(engine, tsr);
 
-        // Get result variable list.
-        VariableList target_vars(tsr.vars());
+        eval_engine_to(engine, tsr);
+      }
+
+      /// Evaluate this object with a product plan and assign it to \c tsr
+
+      /// The expression is evaluated by \c plan when that is beneficial, and
+      /// as written otherwise, so a plan that was already built for this
+      /// expression is not built again.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor to be assigned
+      /// \param plan The product plan of this expression and \c tsr
+      template <typename A, bool Alias>
+      void eval_to(TsrExpr<A, Alias>& tsr, const ProductPlan<A>& plan) const {
+        static_assert(! is_lazy_tile<typename A::value_type>::value,
+            "Assignment to an array of lazy tiles is not supported.");
+        if(plan.is_beneficial()) {
+          plan.eval(tsr);
+          return;
+        }
 
         // Construct the expression engine
         engine_type engine(derived());
-        engine.init(world, pmap, target_vars);
+        init_engine(engine, tsr);
 
-        // Create the distributed evaluator from this expression
+        eval_engine_to(engine, tsr);
+      }
+
+      /// Evaluate this object and add it to \c tsr
+
+      /// The tiles of this expression are evaluated with the process map of
+      /// \c tsr , and each tile is added to the local tile of \c tsr with the
+      /// same index as soon as it is evaluated, so the result of this
+      /// expression is not stored in a temporary array. The shape of \c tsr
+      /// is extended with the non-zero tiles of this expression. The tiles of
+      /// \c tsr are modified in place when they are not shared with another
+      /// array, i.e. when \c tsr is flagged with \c no_alias() or the array
+      /// of \c tsr is unique (see \c DistArray::is_unique() ); otherwise the
+      /// tiles of \c tsr are added to the tiles of this expression. Each
+      /// tile is added once it is complete, e.g. after all tile products of a
+      /// contraction have been reduced, rather than seeding the reduction with
+      /// the tile of \c tsr : this holds at most one temporary tile per result
+      /// tile, and keeps the evaluators, which are shared by all expressions,
+      /// independent of the target.
+      /// \note Tiles of the array of \c tsr that were obtained before the
+      /// assignment, e.g. with \c DistArray::find() , may be modified.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor that is incremented
+      /// \return \c true if this expression was added to \c tsr , or
+      /// \c false if it must be evaluated as a sum with \c tsr , because
+      /// \c tsr is not initialized, has a tile symmetry, or is not
+      /// distributed like this expression, or this expression overrides the
+      /// engine parameters
+      template <typename A, bool Alias>
+      bool accumulate_to(TsrExpr<A, Alias>& tsr) const {
+        static_assert(! is_lazy_tile<typename A::value_type>::value,
+            "Assignment to an array of lazy tiles is not supported.");
+        typedef typename A::value_type value_type;
+
+#ifdef TILEDARRAY_HAS_CUDA
+        if(::TiledArray::detail::is_cuda_tile<value_type>::value)
+          return false;
+#endif // TILEDARRAY_HAS_CUDA
+        A& target = tsr.array();
+        if(override_ptr_ || ! target.is_initialized() || target.symmetry())
+          return false;
+
+        // Construct the distributed evaluator with the process map of tsr
+        engine_type engine(derived());
+        engine.init(target.world(), target.pmap(), VariableList(tsr.vars()));
         typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+        if((dist_eval.pmap() != target.pmap()) ||
+            (dist_eval.trange() != target.trange()))
+          return false;
+
+        // The engine holds copies of the arguments, so this also checks that
+        // tsr is not an argument of this expression.
+        const bool in_place = (! Alias) || target.is_unique();
         dist_eval.eval();
 
-        // Create the result array
         A result(dist_eval.world(), dist_eval.trange(),
-            dist_eval.shape(), dist_eval.pmap());
-
-        // Move the data from dist_eval into the result array. There is no
-        // communication in this step.
+            target.shape().add(dist_eval.shape()), dist_eval.pmap());
+        World& world = dist_eval.world();
         for(const auto index : *dist_eval.pmap()) {
-          if(! dist_eval.is_zero(index))
+          const bool is_zero = dist_eval.is_zero(index);
+          if(result.is_zero(index)) {
+            if(! is_zero)
+              dist_eval.discard(index);
+          } else if(is_zero) {
+            result.set(index, target.find(index));
+          } else if(target.is_zero(index)) {
             set_tile(result, index, dist_eval.get(index));
+          } else {
+            result.set(index, world.taskq.add(
+                & Expr_::template accumulate_tile<value_type>,
+                target.find(index),
+                convert_tile<value_type>(world, dist_eval.get(index)),
+                in_place));
+          }
         }
 
-        // Wait for child expressions of dist_eval
+        // Swap the new array with the target array object.
+        result.swap(target);
+
         dist_eval.wait();
-        // Swap the new array with the result array object.
-        result.swap(tsr.array());
+        return true;
+      }
+
+      /// Start the evaluation of this object and assign it to \c tsr
+
+      /// This function returns without waiting for the tiles of the result
+      /// to be evaluated, so the evaluation of independent expressions can
+      /// overlap. The content of \c tsr is replaced immediately with an
+      /// array with the structure of the result, whose tiles are set as they
+      /// are evaluated. The evaluation of subexpressions may still block until
+      /// the tiles of their arguments are available.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor to be assigned
+      /// \return A future that is set when this process has evaluated all of
+      /// its tiles of the result
+      template <typename A, bool Alias>
+      Future<bool> eval_to_async(TsrExpr<A, Alias>& tsr) const {
+        static_assert(! is_lazy_tile<typename A::value_type>::value,
+            "Assignment to an array of lazy tiles is not supported.");
+
+        // Construct the expression engine
+        engine_type engine(derived());
+        init_engine(engine, tsr);
+
+        return eval_engine_to_async(engine, tsr);
       }
 
 
@@ -0,0 +1,207 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  expr_batch.h
+ *  Apr 12, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_BATCH_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_BATCH_H__INCLUDED
+
+#include <TiledArray/expressions/tsr_expr.h>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// A batch of expression assignments that are evaluated concurrently
+
+    /// Assignments are added to the batch in program order and submitted
+    /// together with \c submit() . The batch finds the dependencies between
+    /// the assignments from the arrays that they read and write: an
+    /// assignment depends on an earlier assignment if it reads the array
+    /// written by it, if it writes an array read by it, or if both write the
+    /// same array. The assignments are then started asynchronously (see
+    /// \c TsrExpr::assign_async() ), level by level, so all independent
+    /// assignments are started before any assignment that has to wait for
+    /// the result of another one. The result is the same as assigning the
+    /// expressions in program order.
+    /// \note Arrays are identified by the address of the array objects, and
+    /// the batch holds references to them, so they must outlive the call to
+    /// \c submit() . All processes must add the same assignments in the same
+    /// order.
+    class ExprBatch {
+    public:
+      typedef ExprBatch ExprBatch_; ///< This class type
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+
+      /// An assignment and the arrays it accesses
+      struct Assignment {
+        const void* result; ///< The assigned array
+        std::vector<const void*> args; ///< The argument arrays
+        std::function<Future<bool>()> launch; ///< Starts the assignment
+      }; // struct Assignment
+
+      std::vector<Assignment> assignments_; ///< The assignments of this batch
+
+      // Argument array collection
+
+      template <typename A, bool Alias>
+      static void collect_args(const TsrExpr<A, Alias>& expr,
+          std::vector<const void*>& args)
+      { args.push_back(&expr.array()); }
+
+      template <typename A, typename S>
+      static void collect_args(const ScalTsrExpr<A, S>& expr,
+          std::vector<const void*>& args)
+      { args.push_back(&expr.array()); }
+
+      template <typename D>
+      static void collect_args(const BlkTsrExprBase<D>& expr,
+          std::vector<const void*>& args)
+      { args.push_back(&expr.array()); }
+
+      template <typename D>
+      static void collect_args(const UnaryExpr<D>& expr,
+          std::vector<const void*>& args)
+      { collect_args(expr.arg(), args); }
+
+      template <typename D>
+      static void collect_args(const BinaryExpr<D>& expr,
+          std::vector<const void*>& args)
+      {
+        collect_args(expr.left(), args);
+        collect_args(expr.right(), args);
+      }
+
+      /// Check for a dependency between two assignments
+
+      /// \param first An assignment
+      /// \param second An assignment that follows \c first in program order
+      /// \return \c true if \c second must be started after \c first
+      static bool depends(const Assignment& first, const Assignment& second) {
+        return (first.result == second.result) ||
+            (std::find(second.args.begin(), second.args.end(), first.result)
+              != second.args.end()) ||
+            (std::find(first.args.begin(), first.args.end(), second.result)
+              != first.args.end());
+      }
+
+    public:
+
+      // Compiler generated functions
+      ExprBatch() = default;
+      ExprBatch(const ExprBatch_&) = delete;
+      ExprBatch(ExprBatch_&&) = default;
+      ~ExprBatch() = default;
+      ExprBatch_& operator=(const ExprBatch_&) = delete;
+      ExprBatch_& operator=(ExprBatch_&&) = default;
+
+      /// Add an assignment to the batch
+
+      /// \tparam A The result array type
+      /// \tparam Alias Tile alias flag
+      /// \tparam D The argument expression type
+      /// \param result The tensor expression that is assigned
+      /// \param arg The expression that is evaluated
+      template <typename A, bool Alias, typename D>
+      void add(const TsrExpr<A, Alias>& result, const Expr<D>& arg) {
+        static_assert(TiledArray::expressions::is_aliased<D>::value,
+            "no_alias() expressions are not allowed on the right-hand side of "
+            "the assignment operator.");
+
+        Assignment assignment;
+        assignment.result = &result.array();
+        collect_args(arg.derived(), assignment.args);
+        TsrExpr<A, Alias> tsr(result);
+        const D expr(arg.derived());
+        assignment.launch = [tsr, expr] () mutable {
+          return tsr.assign_async(expr);
+        };
+        assignments_.push_back(std::move(assignment));
+      }
+
+      /// The number of assignments in the batch
+
+      /// \return The number of assignments that have not been submitted
+      size_type size() const { return assignments_.size(); }
+
+      /// Check for an empty batch
+
+      /// \return \c true if there are no assignments to submit
+      bool empty() const { return assignments_.empty(); }
+
+      /// Dependency levels of the assignments
+
+      /// Assignments at level 0 do not depend on other assignments of the
+      /// batch, and an assignment at level \c n depends on at least one
+      /// assignment at level <tt>n - 1</tt>.
+      /// \return The level of each assignment, in the order they were added
+      std::vector<size_type> levels() const {
+        std::vector<size_type> result(assignments_.size(), 0ul);
+        for(size_type j = 0ul; j < assignments_.size(); ++j)
+          for(size_type i = 0ul; i < j; ++i)
+            if(depends(assignments_[i], assignments_[j]))
+              result[j] = std::max(result[j], result[i] + 1ul);
+        return result;
+      }
+
+      /// Start the assignments of the batch
+
+      /// The assignments are started in the order of their levels, and in
+      /// program order within a level. The batch is empty after this call.
+      /// \return A future for each assignment, in the order they were added,
+      /// that is set when this process has evaluated all of its tiles of the
+      /// result
+      std::vector<Future<bool> > submit() {
+        const std::vector<size_type> level = levels();
+        std::vector<size_type> order(assignments_.size());
+        std::iota(order.begin(), order.end(), 0ul);
+        std::stable_sort(order.begin(), order.end(),
+            [&level] (const size_type i, const size_type j)
+            { return level[i] < level[j]; });
+
+        std::vector<Future<bool> > done(assignments_.size());
+        for(const size_type i : order)
+          done[i] = assignments_[i].launch();
+
+        assignments_.clear();
+        return done;
+      }
+
+      /// Start the assignments of the batch and wait for them
+
+      /// \return The number of assignments that were evaluated
+      size_type eval() {
+        std::vector<Future<bool> > done = submit();
+        for(auto& d : done)
+          d.get();
+        return done.size();
+      }
+
+    }; // class ExprBatch
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EXPR_BATCH_H__INCLUDED
@@ -28,6 +28,7 @@
 
 #include <TiledArray/external/madness.h>
 #include <TiledArray/expressions/expr_trace.h>
+#include <TiledArray/symm/tile_symmetry.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -68,6 +69,7 @@ namespace TiledArray {
       shape_type shape_; ///< The shape of the result tensor
       std::shared_ptr<pmap_interface> pmap_; ///< The process map for the result tensor
       std::shared_ptr<EngineParamOverride<Derived> > override_ptr_; ///< The engine params overriding the default
+      std::shared_ptr<const symmetry::TileSymmetry> symmetry_; ///< The tile symmetry of the result (may be null)
 
     public:
 
@@ -77,7 +79,7 @@ namespace TiledArray {
       template <typename D>
       ExprEngine(const Expr<D> &expr) :
         world_(NULL), vars_(), permute_tiles_(true), perm_(), trange_(), shape_(),
-        pmap_(), override_ptr_(expr.override_ptr_)
+        pmap_(), override_ptr_(expr.override_ptr_), symmetry_()
       { }
 
       /// Construct and initialize the expression engine
@@ -141,6 +143,19 @@ namespace TiledArray {
           shape_ = shape_.mask(*override_ptr_->shape);
       }
 
+      /// Reinitialize the result shape
+
+      /// This function recomputes the shape of the result tensor with the
+      /// permutation, tiled range, and tile operation that were initialized
+      /// by \c init_struct(). It is used to reevaluate an initialized engine
+      /// after the shapes of the arguments have changed.
+      void init_shape() {
+        shape_ = (perm_ ? derived().make_shape(perm_) : derived().make_shape());
+
+        if(override_ptr_ && override_ptr_->shape)
+          shape_ = shape_.mask(*override_ptr_->shape);
+      }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
@@ -218,6 +233,29 @@ namespace TiledArray {
       /// \return A const reference to the process map
       const std::shared_ptr<pmap_interface>& pmap() const { return pmap_; }
 
+      /// Set the tile symmetry of the result
+
+      /// Only the canonical tiles of the result must be evaluated. This is
+      /// only set for the engine at the root of the expression graph, after
+      /// it is initialized.
+      /// \param symmetry The tile symmetry of the result
+      /// \throw TiledArray::Exception When \c symmetry is not compatible with
+      /// the tiled range of the result
+      void init_symmetry(const std::shared_ptr<const symmetry::TileSymmetry>& symmetry) {
+        if(symmetry && ! symmetry->is_compatible(trange_))
+          TA_EXCEPTION("The tile symmetry of the result is not compatible with "
+                       "the tiled range of the expression.");
+        symmetry_ = symmetry;
+      }
+
+      /// Tile symmetry accessor
+
+      /// \return A pointer to the tile symmetry of the result, which is null
+      /// when all result tiles are evaluated
+      const std::shared_ptr<const symmetry::TileSymmetry>& symmetry() const {
+        return symmetry_;
+      }
+
       /// Set the permute tiles flag
 
       /// \param status The new status for permute tiles (true == permtue result tiles)
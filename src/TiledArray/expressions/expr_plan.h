@@ -0,0 +1,145 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  expr_plan.h
+ *  Apr 9, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
+
+#include <TiledArray/expressions/tsr_expr.h>
+#include <memory>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// A compiled expression assignment
+
+    /// An expression plan performs the structural setup of the assignment
+    /// <tt>result = arg</tt> once: the variable lists are parsed, and the
+    /// engine tree, with its permutations, tiled ranges, tile operations,
+    /// process grids, and process maps, is constructed and initialized. Each
+    /// call to \c eval() then evaluates the expression with the current
+    /// content of its argument arrays, and only the shapes, which depend on
+    /// the data, are recomputed. This removes the setup cost from expressions
+    /// that are evaluated repeatedly, e.g. in iterative solvers.
+    /// \note The plan references the arrays of \c result and \c arg , which
+    /// must outlive it. The arrays may be reassigned between evaluations,
+    /// provided their tiled ranges do not change. Scaling factors are fixed
+    /// when the plan is constructed.
+    /// \tparam Result The result tensor expression type
+    /// \tparam Arg The argument expression type
+    template <typename Result, typename Arg>
+    class ExprPlan {
+    public:
+      typedef ExprPlan<Result, Arg> ExprPlan_; ///< This class type
+      typedef Result result_type; ///< The result tensor expression type
+      typedef Arg argument_type; ///< The argument expression type
+      typedef typename Arg::engine_type engine_type; ///< Expression engine type
+      typedef typename engine_type::trange_type trange_type; ///< Tiled range type
+      typedef typename engine_type::shape_type shape_type; ///< Shape type
+      typedef typename engine_type::pmap_interface pmap_interface; ///< Process map interface type
+
+    private:
+
+      result_type result_; ///< The result tensor expression
+      argument_type arg_; ///< The argument expression
+      std::unique_ptr<engine_type> engine_; ///< The initialized engine of \c arg_
+
+    public:
+
+      // Compiler generated functions
+      ExprPlan() = delete;
+      ExprPlan(const ExprPlan_&) = delete;
+      ExprPlan(ExprPlan_&&) = default;
+      ~ExprPlan() = default;
+      ExprPlan_& operator=(const ExprPlan_&) = delete;
+      ExprPlan_& operator=(ExprPlan_&&) = delete;
+
+      /// Constructor
+
+      /// \param result The tensor expression that is assigned
+      /// \param arg The expression that is evaluated
+      ExprPlan(const result_type& result, const argument_type& arg) :
+        result_(result), arg_(arg), engine_(new engine_type(arg_))
+      {
+        static_assert(! is_lazy_tile<typename result_type::array_type::value_type>::value,
+            "Assignment to an array of lazy tiles is not supported.");
+        static_assert(TiledArray::expressions::is_aliased<Arg>::value,
+            "no_alias() expressions are not allowed on the right-hand side of "
+            "the assignment operator.");
+        static_cast<const Expr<Arg>&>(arg_).init_engine(*engine_, result_);
+      }
+
+      /// Evaluate the expression and assign it to the result
+
+      /// The shapes of the engine tree are recomputed from the current
+      /// arguments, which must have the tiled ranges of the arguments that
+      /// were used to construct this plan.
+      /// \return A reference to the result array
+      typename result_type::array_type& eval() {
+        engine_->reinit_struct(arg_);
+        static_cast<const Expr<Arg>&>(arg_).eval_engine_to(*engine_, result_);
+        return result_.array();
+      }
+
+      /// Start the evaluation of the expression and assign it to the result
+
+      /// This is the asynchronous version of \c eval() (see
+      /// \c TsrExpr::assign_async() ).
+      /// \return A future that is set when this process has evaluated all of
+      /// its tiles of the result
+      Future<bool> eval_async() {
+        engine_->reinit_struct(arg_);
+        return static_cast<const Expr<Arg>&>(arg_).eval_engine_to_async(
+            *engine_, result_);
+      }
+
+      /// Result tiled range accessor
+
+      /// \return A const reference to the result tiled range
+      const trange_type& trange() const { return engine_->trange(); }
+
+      /// Result process map accessor
+
+      /// \return A const reference to the result process map
+      const std::shared_ptr<pmap_interface>& pmap() const {
+        return engine_->pmap();
+      }
+
+    }; // class ExprPlan
+
+    /// Construct an expression plan
+
+    /// \tparam A The result array type
+    /// \tparam Alias Tile alias flag
+    /// \tparam D The argument expression type
+    /// \param result The tensor expression that is assigned
+    /// \param arg The expression that is evaluated
+    /// \return A plan that evaluates <tt>result = arg</tt>
+    template <typename A, bool Alias, typename D>
+    inline ExprPlan<TsrExpr<A, Alias>, D>
+    make_plan(const TsrExpr<A, Alias>& result, const Expr<D>& arg) {
+      return ExprPlan<TsrExpr<A, Alias>, D>(result, arg.derived());
+    }
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
@@ -119,6 +119,19 @@ namespace TiledArray {
       /// This function is a noop since the variable list is fixed.
       void init_vars() { }
 
+      /// Reinitialize the result structure for new array data
+
+      /// The array of this engine is replaced with the array of \c expr ,
+      /// which must have the same tiled range, and the result shape is
+      /// recomputed.
+      /// \param expr The argument expression
+      template <typename D>
+      void reinit_struct(const Expr<D>& expr) {
+        TA_ASSERT(expr.derived().array().trange() == array_.trange());
+        array_ = expr.derived().array();
+        ExprEngine_::init_shape();
+      }
+
       void init_distribution(World* world,
           const std::shared_ptr<pmap_interface>& pmap)
       {
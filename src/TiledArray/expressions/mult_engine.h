@@ -35,8 +35,8 @@ namespace TiledArray {
   namespace expressions {
 
     // Forward declarations
-    template <typename, typename> class MultExpr;
-    template <typename, typename, typename> class ScalMultExpr;
+    template <typename, typename, typename> class MultExpr;
+    template <typename, typename, typename, typename> class ScalMultExpr;
     template <typename, typename, typename> class MultEngine;
     template <typename, typename, typename, typename> class ScalMultEngine;
 
@@ -181,9 +181,10 @@ namespace TiledArray {
 
       /// \tparam L The left-hand argument expression type
       /// \tparam R The right-hand argument expression type
+      /// \tparam T The expression result tile type
       /// \param expr The parent expression
-      template <typename L, typename R>
-      MultEngine(const MultExpr<L, R>& expr) :
+      template <typename L, typename R, typename T>
+      MultEngine(const MultExpr<L, R, T>& expr) :
         ContEngine_(expr), contract_(false)
       { }
 
@@ -403,9 +404,10 @@ namespace TiledArray {
       /// \tparam L The left-hand argument expression type
       /// \tparam R The right-hand argument expression type
       /// \tparam S The expression scalar type
+      /// \tparam T The expression result tile type
       /// \param expr The parent expression
-      template <typename L, typename R, typename S>
-      ScalMultEngine(const ScalMultExpr<L, R, S>& expr) : ContEngine_(expr), contract_(false) { }
+      template <typename L, typename R, typename S, typename T>
+      ScalMultEngine(const ScalMultExpr<L, R, S, T>& expr) : ContEngine_(expr), contract_(false) { }
 
       /// Set the variable list for this expression
 
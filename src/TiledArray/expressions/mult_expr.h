@@ -45,14 +45,15 @@ namespace TiledArray {
     using TiledArray::detail::numeric_t;
     using TiledArray::detail::scalar_t;
 
-    template <typename Left, typename Right>
-    struct ExprTrait<MultExpr<Left, Right> > {
+    template <typename Left, typename Right, typename Result>
+    struct ExprTrait<MultExpr<Left, Right, Result> > {
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
-      typedef result_of_mult_t<
-          typename EngineTrait<typename ExprTrait<Left>::engine_type>::eval_type,
-          typename EngineTrait<typename ExprTrait<Right>::engine_type>::eval_type>
-          result_type; ///< Result tile type
+      typedef typename std::conditional<std::is_void<Result>::value,
+          result_of_mult_t<
+              typename EngineTrait<typename ExprTrait<Left>::engine_type>::eval_type,
+              typename EngineTrait<typename ExprTrait<Right>::engine_type>::eval_type>,
+          Result>::type result_type; ///< Result tile type
       typedef MultEngine<typename ExprTrait<Left>::engine_type,
           typename ExprTrait<Right>::engine_type, result_type>
           engine_type; ///< Expression engine type
@@ -62,15 +63,17 @@ namespace TiledArray {
           scalar_type; ///< Multiplication result scalar type
     };
 
-    template <typename Left, typename Right, typename Scalar>
-    struct ExprTrait<ScalMultExpr<Left, Right, Scalar> > {
+    template <typename Left, typename Right, typename Scalar, typename Result>
+    struct ExprTrait<ScalMultExpr<Left, Right, Scalar, Result> > {
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
       typedef Scalar scalar_type;  ///< Tile scalar type
-      typedef result_of_mult_t<
-          typename EngineTrait<typename ExprTrait<Left>::engine_type>::eval_type,
-          typename EngineTrait<typename ExprTrait<Right>::engine_type>::eval_type,
-          scalar_type> result_type; ///< Result tile type
+      typedef typename std::conditional<std::is_void<Result>::value,
+          result_of_mult_t<
+              typename EngineTrait<typename ExprTrait<Left>::engine_type>::eval_type,
+              typename EngineTrait<typename ExprTrait<Right>::engine_type>::eval_type,
+              scalar_type>,
+          Result>::type result_type; ///< Result tile type
       typedef ScalMultEngine<typename ExprTrait<Left>::engine_type,
           typename ExprTrait<Right>::engine_type, Scalar, result_type>
           engine_type; ///< Expression engine type
@@ -83,10 +86,12 @@ namespace TiledArray {
 
     /// \tparam Left The left-hand expression type
     /// \tparam Right The right-hand expression type
-    template <typename Left, typename Right>
-    class MultExpr : public BinaryExpr<MultExpr<Left, Right> > {
+    /// \tparam Result The result tile type, or \c void for the tile type of
+    /// the product of the argument tiles
+    template <typename Left, typename Right, typename Result>
+    class MultExpr : public BinaryExpr<MultExpr<Left, Right, Result> > {
     public:
-      typedef MultExpr<Left, Right> MultExpr_; ///< This class type
+      typedef MultExpr<Left, Right, Result> MultExpr_; ///< This class type
       typedef BinaryExpr<MultExpr_> BinaryExpr_; ///< Binary expression base type
       typedef typename ExprTrait<MultExpr_>::left_type left_type; ///< The left-hand expression type
       typedef typename ExprTrait<MultExpr_>::right_type right_type; ///< The right-hand expression type
@@ -140,10 +145,15 @@ namespace TiledArray {
 
     /// \tparam Left The left-hand expression type
     /// \tparam Right The right-hand expression type
-    template <typename Left, typename Right, typename Scalar>
-    class ScalMultExpr : public BinaryExpr<ScalMultExpr<Left, Right, Scalar> > {
+    /// \tparam Scalar The scaling factor type
+    /// \tparam Result The result tile type, or \c void for the tile type of
+    /// the product of the argument tiles
+    template <typename Left, typename Right, typename Scalar, typename Result>
+    class ScalMultExpr :
+        public BinaryExpr<ScalMultExpr<Left, Right, Scalar, Result> >
+    {
     public:
-      typedef ScalMultExpr<Left, Right, Scalar> ScalMultExpr_; ///< This class type
+      typedef ScalMultExpr<Left, Right, Scalar, Result> ScalMultExpr_; ///< This class type
       typedef BinaryExpr<ScalMultExpr_> BinaryExpr_; ///< Binary expression base type
       typedef typename ExprTrait<ScalMultExpr_>::left_type left_type; ///< The left-hand expression type
       typedef typename ExprTrait<ScalMultExpr_>::right_type right_type; ///< The right-hand expression type
@@ -204,17 +214,18 @@ namespace TiledArray {
     /// \tparam Left The left-hand expression type
     /// \tparam Right The right-hand expression type
     /// \tparam Scalar A scalar type
+    /// \tparam Result The result tile type
     /// \param expr The multiplication expression object
     /// \param factor The scaling factor
     /// \return A scaled-multiplication expression object
-    template <typename Left, typename Right, typename Scalar,
+    template <typename Left, typename Right, typename Scalar, typename Result,
         typename std::enable_if<
             TiledArray::detail::is_numeric_v<Scalar>
         >::type* = nullptr>
-    inline ScalMultExpr<Left, Right, Scalar>
-    operator*(const MultExpr<Left, Right>& expr, const Scalar& factor) {
-      return ScalMultExpr<Left, Right, Scalar>(expr.left(), expr.right(),
-          factor);
+    inline ScalMultExpr<Left, Right, Scalar, Result>
+    operator*(const MultExpr<Left, Right, Result>& expr, const Scalar& factor) {
+      return ScalMultExpr<Left, Right, Scalar, Result>(expr.left(),
+          expr.right(), factor);
     }
 
     /// Scaled-multiplication expression factor
@@ -222,17 +233,18 @@ namespace TiledArray {
     /// \tparam Left The left-hand expression type
     /// \tparam Right The right-hand expression type
     /// \tparam Scalar A scalar type
+    /// \tparam Result The result tile type
     /// \param factor The scaling factor
     /// \param expr The multiplication expression object
     /// \return A scaled-multiplication expression object
-    template <typename Left, typename Right, typename Scalar,
+    template <typename Left, typename Right, typename Scalar, typename Result,
         typename std::enable_if<
             TiledArray::detail::is_numeric_v<Scalar>
         >::type* = nullptr>
-    inline ScalMultExpr<Left, Right, Scalar>
-    operator*(const Scalar& factor, const MultExpr<Left, Right>& expr) {
-      return ScalMultExpr<Left, Right, Scalar>(expr.left(), expr.right(),
-          factor);
+    inline ScalMultExpr<Left, Right, Scalar, Result>
+    operator*(const Scalar& factor, const MultExpr<Left, Right, Result>& expr) {
+      return ScalMultExpr<Left, Right, Scalar, Result>(expr.left(),
+          expr.right(), factor);
     }
 
     /// Scaled-multiplication expression factor
@@ -241,19 +253,21 @@ namespace TiledArray {
     /// \tparam Right The right-hand expression type
     /// \tparam Scalar1 A scalar type
     /// \tparam Scalar2 A scalar type
+    /// \tparam Result The result tile type
     /// \param expr The multiplication expression object
     /// \param factor The scaling factor
     /// \return A scaled-multiplication expression object
     template <typename Left, typename Right, typename Scalar1, typename Scalar2,
+        typename Result,
         typename std::enable_if<
             TiledArray::detail::is_numeric_v<Scalar2>
         >::type* = nullptr>
-    inline ScalMultExpr<Left, Right, mult_t<Scalar1, Scalar2> >
-    operator*(const ScalMultExpr<Left, Right, Scalar1>& expr,
+    inline ScalMultExpr<Left, Right, mult_t<Scalar1, Scalar2>, Result>
+    operator*(const ScalMultExpr<Left, Right, Scalar1, Result>& expr,
         const Scalar2& factor)
     {
-      return ScalMultExpr<Left, Right, mult_t<Scalar1, Scalar2> >(expr.left(),
-          expr.right(), expr.factor() * factor);
+      return ScalMultExpr<Left, Right, mult_t<Scalar1, Scalar2>, Result>(
+          expr.left(), expr.right(), expr.factor() * factor);
     }
 
     /// Scaled-multiplication expression factor
@@ -262,45 +276,89 @@ namespace TiledArray {
     /// \tparam Right The right-hand expression type
     /// \tparam Scalar1 A scalar type
     /// \tparam Scalar2 A scalar type
+    /// \tparam Result The result tile type
     /// \param factor The scaling factor
     /// \param expr The multiplication expression object
     /// \return A scaled-multiplication expression object
     template <typename Left, typename Right, typename Scalar1, typename Scalar2,
+        typename Result,
         typename std::enable_if<
             TiledArray::detail::is_numeric_v<Scalar1>
         >::type* = nullptr>
-    inline ScalMultExpr<Left, Right, mult_t<Scalar2, Scalar1> >
+    inline ScalMultExpr<Left, Right, mult_t<Scalar2, Scalar1>, Result>
     operator*(const Scalar1& factor,
-        const ScalMultExpr<Left, Right, Scalar2>& expr)
+        const ScalMultExpr<Left, Right, Scalar2, Result>& expr)
     {
-      return ScalMultExpr<Left, Right, mult_t<Scalar2, Scalar1> >(expr.left(),
-          expr.right(), expr.factor() * factor);
+      return ScalMultExpr<Left, Right, mult_t<Scalar2, Scalar1>, Result>(
+          expr.left(), expr.right(), expr.factor() * factor);
     }
 
     /// Negated multiplication expression factor
 
     /// \tparam Left The left-hand expression type
     /// \tparam Right The right-hand expression type
+    /// \tparam Result The result tile type
     /// \param expr The multiplication expression object
     /// \return A scaled-multiplication expression object
-    template <typename Left, typename Right>
-    inline ScalMultExpr<Left, Right, typename ExprTrait<MultExpr<Left, Right> >::numeric_type>
-    operator-(const MultExpr<Left, Right>& expr) {
+    template <typename Left, typename Right, typename Result>
+    inline ScalMultExpr<Left, Right,
+        typename ExprTrait<MultExpr<Left, Right, Result> >::numeric_type, Result>
+    operator-(const MultExpr<Left, Right, Result>& expr) {
       return ScalMultExpr<Left, Right, typename ExprTrait<MultExpr<Left,
-          Right> >::numeric_type>(expr.left(), expr.right(), -1);
+          Right, Result> >::numeric_type, Result>(expr.left(), expr.right(), -1);
     }
 
     /// Negated scaled-multiplication expression factor
 
     /// \tparam Left The left-hand expression type
     /// \tparam Right The right-hand expression type
+    /// \tparam Result The result tile type
     /// \param expr The multiplication expression object
     /// \return A scaled-multiplication expression object
-    template <typename Left, typename Right, typename Scalar>
-    inline ScalMultExpr<Left, Right, Scalar>
-    operator-(const ScalMultExpr<Left, Right, Scalar>& expr) {
-      return ScalMultExpr<Left, Right, Scalar>(expr.left(), expr.right(),
-          -expr.factor());
+    template <typename Left, typename Right, typename Scalar, typename Result>
+    inline ScalMultExpr<Left, Right, Scalar, Result>
+    operator-(const ScalMultExpr<Left, Right, Scalar, Result>& expr) {
+      return ScalMultExpr<Left, Right, Scalar, Result>(expr.left(),
+          expr.right(), -expr.factor());
+    }
+
+    /// Multiplication expression result type conversion
+
+    /// The product of the argument tiles is evaluated as, or converted to,
+    /// \c Result tiles. For example, the contraction of single precision
+    /// arrays may be accumulated in, and stored as, double precision tiles:
+    /// \code
+    /// TArrayF a, b;
+    /// TArrayD c;
+    /// c("i,j") = result_as<TensorD>(a("i,k") * b("k,j"));
+    /// \endcode
+    /// \tparam Result The result tile type
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \tparam T The result tile type of \c expr
+    /// \param expr The multiplication expression object
+    /// \return A multiplication expression object with \c Result tiles
+    template <typename Result, typename Left, typename Right, typename T>
+    inline MultExpr<Left, Right, Result>
+    result_as(const MultExpr<Left, Right, T>& expr) {
+      return MultExpr<Left, Right, Result>(expr.left(), expr.right());
+    }
+
+    /// Scaled-multiplication expression result type conversion
+
+    /// \tparam Result The result tile type
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \tparam Scalar A scalar type
+    /// \tparam T The result tile type of \c expr
+    /// \param expr The scaled-multiplication expression object
+    /// \return A scaled-multiplication expression object with \c Result tiles
+    template <typename Result, typename Left, typename Right, typename Scalar,
+        typename T>
+    inline ScalMultExpr<Left, Right, Scalar, Result>
+    result_as(const ScalMultExpr<Left, Right, Scalar, T>& expr) {
+      return ScalMultExpr<Left, Right, Scalar, Result>(expr.left(),
+          expr.right(), expr.factor());
     }
 
     /// Conjugated multiplication expression factory
@@ -514,6 +572,9 @@ namespace TiledArray {
 
 
   }  // namespace expressions
+
+  using expressions::result_as;
+
 } // namespace TiledArray
 
 #endif // TILEDARRAY_EXPRESSIONS_MULT_EXPR_H__INCLUDED
@@ -0,0 +1,871 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  product_plan.h
+ *  Apr 20, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_PRODUCT_PLAN_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_PRODUCT_PLAN_H__INCLUDED
+
+#include <TiledArray/dist_eval/sum_eval.h>
+#include <TiledArray/expressions/tsr_expr.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Evaluation plan for sums of products of arrays
+
+    /// Products of more than two arrays, e.g.
+    /// <tt>w("i,j") * w("j,k") * u("k")</tt>, are evaluated by nested
+    /// multiplication engines in the order they are written, which may cost
+    /// asymptotically more than another order, and a product that appears in
+    /// several terms of a sum is evaluated once for each term. A product plan
+    /// flattens an expression that is a sum of scaled products of arrays into
+    /// its terms, finds the order of the products of each term with the
+    /// smallest estimated cost, and identifies the sub-products that are
+    /// shared by the terms, so they are evaluated once. The cost of a product
+    /// is its number of floating point operations, estimated from the element
+    /// ranges of its arguments and the fraction of non-zero tiles of their
+    /// shapes. The fraction of non-zero tiles of an intermediate product is
+    /// estimated from those of its arguments, assuming the non-zero tiles are
+    /// uncorrelated.
+    ///
+    /// Assignments use a product plan when its estimated cost, which includes
+    /// the accumulation of each term into the result, is smaller than that
+    /// of the expression as written, or when it is a sum of more than two
+    /// terms (see \c Expr::eval_to() ). The intermediate products are then
+    /// evaluated into temporary arrays, and the terms are evaluated together
+    /// and accumulated directly into the result tiles by an N-ary sum (see
+    /// \c TiledArray::detail::SumEvalImpl ), so the terms are not evaluated
+    /// into temporary arrays.
+    /// \note Only expressions whose arguments have the type of the result
+    /// array, and whose scaling factors do not change the numeric type, are
+    /// planned; expressions with blocks, complex conjugates, sums nested in
+    /// products, or engine parameter overrides are evaluated as written. Two
+    /// sub-products are identical when they have the same arrays with the
+    /// same variable lists, and the same result variables. Reordering the
+    /// products changes the order of the floating point operations, so the
+    /// result may differ by rounding.
+    /// \tparam Array The result array type
+    template <typename Array>
+    class ProductPlan {
+    public:
+      typedef ProductPlan<Array> ProductPlan_; ///< This class type
+      typedef Array array_type; ///< The array type
+      typedef TiledArray::detail::numeric_t<Array> numeric_type; ///< The numeric type
+      typedef std::size_t size_type; ///< Size type
+
+      /// The maximum number of arrays in one term
+      static constexpr unsigned int max_factors = 10u;
+
+    private:
+
+      typedef std::uint64_t var_mask; ///< A set of the variables of a term
+
+      /// An argument array
+      struct Leaf {
+        array_type array; ///< A shallow copy of the array
+        VariableList vars; ///< The variable list of the array
+      }; // struct Leaf
+
+      /// A product of arrays, and its evaluation order
+      struct Term {
+        numeric_type factor; ///< The scaling factor of the product
+        std::vector<size_type> leaves; ///< The factors of the product
+        std::vector<std::pair<unsigned int, unsigned int> > products; ///< The products as written (factor set, left factor set)
+        std::vector<unsigned int> split; ///< The left factor set of each planned product
+        std::vector<double> density; ///< The fraction of non-zero tiles of each planned product
+        std::vector<var_mask> leaf_vars; ///< The variables of each factor
+        std::vector<std::string> var_names; ///< The variable names
+        std::vector<double> extent; ///< The element range extent of each variable
+        std::vector<double> tiles; ///< The number of tiles of each variable
+        var_mask target; ///< The result variables
+      }; // struct Term
+
+      /// An argument of an evaluation step
+      struct Operand {
+        bool temporary; ///< \c true for an intermediate product
+        size_type index; ///< The index of the leaf or intermediate product
+        std::string vars; ///< The variable list of the argument
+      }; // struct Operand
+
+      /// The evaluation of an intermediate product
+      struct Step {
+        Operand left; ///< The left-hand argument
+        Operand right; ///< The right-hand argument
+        std::string vars; ///< The variable list of the product
+      }; // struct Step
+
+      /// The accumulation of a term into the result
+      struct Accumulation {
+        numeric_type factor; ///< The scaling factor
+        Operand left; ///< The term, or the left-hand argument of its product
+        bool is_product; ///< \c true when \c left and \c right are multiplied
+        Operand right; ///< The right-hand argument of the product
+      }; // struct Accumulation
+
+      VariableList target_vars_; ///< The result variable list
+      std::vector<Leaf> leaves_; ///< The distinct argument arrays
+      std::vector<Term> terms_; ///< The terms of the sum
+      std::vector<Step> steps_; ///< The intermediate products
+      std::vector<Accumulation> accumulations_; ///< The terms of the result
+      bool valid_; ///< \c true if the expression can be planned
+      double cost_; ///< The estimated cost of the plan
+      double default_cost_; ///< The estimated cost of the expression as written
+      size_type reused_; ///< The number of sub-products used by several terms
+
+      /// Check for scaling factors that do not change the numeric type
+      template <typename S, bool = TiledArray::detail::is_numeric_v<S> >
+      struct is_factor : public std::false_type { };
+
+      template <typename S>
+      struct is_factor<S, true> :
+          public std::is_same<TiledArray::detail::mult_t<S, numeric_type>,
+              numeric_type> { };
+
+      template <typename A>
+      using is_array = std::is_same<typename std::decay<A>::type, array_type>;
+
+      // Terms of the sum
+
+      template <typename D>
+      bool add_terms(const Expr<D>& expr, const numeric_type factor) {
+        Term term;
+        term.factor = factor;
+        unsigned int factors = 0u;
+        if(! add_factors(expr.derived(), term, factors))
+          return false;
+        terms_.push_back(std::move(term));
+        return true;
+      }
+
+      template <typename L, typename R>
+      bool add_terms(const AddExpr<L, R>& expr, const numeric_type factor) {
+        return add_terms(expr.left(), factor) && add_terms(expr.right(), factor);
+      }
+
+      template <typename L, typename R, typename S,
+          typename std::enable_if<is_factor<S>::value>::type* = nullptr>
+      bool add_terms(const ScalAddExpr<L, R, S>& expr, const numeric_type factor) {
+        return add_terms(expr.left(), factor * expr.factor()) &&
+            add_terms(expr.right(), factor * expr.factor());
+      }
+
+      template <typename L, typename R>
+      bool add_terms(const SubtExpr<L, R>& expr, const numeric_type factor) {
+        return add_terms(expr.left(), factor) && add_terms(expr.right(), -factor);
+      }
+
+      template <typename L, typename R, typename S,
+          typename std::enable_if<is_factor<S>::value>::type* = nullptr>
+      bool add_terms(const ScalSubtExpr<L, R, S>& expr, const numeric_type factor) {
+        return add_terms(expr.left(), factor * expr.factor()) &&
+            add_terms(expr.right(), -factor * expr.factor());
+      }
+
+      template <typename A, typename S,
+          typename std::enable_if<is_factor<S>::value>::type* = nullptr>
+      bool add_terms(const ScalExpr<A, S>& expr, const numeric_type factor) {
+        return add_terms(expr.arg(), factor * expr.factor());
+      }
+
+      // Factors of a product
+
+      template <typename D>
+      bool add_factors(const Expr<D>&, Term&, unsigned int&) { return false; }
+
+      template <typename A, bool Alias,
+          typename std::enable_if<is_array<A>::value>::type* = nullptr>
+      bool add_factors(const TsrExpr<A, Alias>& expr, Term& term,
+          unsigned int& factors)
+      { return add_leaf(expr.array(), expr.vars(), term, factors); }
+
+      template <typename A, typename S,
+          typename std::enable_if<is_array<A>::value &&
+              is_factor<S>::value>::type* = nullptr>
+      bool add_factors(const ScalTsrExpr<A, S>& expr, Term& term,
+          unsigned int& factors)
+      {
+        term.factor *= expr.factor();
+        return add_leaf(expr.array(), expr.vars(), term, factors);
+      }
+
+      template <typename A, typename S,
+          typename std::enable_if<is_factor<S>::value>::type* = nullptr>
+      bool add_factors(const ScalExpr<A, S>& expr, Term& term,
+          unsigned int& factors)
+      {
+        term.factor *= expr.factor();
+        return add_factors(expr.arg(), term, factors);
+      }
+
+      template <typename L, typename R>
+      bool add_factors(const MultExpr<L, R, void>& expr, Term& term,
+          unsigned int& factors)
+      { return add_product(expr.left(), expr.right(), term, factors); }
+
+      template <typename L, typename R, typename S,
+          typename std::enable_if<is_factor<S>::value>::type* = nullptr>
+      bool add_factors(const ScalMultExpr<L, R, S, void>& expr, Term& term,
+          unsigned int& factors)
+      {
+        term.factor *= expr.factor();
+        return add_product(expr.left(), expr.right(), term, factors);
+      }
+
+      template <typename L, typename R>
+      bool add_product(const L& left, const R& right, Term& term,
+          unsigned int& factors)
+      {
+        unsigned int left_factors = 0u, right_factors = 0u;
+        if(! (add_factors(left, term, left_factors) &&
+            add_factors(right, term, right_factors)))
+          return false;
+        factors = left_factors | right_factors;
+        term.products.emplace_back(factors, left_factors);
+        return true;
+      }
+
+      /// Add an array to a product
+
+      /// \param array The array
+      /// \param vars The variable list of the array
+      /// \param term The product
+      /// \param[out] factors The set that contains the new factor
+      /// \return \c false if the array cannot be planned
+      bool add_leaf(const array_type& array, const std::string& vars,
+          Term& term, unsigned int& factors)
+      {
+        if(! array.is_initialized() || term.leaves.size() == max_factors)
+          return false;
+
+        VariableList var_list(vars);
+        if(var_list.dim() != array.trange().tiles_range().rank())
+          return false;
+
+        size_type index = 0ul;
+        for(; index < leaves_.size(); ++index)
+          if((leaves_[index].array.id() == array.id()) &&
+              (leaves_[index].vars == var_list))
+            break;
+        if(index == leaves_.size())
+          leaves_.push_back(Leaf{array, std::move(var_list)});
+
+        factors = 1u << term.leaves.size();
+        term.leaves.push_back(index);
+        return true;
+      }
+
+      // Cost model
+
+      /// Find the variables of a term and their ranges
+
+      /// \return \c false if the variables of the term are not consistent,
+      /// or if the term has more variables than a mask can hold
+      bool init_vars(Term& term) const {
+        auto var_index = [&term] (const std::string& name) {
+          return std::find(term.var_names.begin(), term.var_names.end(), name)
+              - term.var_names.begin();
+        };
+
+        for(const size_type leaf : term.leaves) {
+          const Leaf& arg = leaves_[leaf];
+          var_mask vars = 0u;
+          for(unsigned int d = 0u; d < arg.vars.dim(); ++d) {
+            const auto& trange1 = arg.array.trange().data()[d];
+            const size_type v = var_index(arg.vars[d]);
+            if(v == term.var_names.size()) {
+              if(v == std::numeric_limits<var_mask>::digits)
+                return false;
+              term.var_names.push_back(arg.vars[d]);
+              term.extent.push_back(trange1.extent());
+              term.tiles.push_back(trange1.tile_extent());
+            } else if(term.extent[v] != trange1.extent() ||
+                term.tiles[v] != trange1.tile_extent()) {
+              return false;
+            }
+            vars |= var_mask(1) << v;
+          }
+          term.leaf_vars.push_back(vars);
+        }
+
+        term.target = 0u;
+        for(const auto& name : target_vars_) {
+          const size_type v = var_index(name);
+          if(v == term.var_names.size())
+            return false;
+          term.target |= var_mask(1) << v;
+        }
+
+        return true;
+      }
+
+      /// The variables of a sub-product that are used outside of it
+
+      /// \param term The term
+      /// \param factors The factors of the sub-product
+      /// \return The variables of \c factors that are variables of other
+      /// factors of \c term , or of the result
+      static var_mask outer_vars(const Term& term, const unsigned int factors) {
+        var_mask inner = 0u, outer = term.target;
+        for(unsigned int i = 0u; i < term.leaves.size(); ++i)
+          if(factors & (1u << i))
+            inner |= term.leaf_vars[i];
+          else
+            outer |= term.leaf_vars[i];
+        return inner & outer;
+      }
+
+      /// Estimate the cost of a product of two sub-products
+
+      /// The product must be evaluated by a single multiplication, i.e. it is
+      /// either a Hadamard product, where all variables are kept, or a
+      /// contraction, where all common variables are summed.
+      /// \param term The term
+      /// \param factors The factors of the product
+      /// \param left The factors of the left-hand sub-product
+      /// \param left_density The fraction of non-zero tiles of the left-hand
+      /// sub-product
+      /// \param right_density The fraction of non-zero tiles of the
+      /// right-hand sub-product
+      /// \param[out] density The fraction of non-zero tiles of the product
+      /// \return The number of operations of the product, or infinity if it
+      /// cannot be evaluated by a single multiplication
+      static double product_cost(const Term& term, const unsigned int factors,
+          const unsigned int left, const double left_density,
+          const double right_density, double& density)
+      {
+        const var_mask result_vars = outer_vars(term, factors);
+        const var_mask left_vars = outer_vars(term, left);
+        const var_mask right_vars = outer_vars(term, factors ^ left);
+        const var_mask inner_vars = left_vars & right_vars;
+        const bool hadamard = (left_vars == right_vars);
+        if(hadamard ? (result_vars != left_vars) : (inner_vars & result_vars))
+          return std::numeric_limits<double>::infinity();
+
+        double volume = 1.0, inner_tiles = 1.0;
+        for(size_type v = 0ul; v < term.var_names.size(); ++v) {
+          if((left_vars | right_vars) & (var_mask(1) << v))
+            volume *= term.extent[v];
+          if(inner_vars & (var_mask(1) << v))
+            inner_tiles *= term.tiles[v];
+        }
+
+        const double pair_density = left_density * right_density;
+        if(hadamard) {
+          density = pair_density;
+          return volume * pair_density;
+        }
+        density = 1.0 - std::pow(1.0 - pair_density, inner_tiles);
+        return 2.0 * volume * pair_density;
+      }
+
+      /// The fraction of non-zero tiles of a factor
+      double leaf_density(const Term& term, const unsigned int i) const {
+        return 1.0 - double(leaves_[term.leaves[i]].array.shape().sparsity());
+      }
+
+      /// Estimate the cost of a term as written
+
+      /// \return The number of operations, or infinity if a product cannot
+      /// be evaluated by a single multiplication
+      double written_cost(const Term& term) const {
+        std::vector<double> density(1u << term.leaves.size(), 1.0);
+        for(unsigned int i = 0u; i < term.leaves.size(); ++i)
+          density[1u << i] = leaf_density(term, i);
+
+        double cost = 0.0;
+        for(const auto& product : term.products)
+          cost += product_cost(term, product.first, product.second,
+              density[product.second], density[product.first ^ product.second],
+              density[product.first]);
+        return cost;
+      }
+
+      /// Key of a sub-product
+
+      /// \param term The term
+      /// \param factors The factors of the sub-product
+      /// \return A key that identifies the arrays and the result variables of
+      /// the sub-product
+      std::string product_key(const Term& term, const unsigned int factors) const {
+        std::vector<size_type> args;
+        for(unsigned int i = 0u; i < term.leaves.size(); ++i)
+          if(factors & (1u << i))
+            args.push_back(term.leaves[i]);
+        std::sort(args.begin(), args.end());
+
+        std::vector<std::string> vars;
+        const var_mask result_vars = outer_vars(term, factors);
+        for(size_type v = 0ul; v < term.var_names.size(); ++v)
+          if(result_vars & (var_mask(1) << v))
+            vars.push_back(term.var_names[v]);
+        std::sort(vars.begin(), vars.end());
+
+        std::string key;
+        for(const size_type arg : args)
+          key += std::to_string(arg) + ",";
+        key += "|";
+        for(const auto& var : vars)
+          key += var + ",";
+        return key;
+      }
+
+      /// Find the order of the products of a term with the smallest cost
+
+      /// The sub-products of earlier terms are free. Sub-products are
+      /// enumerated by increasing factor sets, so each set is planned after
+      /// all of its subsets.
+      /// \param term The term
+      /// \param computed The keys and densities of the sub-products of
+      /// earlier terms
+      /// \return The estimated cost of the term
+      double plan_term(Term& term,
+          const std::map<std::string, double>& computed) const
+      {
+        const unsigned int sets = 1u << term.leaves.size();
+        std::vector<double> cost(sets, std::numeric_limits<double>::infinity());
+        std::vector<double>& density = term.density;
+        density.assign(sets, 1.0);
+        term.split.assign(sets, 0u);
+        for(unsigned int i = 0u; i < term.leaves.size(); ++i) {
+          cost[1u << i] = 0.0;
+          density[1u << i] = leaf_density(term, i);
+        }
+
+        for(unsigned int factors = 1u; factors < sets; ++factors) {
+          if(! (factors & (factors - 1u)))
+            continue; // A single factor
+
+          auto it = computed.find(product_key(term, factors));
+          if(it != computed.end()) {
+            cost[factors] = 0.0;
+            density[factors] = it->second;
+            continue;
+          }
+
+          // Enumerate the splits where the lowest factor is on the left
+          const unsigned int lowest = factors & (~factors + 1u);
+          for(unsigned int left = (factors - 1u) & factors; left;
+              left = (left - 1u) & factors)
+          {
+            const unsigned int right = factors ^ left;
+            if(! (left & lowest) || std::isinf(cost[left] + cost[right]))
+              continue;
+            double product_density = 1.0;
+            const double c = cost[left] + cost[right] +
+                product_cost(term, factors, left, density[left],
+                    density[right], product_density);
+            if(c < cost[factors]) {
+              cost[factors] = c;
+              density[factors] = product_density;
+              term.split[factors] = left;
+            }
+          }
+        }
+
+        return cost[sets - 1u];
+      }
+
+      /// Record the sub-products of the planned order of a term
+
+      /// \param term The term
+      /// \param factors The factors of a sub-product
+      /// \param computed The keys and densities of the sub-products of
+      /// earlier terms, to which the new sub-products are added
+      /// \param uses The number of uses of each sub-product
+      void count_uses(const Term& term, const unsigned int factors,
+          std::map<std::string, double>& computed,
+          std::map<std::string, size_type>& uses) const
+      {
+        if(! (factors & (factors - 1u)))
+          return;
+        const std::string key = product_key(term, factors);
+        ++uses[key];
+        if(term.split[factors]) {
+          const unsigned int left = term.split[factors];
+          count_uses(term, left, computed, uses);
+          count_uses(term, factors ^ left, computed, uses);
+          computed.emplace(key, term.density[factors]);
+        }
+      }
+
+      // Evaluation steps
+
+      /// The variable list of a product
+
+      /// \param left The variable list of the left-hand argument
+      /// \param right The variable list of the right-hand argument
+      /// \return The variables of \c left , for a Hadamard product, or the
+      /// variables of \c left and then those of \c right that are not common
+      /// to both, for a contraction
+      static std::string product_vars(const std::string& left,
+          const std::string& right)
+      {
+        const VariableList left_vars(left), right_vars(right);
+        if(left_vars.is_permutation(right_vars))
+          return left;
+
+        std::vector<std::string> vars;
+        for(const auto& var : left_vars)
+          if(std::find(right_vars.begin(), right_vars.end(), var) == right_vars.end())
+            vars.push_back(var);
+        for(const auto& var : right_vars)
+          if(std::find(left_vars.begin(), left_vars.end(), var) == left_vars.end())
+            vars.push_back(var);
+        return VariableList(vars.begin(), vars.end()).string();
+      }
+
+      /// Construct the evaluation steps of a sub-product
+
+      /// \param term The term
+      /// \param factors The factors of the sub-product
+      /// \param built The intermediate products that have been constructed
+      /// \return The argument that holds the sub-product
+      Operand build(const Term& term, const unsigned int factors,
+          std::map<std::string, Operand>& built)
+      {
+        if(! (factors & (factors - 1u))) {
+          size_type i = 0ul;
+          while(! (factors & (1u << i)))
+            ++i;
+          return Operand{false, term.leaves[i],
+              leaves_[term.leaves[i]].vars.string()};
+        }
+
+        const std::string key = product_key(term, factors);
+        auto it = built.find(key);
+        if(it != built.end())
+          return it->second;
+
+        TA_ASSERT(term.split[factors]);
+        const Operand left = build(term, term.split[factors], built);
+        const Operand right = build(term, factors ^ term.split[factors], built);
+        steps_.push_back(Step{left, right, product_vars(left.vars, right.vars)});
+        const Operand result{true, steps_.size() - 1ul, steps_.back().vars};
+        built.emplace(key, result);
+        return result;
+      }
+
+      /// Plan the terms
+
+      /// The plan is valid if each product of the expression as written can
+      /// be evaluated by a single multiplication, which is also the condition
+      /// for reordering the products.
+      void plan() {
+        default_cost_ = 0.0;
+        cost_ = 0.0;
+        for(auto& term : terms_) {
+          if(! init_vars(term) || (outer_vars(term,
+              (1u << term.leaves.size()) - 1u) != term.target))
+            return;
+          for(unsigned int i = 0u; i < term.leaves.size(); ++i)
+            if(outer_vars(term, 1u << i) != term.leaf_vars[i])
+              return; // A variable that is not used by the other factors
+          default_cost_ += written_cost(term);
+        }
+        if(std::isinf(default_cost_))
+          return;
+
+        // Plan the terms in order, so later terms reuse the sub-products of
+        // earlier terms
+        std::map<std::string, double> computed;
+        std::map<std::string, size_type> uses;
+        for(auto& term : terms_) {
+          cost_ += plan_term(term, computed);
+          count_uses(term, (1u << term.leaves.size()) - 1u, computed, uses);
+        }
+        if(std::isinf(cost_))
+          return;
+        for(const auto& use : uses)
+          if(use.second > 1ul)
+            ++reused_;
+
+        // Construct the evaluation steps. A term that is not used by other
+        // terms is evaluated directly into the result.
+        std::map<std::string, Operand> built;
+        for(const auto& term : terms_) {
+          const unsigned int factors = (1u << term.leaves.size()) - 1u;
+          Accumulation acc{term.factor, Operand(), false, Operand()};
+          if(term.leaves.size() > 1u && term.split[factors] &&
+              uses[product_key(term, factors)] == 1ul) {
+            acc.left = build(term, term.split[factors], built);
+            acc.right = build(term, factors ^ term.split[factors], built);
+            acc.is_product = true;
+          } else {
+            acc.left = build(term, factors, built);
+
+            // Terms of the same array or intermediate product are combined
+            auto it = std::find_if(accumulations_.begin(), accumulations_.end(),
+                [&acc] (const Accumulation& other) {
+                  return ! other.is_product &&
+                      (other.left.temporary == acc.left.temporary) &&
+                      (other.left.index == acc.left.index) &&
+                      (other.left.vars == acc.left.vars);
+                });
+            if(it != accumulations_.end()) {
+              it->factor += acc.factor;
+              continue;
+            }
+          }
+          accumulations_.push_back(std::move(acc));
+        }
+
+        // Add the cost of accumulating the terms into the result, and of the
+        // sums of the expression as written
+        double volume = 1.0;
+        for(const auto& name : target_vars_) {
+          const Term& term = terms_.front();
+          volume *= term.extent[std::find(term.var_names.begin(),
+              term.var_names.end(), name) - term.var_names.begin()];
+        }
+        cost_ += volume * double(accumulations_.size() - 1ul);
+        default_cost_ += volume * double(terms_.size() - 1ul);
+
+        valid_ = true;
+      }
+
+      /// Argument expression of an evaluation step
+      static TsrExpr<const array_type, true>
+      argument(const Operand& operand, const std::vector<Leaf>& leaves,
+          const std::vector<array_type>& temporaries)
+      {
+        const array_type& array = (operand.temporary ?
+            temporaries[operand.index] : leaves[operand.index].array);
+        return array(operand.vars);
+      }
+
+      typedef TiledArray::detail::SumEvalImpl<typename array_type::value_type,
+          typename array_type::policy_type> sum_eval_type; ///< The N-ary sum evaluator type
+      typedef typename array_type::shape_type shape_type; ///< The shape type
+      typedef typename array_type::pmap_interface pmap_interface; ///< The process map interface type
+
+      /// Add the distributed evaluator of a term to a sum
+
+      /// The first term selects the process map of the sum, which is used
+      /// by the other terms.
+      /// \tparam D The term expression type
+      /// \param expr The term expression
+      /// \param world The world of the result
+      /// \param vars The result variable list
+      /// \param[in,out] pmap The process map of the sum (may be null before
+      /// the first term is added)
+      /// \param[in,out] shape The shape of the sum
+      /// \param[in,out] terms The terms of the sum
+      template <typename D>
+      static void add_term(const Expr<D>& expr, World& world,
+          const VariableList& vars, std::shared_ptr<pmap_interface>& pmap,
+          shape_type& shape,
+          std::vector<std::shared_ptr<typename sum_eval_type::Term> >& terms)
+      {
+        typename D::engine_type engine(expr.derived());
+        engine.init(world, pmap, vars);
+        const auto dist_eval = engine.make_dist_eval();
+        if(terms.empty()) {
+          pmap = dist_eval.pmap();
+          shape = dist_eval.shape();
+        } else {
+          shape = shape.add(dist_eval.shape());
+        }
+        terms.push_back(sum_eval_type::make_term(dist_eval));
+      }
+
+      /// Accumulate the terms into the result
+
+      /// The tiles of the terms are added to the result tiles as they are
+      /// evaluated (see \c TiledArray::detail::SumEvalImpl ), so the terms
+      /// are not evaluated into temporary arrays.
+      /// \tparam Alias Tile alias flag
+      /// \param result The tensor expression that is assigned
+      /// \param world The world of the result
+      /// \param temporaries The intermediate products
+      template <bool Alias>
+      void sum(TsrExpr<array_type, Alias>& result, World& world,
+          const std::vector<array_type>& temporaries) const
+      {
+        std::shared_ptr<pmap_interface> pmap;
+        if(result.array().is_initialized())
+          pmap = result.array().pmap();
+        shape_type shape;
+        std::vector<std::shared_ptr<typename sum_eval_type::Term> > terms;
+        terms.reserve(accumulations_.size());
+        for(const auto& acc : accumulations_) {
+          const auto left = argument(acc.left, leaves_, temporaries);
+          if(acc.is_product)
+            add_term(acc.factor * (left * argument(acc.right, leaves_, temporaries)),
+                world, result.vars(), pmap, shape, terms);
+          else
+            add_term(acc.factor * left, world, result.vars(), pmap, shape, terms);
+        }
+
+        TiledArray::detail::DistEval<typename array_type::value_type,
+            typename array_type::policy_type> dist_eval(
+                std::make_shared<sum_eval_type>(terms, world,
+                    terms.front()->trange(), shape, pmap));
+        dist_eval.eval();
+
+        // Create the result array, and move the tiles of the sum into it
+        array_type array(world, dist_eval.trange(), dist_eval.shape(), pmap);
+        if(result.array().is_initialized() && result.array().symmetry())
+          array.set_symmetry(*result.array().symmetry());
+        for(const auto index : *pmap) {
+          if(dist_eval.is_zero(index))
+            continue;
+          if(array.is_canonical(index))
+            array.set(index, dist_eval.get(index));
+          else
+            dist_eval.discard(index);
+        }
+        array.swap(result.array());
+
+        dist_eval.wait();
+      }
+
+    public:
+
+      // Compiler generated functions
+      ProductPlan() = delete;
+      ProductPlan(const ProductPlan_&) = default;
+      ProductPlan(ProductPlan_&&) = default;
+      ~ProductPlan() = default;
+      ProductPlan_& operator=(const ProductPlan_&) = default;
+      ProductPlan_& operator=(ProductPlan_&&) = default;
+
+      /// Constructor
+
+      /// \tparam Alias Tile alias flag
+      /// \tparam D The argument expression type
+      /// \param result The tensor expression that is assigned
+      /// \param arg The expression that is evaluated
+      template <bool Alias, typename D>
+      ProductPlan(const TsrExpr<array_type, Alias>& result, const Expr<D>& arg) :
+        target_vars_(result.vars()), leaves_(), terms_(), steps_(),
+        accumulations_(), valid_(false), cost_(0.0), default_cost_(0.0),
+        reused_(0ul)
+      {
+        if(add_terms(arg.derived(), numeric_type(1)))
+          plan();
+      }
+
+      /// Check that the expression can be planned
+
+      /// \return \c true if the expression is a sum of products of arrays
+      /// that this plan can evaluate
+      bool is_valid() const { return valid_; }
+
+      /// Check that the plan is better than the expression as written
+
+      /// A sum of more than two terms is accumulated by a single N-ary sum,
+      /// instead of a tree of binary sums whose arguments wait for each
+      /// other, so the plan is also used when it is not cheaper.
+      /// \return \c true if the estimated cost of the plan is smaller than
+      /// that of the expression as written, or if the plan accumulates more
+      /// than two terms
+      bool is_beneficial() const {
+        return valid_ && ((cost_ < default_cost_) || (accumulations_.size() > 2ul));
+      }
+
+      /// The number of accumulated terms
+
+      /// \return The number of terms that are summed into the result, after
+      /// the terms of the same intermediate product have been combined
+      size_type terms() const { return accumulations_.size(); }
+
+      /// Estimated cost of the plan
+
+      /// \return The estimated number of operations of the products and of
+      /// the accumulation of the terms
+      double cost() const { return cost_; }
+
+      /// Estimated cost of the expression as written
+
+      /// \return The estimated number of operations of the products
+      double default_cost() const { return default_cost_; }
+
+      /// The number of intermediate products
+
+      /// \return The number of temporary arrays of the plan
+      size_type intermediates() const { return steps_.size(); }
+
+      /// The number of reused sub-products
+
+      /// \return The number of sub-products that are used by more than one
+      /// term, and are evaluated once
+      size_type reused() const { return reused_; }
+
+      /// Evaluate the plan and assign the result
+
+      /// \tparam Alias Tile alias flag
+      /// \param result The tensor expression that is assigned
+      template <bool Alias>
+      void eval(TsrExpr<array_type, Alias>& result) const {
+        TA_ASSERT(valid_);
+
+        // Evaluate the intermediate products in the world of the result
+        World& world = (result.array().is_initialized() ?
+            result.array().world() : TiledArray::get_default_world());
+        std::vector<array_type> temporaries(steps_.size());
+        for(size_type i = 0ul; i < steps_.size(); ++i) {
+          const Step& step = steps_[i];
+          temporaries[i](step.vars) =
+              (argument(step.left, leaves_, temporaries) *
+              argument(step.right, leaves_, temporaries)).set_world(world);
+        }
+
+        // Accumulate the terms. The leaves hold copies of the arguments, so
+        // the result may also be an argument.
+        if(accumulations_.size() > 1ul) {
+          sum(result, world, temporaries);
+        } else {
+          const Accumulation& acc = accumulations_.front();
+          const auto left = argument(acc.left, leaves_, temporaries);
+          if(acc.is_product)
+            result = acc.factor * (left * argument(acc.right, leaves_, temporaries));
+          else
+            result = acc.factor * left;
+        }
+      }
+
+    }; // class ProductPlan
+
+    /// Construct a product plan
+
+    /// \tparam A The result array type
+    /// \tparam Alias Tile alias flag
+    /// \tparam D The argument expression type
+    /// \param result The tensor expression that is assigned
+    /// \param arg The expression that is evaluated
+    /// \return The product plan of <tt>result = arg</tt>
+    template <typename A, bool Alias, typename D>
+    inline ProductPlan<A>
+    make_product_plan(const TsrExpr<A, Alias>& result, const Expr<D>& arg) {
+      return ProductPlan<A>(result, arg);
+    }
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_PRODUCT_PLAN_H__INCLUDED
@@ -131,8 +131,31 @@ namespace TiledArray {
         return array_;
       }
 
+      /// Asynchronous expression assignment
+
+      /// Unlike the assignment operator, this function returns before the
+      /// tiles of this array have been evaluated. The array is replaced
+      /// immediately with the structure of the result, and its tiles become
+      /// available as they are evaluated, so independent expressions may be
+      /// evaluated concurrently (see also \c ExprBatch ).
+      /// \tparam D The derived expression type
+      /// \param other The expression that will be assigned to this array
+      /// \return A future that is set when this process has evaluated all of
+      /// its tiles of the result
+      template <typename D>
+      Future<bool> assign_async(const Expr<D>& other) {
+        static_assert(TiledArray::expressions::is_aliased<D>::value,
+            "no_alias() expressions are not allowed on the right-hand side of "
+            "the assignment operator.");
+        return other.derived().eval_to_async(*this);
+      }
+
       /// Expression plus-assignment operator
 
+      /// The tiles of \c other are added to the tiles of this array as they
+      /// are evaluated, without a temporary array for \c other (see
+      /// \c Expr::accumulate_to() ), unless the sum is evaluated by a product
+      /// plan or cannot be accumulated in place.
       /// \tparam D The derived expression type
       /// \param other The expression that will be added to this array
       template <typename D>
@@ -140,7 +163,12 @@ namespace TiledArray {
         static_assert(TiledArray::expressions::is_aliased<D>::value,
             "no_alias() expressions are not allowed on the right-hand side of "
             "the assignment operator.");
-        return operator=(AddExpr<TsrExpr_, D>(*this, other.derived()));
+        const AddExpr<TsrExpr_, D> sum(*this, other.derived());
+        const ProductPlan<array_type> plan(*this, sum);
+        if(! plan.is_beneficial() && other.derived().accumulate_to(*this))
+          return array_;
+        sum.eval_to(*this, plan);
+        return array_;
       }
 
       /// Expression minus-assignment operator
@@ -327,4 +355,8 @@ namespace TiledArray {
   }  // namespace expressions
 } // namespace TiledArray
 
+// The product plans used by Expr::eval_to() need the complete tensor
+// expression types
+#include <TiledArray/expressions/product_plan.h>
+
 #endif // TILEDARRAY_EXPRESSIONS_TSR_EXPR_H__INCLUDED
@@ -131,6 +131,18 @@ namespace TiledArray {
         ExprEngine_::init_struct(target_vars);
       }
 
+      /// Reinitialize result tensor structure for new argument data
+
+      /// This function will rebind the leaves of the argument engine to the
+      /// arrays of \c expr and recompute the shape of the argument and result
+      /// tensor.
+      /// \param expr The expression of this engine
+      template <typename D>
+      void reinit_struct(const Expr<D>& expr) {
+        arg_.reinit_struct(expr.derived().arg());
+        ExprEngine_::init_shape();
+      }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
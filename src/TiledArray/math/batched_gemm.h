@@ -0,0 +1,161 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  batched_gemm.h
+ *  Mar 12, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_BATCHED_GEMM_H__INCLUDED
+#define TILEDARRAY_MATH_BATCHED_GEMM_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/math/blas.h>
+#include <algorithm>
+#include <memory>
+
+namespace TiledArray {
+  namespace math {
+
+    /// The maximum number of elements in the packed operands of a batched GEMM
+
+    /// Pairs are packed into a single GEMM only while the packed left- and
+    /// right-hand operands fit in this many elements, which keeps the
+    /// packed operands in cache. Pairs that are larger than this are
+    /// evaluated with one GEMM each, since the BLAS call overhead of a large
+    /// product is negligible.
+    static constexpr std::size_t gemm_batch_pack_limit = 65536ul;
+
+    /// Accumulate a sum of matrix products into a single result matrix
+
+    /// This evaluates
+    /// \f[
+    ///   C = \beta C + \alpha \sum_i {\rm op}(A_i) \, {\rm op}(B_i)
+    /// \f]
+    /// where \f$ {\rm op}(A_i) \f$ is an \f$ m \times k_i \f$ matrix and
+    /// \f$ {\rm op}(B_i) \f$ is a \f$ k_i \times n \f$ matrix. Since the
+    /// sum is equal to a single product of the \f$ A_i \f$ concatenated along
+    /// the contracted dimension with the \f$ B_i \f$ concatenated along the
+    /// contracted dimension, small products are packed together and
+    /// evaluated with one GEMM call, which avoids the per-call overhead and
+    /// poor cache reuse of many small GEMMs. All matrices are row-major and
+    /// each \f$ A_i \f$ and \f$ B_i \f$ is stored contiguously.
+    /// \tparam S1 The \c alpha scalar type
+    /// \tparam T1 The left-hand matrix element type
+    /// \tparam T2 The right-hand matrix element type
+    /// \tparam S2 The \c beta scalar type
+    /// \tparam T3 The result matrix element type
+    /// \param op_a The operation applied to each \f$ A_i \f$
+    /// \param op_b The operation applied to each \f$ B_i \f$
+    /// \param m The number of rows of the result
+    /// \param n The number of columns of the result
+    /// \param k The contracted extent of each product
+    /// \param batch The number of products
+    /// \param alpha The scaling factor of the products
+    /// \param a The left-hand matrices
+    /// \param b The right-hand matrices
+    /// \param beta The scaling factor of \c c
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline void gemm_batch(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer* k, const std::size_t batch, const S1 alpha,
+        const T1* const* a, const T2* const* b, const S2 beta, T3* c,
+        const integer ldc)
+    {
+      TA_ASSERT(m >= 0);
+      TA_ASSERT(n >= 0);
+
+      std::unique_ptr<T1[]> a_pack;
+      std::unique_ptr<T2[]> b_pack;
+      std::size_t pack_size = 0ul;
+
+      for(std::size_t first = 0ul; first < batch; ) {
+        // Collect the products that fit in the packed operands
+        std::size_t last = first + 1ul;
+        integer k_pack = k[first];
+        while((last < batch) &&
+            (std::size_t(k_pack + k[last]) * std::size_t(m + n) <= gemm_batch_pack_limit))
+          k_pack += k[last++];
+
+        // The result is scaled by beta only with the first product
+        const S2 beta_pack = (first == 0ul ? beta : S2(1));
+
+        if((last - first) == 1ul) {
+          // Evaluate a single product in place
+          const integer lda = (op_a == madness::cblas::NoTrans ? k[first] : m);
+          const integer ldb = (op_b == madness::cblas::NoTrans ? n : k[first]);
+          math::gemm(op_a, op_b, m, n, k[first], alpha, a[first], lda, b[first], ldb,
+              beta_pack, c, ldc);
+        } else {
+          // Allocate the packed operand buffers
+          if(pack_size < std::size_t(k_pack)) {
+            pack_size = std::max<std::size_t>(k_pack,
+                gemm_batch_pack_limit / std::max<std::size_t>(m + n, 1ul));
+            a_pack.reset(new T1[pack_size * m]);
+            b_pack.reset(new T2[pack_size * n]);
+          }
+
+          // Pack the left-hand matrices into a m x k_pack (or k_pack x m) matrix
+          if(op_a == madness::cblas::NoTrans) {
+            for(integer i = 0; i < m; ++i) {
+              T1* MADNESS_RESTRICT a_row = a_pack.get() + i * k_pack;
+              for(std::size_t p = first; p < last; ++p) {
+                std::copy_n(a[p] + i * k[p], k[p], a_row);
+                a_row += k[p];
+              }
+            }
+          } else {
+            T1* MADNESS_RESTRICT a_it = a_pack.get();
+            for(std::size_t p = first; p < last; ++p) {
+              std::copy_n(a[p], k[p] * m, a_it);
+              a_it += k[p] * m;
+            }
+          }
+
+          // Pack the right-hand matrices into a k_pack x n (or n x k_pack) matrix
+          if(op_b == madness::cblas::NoTrans) {
+            T2* MADNESS_RESTRICT b_it = b_pack.get();
+            for(std::size_t p = first; p < last; ++p) {
+              std::copy_n(b[p], k[p] * n, b_it);
+              b_it += k[p] * n;
+            }
+          } else {
+            for(integer j = 0; j < n; ++j) {
+              T2* MADNESS_RESTRICT b_row = b_pack.get() + j * k_pack;
+              for(std::size_t p = first; p < last; ++p) {
+                std::copy_n(b[p] + j * k[p], k[p], b_row);
+                b_row += k[p];
+              }
+            }
+          }
+
+          const integer lda = (op_a == madness::cblas::NoTrans ? k_pack : m);
+          const integer ldb = (op_b == madness::cblas::NoTrans ? n : k_pack);
+          math::gemm(op_a, op_b, m, n, k_pack, alpha, a_pack.get(), lda, b_pack.get(),
+              ldb, beta_pack, c, ldc);
+        }
+
+        first = last;
+      }
+    }
+
+  }  // namespace math
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_BATCHED_GEMM_H__INCLUDED
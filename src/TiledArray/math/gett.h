@@ -0,0 +1,234 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  gett.h
+ *  Mar 28, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_GETT_H__INCLUDED
+#define TILEDARRAY_MATH_GETT_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/math/blas.h>
+#include <TiledArray/permutation.h>
+#include <TiledArray/range.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+  namespace math {
+
+    /// The contracted extent of the blocks that are packed by \c gett
+
+    /// Contracted extents of up to twice this size are packed whole.
+    static constexpr integer gett_k_block = 512;
+
+    /// The maximum number of elements in a block that is packed by \c gett
+    static constexpr integer gett_pack_limit = 524288;
+
+    namespace detail {
+
+      /// Pack a block of a tensor into a row-major matrix
+
+      /// \tparam T The tensor element type
+      /// \param rows The number of rows in the block
+      /// \param cols The number of columns in the block
+      /// \param data The tensor data
+      /// \param row The offsets of the rows of the block
+      /// \param col The offsets of the columns of the block
+      /// \param result The packed matrix
+      template <typename T>
+      inline void gett_pack(const integer rows, const integer cols,
+          const T* const data, const std::size_t* const row,
+          const std::size_t* const col, T* const result)
+      {
+        for(integer i = 0; i < rows; ++i) {
+          const T* MADNESS_RESTRICT const data_i = data + row[i];
+          const std::size_t* MADNESS_RESTRICT const col_i = col;
+          T* MADNESS_RESTRICT const result_i = result + i * cols;
+          for(integer j = 0; j < cols; ++j)
+            result_i[j] = data_i[col_i[j]];
+        }
+      }
+
+    }  // namespace detail
+
+    /// Element offsets of a group of tensor dimensions
+
+    /// Computes the offsets, relative to the first element of a tensor, of
+    /// the elements of the fused dimensions <tt>[first, last)</tt> of the
+    /// tensor permuted by \c perm , in row-major order. The data of the
+    /// tensor is not permuted; the offsets refer to its original layout, so
+    /// element \c (i,j) of a permuted tensor viewed as a matrix with row
+    /// dimensions \c R and column dimensions \c C is at
+    /// <tt>row[i] + col[j]</tt>, where \c row and \c col are the offsets of
+    /// \c R and \c C .
+    /// \param range The range of the tensor
+    /// \param perm The permutation that is applied to the tensor (an empty
+    /// permutation is the identity)
+    /// \param first The first permuted dimension of the group
+    /// \param last The end of the permuted dimension group
+    /// \return The offsets of the elements of the group
+    inline std::vector<std::size_t>
+    permuted_offsets(const Range& range, const Permutation& perm,
+        const unsigned int first, const unsigned int last)
+    {
+      TA_ASSERT(first <= last);
+      TA_ASSERT(last <= range.rank());
+      TA_ASSERT(! perm || (perm.dim() == range.rank()));
+
+      // Find the original dimension of each permuted dimension
+      std::vector<unsigned int> dims(range.rank());
+      for(unsigned int i = 0u; i < range.rank(); ++i)
+        dims[perm ? perm[i] : i] = i;
+
+      std::size_t volume = 1ul;
+      for(unsigned int j = first; j < last; ++j)
+        volume *= range.extent_data()[dims[j]];
+
+      // Expand the offsets one dimension at a time
+      std::vector<std::size_t> offsets;
+      offsets.reserve(volume);
+      offsets.push_back(0ul);
+      for(unsigned int j = first; j < last; ++j) {
+        const std::size_t extent = range.extent_data()[dims[j]];
+        const std::size_t stride = range.stride_data()[dims[j]];
+        const std::size_t size = offsets.size();
+        offsets.resize(size * extent);
+        for(std::size_t x = size; x-- > 0ul; ) {
+          const std::size_t offset = offsets[x];
+          for(std::size_t y = 0ul; y < extent; ++y)
+            offsets[x * extent + y] = offset + y * stride;
+        }
+      }
+
+      return offsets;
+    }
+
+    /// General tensor times tensor
+
+    /// This evaluates
+    /// \f[
+    ///   C = \beta C + \alpha A B
+    /// \f]
+    /// where \f$ A \f$ is an \f$ m \times k \f$ matrix and \f$ B \f$ is a
+    /// \f$ k \times n \f$ matrix that are views of tensors with an arbitrary
+    /// layout: element \f$ A_{ip} \f$ is <tt>a[a_row[i] + a_col[p]]</tt> and
+    /// element \f$ B_{pj} \f$ is <tt>b[b_row[p] + b_col[j]]</tt> (see
+    /// \c permuted_offsets ). Blocks of the operands, with at most
+    /// \c gett_pack_limit elements each, are packed directly from the tensor
+    /// layout into matrices that are contracted with \c math::gemm , so the
+    /// tensors are never permuted into a temporary copy. Each block is packed
+    /// as a row-major or column-major matrix, whichever reads the tensor with
+    /// the smaller stride. \f$ C \f$ is row-major.
+    /// \tparam S1 The \c alpha scalar type
+    /// \tparam T1 The left-hand tensor element type
+    /// \tparam T2 The right-hand tensor element type
+    /// \tparam S2 The \c beta scalar type
+    /// \tparam T3 The result matrix element type
+    /// \param m The number of rows of the result
+    /// \param n The number of columns of the result
+    /// \param k The contracted extent
+    /// \param alpha The scaling factor of the product
+    /// \param a The left-hand tensor data
+    /// \param a_row The row offsets of \c a
+    /// \param a_col The column offsets of \c a
+    /// \param b The right-hand tensor data
+    /// \param b_row The row offsets of \c b
+    /// \param b_col The column offsets of \c b
+    /// \param beta The scaling factor of \c c
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline void gett(const integer m, const integer n, const integer k,
+        const S1 alpha, const T1* const a, const std::size_t* const a_row,
+        const std::size_t* const a_col, const T2* const b,
+        const std::size_t* const b_row, const std::size_t* const b_col,
+        const S2 beta, T3* const c, const integer ldc)
+    {
+      TA_ASSERT(m >= 0);
+      TA_ASSERT(n >= 0);
+      TA_ASSERT(k >= 0);
+
+      if((m == 0) || (n == 0))
+        return;
+      if(k == 0) {
+        // Only scale the result
+        for(integer i = 0; i < m; ++i) {
+          T3* MADNESS_RESTRICT const c_i = c + i * ldc;
+          for(integer j = 0; j < n; ++j)
+            c_i[j] = (beta == S2(0) ? T3(0) : c_i[j] * beta);
+        }
+        return;
+      }
+
+      // Select the block sizes so each packed block has at most
+      // gett_pack_limit elements
+      const integer kc = (k <= 2 * gett_k_block ? k : gett_k_block);
+      const integer block = std::max<integer>(gett_pack_limit / kc, 1);
+      const integer mc = std::min(m, block);
+      const integer nc = std::min(n, block);
+      std::unique_ptr<T1[]> a_pack(new T1[mc * kc]);
+      std::unique_ptr<T2[]> b_pack(new T2[kc * nc]);
+
+      // Pack each block in the orientation in which the tensor is read with
+      // the smallest stride
+      const bool a_trans = (m > 1) && (k > 1) &&
+          ((a_row[1] - a_row[0]) < (a_col[1] - a_col[0]));
+      const bool b_trans = (n > 1) && (k > 1) &&
+          ((b_row[1] - b_row[0]) < (b_col[1] - b_col[0]));
+
+      for(integer jc = 0; jc < n; jc += nc) {
+        const integer nb = std::min(nc, n - jc);
+
+        for(integer pc = 0; pc < k; pc += kc) {
+          const integer kb = std::min(kc, k - pc);
+
+          // The result is scaled by beta only with the first block
+          const S2 beta_block = (pc == 0 ? beta : S2(1));
+
+          // Pack the kb x nb block of B
+          if(b_trans)
+            detail::gett_pack(nb, kb, b, b_col + jc, b_row + pc, b_pack.get());
+          else
+            detail::gett_pack(kb, nb, b, b_row + pc, b_col + jc, b_pack.get());
+
+          for(integer ic = 0; ic < m; ic += mc) {
+            const integer mb = std::min(mc, m - ic);
+
+            // Pack the mb x kb block of A
+            if(a_trans)
+              detail::gett_pack(kb, mb, a, a_col + pc, a_row + ic, a_pack.get());
+            else
+              detail::gett_pack(mb, kb, a, a_row + ic, a_col + pc, a_pack.get());
+
+            math::gemm((a_trans ? madness::cblas::Trans : madness::cblas::NoTrans),
+                (b_trans ? madness::cblas::Trans : madness::cblas::NoTrans),
+                mb, nb, kb, alpha, a_pack.get(), (a_trans ? mb : kb),
+                b_pack.get(), (b_trans ? kb : nb), beta_block,
+                c + ic * ldc + jc, ldc);
+          }
+        }
+      }
+    }
+
+  }  // namespace math
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_GETT_H__INCLUDED
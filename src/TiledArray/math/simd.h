@@ -0,0 +1,953 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  simd.h
+ *  Mar 19, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_SIMD_H__INCLUDED
+#define TILEDARRAY_MATH_SIMD_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/math/vector_op.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+// The explicit kernels are written with the GCC vector extensions, which are
+// also supported by clang. Kernels for each instruction set are compiled with
+// the target attribute and selected at runtime, so they do not depend on the
+// compiler flags used to build TiledArray.
+#if (defined(__GNUC__) || defined(__clang__)) && ! defined(__INTEL_COMPILER)
+# if defined(__x86_64__) || defined(__i386__)
+#  define TILEDARRAY_SIMD_X86 1
+# elif defined(__aarch64__) && defined(__ARM_NEON)
+#  define TILEDARRAY_SIMD_NEON 1
+# endif
+#endif
+
+namespace TiledArray {
+  namespace math {
+    namespace simd {
+
+      /// Instruction set levels of the SIMD kernels
+      enum class Level {
+        generic = 0, ///< Portable kernels
+        neon = 1,    ///< ARM NEON (128-bit vectors)
+        avx2 = 2,    ///< x86 AVX2 and FMA (256-bit vectors)
+        avx512 = 3   ///< x86 AVX-512F (512-bit vectors)
+      };
+
+      /// Name of a SIMD level
+
+      /// \param l The SIMD level
+      /// \return The name of \c l
+      inline const char* level_name(const Level l) {
+        switch(l) {
+          case Level::neon: return "neon";
+          case Level::avx2: return "avx2";
+          case Level::avx512: return "avx512";
+          default: return "generic";
+        }
+      }
+
+      /// Check that a SIMD level is supported by this process
+
+      /// \param l The SIMD level
+      /// \return \c true if kernels for \c l were compiled and the processor
+      /// supports the required instructions
+      inline bool supported(const Level l) {
+        switch(l) {
+#if defined(TILEDARRAY_SIMD_X86)
+          case Level::avx512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f");
+          case Level::avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(TILEDARRAY_SIMD_NEON)
+          case Level::neon:
+            return true;
+#endif
+          case Level::generic:
+            return true;
+          default:
+            return false;
+        }
+      }
+
+      /// The highest SIMD level that may be used by this process
+
+      /// This is the highest supported level, which may be lowered with the
+      /// \c TA_SIMD_LEVEL environment variable (one of \c generic, \c neon,
+      /// \c avx2, or \c avx512).
+      /// \return The highest SIMD level
+      inline Level max_level() {
+        static const Level max = [] () {
+          Level l = Level::avx512;
+          while(! supported(l))
+            l = Level(int(l) - 1);
+
+          const char* env = std::getenv("TA_SIMD_LEVEL");
+          if(env) {
+            const std::string name(env);
+            for(Level e = Level::generic; e < l; e = Level(int(e) + 1)) {
+              if(name == level_name(e)) {
+                l = e;
+                while(! supported(l))
+                  l = Level(int(l) - 1);
+                break;
+              }
+            }
+          }
+
+          return l;
+        }();
+        return max;
+      }
+
+      namespace detail {
+
+        inline std::atomic<int>& current_level() {
+          static std::atomic<int> current(static_cast<int>(max_level()));
+          return current;
+        }
+
+      } // namespace detail
+
+      /// The SIMD level used by the kernels
+
+      /// \return The current SIMD level
+      inline Level level() {
+        return Level(detail::current_level().load(std::memory_order_relaxed));
+      }
+
+      /// Set the SIMD level used by the kernels
+
+      /// \param l The requested SIMD level
+      /// \return The SIMD level in use, which is the highest supported level
+      /// that is not greater than \c l or \c max_level()
+      inline Level set_level(Level l) {
+        l = std::min(l, max_level());
+        while(! supported(l))
+          l = Level(int(l) - 1);
+        detail::current_level().store(int(l), std::memory_order_relaxed);
+        return l;
+      }
+
+      /// Check that the SIMD kernels support a type
+
+      /// \tparam T The element type
+      template <typename T>
+      struct is_simd_type : public std::false_type { };
+
+      template <>
+      struct is_simd_type<float> : public std::true_type { };
+
+      template <>
+      struct is_simd_type<double> : public std::true_type { };
+
+      template <>
+      struct is_simd_type<std::complex<float> > : public std::true_type { };
+
+      template <>
+      struct is_simd_type<std::complex<double> > : public std::true_type { };
+
+      namespace detail {
+
+        template <typename T>
+        struct real_type { typedef T type; };
+
+        template <typename T>
+        struct real_type<std::complex<T> > { typedef T type; };
+
+        /// Scalar kernel traits
+
+        /// This provides the interface of \c Vec for one element at a time,
+        /// and is used for the generic kernels.
+        /// \tparam T The element type
+        template <typename T>
+        struct Scalar {
+          typedef T type;
+          static constexpr std::size_t size = 1ul;
+
+          static TILEDARRAY_FORCE_INLINE void load(type& x, const T* const p) { x = *p; }
+          static TILEDARRAY_FORCE_INLINE void store(T* const p, const type& x) { *p = x; }
+          static TILEDARRAY_FORCE_INLINE void fill(type& x, const T value) { x = value; }
+          static TILEDARRAY_FORCE_INLINE void max_abs(type& result, const type& x) {
+            const T abs_x = std::abs(x);
+            if(abs_x > result) result = abs_x;
+          }
+          static TILEDARRAY_FORCE_INLINE void min_abs(type& result, const type& x) {
+            const T abs_x = std::abs(x);
+            if(abs_x < result) result = abs_x;
+          }
+          static TILEDARRAY_FORCE_INLINE T sum(const type& x) { return x; }
+          static TILEDARRAY_FORCE_INLINE T max(const type& x) { return x; }
+          static TILEDARRAY_FORCE_INLINE T min(const type& x) { return x; }
+        }; // struct Scalar
+
+#if defined(TILEDARRAY_SIMD_X86) || defined(TILEDARRAY_SIMD_NEON)
+        /// SIMD vector kernel traits
+
+        /// Vectors are passed by reference so the traits may be inlined into
+        /// kernels compiled for any instruction set without changing the
+        /// calling convention.
+        /// \tparam T The element type
+        /// \tparam Bytes The vector register size in bytes
+        template <typename T, std::size_t Bytes>
+        struct Vec {
+          typedef T type __attribute__((vector_size(Bytes)));
+          typedef decltype(type() < type()) mask_type;
+          static constexpr std::size_t size = Bytes / sizeof(T);
+
+          static TILEDARRAY_FORCE_INLINE void load(type& x, const T* const p) {
+            std::memcpy(&x, p, sizeof(type));
+          }
+
+          static TILEDARRAY_FORCE_INLINE void store(T* const p, const type& x) {
+            std::memcpy(p, &x, sizeof(type));
+          }
+
+          static TILEDARRAY_FORCE_INLINE void fill(type& x, const T value) {
+            for(std::size_t i = 0ul; i < size; ++i)
+              x[i] = value;
+          }
+
+          static TILEDARRAY_FORCE_INLINE void abs(type& abs_x, const type& x) {
+            type sign;
+            fill(sign, T(-0.0));
+            abs_x = (type)(~(mask_type)sign & (mask_type)x);
+          }
+
+          static TILEDARRAY_FORCE_INLINE void max_abs(type& result, const type& x) {
+            type abs_x;
+            abs(abs_x, x);
+            const mask_type m = (abs_x > result);
+            result = (type)((m & (mask_type)abs_x) | (~m & (mask_type)result));
+          }
+
+          static TILEDARRAY_FORCE_INLINE void min_abs(type& result, const type& x) {
+            type abs_x;
+            abs(abs_x, x);
+            const mask_type m = (abs_x < result);
+            result = (type)((m & (mask_type)abs_x) | (~m & (mask_type)result));
+          }
+
+          static TILEDARRAY_FORCE_INLINE T sum(const type& x) {
+            T result = x[0];
+            for(std::size_t i = 1ul; i < size; ++i)
+              result += x[i];
+            return result;
+          }
+
+          static TILEDARRAY_FORCE_INLINE T max(const type& x) {
+            T result = x[0];
+            for(std::size_t i = 1ul; i < size; ++i)
+              if(x[i] > result) result = x[i];
+            return result;
+          }
+
+          static TILEDARRAY_FORCE_INLINE T min(const type& x) {
+            T result = x[0];
+            for(std::size_t i = 1ul; i < size; ++i)
+              if(x[i] < result) result = x[i];
+            return result;
+          }
+        }; // struct Vec
+#endif // defined(TILEDARRAY_SIMD_X86) || defined(TILEDARRAY_SIMD_NEON)
+
+        // Element-wise operations, which are applied to both vectors and
+        // scalars
+
+        template <typename T>
+        struct ScaleOp {
+          const T factor;
+          template <typename U>
+          TILEDARRAY_FORCE_INLINE void operator()(U& x) const { x *= factor; }
+        };
+
+        template <typename T>
+        struct AxpyOp {
+          const T factor;
+          template <typename U>
+          TILEDARRAY_FORCE_INLINE void operator()(U& y, const U& x) const
+          { y += x * factor; }
+        };
+
+        struct AddOp {
+          template <typename U>
+          TILEDARRAY_FORCE_INLINE void operator()(U& y, const U& x) const
+          { y += x; }
+        };
+
+        template <typename T>
+        struct ScalAddOp {
+          const T factor;
+          template <typename U>
+          TILEDARRAY_FORCE_INLINE void operator()(U& y, const U& x) const
+          { y = (y + x) * factor; }
+        };
+
+        struct SubtOp {
+          template <typename U>
+          TILEDARRAY_FORCE_INLINE void operator()(U& y, const U& x) const
+          { y -= x; }
+        };
+
+        template <typename T>
+        struct ScalSubtOp {
+          const T factor;
+          template <typename U>
+          TILEDARRAY_FORCE_INLINE void operator()(U& y, const U& x) const
+          { y = (y - x) * factor; }
+        };
+
+        struct MultOp {
+          template <typename U>
+          TILEDARRAY_FORCE_INLINE void operator()(U& y, const U& x) const
+          { y *= x; }
+        };
+
+        template <typename T>
+        struct ScalMultOp {
+          const T factor;
+          template <typename U>
+          TILEDARRAY_FORCE_INLINE void operator()(U& y, const U& x) const
+          { y = (y * x) * factor; }
+        };
+
+        /// Kernels that are compiled for each instruction set
+
+        /// \tparam V The kernel traits, \c Vec or \c Scalar
+        template <typename V>
+        struct Kernels {
+          typedef typename V::type vec_type;
+          static constexpr std::size_t size = V::size;
+
+          /// <tt>op(x[i])</tt>
+          template <typename T, typename Op>
+          static TILEDARRAY_FORCE_INLINE void
+          inplace_unary(const std::size_t n, T* const x, const Op& op) {
+            vec_type x0;
+            const std::size_t nv = n - (n % size);
+            std::size_t i = 0ul;
+            for(; i < nv; i += size) {
+              V::load(x0, x + i);
+              op(x0);
+              V::store(x + i, x0);
+            }
+            for(; i < n; ++i)
+              op(x[i]);
+          }
+
+          /// <tt>op(y[i], x[i])</tt>
+          template <typename T, typename Op>
+          static TILEDARRAY_FORCE_INLINE void
+          inplace_binary(const std::size_t n, T* const y, const T* const x,
+              const Op& op)
+          {
+            vec_type y0, x0;
+            const std::size_t nv = n - (n % size);
+            std::size_t i = 0ul;
+            for(; i < nv; i += size) {
+              V::load(y0, y + i);
+              V::load(x0, x + i);
+              op(y0, x0);
+              V::store(y + i, y0);
+            }
+            for(; i < n; ++i)
+              op(y[i], x[i]);
+          }
+
+          /// Sum of <tt>x[i] * x[i]</tt>
+          template <typename T>
+          static TILEDARRAY_FORCE_INLINE T
+          squared_norm(const std::size_t n, const T* const x) {
+            vec_type acc0, acc1, acc2, acc3, x0, x1, x2, x3;
+            V::fill(acc0, T(0));
+            acc3 = acc2 = acc1 = acc0;
+            std::size_t i = 0ul;
+            for(; (i + 4ul * size) <= n; i += 4ul * size) {
+              V::load(x0, x + i);
+              V::load(x1, x + i + size);
+              V::load(x2, x + i + 2ul * size);
+              V::load(x3, x + i + 3ul * size);
+              acc0 += x0 * x0;
+              acc1 += x1 * x1;
+              acc2 += x2 * x2;
+              acc3 += x3 * x3;
+            }
+            for(; (i + size) <= n; i += size) {
+              V::load(x0, x + i);
+              acc0 += x0 * x0;
+            }
+            acc0 += acc1;
+            acc2 += acc3;
+            acc0 += acc2;
+            T result = V::sum(acc0);
+            for(; i < n; ++i)
+              result += x[i] * x[i];
+            return result;
+          }
+
+          /// Sum of <tt>x[i] * y[i]</tt>
+          template <typename T>
+          static TILEDARRAY_FORCE_INLINE T
+          dot(const std::size_t n, const T* const x, const T* const y) {
+            vec_type acc0, acc1, acc2, acc3, x0, x1, x2, x3, y0, y1, y2, y3;
+            V::fill(acc0, T(0));
+            acc3 = acc2 = acc1 = acc0;
+            std::size_t i = 0ul;
+            for(; (i + 4ul * size) <= n; i += 4ul * size) {
+              V::load(x0, x + i);
+              V::load(x1, x + i + size);
+              V::load(x2, x + i + 2ul * size);
+              V::load(x3, x + i + 3ul * size);
+              V::load(y0, y + i);
+              V::load(y1, y + i + size);
+              V::load(y2, y + i + 2ul * size);
+              V::load(y3, y + i + 3ul * size);
+              acc0 += x0 * y0;
+              acc1 += x1 * y1;
+              acc2 += x2 * y2;
+              acc3 += x3 * y3;
+            }
+            for(; (i + size) <= n; i += size) {
+              V::load(x0, x + i);
+              V::load(y0, y + i);
+              acc0 += x0 * y0;
+            }
+            acc0 += acc1;
+            acc2 += acc3;
+            acc0 += acc2;
+            T result = V::sum(acc0);
+            for(; i < n; ++i)
+              result += x[i] * y[i];
+            return result;
+          }
+
+          /// Maximum of <tt>abs(x[i])</tt>, or zero when \c n is zero
+          template <typename T>
+          static TILEDARRAY_FORCE_INLINE T
+          abs_max(const std::size_t n, const T* const x) {
+            vec_type acc0, acc1, x0, x1;
+            V::fill(acc0, T(0));
+            acc1 = acc0;
+            std::size_t i = 0ul;
+            for(; (i + 2ul * size) <= n; i += 2ul * size) {
+              V::load(x0, x + i);
+              V::load(x1, x + i + size);
+              V::max_abs(acc0, x0);
+              V::max_abs(acc1, x1);
+            }
+            for(; (i + size) <= n; i += size) {
+              V::load(x0, x + i);
+              V::max_abs(acc0, x0);
+            }
+            V::max_abs(acc0, acc1);
+            T result = V::max(acc0);
+            for(; i < n; ++i)
+              Scalar<T>::max_abs(result, x[i]);
+            return result;
+          }
+
+          /// Minimum of <tt>abs(x[i])</tt>, or the largest value of \c T
+          /// when \c n is zero
+          template <typename T>
+          static TILEDARRAY_FORCE_INLINE T
+          abs_min(const std::size_t n, const T* const x) {
+            vec_type acc0, acc1, x0, x1;
+            V::fill(acc0, std::numeric_limits<T>::max());
+            acc1 = acc0;
+            std::size_t i = 0ul;
+            for(; (i + 2ul * size) <= n; i += 2ul * size) {
+              V::load(x0, x + i);
+              V::load(x1, x + i + size);
+              V::min_abs(acc0, x0);
+              V::min_abs(acc1, x1);
+            }
+            for(; (i + size) <= n; i += size) {
+              V::load(x0, x + i);
+              V::min_abs(acc0, x0);
+            }
+            V::min_abs(acc0, acc1);
+            T result = V::min(acc0);
+            for(; i < n; ++i)
+              Scalar<T>::min_abs(result, x[i]);
+            return result;
+          }
+        }; // struct Kernels
+
+        /// Define an instruction set entry point for each kernel
+
+        /// The kernels are inlined into functions that are compiled for the
+        /// instruction set given by \c ATTR .
+#define TILEDARRAY_SIMD_ISA( NAME , VEC , ATTR ) \
+        struct NAME { \
+          template <typename T, typename Op> ATTR \
+          static void inplace_unary(const std::size_t n, T* const x, const Op& op) \
+          { Kernels<VEC<T> >::inplace_unary(n, x, op); } \
+          template <typename T, typename Op> ATTR \
+          static void inplace_binary(const std::size_t n, T* const y, const T* const x, \
+              const Op& op) \
+          { Kernels<VEC<T> >::inplace_binary(n, y, x, op); } \
+          template <typename T> ATTR \
+          static T squared_norm(const std::size_t n, const T* const x) \
+          { return Kernels<VEC<T> >::squared_norm(n, x); } \
+          template <typename T> ATTR \
+          static T dot(const std::size_t n, const T* const x, const T* const y) \
+          { return Kernels<VEC<T> >::dot(n, x, y); } \
+          template <typename T> ATTR \
+          static T abs_max(const std::size_t n, const T* const x) \
+          { return Kernels<VEC<T> >::abs_max(n, x); } \
+          template <typename T> ATTR \
+          static T abs_min(const std::size_t n, const T* const x) \
+          { return Kernels<VEC<T> >::abs_min(n, x); } \
+        }
+
+        TILEDARRAY_SIMD_ISA(Generic, Scalar, );
+
+#if defined(TILEDARRAY_SIMD_X86)
+        template <typename T>
+        using Vec256 = Vec<T, 32ul>;
+        template <typename T>
+        using Vec512 = Vec<T, 64ul>;
+
+        TILEDARRAY_SIMD_ISA(Avx2, Vec256, __attribute__((target("avx2,fma"))));
+        TILEDARRAY_SIMD_ISA(Avx512, Vec512, __attribute__((target("avx512f,avx2,fma"))));
+#elif defined(TILEDARRAY_SIMD_NEON)
+        template <typename T>
+        using Vec128 = Vec<T, 16ul>;
+
+        TILEDARRAY_SIMD_ISA(Neon, Vec128, );
+#endif
+
+#undef TILEDARRAY_SIMD_ISA
+
+        /// Call \c f with the instruction set of the current SIMD level
+
+        /// \tparam F The function type
+        /// \param f A function that is called as <tt>f(isa)</tt>
+        /// \return The result of \c f
+        template <typename F>
+        TILEDARRAY_FORCE_INLINE decltype(auto) dispatch(F&& f) {
+          switch(level()) {
+#if defined(TILEDARRAY_SIMD_X86)
+            case Level::avx512: return f(Avx512());
+            case Level::avx2: return f(Avx2());
+#elif defined(TILEDARRAY_SIMD_NEON)
+            case Level::neon: return f(Neon());
+#endif
+            default: return f(Generic());
+          }
+        }
+
+        /// Evaluate an element-wise operation in blocks
+
+        /// Large operations are evaluated in parallel in the same way as
+        /// \c inplace_vector_op .
+        /// \tparam Op The block operation type
+        /// \param n The number of elements
+        /// \param op The block operation, called as <tt>op(offset, size)</tt>
+        template <typename Op>
+        inline void for_blocks(const std::size_t n, const Op& op) {
+#ifdef HAVE_INTEL_TBB
+          tbb::parallel_for(SizeTRange(0ul, n),
+              [&] (const SizeTRange& range) { op(range.begin(), range.size()); },
+              tbb::auto_partitioner());
+#else
+          const std::size_t blocks = vector_op_blocks(n);
+          if(blocks > 1ul)
+            vector_op_parallel(n, blocks,
+                [&] (const std::size_t, const std::size_t offset, const std::size_t size)
+                { op(offset, size); });
+          else
+            op(0ul, n);
+#endif
+        }
+
+        /// Evaluate a reduction in blocks
+
+        /// Large reductions are evaluated in parallel in the same way as
+        /// \c reduce_op . Without TBB, the partial results are joined in
+        /// block order.
+        /// \tparam Op The block reduction type
+        /// \tparam JoinOp The join operation type
+        /// \tparam R The result type
+        /// \param n The number of elements
+        /// \param op The block reduction, called as <tt>op(offset, size)</tt>
+        /// \param join_op The join operation, called as <tt>join_op(r1, r2)</tt>
+        /// \param identity The identity of \c join_op
+        /// \return The result of the reduction
+        template <typename Op, typename JoinOp, typename R>
+        inline R reduce_blocks(const std::size_t n, const Op& op,
+            const JoinOp& join_op, const R identity)
+        {
+#ifdef HAVE_INTEL_TBB
+          return tbb::parallel_reduce(SizeTRange(0ul, n), identity,
+              [&] (const SizeTRange& range, const R result)
+              { return join_op(result, op(range.begin(), range.size())); },
+              join_op, tbb::auto_partitioner());
+#else
+          const std::size_t blocks = vector_op_blocks(n);
+          if(blocks == 1ul)
+            return join_op(identity, op(0ul, n));
+
+          std::vector<R> partial(blocks);
+          vector_op_parallel(n, blocks,
+              [&] (const std::size_t b, const std::size_t offset, const std::size_t size)
+              { partial[b] = op(offset, size); });
+          R result = identity;
+          for(const R& p : partial)
+            result = join_op(result, p);
+          return result;
+#endif
+        }
+
+        template <typename T>
+        inline typename real_type<T>::type* real_data(T* const x) {
+          return reinterpret_cast<typename real_type<T>::type*>(x);
+        }
+
+        template <typename T>
+        inline const typename real_type<T>::type* real_data(const T* const x) {
+          return reinterpret_cast<const typename real_type<T>::type*>(x);
+        }
+
+        template <typename T>
+        struct real_size {
+          static constexpr std::size_t value = sizeof(T) / sizeof(typename real_type<T>::type);
+        };
+
+        /// Apply an element-wise operation that is linear in the real and
+        /// imaginary parts, so complex data may be treated as real data
+        template <typename T, typename Op>
+        inline void real_inplace_unary(const std::size_t n, T* const x, const Op& op) {
+          auto* const rx = real_data(x);
+          for_blocks(n * real_size<T>::value,
+              [=] (const std::size_t offset, const std::size_t size) {
+                dispatch([=] (auto isa) { decltype(isa)::inplace_unary(size, rx + offset, op); });
+              });
+        }
+
+        template <typename T, typename Op>
+        inline void real_inplace_binary(const std::size_t n, T* const y,
+            const T* const x, const Op& op)
+        {
+          auto* const ry = real_data(y);
+          const auto* const rx = real_data(x);
+          for_blocks(n * real_size<T>::value,
+              [=] (const std::size_t offset, const std::size_t size) {
+                dispatch([=] (auto isa)
+                    { decltype(isa)::inplace_binary(size, ry + offset, rx + offset, op); });
+              });
+        }
+
+        /// Apply an element-wise operation that mixes the real and imaginary
+        /// parts of complex data, which always uses the generic kernels
+        template <typename T, typename Op>
+        inline void complex_inplace_binary(const std::size_t n, T* const y,
+            const T* const x, const Op& op)
+        {
+          for_blocks(n, [=] (const std::size_t offset, const std::size_t size)
+              { Generic::inplace_binary(size, y + offset, x + offset, op); });
+        }
+
+        template <typename T>
+        struct Plus {
+          TILEDARRAY_FORCE_INLINE T operator()(const T x, const T y) const { return x + y; }
+        };
+
+        template <typename T>
+        struct Max {
+          TILEDARRAY_FORCE_INLINE T operator()(const T x, const T y) const
+          { return (y > x ? y : x); }
+        };
+
+        template <typename T>
+        struct Min {
+          TILEDARRAY_FORCE_INLINE T operator()(const T x, const T y) const
+          { return (y < x ? y : x); }
+        };
+
+      } // namespace detail
+
+      /// Scale a vector
+
+      /// <tt>x[i] *= a</tt>
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param a The scaling factor
+      /// \param x The vector to be scaled
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value>::type* = nullptr>
+      inline void scale_to(const std::size_t n,
+          const typename detail::real_type<T>::type a, T* const x)
+      {
+        detail::real_inplace_unary(n, x,
+            detail::ScaleOp<typename detail::real_type<T>::type>{a});
+      }
+
+      /// Scale and add a vector
+
+      /// <tt>y[i] += a * x[i]</tt>
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param a The scaling factor
+      /// \param x The vector to be scaled
+      /// \param y The vector to be added to
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value>::type* = nullptr>
+      inline void axpy(const std::size_t n, const typename detail::real_type<T>::type a,
+          const T* const x, T* const y)
+      {
+        detail::real_inplace_binary(n, y, x,
+            detail::AxpyOp<typename detail::real_type<T>::type>{a});
+      }
+
+      /// Add a vector
+
+      /// <tt>y[i] += x[i]</tt>
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The vector to be added
+      /// \param y The vector to be added to
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value>::type* = nullptr>
+      inline void add_to(const std::size_t n, const T* const x, T* const y) {
+        detail::real_inplace_binary(n, y, x, detail::AddOp());
+      }
+
+      /// Add a vector and scale the result
+
+      /// <tt>y[i] = (y[i] + x[i]) * factor</tt>
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The vector to be added
+      /// \param y The vector to be added to
+      /// \param factor The scaling factor
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value>::type* = nullptr>
+      inline void add_to(const std::size_t n, const T* const x, T* const y,
+          const typename detail::real_type<T>::type factor)
+      {
+        detail::real_inplace_binary(n, y, x,
+            detail::ScalAddOp<typename detail::real_type<T>::type>{factor});
+      }
+
+      /// Subtract a vector
+
+      /// <tt>y[i] -= x[i]</tt>
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The vector to be subtracted
+      /// \param y The vector to be subtracted from
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value>::type* = nullptr>
+      inline void subt_to(const std::size_t n, const T* const x, T* const y) {
+        detail::real_inplace_binary(n, y, x, detail::SubtOp());
+      }
+
+      /// Subtract a vector and scale the result
+
+      /// <tt>y[i] = (y[i] - x[i]) * factor</tt>
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The vector to be subtracted
+      /// \param y The vector to be subtracted from
+      /// \param factor The scaling factor
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value>::type* = nullptr>
+      inline void subt_to(const std::size_t n, const T* const x, T* const y,
+          const typename detail::real_type<T>::type factor)
+      {
+        detail::real_inplace_binary(n, y, x,
+            detail::ScalSubtOp<typename detail::real_type<T>::type>{factor});
+      }
+
+      /// Multiply by a vector
+
+      /// <tt>y[i] *= x[i]</tt>. Complex products use the generic kernels.
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The vector to multiply by
+      /// \param y The vector to be multiplied
+      template <typename T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+      inline void mult_to(const std::size_t n, const T* const x, T* const y) {
+        detail::real_inplace_binary(n, y, x, detail::MultOp());
+      }
+
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value &&
+          ! std::is_floating_point<T>::value>::type* = nullptr>
+      inline void mult_to(const std::size_t n, const T* const x, T* const y) {
+        detail::complex_inplace_binary(n, y, x, detail::MultOp());
+      }
+
+      /// Multiply by a vector and scale the result
+
+      /// <tt>y[i] = (y[i] * x[i]) * factor</tt>. Complex products use the
+      /// generic kernels.
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The vector to multiply by
+      /// \param y The vector to be multiplied
+      /// \param factor The scaling factor
+      template <typename T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+      inline void mult_to(const std::size_t n, const T* const x, T* const y,
+          const typename detail::real_type<T>::type factor)
+      {
+        detail::real_inplace_binary(n, y, x, detail::ScalMultOp<T>{factor});
+      }
+
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value &&
+          ! std::is_floating_point<T>::value>::type* = nullptr>
+      inline void mult_to(const std::size_t n, const T* const x, T* const y,
+          const typename detail::real_type<T>::type factor)
+      {
+        detail::complex_inplace_binary(n, y, x,
+            detail::ScalMultOp<typename detail::real_type<T>::type>{factor});
+      }
+
+      /// Square of the vector 2-norm
+
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The vector
+      /// \return The sum of the squared magnitudes of the elements of \c x
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value>::type* = nullptr>
+      inline typename detail::real_type<T>::type
+      squared_norm(const std::size_t n, const T* const x) {
+        typedef typename detail::real_type<T>::type real_type;
+        const real_type* const rx = detail::real_data(x);
+        return detail::reduce_blocks(n * detail::real_size<T>::value,
+            [=] (const std::size_t offset, const std::size_t size) {
+              return detail::dispatch([=] (auto isa)
+                  { return decltype(isa)::squared_norm(size, rx + offset); });
+            }, detail::Plus<real_type>(), real_type(0));
+      }
+
+      /// Vector dot product
+
+      /// The dot product does not conjugate complex elements, and complex
+      /// products use the generic kernels.
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The left-hand vector
+      /// \param y The right-hand vector
+      /// \return The sum of <tt>x[i] * y[i]</tt>
+      template <typename T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+      inline T dot(const std::size_t n, const T* const x, const T* const y) {
+        return detail::reduce_blocks(n,
+            [=] (const std::size_t offset, const std::size_t size) {
+              return detail::dispatch([=] (auto isa)
+                  { return decltype(isa)::dot(size, x + offset, y + offset); });
+            }, detail::Plus<T>(), T(0));
+      }
+
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value &&
+          ! std::is_floating_point<T>::value>::type* = nullptr>
+      inline T dot(const std::size_t n, const T* const x, const T* const y) {
+        return detail::reduce_blocks(n,
+            [=] (const std::size_t offset, const std::size_t size)
+            { return detail::Generic::dot(size, x + offset, y + offset); },
+            detail::Plus<T>(), T(0));
+      }
+
+      /// Maximum absolute value
+
+      /// Absolute values of complex elements use the generic kernels.
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The vector
+      /// \return The maximum of <tt>abs(x[i])</tt>, or zero if \c n is zero
+      template <typename T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+      inline T abs_max(const std::size_t n, const T* const x) {
+        return detail::reduce_blocks(n,
+            [=] (const std::size_t offset, const std::size_t size) {
+              return detail::dispatch([=] (auto isa)
+                  { return decltype(isa)::abs_max(size, x + offset); });
+            }, detail::Max<T>(), T(0));
+      }
+
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value &&
+          ! std::is_floating_point<T>::value>::type* = nullptr>
+      inline typename detail::real_type<T>::type
+      abs_max(const std::size_t n, const T* const x) {
+        typedef typename detail::real_type<T>::type real_type;
+        return detail::reduce_blocks(n,
+            [=] (const std::size_t offset, const std::size_t size) {
+              real_type result = 0;
+              for(std::size_t i = offset; i < (offset + size); ++i)
+                detail::Scalar<real_type>::max_abs(result, std::abs(x[i]));
+              return result;
+            }, detail::Max<real_type>(), real_type(0));
+      }
+
+      /// Minimum absolute value
+
+      /// Absolute values of complex elements use the generic kernels.
+      /// \tparam T The element type
+      /// \param n The number of elements
+      /// \param x The vector
+      /// \return The minimum of <tt>abs(x[i])</tt>, or the largest value of
+      /// the real type of \c T if \c n is zero
+      template <typename T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+      inline T abs_min(const std::size_t n, const T* const x) {
+        return detail::reduce_blocks(n,
+            [=] (const std::size_t offset, const std::size_t size) {
+              return detail::dispatch([=] (auto isa)
+                  { return decltype(isa)::abs_min(size, x + offset); });
+            }, detail::Min<T>(), std::numeric_limits<T>::max());
+      }
+
+      template <typename T,
+          typename std::enable_if<is_simd_type<T>::value &&
+          ! std::is_floating_point<T>::value>::type* = nullptr>
+      inline typename detail::real_type<T>::type
+      abs_min(const std::size_t n, const T* const x) {
+        typedef typename detail::real_type<T>::type real_type;
+        return detail::reduce_blocks(n,
+            [=] (const std::size_t offset, const std::size_t size) {
+              real_type result = std::numeric_limits<real_type>::max();
+              for(std::size_t i = offset; i < (offset + size); ++i)
+                detail::Scalar<real_type>::min_abs(result, std::abs(x[i]));
+              return result;
+            }, detail::Min<real_type>(), std::numeric_limits<real_type>::max());
+      }
+
+    }  // namespace simd
+  }  // namespace math
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_SIMD_H__INCLUDED
@@ -0,0 +1,351 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  sparse_gemm.h
+ *  Mar 2, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_SPARSE_GEMM_H__INCLUDED
+#define TILEDARRAY_MATH_SPARSE_GEMM_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/external/madness.h>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace TiledArray {
+  namespace math {
+
+    /// Compressed sparse row matrix of non-negative values
+
+    /// This is the argument type of \c sparse_gemm . Only the non-zero
+    /// elements of the source matrix are stored, so zero elements (e.g. the
+    /// norms of zero tiles) are screened out of the product before any
+    /// arithmetic is done.
+    /// \tparam T The element type
+    template <typename T>
+    class SparseMatrix {
+    public:
+      typedef T value_type; ///< Element type
+      typedef std::size_t size_type; ///< Size type
+      typedef std::pair<size_type, value_type> element_type;
+                  ///< A (column, value) pair
+
+    private:
+      size_type rows_ = 0ul; ///< Number of rows
+      size_type cols_ = 0ul; ///< Number of columns
+      std::vector<size_type> row_ptr_; ///< Offset of the first element of each row
+      std::vector<element_type> elements_; ///< Non-zero elements in row order
+
+      /// Fill the compressed rows
+
+      /// \tparam Ord The ordinal functor type
+      /// \tparam Val The value functor type
+      /// \param n The number of stored elements
+      /// \param trans If \c true the elements are stored in column-major order
+      /// \param ord A functor that returns the storage ordinal of element \c i
+      /// \param val A functor that returns the value of element \c i
+      template <typename Ord, typename Val>
+      void init(const size_type n, const bool trans, const Ord& ord, const Val& val) {
+        row_ptr_.assign(rows_ + 1ul, 0ul);
+        if(rows_ == 0ul || cols_ == 0ul)
+          return;
+
+        // Count the non-zero elements of each row
+        for(size_type i = 0ul; i < n; ++i)
+          if(val(i) != value_type(0)) {
+            const size_type o = ord(i);
+            ++row_ptr_[(trans ? o % rows_ : o / cols_) + 1ul];
+          }
+        for(size_type r = 0ul; r < rows_; ++r)
+          row_ptr_[r + 1ul] += row_ptr_[r];
+
+        // Scatter the non-zero elements into their rows
+        elements_.resize(row_ptr_.back());
+        std::vector<size_type> next(row_ptr_.begin(), row_ptr_.end() - 1);
+        for(size_type i = 0ul; i < n; ++i) {
+          const value_type v = val(i);
+          if(v != value_type(0)) {
+            const size_type o = ord(i);
+            const size_type r = (trans ? o % rows_ : o / cols_);
+            const size_type c = (trans ? o / rows_ : o % cols_);
+            elements_[next[r]++] = element_type(c, v);
+          }
+        }
+      }
+
+    public:
+
+      SparseMatrix() = default;
+      SparseMatrix(const SparseMatrix&) = default;
+      SparseMatrix(SparseMatrix&&) = default;
+      SparseMatrix& operator=(const SparseMatrix&) = default;
+      SparseMatrix& operator=(SparseMatrix&&) = default;
+
+      /// Compress a dense matrix
+
+      /// \param rows The number of rows
+      /// \param cols The number of columns
+      /// \param data A pointer to the \c rows*cols matrix elements
+      /// \param trans If \c true \c data is the column-major (i.e.
+      /// transposed) matrix
+      SparseMatrix(const size_type rows, const size_type cols,
+          const value_type* const data, const bool trans) :
+        rows_(rows), cols_(cols)
+      {
+        TA_ASSERT(data || (rows * cols == 0ul));
+        init(rows * cols, trans, [] (const size_type i) { return i; },
+            [data] (const size_type i) { return data[i]; });
+      }
+
+      /// Compress a list of non-zero matrix elements
+
+      /// \param rows The number of rows
+      /// \param cols The number of columns
+      /// \param ordinals The storage ordinals of the elements
+      /// \param values The element values
+      /// \param trans If \c true \c ordinals refer to the column-major (i.e.
+      /// transposed) matrix
+      SparseMatrix(const size_type rows, const size_type cols,
+          const std::vector<size_type>& ordinals,
+          const std::vector<value_type>& values, const bool trans) :
+        rows_(rows), cols_(cols)
+      {
+        TA_ASSERT(ordinals.size() == values.size());
+        init(ordinals.size(), trans,
+            [&ordinals] (const size_type i) { return ordinals[i]; },
+            [&values] (const size_type i) { return values[i]; });
+      }
+
+      /// Row count accessor
+
+      /// \return The number of rows
+      size_type rows() const { return rows_; }
+
+      /// Column count accessor
+
+      /// \return The number of columns
+      size_type cols() const { return cols_; }
+
+      /// Non-zero element count accessor
+
+      /// \return The number of non-zero elements
+      size_type nnz() const { return elements_.size(); }
+
+      /// Row iterator accessor
+
+      /// \param r The row index
+      /// \return A pointer to the first element of row \c r
+      const element_type* row_begin(const size_type r) const {
+        TA_ASSERT(r < rows_);
+        return elements_.data() + row_ptr_[r];
+      }
+
+      /// Row iterator accessor
+
+      /// \param r The row index
+      /// \return A pointer to one past the last element of row \c r
+      const element_type* row_end(const size_type r) const {
+        TA_ASSERT(r < rows_);
+        return elements_.data() + row_ptr_[r + 1ul];
+      }
+
+      /// Row non-zero element count accessor
+
+      /// \param r The row index
+      /// \return The number of non-zero elements in row \c r
+      size_type row_nnz(const size_type r) const {
+        TA_ASSERT(r < rows_);
+        return row_ptr_[r + 1ul] - row_ptr_[r];
+      }
+
+    }; // class SparseMatrix
+
+
+    /// The minimum number of products in a \c sparse_gemm row block
+
+    /// Row blocks of \c sparse_gemm are evaluated as separate tasks, so this
+    /// is the smallest amount of work that is worth the task overhead.
+    constexpr std::size_t sparse_gemm_grain_size = 65536ul;
+
+    /// Partition the rows of a sparse matrix product
+
+    /// The rows of the result are split into contiguous blocks with roughly
+    /// the same number of scalar products. The product is small enough to be
+    /// evaluated in one block if it has fewer than \c 2*sparse_gemm_grain_size
+    /// products or there are no worker threads.
+    /// \tparam T The element type
+    /// \param left The left-hand argument
+    /// \param right The right-hand argument
+    /// \return The first row of each block followed by the number of rows
+    template <typename T>
+    std::vector<std::size_t>
+    sparse_gemm_partition(const SparseMatrix<T>& left, const SparseMatrix<T>& right) {
+      typedef std::size_t size_type;
+      TA_ASSERT(left.cols() == right.rows());
+
+      const size_type M = left.rows();
+
+      // Count the number of scalar products in each row
+      std::vector<size_type> work(M, 0ul);
+      size_type total = 0ul;
+      for(size_type m = 0ul; m < M; ++m) {
+        for(auto it = left.row_begin(m); it != left.row_end(m); ++it)
+          work[m] += right.row_nnz(it->first);
+        total += work[m];
+      }
+
+      const size_type threads = madness::ThreadPool::size();
+      const size_type max_blocks = std::min(M, 4ul * (threads + 1ul));
+      const size_type blocks = (threads == 0ul ? 1ul :
+          std::max(size_type(1ul), std::min(total / sparse_gemm_grain_size, max_blocks)));
+
+      std::vector<size_type> partition;
+      partition.reserve(blocks + 1ul);
+      partition.push_back(0ul);
+      if(blocks > 1ul) {
+        const size_type block_work = (total + blocks - 1ul) / blocks;
+        size_type block_sum = 0ul;
+        for(size_type m = 0ul; m < M; ++m) {
+          block_sum += work[m];
+          if(block_sum >= block_work && (m + 1ul) < M) {
+            partition.push_back(m + 1ul);
+            block_sum = 0ul;
+          }
+        }
+      }
+      partition.push_back(M);
+
+      return partition;
+    }
+
+    /// Sparse matrix product over a block of rows
+
+    /// Each row of \f$ C = A \, {\rm diag}(w) \, B \f$ is accumulated in a
+    /// dense work vector, where only the columns that receive a contribution
+    /// are visited. \c op is called with the row index, the (unsorted) list
+    /// of columns that received contributions, and the work vector, which
+    /// holds the row values in those columns.
+    /// \tparam T The element type
+    /// \tparam Op The row operation type
+    /// \param left The left-hand argument, \c A
+    /// \param right The right-hand argument, \c B
+    /// \param weights The inner dimension weights, \c w ; may be \c nullptr ,
+    /// in which case all weights are one
+    /// \param first The first row of the block
+    /// \param last One past the last row of the block
+    /// \param op The row operation
+    template <typename T, typename Op>
+    void sparse_gemm(const SparseMatrix<T>& left, const SparseMatrix<T>& right,
+        const T* const weights, const std::size_t first, const std::size_t last,
+        const Op& op)
+    {
+      typedef std::size_t size_type;
+      TA_ASSERT(left.cols() == right.rows());
+      TA_ASSERT(first <= last);
+      TA_ASSERT(last <= left.rows());
+
+      std::vector<T> accumulator(right.cols(), T(0));
+      std::vector<char> touched(right.cols(), 0);
+      std::vector<size_type> columns;
+
+      for(size_type m = first; m < last; ++m) {
+        columns.clear();
+        for(auto l = left.row_begin(m); l != left.row_end(m); ++l) {
+          const size_type k = l->first;
+          const T a = (weights ? l->second * weights[k] : l->second);
+          for(auto r = right.row_begin(k); r != right.row_end(k); ++r) {
+            const size_type n = r->first;
+            if(! touched[n]) {
+              touched[n] = 1;
+              columns.push_back(n);
+            }
+            accumulator[n] += a * r->second;
+          }
+        }
+
+        if(columns.empty())
+          continue;
+
+        op(m, columns, static_cast<const T*>(accumulator.data()));
+
+        for(const size_type n : columns) {
+          accumulator[n] = T(0);
+          touched[n] = 0;
+        }
+      }
+    }
+
+    /// Sparse matrix product
+
+    /// Compute \f$ C = A \, {\rm diag}(w) \, B \f$ one row at a time. The
+    /// row blocks given by \c partition are evaluated concurrently by the
+    /// MADNESS task queue when there is more than one block, so \c op must
+    /// be safe to call concurrently for rows in different blocks.
+    /// \c op is called as <tt>op(block, m, columns, accumulator)</tt> ; see
+    /// the block version of \c sparse_gemm for a description of the other
+    /// arguments.
+    /// \tparam T The element type
+    /// \tparam Op The row operation type
+    /// \param left The left-hand argument, \c A
+    /// \param right The right-hand argument, \c B
+    /// \param weights The inner dimension weights, \c w ; may be \c nullptr
+    /// \param partition The row partition given by \c sparse_gemm_partition
+    /// \param op The row operation
+    template <typename T, typename Op>
+    void sparse_gemm(const SparseMatrix<T>& left, const SparseMatrix<T>& right,
+        const T* const weights, const std::vector<std::size_t>& partition,
+        const Op& op)
+    {
+      typedef std::size_t size_type;
+      TA_ASSERT(partition.size() >= 2ul);
+      const size_type blocks = partition.size() - 1ul;
+
+      auto eval_block = [&] (const size_type b) {
+        sparse_gemm(left, right, weights, partition[b], partition[b + 1ul],
+            [b,&op] (const size_type m, std::vector<size_type>& columns,
+                const T* const accumulator)
+            { op(b, m, columns, accumulator); });
+      };
+
+      if(blocks == 1ul) {
+        eval_block(0ul);
+        return;
+      }
+
+      // Spawn a task for all but the first block, which is evaluated here.
+      // The tasks return a value because Future<void> is always ready, so it
+      // cannot be used to wait for the tasks.
+      World& world = TiledArray::get_default_world();
+      std::vector<Future<bool> > done;
+      done.reserve(blocks - 1ul);
+      for(size_type b = 1ul; b < blocks; ++b)
+        done.push_back(world.taskq.add([eval_block,b] () {
+          eval_block(b);
+          return true;
+        }));
+      eval_block(0ul);
+      for(auto& d : done)
+        d.get();
+    }
+
+  }  // namespace math
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_SPARSE_GEMM_H__INCLUDED
@@ -29,6 +29,8 @@
 #include <TiledArray/type_traits.h>
 #include <TiledArray/external/madness.h>
 #include <TiledArray/config.h>
+#include <atomic>
+#include <vector>
 
 #define TILEDARRAY_LOOP_UNWIND ::TiledArray::math::LoopUnwind::value
 
@@ -336,6 +338,74 @@ namespace TiledArray {
 
 //    SizeTRange::set_grain_size(1024ul);
 
+#else
+
+    /// The minimum size of a vector operation that is evaluated in parallel
+
+    /// Without TBB, vector operations with at least this many elements are
+    /// split into blocks that are evaluated by the MADNESS thread pool.
+    constexpr std::size_t vector_op_parallel_threshold = 65536ul;
+
+    /// The number of elements in each block of a parallel vector operation
+    constexpr std::size_t vector_op_grain_size = 16384ul;
+
+    static_assert((vector_op_grain_size % TILEDARRAY_LOOP_UNWIND) == 0ul,
+        "vector_op_grain_size must be a multiple of the loop unwind size");
+
+    /// Number of blocks of a parallel vector operation
+
+    /// \param n The number of elements in the vector operation
+    /// \return The number of blocks the operation is split into, which is 1
+    /// when the operation is smaller than \c vector_op_parallel_threshold or
+    /// there are no worker threads
+    inline std::size_t vector_op_blocks(const std::size_t n) {
+      if((n < vector_op_parallel_threshold) || ! madness::initialized() ||
+          (madness::ThreadPool::size() == 0))
+        return 1ul;
+      return (n + vector_op_grain_size - 1ul) / vector_op_grain_size;
+    }
+
+    /// Evaluate the blocks of a vector operation in parallel
+
+    /// Blocks are claimed from a shared counter by the calling thread and by
+    /// up to one task per worker thread, so threads that are idle take over
+    /// the remaining blocks of threads that are busy. This function returns
+    /// when all blocks have been evaluated.
+    /// \tparam Op The block operation type
+    /// \param n The number of elements in the vector operation
+    /// \param blocks The number of blocks, given by \c vector_op_blocks
+    /// \param op The block operation, which is called as
+    /// <tt>op(block, offset, size)</tt> and must be safe to call concurrently
+    template <typename Op>
+    void vector_op_parallel(const std::size_t n, const std::size_t blocks,
+        const Op& op)
+    {
+      std::atomic<std::size_t> next(0ul);
+      auto eval_blocks = [&] () {
+        for(std::size_t b = next++; b < blocks; b = next++) {
+          const std::size_t offset = b * vector_op_grain_size;
+          op(b, offset, std::min(vector_op_grain_size, n - offset));
+        }
+      };
+
+      // Spawn helper tasks and evaluate blocks here until none are left. The
+      // tasks return a value because Future<void> is always ready, so it
+      // cannot be used to wait for the tasks.
+      World& world = TiledArray::get_default_world();
+      const std::size_t tasks =
+          std::min<std::size_t>(madness::ThreadPool::size(), blocks - 1ul);
+      std::vector<Future<bool> > done;
+      done.reserve(tasks);
+      for(std::size_t t = 0ul; t < tasks; ++t)
+        done.push_back(world.taskq.add([&eval_blocks] () {
+          eval_blocks();
+          return true;
+        }));
+      eval_blocks();
+      for(auto& d : done)
+        d.get();
+    }
+
 #endif
 
     template <typename Op, typename Result, typename... Args,
@@ -412,7 +482,13 @@ namespace TiledArray {
 
         tbb::parallel_for(range, apply_inplace_vector_op, tbb::auto_partitioner());
       #else
-        inplace_vector_op_serial(op, n, result, args...);
+        const std::size_t blocks = vector_op_blocks(n);
+        if(blocks > 1ul)
+          vector_op_parallel(n, blocks,
+              [&] (const std::size_t, const std::size_t offset, const std::size_t size)
+              { inplace_vector_op_serial(op, size, result + offset, (args + offset)...); });
+        else
+          inplace_vector_op_serial(op, n, result, args...);
       #endif
     }
 
@@ -493,7 +569,13 @@ namespace TiledArray {
 
       tbb::parallel_for(range, apply_vector_op, tbb::auto_partitioner());
       #else
-        vector_op_serial(op, n, result, args...);
+        const std::size_t blocks = vector_op_blocks(n);
+        if(blocks > 1ul)
+          vector_op_parallel(n, blocks,
+              [&] (const std::size_t, const std::size_t offset, const std::size_t size)
+              { vector_op_serial(op, size, result + offset, (args + offset)...); });
+        else
+          vector_op_serial(op, n, result, args...);
       #endif
     }
 
@@ -559,7 +641,13 @@ namespace TiledArray {
         auto apply_vector_ptr_op = ApplyVectorPtrOp<Op,Result,Args...>(op, result, args...);
         tbb::parallel_for(range, apply_vector_ptr_op,tbb::auto_partitioner());
       #else
-        vector_ptr_op_serial(op,n,result,args...);
+        const std::size_t blocks = vector_op_blocks(n);
+        if(blocks > 1ul)
+          vector_op_parallel(n, blocks,
+              [&] (const std::size_t, const std::size_t offset, const std::size_t size)
+              { vector_ptr_op_serial(op, size, result + offset, (args + offset)...); });
+        else
+          vector_ptr_op_serial(op,n,result,args...);
       #endif
     }
 
@@ -640,7 +728,6 @@ namespace TiledArray {
     void reduce_op(ReduceOp&& reduce_op, JoinOp&& join_op, const Result& identity, const std::size_t n, Result& result,
                    const Args* const... args)
     {
-      //TODO implement reduce operation with TBB
 #ifdef HAVE_INTEL_TBB
         SizeTRange range(0, n);
 
@@ -650,7 +737,19 @@ namespace TiledArray {
 
         result = apply_reduce_op.result();
 #else
-        reduce_op_serial(reduce_op,n,result,args...);
+        const std::size_t blocks = vector_op_blocks(n);
+        if(blocks > 1ul) {
+          // Reduce each block separately and join the partial results in
+          // block order, so the result does not depend on the thread count.
+          std::vector<Result> partial(blocks, identity);
+          vector_op_parallel(n, blocks,
+              [&] (const std::size_t block, const std::size_t offset, const std::size_t size)
+              { reduce_op_serial(reduce_op, size, partial[block], (args + offset)...); });
+          for(const Result& p : partial)
+            join_op(result, p);
+        } else {
+          reduce_op_serial(reduce_op,n,result,args...);
+        }
 #endif
     }
 
@@ -0,0 +1,174 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  parallel_io.h
+ *  Apr 14, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_PARALLEL_IO_H__INCLUDED
+#define TILEDARRAY_PARALLEL_IO_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/external/madness.h>
+#include <madness/world/buffer_archive.h>
+#include <madness/world/vector_archive.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Statistics of a parallel array store or load
+
+  /// The statistics returned by \c DistArray::store() and
+  /// \c DistArray::load() describe the work of the calling process, which is
+  /// zero on processes that are not I/O nodes. Use \c reduce() to obtain the
+  /// statistics of all I/O nodes.
+  struct IOStatistics {
+    std::size_t tiles = 0ul; ///< The number of tiles written or read
+    std::size_t bytes = 0ul; ///< The number of tile bytes written or read
+    double seconds = 0.0; ///< The wall time spent writing or reading
+
+    /// Achieved bandwidth
+
+    /// \return The number of bytes per second, or zero if no time was spent
+    double bandwidth() const {
+      return (seconds > 0.0 ? double(bytes) / seconds : 0.0);
+    }
+
+    /// Combine the statistics of all processes
+
+    /// The tile and byte counts are summed, and the time is the maximum time
+    /// of all processes, so the bandwidth of the result is the aggregate
+    /// bandwidth of the I/O nodes.
+    /// \param world The world of the array
+    /// \return The statistics of all processes
+    /// \note This is a collective operation.
+    IOStatistics reduce(World& world) const {
+      IOStatistics result = *this;
+      world.gop.sum(result.tiles);
+      world.gop.sum(result.bytes);
+      world.gop.max(result.seconds);
+      return result;
+    }
+  }; // struct IOStatistics
+
+  namespace detail {
+
+    /// The number of tiles an I/O node keeps in flight
+
+    /// An I/O node requests, and serializes, up to this many tiles ahead of
+    /// the tile it is writing. The default is 32, and it may be changed
+    /// with the \c TA_IO_WINDOW environment variable.
+    /// \return The I/O window size
+    inline std::size_t io_window() {
+      static const std::size_t window = [] () {
+        const char* window = std::getenv("TA_IO_WINDOW");
+        if(window)
+          return std::max<std::size_t>(std::strtoul(window, nullptr, 10), 1ul);
+        return std::size_t(32ul);
+      }();
+      return window;
+    }
+
+    /// The size of a serialized object
+
+    /// \tparam T The object type
+    /// \param t The object
+    /// \return The number of bytes written when \c t is stored in a binary
+    /// archive
+    template <typename T>
+    inline std::size_t serialized_size(const T& t) {
+      madness::archive::BufferOutputArchive count;
+      count & t;
+      return count.size();
+    }
+
+    /// Serialize an object to a buffer
+
+    /// The buffer holds the bytes that a binary archive writes for \c t , so
+    /// it can be written to an archive in place of \c t . The buffer grows as
+    /// \c t is written, so \c t is serialized only once.
+    /// \tparam T The object type
+    /// \param t The object
+    /// \return A buffer with the serialized object
+    template <typename T>
+    inline std::vector<unsigned char> serialize_to_buffer(const T& t) {
+      std::vector<unsigned char> buffer;
+      madness::archive::VectorOutputArchive oar(buffer);
+      oar & t;
+      return buffer;
+    }
+
+    /// Write a buffer to a file at the given offset
+
+    /// \param fd The file descriptor
+    /// \param data The buffer
+    /// \param size The number of bytes to write
+    /// \param offset The file offset
+    /// \throw TiledArray::Exception When the write fails
+    inline void write_at(const int fd, const void* data, std::size_t size,
+        std::uint64_t offset)
+    {
+      const char* p = static_cast<const char*>(data);
+      while(size > 0ul) {
+        const ssize_t n = ::pwrite(fd, p, size, off_t(offset));
+        if(n < 0) {
+          if(errno == EINTR)
+            continue;
+          TA_EXCEPTION("Unable to write to the file.");
+        }
+        p += n;
+        size -= std::size_t(n);
+        offset += std::uint64_t(n);
+      }
+    }
+
+    /// Read a buffer from a file at the given offset
+
+    /// \param fd The file descriptor
+    /// \param[out] data The buffer
+    /// \param size The number of bytes to read
+    /// \param offset The file offset
+    /// \throw TiledArray::Exception When the read fails
+    inline void read_at(const int fd, void* data, std::size_t size,
+        std::uint64_t offset)
+    {
+      char* p = static_cast<char*>(data);
+      while(size > 0ul) {
+        const ssize_t n = ::pread(fd, p, size, off_t(offset));
+        if(n < 0) {
+          if(errno == EINTR)
+            continue;
+          TA_EXCEPTION("Unable to read from the file.");
+        }
+        if(n == 0)
+          TA_EXCEPTION("Unexpected end of file.");
+        p += n;
+        size -= std::size_t(n);
+        offset += std::uint64_t(n);
+      }
+    }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_PARALLEL_IO_H__INCLUDED
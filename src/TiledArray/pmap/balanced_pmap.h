@@ -0,0 +1,236 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  balanced_pmap.h
+ *  Apr 22, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_BALANCED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_BALANCED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/tiled_range.h>
+#include <algorithm>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// A process map that balances the cost of the tiles
+
+    /// Map N tiles among P processes into contiguous blocks of tiles, like
+    /// \c BlockedPmap , whose total costs are approximately equal. The cost
+    /// of a tile is an estimate of the work or the memory it requires, e.g.
+    /// the volume of the non-zero tiles of a shape (see the constructors).
+    /// The block of process \c p ends at the tile where the partial sum of
+    /// the costs is closest to <tt>(p + 1) / P</tt> of the total cost, so the
+    /// cost of each process differs from the average by about the cost of one
+    /// tile at most. Since the blocks follow the ordinal order of the tiles,
+    /// the process maps of arrays with similar costs map most tiles to the
+    /// same processes. When the total cost is zero, the tiles are mapped like
+    /// \c BlockedPmap .
+    /// \note The costs must be the same on all processes.
+    class BalancedPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+
+    private:
+
+      std::vector<size_type> first_; ///< The first tile of each process's block, and the number of tiles
+      std::vector<double> loads_; ///< The total cost of each process's block
+      double total_; ///< The total cost of the tiles
+
+      /// Partition the tiles
+
+      /// \param costs The cost of each tile
+      void init(const std::vector<double>& costs) {
+        TA_ASSERT(costs.size() == size_);
+
+        total_ = 0.0;
+        for(const double cost : costs) {
+          TA_ASSERT(cost >= 0.0);
+          total_ += cost;
+        }
+
+        first_.assign(procs_ + 1ul, size_);
+        first_.front() = 0ul;
+        if(total_ > 0.0) {
+          // Place each block boundary at the tile where the partial sum of
+          // the costs is closest to the target
+          double partial = 0.0;
+          size_type tile = 0ul;
+          for(size_type p = 1ul; p < procs_; ++p) {
+            const double target = total_ * double(p) / double(procs_);
+            while((tile < size_) && (partial + costs[tile] <= target))
+              partial += costs[tile++];
+            if((tile < size_) && ((partial + costs[tile] - target) < (target - partial)))
+              partial += costs[tile++];
+            first_[p] = tile;
+          }
+        } else {
+          const size_type block_size = size_ / procs_;
+          const size_type remainder = size_ % procs_;
+          for(size_type p = 1ul; p < procs_; ++p)
+            first_[p] = p * block_size + std::min(p, remainder);
+        }
+
+        loads_.assign(procs_, 0.0);
+        for(size_type p = 0ul; p < procs_; ++p)
+          for(size_type tile = first_[p]; tile < first_[p + 1ul]; ++tile)
+            loads_[p] += costs[tile];
+
+        this->local_size_ = first_[rank_ + 1ul] - first_[rank_];
+      }
+
+      /// Tile costs of a shape
+
+      /// \tparam Shape The shape type
+      /// \param trange The tiled range
+      /// \param shape The shape
+      /// \return The volume of each non-zero tile, or zero
+      template <typename Shape>
+      static std::vector<double>
+      make_costs(const TiledRange& trange, const Shape& shape) {
+        const size_type size = trange.tiles_range().volume();
+        std::vector<double> costs(size, 0.0);
+        for(size_type tile = 0ul; tile < size; ++tile)
+          if(! shape.is_zero(tile))
+            costs[tile] = double(trange.make_tile_range(tile).volume());
+        return costs;
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Key type
+
+      /// Construct a balanced map from tile costs
+
+      /// \param world The world where the tiles will be mapped
+      /// \param costs The non-negative cost of each tile
+      BalancedPmap(World& world, const std::vector<double>& costs) :
+        Pmap(world, costs.size()), first_(), loads_(), total_(0.0)
+      {
+        init(costs);
+      }
+
+      /// Construct a balanced map with a cost function
+
+      /// \tparam Op The cost function type
+      /// \param world The world where the tiles will be mapped
+      /// \param size The number of tiles to be mapped
+      /// \param op The cost function, which returns the non-negative cost of
+      /// the tile with a given ordinal index
+      template <typename Op>
+      BalancedPmap(World& world, const size_type size, Op&& op) :
+        Pmap(world, size), first_(), loads_(), total_(0.0)
+      {
+        std::vector<double> costs(size);
+        for(size_type tile = 0ul; tile < size; ++tile)
+          costs[tile] = op(tile);
+        init(costs);
+      }
+
+      /// Construct a balanced map from the shape of an array
+
+      /// The cost of a tile is its volume, or zero if it is a zero tile.
+      /// \tparam Shape The shape type
+      /// \param world The world where the tiles will be mapped
+      /// \param trange The tiled range of the array
+      /// \param shape The shape of the array
+      template <typename Shape>
+      BalancedPmap(World& world, const TiledRange& trange, const Shape& shape) :
+        Pmap(world, trange.tiles_range().volume()), first_(), loads_(),
+        total_(0.0)
+      {
+        init(make_costs(trange, shape));
+      }
+
+      virtual ~BalancedPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return (std::upper_bound(first_.begin() + 1, first_.end(), tile) -
+            first_.begin()) - 1;
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return ((tile >= first_[rank_]) && (tile < first_[rank_ + 1ul]));
+      }
+
+      /// Process load accessor
+
+      /// \param proc The process rank
+      /// \return The total cost of the tiles of process \c proc
+      double load(const size_type proc) const {
+        TA_ASSERT(proc < procs_);
+        return loads_[proc];
+      }
+
+      /// Load imbalance
+
+      /// \return The ratio of the largest cost of a process to the average
+      /// cost of the processes, which is 1 when the map is balanced
+      double imbalance() const {
+        return (total_ > 0.0 ?
+            *std::max_element(loads_.begin(), loads_.end()) * double(procs_) / total_ :
+            1.0);
+      }
+
+      virtual const_iterator begin() const {
+        return Iterator(*this, first_[rank_], first_[rank_ + 1ul], first_[rank_], false);
+      }
+      virtual const_iterator end() const {
+        return Iterator(*this, first_[rank_], first_[rank_ + 1ul], first_[rank_ + 1ul], false);
+      }
+
+    }; // class BalancedPmap
+
+    /// Load imbalance of a process map
+
+    /// \param pmap The process map
+    /// \param costs The cost of each tile
+    /// \return The ratio of the largest cost of a process to the average
+    /// cost of the processes, which is 1 when \c pmap is balanced
+    inline double load_imbalance(const Pmap& pmap, const std::vector<double>& costs) {
+      TA_ASSERT(costs.size() == pmap.size());
+      std::vector<double> loads(pmap.procs(), 0.0);
+      double total = 0.0;
+      for(Pmap::size_type tile = 0ul; tile < costs.size(); ++tile) {
+        loads[pmap.owner(tile)] += costs[tile];
+        total += costs[tile];
+      }
+      return (total > 0.0 ?
+          *std::max_element(loads.begin(), loads.end()) * double(pmap.procs()) / total :
+          1.0);
+    }
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_BALANCED_PMAP_H__INCLUDED
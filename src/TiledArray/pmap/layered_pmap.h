@@ -0,0 +1,206 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  layered_pmap.h
+ *  Mar 9, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_LAYERED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_LAYERED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Maps the tiles of a contraction argument onto a layered process grid
+
+    /// The process grid is a stack of \c layers identical 2-d grids of
+    /// \f$ P_{\rm row} \times P_{\rm col} \f$ processes, where layer \f$ l \f$
+    /// begins at process \f$ l \cdot S \f$ and \f$ S \f$ is the layer stride.
+    /// The contracted (i.e. inner) dimension of the tile matrix, which is
+    /// either its columns or its rows, is split into \c layers contiguous
+    /// slabs of nearly equal size. Tile \f$ \{ i, j \} \f$ in slab \f$ l \f$
+    /// is mapped cyclically onto layer \f$ l \f$ , i.e. to process
+    /// \f$ l \cdot S + (i \% P_{\rm row}) P_{\rm col} + j \% P_{\rm col} \f$ .
+    /// With one layer this is identical to \c CyclicPmap .
+    ///
+    /// \note This class is used to map <em>tile</em> indices to processes.
+    class LayeredPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+
+    private:
+
+      const size_type rows_; ///< Number of tile rows to be mapped
+      const size_type cols_; ///< Number of tile columns to be mapped
+      const size_type proc_rows_; ///< Number of process rows in each layer
+      const size_type proc_cols_; ///< Number of process columns in each layer
+      const size_type layers_; ///< Number of process grid layers
+      const size_type layer_stride_; ///< Process offset between layers
+      const bool inner_cols_; ///< \c true if the columns are split among layers
+
+      /// Count the indices in a range that belong to a process coordinate
+
+      /// \param first The first index of the range
+      /// \param last The end of the range
+      /// \param proc The process coordinate
+      /// \param nprocs The number of process coordinates
+      /// \return The number of indices \c i in <tt>[first,last)</tt> where
+      /// <tt>i % nprocs == proc</tt>
+      static size_type count(const size_type first, const size_type last,
+          const size_type proc, const size_type nprocs)
+      {
+        auto count_below = [=] (const size_type n) {
+          return (n / nprocs) + ((n % nprocs) > proc ? 1ul : 0ul);
+        };
+        return count_below(last) - count_below(first);
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// First inner index of a slab
+
+      /// \param layer The layer index
+      /// \param layers The number of layers
+      /// \param n The extent of the inner dimension
+      /// \return The first inner index assigned to \c layer
+      static size_type slab_begin(const size_type layer, const size_type layers,
+          const size_type n)
+      { return (n * layer) / layers; }
+
+      /// Slab of an inner index
+
+      /// \param i The inner index
+      /// \param layers The number of layers
+      /// \param n The extent of the inner dimension
+      /// \return The layer that is assigned inner index \c i
+      static size_type slab(const size_type i, const size_type layers,
+          const size_type n)
+      { return ((i + 1ul) * layers - 1ul) / n; }
+
+      /// Construct process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param rows The number of tile rows to be mapped
+      /// \param cols The number of tile columns to be mapped
+      /// \param proc_rows The number of process rows in each layer
+      /// \param proc_cols The number of process columns in each layer
+      /// \param layers The number of layers
+      /// \param layer_stride The process offset between layers
+      /// \param inner_cols If \c true the tile columns are split among layers,
+      /// otherwise the tile rows are split among layers
+      /// \throw TiledArray::Exception When the layers do not fit in \c world
+      /// \throw TiledArray::Exception When there are more layers than slabs
+      LayeredPmap(World& world, size_type rows, size_type cols,
+          size_type proc_rows, size_type proc_cols, size_type layers,
+          size_type layer_stride, bool inner_cols) :
+        Pmap(world, rows * cols), rows_(rows), cols_(cols),
+        proc_rows_(proc_rows), proc_cols_(proc_cols), layers_(layers),
+        layer_stride_(layer_stride), inner_cols_(inner_cols)
+      {
+        // Check that the size is non-zero
+        TA_ASSERT(rows_ >= 1ul);
+        TA_ASSERT(cols_ >= 1ul);
+
+        // Check limits of process rows, columns, and layers
+        TA_ASSERT(proc_rows_ >= 1ul);
+        TA_ASSERT(proc_cols_ >= 1ul);
+        TA_ASSERT(layers_ >= 1ul);
+        TA_ASSERT(layers_ <= (inner_cols_ ? cols_ : rows_));
+        TA_ASSERT((proc_rows_ * proc_cols_) <= layer_stride_);
+        TA_ASSERT((layers_ * layer_stride_) <= procs_);
+
+        // Compute local size_, if have any
+        const size_type layer = rank_ / layer_stride_;
+        const size_type layer_rank = rank_ % layer_stride_;
+        if((layer < layers_) && (layer_rank < (proc_rows_ * proc_cols_))) {
+          // Compute rank coordinates
+          const size_type rank_row = layer_rank / proc_cols_;
+          const size_type rank_col = layer_rank % proc_cols_;
+
+          // Compute the range of the slab assigned to this layer
+          const size_type n = (inner_cols_ ? cols_ : rows_);
+          const size_type first = slab_begin(layer, layers_, n);
+          const size_type last = slab_begin(layer + 1ul, layers_, n);
+
+          const size_type local_rows = (inner_cols_ ?
+              count(0ul, rows_, rank_row, proc_rows_) :
+              count(first, last, rank_row, proc_rows_));
+          const size_type local_cols = (inner_cols_ ?
+              count(first, last, rank_col, proc_cols_) :
+              count(0ul, cols_, rank_col, proc_cols_));
+
+          this->local_size_ = local_rows * local_cols;
+        }
+      }
+
+      virtual ~LayeredPmap() { }
+
+      /// Access number of rows in the tile index matrix
+      size_type nrows() const { return rows_; }
+      /// Access number of columns in the tile index matrix
+      size_type ncols() const { return cols_; }
+      /// Access number of rows in the process matrix of each layer
+      size_type nrows_proc() const { return proc_rows_; }
+      /// Access number of columns in the process matrix of each layer
+      size_type ncols_proc() const { return proc_cols_; }
+      /// Access number of layers
+      size_type nlayers() const { return layers_; }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        // Compute tile coordinate in tile grid
+        const size_type tile_row = tile / cols_;
+        const size_type tile_col = tile % cols_;
+        // Compute the layer that holds the slab of tile
+        const size_type layer = (inner_cols_ ?
+            slab(tile_col, layers_, cols_) : slab(tile_row, layers_, rows_));
+        // Compute the process that owns tile
+        const size_type proc = layer * layer_stride_
+            + (tile_row % proc_rows_) * proc_cols_ + (tile_col % proc_cols_);
+
+        TA_ASSERT(proc < procs_);
+
+        return proc;
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return (LayeredPmap::owner(tile) == rank_);
+      }
+
+    }; // class LayeredPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+
+#endif // TILEDARRAY_PMAP_LAYERED_PMAP_H__INCLUDED
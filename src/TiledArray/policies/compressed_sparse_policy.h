@@ -0,0 +1,76 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2019  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  compressed_sparse_policy.h
+ *  Oct 17, 2019
+ *
+ */
+
+#ifndef TILEDARRAY_COMPRESSED_SPARSE_POLICY_H__INCLUDED
+#define TILEDARRAY_COMPRESSED_SPARSE_POLICY_H__INCLUDED
+
+#include <TiledArray/tiled_range.h>
+#include <TiledArray/pmap/balanced_pmap.h>
+#include <TiledArray/pmap/blocked_pmap.h>
+#include <TiledArray/compressed_sparse_shape.h>
+
+namespace TiledArray {
+
+  /// Policy for block-sparse arrays whose shape only stores non-zero tile norms
+
+  /// This policy is equivalent to \c SparsePolicy , except that the array
+  /// shape is a \c CompressedSparseShape , so the memory required by the shape
+  /// on each process scales with the number of non-zero tiles instead of the
+  /// volume of the tile range.
+  class CompressedSparsePolicy {
+  public:
+    typedef TiledArray::TiledRange trange_type;
+    typedef trange_type::range_type range_type;
+    typedef range_type::size_type size_type;
+    typedef TiledArray::CompressedSparseShape<float> shape_type;
+    typedef TiledArray::Pmap pmap_interface;
+    typedef TiledArray::detail::BlockedPmap default_pmap_type;
+
+    /// Create a default process map
+
+    /// \param world The world of the process map
+    /// \param size The number of tiles in the array
+    /// \return A shared pointer to a process map
+    static std::shared_ptr<pmap_interface>
+    default_pmap(World& world, const std::size_t size) {
+      return std::make_shared<default_pmap_type>(world, size);
+    }
+
+    /// Create a default process map for the shape of an array
+
+    /// The tiles are distributed so that each process owns about the same
+    /// volume of non-zero tiles (see \c detail::BalancedPmap ).
+    /// \param world The world of the process map
+    /// \param trange The tiled range of the array
+    /// \param shape The shape of the array
+    /// \return A shared pointer to a process map
+    static std::shared_ptr<pmap_interface>
+    default_pmap(World& world, const trange_type& trange, const shape_type& shape) {
+      return std::make_shared<TiledArray::detail::BalancedPmap>(world, trange,
+          shape);
+    }
+
+  }; // class CompressedSparsePolicy
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_COMPRESSED_SPARSE_POLICY_H__INCLUDED
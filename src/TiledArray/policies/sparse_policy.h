@@ -27,6 +27,7 @@
 #define TILEDARRAY_SPARSE_ARRAY_H__INCLUDED
 
 #include <TiledArray/tiled_range.h>
+#include <TiledArray/pmap/balanced_pmap.h>
 #include <TiledArray/pmap/blocked_pmap.h>
 #include <TiledArray/sparse_shape.h>
 
@@ -51,6 +52,20 @@ namespace TiledArray {
       return std::make_shared<default_pmap_type>(world, size);
     }
 
+    /// Create a default process map for the shape of an array
+
+    /// The tiles are distributed so that each process owns about the same
+    /// volume of non-zero tiles (see \c detail::BalancedPmap ).
+    /// \param world The world of the process map
+    /// \param trange The tiled range of the array
+    /// \param shape The shape of the array
+    /// \return A shared pointer to a process map
+    static std::shared_ptr<pmap_interface>
+    default_pmap(World& world, const trange_type& trange, const shape_type& shape) {
+      return std::make_shared<TiledArray::detail::BalancedPmap>(world, trange,
+          shape);
+    }
+
   }; // class SparsePolicy
 
 } // namespace TiledArray
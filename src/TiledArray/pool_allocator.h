@@ -0,0 +1,552 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  pool_allocator.h
+ *  Apr 3, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_POOL_ALLOCATOR_H__INCLUDED
+#define TILEDARRAY_POOL_ALLOCATOR_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/external/madness.h>
+#include <Eigen/Core>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Memory pool statistics
+
+  /// The counters accumulate from the start of the program, or from the last
+  /// call to \c pool_reset_statistics() .
+  struct PoolStatistics {
+    std::size_t requests; ///< The number of allocations
+    std::size_t hits; ///< The number of allocations that reused a pooled block
+    std::size_t misses; ///< The number of pooled allocations that used new memory
+    std::size_t large; ///< The number of allocations too large to be pooled
+    std::size_t retained_bytes; ///< The bytes held by the pool for reuse
+    std::size_t max_retained_bytes; ///< The limit of \c retained_bytes
+
+    /// The fraction of allocations that reused a pooled block
+
+    /// \return The pool hit rate, or 0 when no memory was allocated
+    double hit_rate() const {
+      return (requests ? double(hits) / double(requests) : 0.0);
+    }
+  }; // struct PoolStatistics
+
+  namespace detail {
+
+    /// Size-classed memory pool with per-thread caches
+
+    /// Blocks are rounded up to one of four size classes per power of two,
+    /// from \c min_size to \c max_size bytes, so a freed block can be reused
+    /// by any allocation of the same class. Each thread keeps a cache of free
+    /// blocks, which is used without contention with other threads; blocks
+    /// that overflow a thread cache go to a shared free list, where they can
+    /// be reused by other threads, e.g. when tiles are allocated by one task
+    /// and freed by another. The pool never holds more than
+    /// \c max_retained() bytes: blocks freed beyond this limit are returned
+    /// to the system. The limit may be set with the \c TA_POOL_MAX_RETAINED
+    /// environment variable (in bytes). Blocks are aligned like the blocks of
+    /// \c Eigen::aligned_allocator .
+    class MemoryPool {
+    public:
+      typedef std::size_t size_type;
+
+      static constexpr unsigned int min_exp = 6u; ///< log2 of the smallest class
+      static constexpr unsigned int max_exp = 26u; ///< log2 of the largest class
+      static constexpr size_type min_size = size_type(1) << min_exp; ///< Smallest pooled block
+      static constexpr size_type max_size = size_type(1) << max_exp; ///< Largest pooled block
+      static constexpr unsigned int num_classes = (max_exp - min_exp) * 4u + 1u; ///< Number of size classes
+      static constexpr size_type thread_cache_bytes = 4194304ul; ///< Thread cache size of each class
+      static constexpr size_type default_max_retained = 536870912ul; ///< Default retained byte limit
+
+      /// The size class of an allocation
+
+      /// \param bytes The number of bytes requested
+      /// \return The size class of \c bytes , or \c num_classes if it is
+      /// too large to be pooled
+      static unsigned int size_class(const size_type bytes) {
+        if(bytes <= min_size)
+          return 0u;
+        if(bytes > max_size)
+          return num_classes;
+        const size_type b = bytes - 1ul;
+        unsigned int e = min_exp;
+        while((b >> (e + 1u)) != 0ul)
+          ++e;
+        return (e - min_exp) * 4u + unsigned((b >> (e - 2u)) & 3ul) + 1u;
+      }
+
+      /// The block size of a size class
+
+      /// \param c The size class
+      /// \return The number of bytes in blocks of class \c c
+      static size_type class_size(const unsigned int c) {
+        TA_ASSERT(c < num_classes);
+        if(c == 0u)
+          return min_size;
+        const unsigned int e = min_exp + (c - 1u) / 4u;
+        return (size_type(1) << e) + size_type((c - 1u) % 4u + 1u) * (size_type(1) << (e - 2u));
+      }
+
+    private:
+
+      /// A free block, which links to the next free block of its list
+      struct Block {
+        Block* next;
+      }; // struct Block
+
+      /// A list of free blocks
+      struct FreeList {
+        FreeList() : head(nullptr), count(0ul) { }
+
+        void push(void* const p) {
+          Block* const block = static_cast<Block*>(p);
+          block->next = head;
+          head = block;
+          ++count;
+        }
+
+        void* pop() {
+          Block* const block = head;
+          if(block) {
+            head = block->next;
+            --count;
+          }
+          return block;
+        }
+
+        Block* head; ///< The first free block
+        size_type count; ///< The number of free blocks
+      }; // struct FreeList
+
+      /// Counters of the pool statistics
+      struct Counters {
+        Counters() : requests(0ul), misses(0ul), large(0ul) { }
+
+        void reset() { requests = misses = large = 0ul; }
+
+        Counters& operator+=(const Counters& other) {
+          requests += other.requests;
+          misses += other.misses;
+          large += other.large;
+          return *this;
+        }
+
+        size_type requests; ///< All allocations
+        size_type misses; ///< Pooled allocations that used new memory
+        size_type large; ///< Allocations that were not pooled
+      }; // struct Counters
+
+      /// The free blocks and counters of one thread
+
+      /// The lock is only contended when the pool is trimmed or its
+      /// statistics are collected by another thread.
+      struct ThreadCache {
+        ThreadCache() { MemoryPool::instance().register_cache(this); }
+        ~ThreadCache() {
+          MemoryPool::instance().unregister_cache(this);
+          cache_destroyed() = true;
+        }
+
+        madness::Spinlock mutex; ///< Guards the lists and counters
+        std::array<FreeList, num_classes> lists; ///< Free blocks of each class
+        Counters counters; ///< Statistics of this thread
+      }; // struct ThreadCache
+
+      std::array<FreeList, num_classes> lists_; ///< Shared free blocks of each class
+      std::array<madness::Spinlock, num_classes> list_mutex_; ///< Guards lists_
+      std::mutex cache_mutex_; ///< Guards caches_ and retired_
+      std::vector<ThreadCache*> caches_; ///< The thread caches
+      Counters retired_; ///< Statistics of exited threads and destroyed caches
+      std::atomic<size_type> retained_; ///< Bytes in free blocks
+      std::atomic<size_type> max_retained_; ///< Limit of retained_
+
+      MemoryPool() : retained_(0ul), max_retained_(default_max_retained) {
+        const char* max_retained = std::getenv("TA_POOL_MAX_RETAINED");
+        if(max_retained)
+          max_retained_ = std::strtoull(max_retained, nullptr, 10);
+      }
+
+      MemoryPool(const MemoryPool&) = delete;
+      MemoryPool& operator=(const MemoryPool&) = delete;
+
+      /// Flag that is set when the cache of this thread has been destroyed
+
+      /// The flag is trivially destructible, so it may be read while the
+      /// thread-local and static objects of the thread are destroyed.
+      /// \return A reference to the flag of this thread
+      static bool& cache_destroyed() {
+        static thread_local bool destroyed = false;
+        return destroyed;
+      }
+
+      /// The cache of this thread
+
+      /// Objects that are destroyed after the cache of their thread, e.g.
+      /// thread-local objects constructed before it and static objects, use
+      /// the shared lists instead.
+      /// \return The cache of this thread, or \c nullptr if it has been
+      /// destroyed
+      static ThreadCache* thread_cache() {
+        if(cache_destroyed())
+          return nullptr;
+        static thread_local ThreadCache cache;
+        return &cache;
+      }
+
+      /// Update the counters of this thread
+
+      /// \tparam Op The update operation type
+      /// \param cache The cache of this thread, or \c nullptr if it has been
+      /// destroyed, in which case the counters of exited threads are updated
+      /// \param op The update operation, which is called as <tt>op(counters)</tt>
+      template <typename Op>
+      void count(ThreadCache* const cache, const Op& op) {
+        if(cache) {
+          madness::ScopedMutex<madness::Spinlock> locker(cache->mutex);
+          op(cache->counters);
+        } else {
+          std::lock_guard<std::mutex> locker(cache_mutex_);
+          op(retired_);
+        }
+      }
+
+      void register_cache(ThreadCache* const cache) {
+        std::lock_guard<std::mutex> locker(cache_mutex_);
+        caches_.push_back(cache);
+      }
+
+      /// Move the blocks of an exiting thread to the shared lists
+      void unregister_cache(ThreadCache* const cache) {
+        {
+          std::lock_guard<std::mutex> locker(cache_mutex_);
+          caches_.erase(std::find(caches_.begin(), caches_.end(), cache));
+          retired_ += cache->counters;
+        }
+        for(unsigned int c = 0u; c < num_classes; ++c) {
+          madness::ScopedMutex<madness::Spinlock> locker(list_mutex_[c]);
+          while(void* const p = cache->lists[c].pop())
+            lists_[c].push(p);
+        }
+      }
+
+      /// Reserve retained bytes for a freed block
+
+      /// \param size The size of the block
+      /// \return \c true if the block fits under the retained limit
+      bool retain(const size_type size) {
+        const size_type limit = max_retained_.load(std::memory_order_relaxed);
+        size_type retained = retained_.load(std::memory_order_relaxed);
+        do {
+          if(retained + size > limit)
+            return false;
+        } while(! retained_.compare_exchange_weak(retained, retained + size,
+            std::memory_order_relaxed));
+        return true;
+      }
+
+      /// Free all blocks of a list
+
+      /// \return The number of bytes freed
+      static size_type release(FreeList& list, const unsigned int c) {
+        const size_type bytes = list.count * class_size(c);
+        while(void* const p = list.pop())
+          Eigen::internal::aligned_free(p);
+        return bytes;
+      }
+
+    public:
+
+      /// The memory pool of this process
+
+      /// The pool is never destroyed, so memory may be returned to it by
+      /// objects that are destroyed at exit.
+      /// \return The singleton memory pool
+      static MemoryPool& instance() {
+        static MemoryPool* const pool = new MemoryPool();
+        return *pool;
+      }
+
+      /// Allocate memory
+
+      /// \param bytes The number of bytes to allocate
+      /// \return A pointer to at least \c bytes bytes of memory
+      /// \throw std::bad_alloc When memory cannot be allocated
+      void* allocate(const size_type bytes) {
+        const unsigned int c = size_class(bytes);
+        ThreadCache* const cache = thread_cache();
+
+        if(c == num_classes) {
+          count(cache, [] (Counters& counters) {
+            ++counters.requests;
+            ++counters.large;
+          });
+          return Eigen::internal::aligned_malloc(bytes);
+        }
+
+        // Search the thread cache, then the shared list, for a free block
+        void* p = nullptr;
+        if(cache) {
+          madness::ScopedMutex<madness::Spinlock> locker(cache->mutex);
+          ++cache->counters.requests;
+          p = cache->lists[c].pop();
+        } else {
+          count(cache, [] (Counters& counters) { ++counters.requests; });
+        }
+        if(! p) {
+          madness::ScopedMutex<madness::Spinlock> locker(list_mutex_[c]);
+          p = lists_[c].pop();
+        }
+
+        if(p) {
+          retained_.fetch_sub(class_size(c), std::memory_order_relaxed);
+        } else {
+          p = Eigen::internal::aligned_malloc(class_size(c));
+          count(cache, [] (Counters& counters) { ++counters.misses; });
+        }
+
+        return p;
+      }
+
+      /// Deallocate memory
+
+      /// \param p A pointer to memory allocated by this pool
+      /// \param bytes The number of bytes that were allocated at \c p
+      void deallocate(void* const p, const size_type bytes) {
+        if(! p)
+          return;
+        const unsigned int c = size_class(bytes);
+        if((c == num_classes) || ! retain(class_size(c))) {
+          Eigen::internal::aligned_free(p);
+          return;
+        }
+
+        ThreadCache* const cache = thread_cache();
+        if(cache) {
+          madness::ScopedMutex<madness::Spinlock> locker(cache->mutex);
+          if((cache->lists[c].count + 1ul) * class_size(c) <= thread_cache_bytes) {
+            cache->lists[c].push(p);
+            return;
+          }
+        }
+        madness::ScopedMutex<madness::Spinlock> locker(list_mutex_[c]);
+        lists_[c].push(p);
+      }
+
+      /// Return all free blocks to the system
+
+      /// \return The number of bytes freed
+      size_type trim() {
+        size_type bytes = 0ul;
+        {
+          std::lock_guard<std::mutex> locker(cache_mutex_);
+          for(ThreadCache* cache : caches_) {
+            madness::ScopedMutex<madness::Spinlock> cache_locker(cache->mutex);
+            for(unsigned int c = 0u; c < num_classes; ++c)
+              bytes += release(cache->lists[c], c);
+          }
+        }
+        for(unsigned int c = 0u; c < num_classes; ++c) {
+          madness::ScopedMutex<madness::Spinlock> locker(list_mutex_[c]);
+          bytes += release(lists_[c], c);
+        }
+        retained_.fetch_sub(bytes, std::memory_order_relaxed);
+        return bytes;
+      }
+
+      /// Collect the pool statistics
+
+      /// \return The statistics of all threads
+      PoolStatistics statistics() {
+        Counters counters;
+        {
+          std::lock_guard<std::mutex> locker(cache_mutex_);
+          counters = retired_;
+          for(ThreadCache* cache : caches_) {
+            madness::ScopedMutex<madness::Spinlock> cache_locker(cache->mutex);
+            counters += cache->counters;
+          }
+        }
+        PoolStatistics result;
+        result.requests = counters.requests;
+        result.hits = counters.requests - counters.misses - counters.large;
+        result.misses = counters.misses;
+        result.large = counters.large;
+        result.retained_bytes = retained_.load(std::memory_order_relaxed);
+        result.max_retained_bytes = max_retained_.load(std::memory_order_relaxed);
+        return result;
+      }
+
+      /// Reset the allocation counters
+      void reset_statistics() {
+        std::lock_guard<std::mutex> locker(cache_mutex_);
+        retired_.reset();
+        for(ThreadCache* cache : caches_) {
+          madness::ScopedMutex<madness::Spinlock> cache_locker(cache->mutex);
+          cache->counters.reset();
+        }
+      }
+
+      /// Retained byte limit accessor
+
+      /// \return The maximum number of bytes held by the pool
+      size_type max_retained() const {
+        return max_retained_.load(std::memory_order_relaxed);
+      }
+
+      /// Set the retained byte limit
+
+      /// Blocks that are already retained are not freed; use \c trim() to
+      /// return them to the system.
+      /// \param bytes The maximum number of bytes held by the pool
+      void max_retained(const size_type bytes) {
+        max_retained_.store(bytes, std::memory_order_relaxed);
+      }
+
+    }; // class MemoryPool
+
+  }  // namespace detail
+
+  /// Pooled allocator
+
+  /// Allocates memory from the size-classed, thread-caching memory pool
+  /// (see \c detail::MemoryPool ), so the buffers of temporary tiles are
+  /// recycled between tasks instead of being returned to the system. When
+  /// used as the allocator of \c Tensor , the tensor implementation object
+  /// and its reference count are allocated from the pool too. All instances
+  /// share the pool, so memory may be deallocated by any instance.
+  /// \tparam T The element type
+  template <typename T>
+  class pool_allocator {
+  public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind {
+      typedef pool_allocator<U> other;
+    };
+
+    pool_allocator() noexcept { }
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U>&) noexcept { }
+
+    /// Allocate memory
+
+    /// \param n The number of elements
+    /// \return A pointer to uninitialized memory for \c n elements
+    pointer allocate(const size_type n) {
+      if(n > std::numeric_limits<size_type>::max() / sizeof(T))
+        throw std::bad_alloc();
+      return static_cast<pointer>(
+          detail::MemoryPool::instance().allocate(n * sizeof(T)));
+    }
+
+    /// Deallocate memory
+
+    /// \param p A pointer returned by \c allocate
+    /// \param n The number of elements that were allocated
+    void deallocate(pointer p, const size_type n) noexcept {
+      detail::MemoryPool::instance().deallocate(p, n * sizeof(T));
+    }
+
+    size_type max_size() const noexcept {
+      return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+      ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U* p) { p->~U(); }
+
+  }; // class pool_allocator
+
+  template <typename T1, typename T2>
+  inline bool operator==(const pool_allocator<T1>&, const pool_allocator<T2>&) noexcept {
+    return true;
+  }
+
+  template <typename T1, typename T2>
+  inline bool operator!=(const pool_allocator<T1>&, const pool_allocator<T2>&) noexcept {
+    return false;
+  }
+
+  namespace detail {
+
+    /// Test for the pool allocator
+
+    /// \tparam A An allocator type
+    template <typename A>
+    struct is_pool_allocator : public std::false_type { };
+
+    template <typename T>
+    struct is_pool_allocator<pool_allocator<T> > : public std::true_type { };
+
+  }  // namespace detail
+
+  /// Memory pool statistics
+
+  /// \return The statistics of the memory pool of this process
+  inline PoolStatistics pool_statistics() {
+    return detail::MemoryPool::instance().statistics();
+  }
+
+  /// Reset the memory pool allocation counters
+  inline void pool_reset_statistics() {
+    detail::MemoryPool::instance().reset_statistics();
+  }
+
+  /// Return the free memory of the pool to the system
+
+  /// This may be called between iterations, e.g. after a fence, to release
+  /// the buffers that are retained for reuse.
+  /// \return The number of bytes freed
+  inline std::size_t pool_trim() {
+    return detail::MemoryPool::instance().trim();
+  }
+
+  /// Set the maximum number of bytes retained by the memory pool
+
+  /// \param bytes The retained byte limit; 0 disables recycling
+  inline void pool_set_max_retained(const std::size_t bytes) {
+    detail::MemoryPool::instance().max_retained(bytes);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_POOL_ALLOCATOR_H__INCLUDED
@@ -27,7 +27,10 @@
 #define TILEDARRAY_GRID_H__INCLUDED
 
 #include <TiledArray/pmap/cyclic_pmap.h>
+#include <TiledArray/pmap/layered_pmap.h>
 #include <TiledArray/math/eigen.h>
+#include <cmath>
+#include <limits>
 
 namespace TiledArray {
   namespace detail {
@@ -56,6 +59,17 @@ namespace TiledArray {
     /// \f]
     /// where the positive, real root of \f$P_{\rm{row}}\f$ give the optimal
     /// optimal communication time.
+    ///
+    /// The grid may also be stacked into \f$c\f$ layers for a
+    /// communication-avoiding contraction. Each layer is a 2D grid of the
+    /// \f$P/c\f$ processes that begin at rank \f$l P/c\f$, and it evaluates
+    /// the partial product of one contiguous slab of the inner dimension.
+    /// The partial results are summed on layer 0, which holds the result.
+    /// Unlike the 2.5D algorithm, the arguments are split among the layers
+    /// along the inner dimension (split-K) instead of being replicated on each
+    /// layer, so the layers need no extra memory for the arguments, but the
+    /// result tiles are stored on layer 0 only. See \c optimal_layers for the
+    /// choice of \f$c\f$.
     class ProcGrid {
     public:
       typedef uint_fast32_t size_type;
@@ -74,6 +88,9 @@ namespace TiledArray {
       size_type local_rows_; ///< The number of local element rows
       size_type local_cols_; ///< The number of local element columns
       size_type local_size_; ///< Number of local elements
+      size_type layers_; ///< Number of process grid layers
+      size_type layer_stride_; ///< Number of processes assigned to each layer
+      ProcessID rank_layer_; ///< This process's layer in the process grid
 
 
       /// Compute the number of process rows that minimizes communication
@@ -246,6 +263,61 @@ namespace TiledArray {
         }
       }
 
+      /// Member variable initialization for a layered grid
+
+      /// This function splits the processes into \c layers groups and
+      /// initializes the 2D grid of one layer.
+      void init(const size_type rank, const size_type nprocs,
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers)
+      {
+        layers_ = std::max<size_type>(1u, std::min(layers, nprocs));
+        layer_stride_ = nprocs / layers_;
+
+        if(rank < (layers_ * layer_stride_)) {
+          rank_layer_ = rank / layer_stride_;
+          init(rank % layer_stride_, layer_stride_, row_size, col_size);
+        } else {
+          // This process is not included in any layer
+          init(0u, layer_stride_, row_size, col_size);
+          rank_layer_ = -1;
+          rank_row_ = -1;
+          rank_col_ = -1;
+          local_rows_ = 0u;
+          local_cols_ = 0u;
+          local_size_ = 0u;
+        }
+      }
+
+      /// First process of this process's layer
+
+      /// \return The rank of the first process in the layer of this process
+      ProcessID layer_offset() const {
+        return std::max<ProcessID>(rank_layer_, 0) * layer_stride_;
+      }
+
+      /// Construct the 2D grid of one layer without a world
+
+      /// This grid is only used to evaluate the dimensions of candidate
+      /// grids, e.g. in \c optimal_layers . It has no world, so process groups
+      /// and process maps cannot be constructed from it.
+      /// \param nprocs The number of processes in the grid
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      ProcGrid(const size_type nprocs, const size_type rows,
+          const size_type cols, const std::size_t row_size,
+          const std::size_t col_size) :
+        world_(NULL), rows_(rows), cols_(cols), size_(rows_ * cols_),
+        proc_rows_(0u), proc_cols_(0u), proc_size_(0u), rank_row_(-1),
+        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u),
+        layers_(1u), layer_stride_(nprocs), rank_layer_(0)
+      {
+        TA_ASSERT(nprocs >= 1u);
+        init(0u, nprocs, row_size, col_size);
+      }
+
     public:
       /// Default constructor
 
@@ -253,7 +325,8 @@ namespace TiledArray {
       ProcGrid() :
         world_(NULL), rows_(0u), cols_(0u), size_(0u), proc_rows_(0u),
         proc_cols_(0u), proc_size_(0u), rank_row_(0), rank_col_(0),
-        local_rows_(0u), local_cols_(0u), local_size_(0u)
+        local_rows_(0u), local_cols_(0u), local_size_(0u), layers_(1u),
+        layer_stride_(0u), rank_layer_(0)
       { }
 
       /// Construct a process grid
@@ -268,18 +341,36 @@ namespace TiledArray {
       /// \param col_size The number of element columns
       ProcGrid(World& world, const size_type rows, const size_type cols,
           const std::size_t row_size, const std::size_t col_size) :
+        ProcGrid(world, rows, cols, row_size, col_size, 1u)
+      { }
+
+      /// Construct a layered process grid
+
+      /// The processes of \c world are split into \c layers groups, and a 2D
+      /// grid is constructed for each group as above.
+      /// \param world The world where the process grid will live
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param layers The number of process grid layers
+      ProcGrid(World& world, const size_type rows, const size_type cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers) :
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
         proc_rows_(0ul), proc_cols_(0ul), proc_size_(0ul),
         rank_row_(-1), rank_col_(-1),
-        local_rows_(0ul), local_cols_(0ul), local_size_(0ul)
+        local_rows_(0ul), local_cols_(0ul), local_size_(0ul),
+        layers_(1ul), layer_stride_(0ul), rank_layer_(-1)
       {
         // Check for non-zero sizes
         TA_ASSERT(rows_ >= 1u);
         TA_ASSERT(cols_ >= 1u);
         TA_ASSERT(row_size >= 1ul);
         TA_ASSERT(col_size >= 1ul);
+        TA_ASSERT(layers >= 1u);
 
-        init(world_->rank(), world_->size(), row_size, col_size);
+        init(world_->rank(), world_->size(), row_size, col_size, layers);
       }
 
 #ifdef TILEDARRAY_ENABLE_TEST_PROC_GRID
@@ -303,18 +394,37 @@ namespace TiledArray {
       ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
           const size_type rows, const size_type cols,
           const std::size_t row_size, const std::size_t col_size) :
+        ProcGrid(world, test_rank, test_nprocs, rows, cols, row_size, col_size, 1u)
+      { }
+
+      /// Construct a layered process grid
+
+      /// \param world The world where the process grid will live
+      /// \param test_rank Test rank
+      /// \param test_nprocs Test number of procs
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param layers The number of process grid layers
+      ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
+          const size_type rows, const size_type cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers) :
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
         proc_rows_(0u), proc_cols_(0u), proc_size_(0u), rank_row_(-1),
-        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u)
+        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u),
+        layers_(1u), layer_stride_(0u), rank_layer_(-1)
       {
         // Check for non-zero sizes
         TA_ASSERT(rows >= 1u);
         TA_ASSERT(cols >= 1u);
         TA_ASSERT(row_size >= 1u);
         TA_ASSERT(col_size >= 1u);
+        TA_ASSERT(layers >= 1u);
         TA_ASSERT(test_rank < test_nprocs);
 
-        init(test_rank, test_nprocs, row_size, col_size);
+        init(test_rank, test_nprocs, row_size, col_size, layers);
       }
 #endif // TILEDARRAY_ENABLE_TEST_PROC_GRID
 
@@ -330,7 +440,8 @@ namespace TiledArray {
         proc_cols_(other.proc_cols_), proc_size_(other.proc_size_),
         rank_row_(other.rank_row_), rank_col_(other.rank_col_),
         local_rows_(other.local_rows_), local_cols_(other.local_cols_),
-        local_size_(other.local_size_)
+        local_size_(other.local_size_), layers_(other.layers_),
+        layer_stride_(other.layer_stride_), rank_layer_(other.rank_layer_)
       { }
 
       /// Copy assignment operator
@@ -349,6 +460,9 @@ namespace TiledArray {
         local_rows_ = other.local_rows_;
         local_cols_ = other.local_cols_;
         local_size_ = other.local_size_;
+        layers_ = other.layers_;
+        layer_stride_ = other.layer_stride_;
+        rank_layer_ = other.rank_layer_;
 
         return *this;
       }
@@ -409,6 +523,107 @@ namespace TiledArray {
       /// less than the number of process in world).
       size_type proc_size() const { return proc_size_; }
 
+      /// Layer count accessor
+
+      /// \return The number of layers in the process grid
+      size_type layers() const { return layers_; }
+
+      /// Rank layer accessor
+
+      /// \return The layer of this process in the process grid, or -1 if this
+      /// process is not included in the process grid
+      ProcessID rank_layer() const { return rank_layer_; }
+
+      /// Layer stride accessor
+
+      /// \return The number of processes assigned to each layer (may be
+      /// greater than \c proc_size() )
+      size_type layer_stride() const { return layer_stride_; }
+
+      /// First inner tile of this process's layer
+
+      /// \param inner The number of tiles in the inner dimension
+      /// \return The first inner tile index assigned to the layer of this
+      /// process
+      size_type layer_inner_begin(const size_type inner) const {
+        return LayeredPmap::slab_begin(std::max<ProcessID>(rank_layer_, 0),
+            layers_, inner);
+      }
+
+      /// End of the inner tiles of this process's layer
+
+      /// \param inner The number of tiles in the inner dimension
+      /// \return One past the last inner tile index assigned to the layer of
+      /// this process
+      size_type layer_inner_end(const size_type inner) const {
+        return LayeredPmap::slab_begin(std::max<ProcessID>(rank_layer_, 0) + 1,
+            layers_, inner);
+      }
+
+      /// Map a process grid coordinate to the corresponding process in layer 0
+
+      /// \param layer The layer of the process
+      /// \return The process in \c layer that corresponds to the process
+      /// coordinate \c (rank_row,rank_col)
+      ProcessID map_layer(const size_type layer) const {
+        TA_ASSERT(layer < layers_);
+        return layer * layer_stride_ + rank_row_ * proc_cols_ + rank_col_;
+      }
+
+      /// Compute the number of process grid layers that minimizes communication
+
+      /// Stacking the grid into \f$c\f$ layers of \f$P/c\f$ processes
+      /// reduces the number of SUMMA iterations per layer by a factor of
+      /// \f$c\f$, at the cost of summing \f$c\f$ partial results on layer 0.
+      /// The data volume received by a single process is approximately
+      /// \f[
+      ///   T(c) = \frac{Kk}{c} \left(\frac{Mm}{P_{\rm{row}}}
+      ///     + \frac{Nn}{P_{\rm{col}}}\right)
+      ///     + (c - 1) \frac{MmNn}{P_{\rm{row}} P_{\rm{col}}}
+      /// \f]
+      /// where \f$P_{\rm{row}} \times P_{\rm{col}}\f$ is the 2D grid of a
+      /// layer. \f$T(c)\f$ is evaluated for
+      /// \f$ 1 \le c \le \min(P^{1/3}, K) \f$, and the smallest \f$c\f$
+      /// within 5% of the minimum is selected, so small process counts always
+      /// use the plain 2D grid.
+      /// \param nprocs The number of processes
+      /// \param rows The number of tile rows, \f$M\f$
+      /// \param cols The number of tile columns, \f$N\f$
+      /// \param inner The number of inner tiles, \f$K\f$
+      /// \param row_size The number of element rows, \f$Mm\f$
+      /// \param col_size The number of element columns, \f$Nn\f$
+      /// \param inner_size The number of inner elements, \f$Kk\f$
+      /// \return The number of layers that minimizes communication
+      static size_type optimal_layers(const size_type nprocs,
+          const size_type rows, const size_type cols, const size_type inner,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size)
+      {
+        size_type max_layers = std::cbrt(double(nprocs)) + 1e-6;
+        max_layers = std::max<size_type>(1u, std::min(max_layers, inner));
+
+        size_type result = 1u;
+        double min_cost = std::numeric_limits<double>::max();
+        for(size_type layers = 1u; layers <= max_layers; ++layers) {
+          // Construct the 2D grid of one layer
+          const ProcGrid grid(nprocs / layers, rows, cols, row_size, col_size);
+
+          const double Pr = grid.proc_rows_;
+          const double Pc = grid.proc_cols_;
+          const double cost =
+              (double(inner_size) / double(layers)) *
+              (double(row_size) / Pr + double(col_size) / Pc)
+              + double(layers - 1u) * double(row_size) * double(col_size) / (Pr * Pc);
+
+          if(cost < 0.95 * min_cost) {
+            min_cost = cost;
+            result = layers;
+          }
+        }
+
+        return result;
+      }
+
 
       /// Construct a row group
 
@@ -425,7 +640,7 @@ namespace TiledArray {
           proc_list.reserve(proc_cols_);
 
           // Populate the row process list
-          size_type p = rank_row_ * proc_cols_;
+          size_type p = layer_offset() + rank_row_ * proc_cols_;
           const size_type row_end = p + proc_cols_;
           for(; p < row_end; ++p)
             proc_list.push_back(p);
@@ -452,8 +667,9 @@ namespace TiledArray {
           proc_list.reserve(proc_rows_);
 
           // Populate the column process list
+          const size_type offset = layer_offset();
           for(size_type p = rank_col_; p < proc_size_; p += proc_cols_)
-            proc_list.push_back(p);
+            proc_list.push_back(offset + p);
 
           // Construct the group
           if(proc_list.size() != 0)
@@ -469,7 +685,7 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (row,rank_col)
       ProcessID map_row(const size_type row) const {
         TA_ASSERT(row < proc_rows_);
-        return rank_col_ + row * proc_cols_;
+        return layer_offset() + rank_col_ + row * proc_cols_;
       }
 
       /// Map a column to the process in this process's row
@@ -478,12 +694,13 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (rank_row,col)
       ProcessID map_col(const size_type col) const {
         TA_ASSERT(col < proc_cols_);
-        return rank_row_ * proc_cols_ + col;
+        return layer_offset() + rank_row_ * proc_cols_ + col;
       }
 
       /// Construct a cyclic process
 
       /// Construct a cyclic process map with the same phase as the process grid.
+      /// The tiles are mapped to layer 0.
       /// \return Cyclic process map
       std::shared_ptr<Pmap> make_pmap() const {
         TA_ASSERT(world_);
@@ -495,11 +712,17 @@ namespace TiledArray {
 
       /// Construct a cyclic process map where the column phase of the process
       /// matches that of this process grid.
+      /// If the grid is layered, the rows are split among the layers (see
+      /// \c LayeredPmap ).
       /// \param rows The number of rows in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_col_phase_pmap(const size_type rows) const {
         TA_ASSERT(world_);
 
+        if(layers_ > 1u)
+          return std::make_shared<LayeredPmap>(*world_, rows, cols_, proc_rows_,
+              proc_cols_, layers_, layer_stride_, false);
+
         return std::make_shared<CyclicPmap>(*world_, rows, cols_, proc_rows_, proc_cols_);
       }
 
@@ -507,11 +730,17 @@ namespace TiledArray {
 
       /// Construct a cyclic process map where the column phase of the process
       /// matches that of this process grid.
+      /// If the grid is layered, the columns are split among the layers (see
+      /// \c LayeredPmap ).
       /// \param cols The number of columns in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_row_phase_pmap(const size_type cols) const {
         TA_ASSERT(world_);
 
+        if(layers_ > 1u)
+          return std::make_shared<LayeredPmap>(*world_, rows_, cols, proc_rows_,
+              proc_cols_, layers_, layer_stride_, true);
+
         return std::make_shared<CyclicPmap>(*world_, rows_, cols, proc_rows_, proc_cols_);
       }
     }; // class Grid
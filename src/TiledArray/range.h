@@ -23,6 +23,7 @@
 #include <TiledArray/range_iterator.h>
 #include <TiledArray/permutation.h>
 #include <TiledArray/size_array.h>
+#include <memory>
 
 namespace TiledArray {
 
@@ -48,6 +49,9 @@ namespace TiledArray {
     typedef detail::RangeIterator<size_type, Range_> const_iterator; ///< Coordinate iterator
     friend class detail::RangeIterator<size_type, Range_>;
 
+    /// The maximum rank of ranges that hold their data without heap memory
+    static constexpr unsigned int max_inline_rank = 6u;
+
   protected:
 
     size_type* data_ = nullptr;
@@ -59,9 +63,71 @@ namespace TiledArray {
                       ///<   extent[0],  ..., extent[rank_ - 1],
                       ///<   stride[0],  ..., stride[rank_ - 1] }
                       ///< \endcode
+                      ///< It points to \c inline_data_ when \c rank_ is not
+                      ///< greater than \c max_inline_rank .
     size_type offset_ = 0ul; ///< Ordinal index offset correction
     size_type volume_ = 0ul; ///< Total number of elements
     unsigned int rank_ = 0u; ///< The rank (or number of dimensions) in the range
+    size_type inline_data_[max_inline_rank << 2]; ///< The data of small ranges
+
+    /// Allocate the range data array
+
+    /// \param rank The rank of the range
+    /// \pre \c data_ is not allocated
+    /// \post \c data_ holds <tt>4*rank</tt> elements and \c rank_ is
+    /// equal to \c rank
+    /// \throw std::bad_alloc When memory allocation fails.
+    void alloc_data(const unsigned int rank) {
+      data_ = (rank > max_inline_rank ? new size_type[rank << 2] :
+          (rank > 0u ? inline_data_ : nullptr));
+      rank_ = rank;
+    }
+
+    /// Free the range data array
+
+    /// \post \c data_ is not allocated and \c rank_ is zero
+    void free_data() {
+      if(data_ != inline_data_)
+        delete [] data_;
+      data_ = nullptr;
+      rank_ = 0u;
+    }
+
+    /// Reallocate the range data array
+
+    /// The array is kept when the rank is not changed.
+    /// \param rank The rank of the range
+    /// \post \c data_ holds <tt>4*rank</tt> elements and \c rank_ is
+    /// equal to \c rank
+    /// \throw std::bad_alloc When memory allocation fails.
+    void realloc_data(const unsigned int rank) {
+      if(rank_ != rank) {
+        free_data();
+        alloc_data(rank);
+      }
+    }
+
+    /// Move the data of another range to this range
+
+    /// \param other The range to be moved
+    /// \pre \c data_ is not allocated
+    /// \post \c other is an empty range
+    void move_data(Range_& other) {
+      if(other.data_ == other.inline_data_) {
+        data_ = inline_data_;
+        memcpy(data_, other.data_, (sizeof(size_type) << 2) * other.rank_);
+      } else {
+        data_ = other.data_;
+      }
+      offset_ = other.offset_;
+      volume_ = other.volume_;
+      rank_ = other.rank_;
+
+      other.data_ = nullptr;
+      other.offset_ = 0ul;
+      other.volume_ = 0ul;
+      other.rank_ = 0u;
+    }
 
   private:
 
@@ -312,8 +378,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(lower_bound, upper_bound);
       }
     }
@@ -336,8 +401,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(lower_bound, upper_bound);
       }
     }
@@ -356,8 +420,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(extent);
       }
     }
@@ -374,8 +437,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(extent);
       }
     }
@@ -396,8 +458,7 @@ namespace TiledArray {
       const size_type n = detail::size(bounds);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(bounds);
       }
     }
@@ -416,8 +477,7 @@ namespace TiledArray {
       const size_type n = detail::size(bounds);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(bounds);
       }
     }
@@ -453,10 +513,9 @@ namespace TiledArray {
     /// \throw std::bad_alloc When memory allocation fails.
     Range(const Range_& other) {
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
+        alloc_data(other.rank_);
         offset_ = other.offset_;
         volume_ = other.volume_;
-        rank_ = other.rank_;
         memcpy(data_, other.data_, (sizeof(size_type) << 2) * other.rank_);
       }
     }
@@ -465,14 +524,8 @@ namespace TiledArray {
 
     /// \param other The range to be copied
     /// \throw std::bad_alloc When memory allocation fails.
-    Range(Range_&& other) :
-      data_(other.data_), offset_(other.offset_), volume_(other.volume_),
-      rank_(other.rank_)
-    {
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
+    Range(Range_&& other) {
+      move_data(other);
     }
 
     /// Permuting copy constructor
@@ -484,8 +537,7 @@ namespace TiledArray {
       TA_ASSERT(perm.dim() == other.rank_);
 
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
-        rank_ = other.rank_;
+        alloc_data(other.rank_);
 
         if(perm) {
           init_range_data(perm, other.data_, other.data_ + rank_);
@@ -499,7 +551,10 @@ namespace TiledArray {
     }
 
     /// Destructor
-    ~Range() { delete [] data_; }
+    ~Range() {
+      if(data_ != inline_data_)
+        delete [] data_;
+    }
 
     /// Copy assignment operator
 
@@ -507,14 +562,12 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw std::bad_alloc When memory allocation fails.
     Range_& operator=(const Range_& other) {
-      if(rank_ != other.rank_) {
-        delete [] data_;
-        data_ = (other.rank_ > 0ul ? new size_type[other.rank_ << 2] : nullptr);
-        rank_ = other.rank_;
+      if(this != &other) {
+        realloc_data(other.rank_);
+        memcpy(data_, other.data_, (sizeof(size_type) << 2) * rank_);
+        offset_ = other.offset_;
+        volume_ = other.volume_;
       }
-      memcpy(data_, other.data_, (sizeof(size_type) << 2) * rank_);
-      offset_ = other.offset_;
-      volume_ = other.volume_;
 
       return *this;
     }
@@ -525,15 +578,10 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw nothing
     Range_& operator=(Range_&& other) {
-      data_ = other.data_;
-      offset_ = other.offset_;
-      volume_ = other.volume_;
-      rank_ = other.rank_;
-
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
+      if(this != &other) {
+        free_data();
+        move_data(other);
+      }
 
       return *this;
     }
@@ -764,11 +812,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
 
       // Reallocate memory for range arrays
-      if(rank_ != n) {
-        delete [] data_;
-        data_ = (n > 0ul ? new size_type[n << 2] : nullptr);
-        rank_ = n;
-      }
+      realloc_data(n);
       if(n > 0ul)
         init_range_data(lower_bound, upper_bound);
       else
@@ -934,11 +978,7 @@ namespace TiledArray {
 
       // Reallocate the array
       const unsigned int four_x_rank = rank << 2;
-      if(rank_ != rank) {
-        delete [] data_;
-        data_ = (rank > 0u ? new size_type[four_x_rank] : nullptr);
-        rank_ = rank;
-      }
+      realloc_data(rank);
 
       // Get range data
       ar & madness::archive::wrap(data_, four_x_rank) & offset_ & volume_;
@@ -951,11 +991,10 @@ namespace TiledArray {
     }
 
     void swap(Range_& other) {
-      // Get temp data
-      std::swap(data_, other.data_);
-      std::swap(offset_, other.offset_);
-      std::swap(volume_, other.volume_);
-      std::swap(rank_, other.rank_);
+      // Inline data cannot be exchanged by swapping pointers
+      Range_ temp(std::move(other));
+      other = std::move(*this);
+      *this = std::move(temp);
     }
 
   private:
@@ -1041,15 +1080,17 @@ namespace TiledArray {
   inline Range& Range::operator *=(const Permutation& perm) {
     TA_ASSERT(perm.dim() == rank_);
     if(rank_ > 1ul) {
-      // Copy the lower and upper bound data into a temporary array
-      size_type* MADNESS_RESTRICT const temp_lower = new size_type[rank_ << 1];
+      // Copy the lower and upper bound data into a temporary array, which is
+      // on the stack for small ranks
+      size_type temp_buffer[max_inline_rank << 1];
+      std::unique_ptr<size_type[]> temp_heap(rank_ > max_inline_rank ?
+          new size_type[rank_ << 1] : nullptr);
+      size_type* MADNESS_RESTRICT const temp_lower =
+          (temp_heap ? temp_heap.get() : temp_buffer);
       const size_type* MADNESS_RESTRICT const temp_upper = temp_lower + rank_;
       std::memcpy(temp_lower, data_, (sizeof(size_type) << 1) * rank_);
 
       init_range_data(perm, temp_lower, temp_upper);
-
-      // Cleanup old memory.
-      delete[] temp_lower;
     }
     return *this;
   }
@@ -23,6 +23,8 @@
 #include <TiledArray/config.h>
 #include <TiledArray/error.h>
 #include <TiledArray/external/madness.h>
+#include <algorithm>
+#include <vector>
 
 #ifdef TILEDARRAY_HAS_CUDA
 #include <TiledArray/external/cuda.h>
@@ -71,6 +73,33 @@ namespace TiledArray {
     private:
       opT op_; ///< The pairwise reduction operation
 
+      /// Reduce a batch of argument pairs with the batched operation of \c opT
+      template <typename Op>
+      static auto reduce_batch(const Op& op, result_type& result,
+          const std::vector<const first_argument_type*>& first,
+          const std::vector<const second_argument_type*>& second, int) ->
+          decltype(op(result, first, second))
+      { return op(result, first, second); }
+
+      /// Reduce a batch of argument pairs one pair at a time
+      template <typename Op>
+      static void reduce_batch(const Op& op, result_type& result,
+          const std::vector<const first_argument_type*>& first,
+          const std::vector<const second_argument_type*>& second, long)
+      {
+        for(std::size_t i = 0ul; i < first.size(); ++i)
+          op(result, *first[i], *second[i]);
+      }
+
+      /// Batch size of an operation that defines \c batch_size()
+      template <typename Op>
+      static auto op_batch_size(const Op& op, int) -> decltype(op.batch_size())
+      { return op.batch_size(); }
+
+      /// Batch size of an operation that does not define \c batch_size()
+      template <typename Op>
+      static std::size_t op_batch_size(const Op&, long) { return 1ul; }
+
     public:
       /// Default constructor
       ReducePairOpWrapper() : op_() { }
@@ -120,6 +149,35 @@ namespace TiledArray {
         op_(result, arg.first, arg.second);
       }
 
+      /// Reduce a batch of argument pairs
+
+      /// If \c opT provides a batched pair reduction, i.e.
+      /// <tt>op(result, std::vector<const first_argument_type*>,
+      /// std::vector<const second_argument_type*>)</tt>, it is used to reduce
+      /// the whole batch at once, otherwise the pairs are reduced one at a
+      /// time.
+      /// \param[out] result The object that will hold the result of this reduction
+      /// \param[in] args The argument pairs to be reduced
+      void operator()(result_type& result,
+          const std::vector<const argument_type*>& args) const
+      {
+        std::vector<const first_argument_type*> first;
+        std::vector<const second_argument_type*> second;
+        first.reserve(args.size());
+        second.reserve(args.size());
+        for(const argument_type* arg : args) {
+          first.push_back(& arg->first.get());
+          second.push_back(& arg->second.get());
+        }
+        reduce_batch(op_, result, first, second, 0);
+      }
+
+      /// Maximum number of argument pairs that should be reduced together
+
+      /// \return The batch size of \c opT , or 1 if \c opT does not define
+      /// \c batch_size()
+      std::size_t batch_size() const { return op_batch_size(op_, 0); }
+
     }; // class ReducePairOpWrapper
 
 
@@ -196,6 +254,18 @@ namespace TiledArray {
     ///     }
     /// }; // struct VectorProduct
     /// \endcode
+    /// The reduction operation may also define
+    /// \code
+    ///     // Maximum number of arguments that are reduced together
+    ///     std::size_t batch_size() const;
+    ///
+    ///     // Reduce a batch of arguments
+    ///     void operator()(result_type&,
+    ///         const std::vector<const argument_type*>&) const;
+    /// \endcode
+    /// in which case arguments that become ready while the result objects are
+    /// busy are collected, up to \c batch_size() at a time, and reduced with
+    /// a single call.
     /// \note There is no need to add this object to the MADNESS task queue. It
     /// will be handled internally by the object. Simply call \c submit() to add
     /// this task to the task queue.
@@ -435,7 +505,21 @@ namespace TiledArray {
         void reduce(std::shared_ptr<result_type>& result) {
           while(result) {
             lock_.lock(); // <<< Begin critical section
-            if(ready_object_) {
+            if(! ready_batch_.empty()) {
+              // Get the batch of ready arguments
+              std::vector<ReduceObject*> batch;
+              batch.swap(ready_batch_);
+              lock_.unlock(); // <<< End critical section
+
+              // Reduce the arguments that were held by ready_batch_
+              reduce_batch(*result, batch);
+
+              // cleanup the arguments
+              for(ReduceObject* ready_object : batch) {
+                ReduceObject::destroy(ready_object);
+                this->dec();
+              }
+            } else if(ready_object_) {
               // Get the ready argument
               ReduceObject* ready_object = const_cast<ReduceObject*>(ready_object_);
               ready_object_ = nullptr;
@@ -619,6 +703,83 @@ namespace TiledArray {
 #endif
         }
 
+        /// Reduce a batch of arguments with the batched reduction of \c opT
+        template <typename Op>
+        static auto reduce_batch(Op& op, result_type& result,
+            const std::vector<const argument_type*>& args, int) ->
+            decltype(op(result, args))
+        { return op(result, args); }
+
+        /// Reduce a batch of arguments one at a time
+        template <typename Op>
+        static void reduce_batch(Op& op, result_type& result,
+            const std::vector<const argument_type*>& args, long)
+        {
+          for(const argument_type* arg : args)
+            op(result, *arg);
+        }
+
+        /// Reduce a batch of reduction arguments
+
+        /// \param result The target of the reduction
+        /// \param objects The reduction arguments to be reduced
+        void reduce_batch(result_type& result,
+            const std::vector<ReduceObject*>& objects)
+        {
+          std::vector<const argument_type*> args;
+          args.reserve(objects.size());
+          for(const ReduceObject* object : objects)
+            args.push_back(& object->arg());
+          reduce_batch(op_, result, args, 0);
+        }
+
+        /// Batch size of an operation that defines \c batch_size()
+        template <typename Op>
+        static std::size_t op_batch_size(const Op& op, int,
+            decltype(std::declval<const Op&>().batch_size())* = nullptr)
+        {
+#ifdef TILEDARRAY_HAS_CUDA
+          // CUDA tiles are reduced one argument at a time
+          if(detail::is_cuda_tile<result_type>::value)
+            return 1ul;
+#endif
+          return std::max<std::size_t>(op.batch_size(), 1ul);
+        }
+
+        /// Batch size of an operation that does not define \c batch_size()
+        template <typename Op>
+        static std::size_t op_batch_size(const Op&, long) { return 1ul; }
+
+        /// Reduce a batch of arguments into a result
+
+        /// \param result The target of the reduction
+        /// \param objects The reduction arguments to be reduced
+        void reduce_result_batch(std::shared_ptr<result_type> result,
+            const std::vector<ReduceObject*>& objects)
+        {
+          // Reduce the arguments
+          reduce_batch(*result, objects);
+
+          // Cleanup the arguments
+          for(const ReduceObject* object : objects)
+            ReduceObject::destroy(object);
+
+          // Check for more reductions
+          reduce(result);
+
+          // Decrement the dependency counter for the arguments. This must
+          // be done after the reduce call to avoid a race condition.
+          for(std::size_t i = 0ul; i < objects.size(); ++i)
+            this->dec();
+        }
+
+        /// Reduce a batch of arguments into a new result
+
+        /// \param objects The reduction arguments to be reduced
+        void reduce_new_batch(const std::vector<ReduceObject*>& objects) {
+          reduce_result_batch(std::make_shared<result_type>(op_()), objects);
+        }
+
 #ifdef TILEDARRAY_HAS_CUDA
         template <typename Result = result_type>
         std::enable_if_t<detail::is_cuda_tile<Result>::value, void>
@@ -652,6 +813,8 @@ namespace TiledArray {
         opT op_; ///< The reduction operation
         std::shared_ptr<result_type> ready_result_; ///< Result object that is ready to be reduced
         volatile ReduceObject* ready_object_; ///< Reduction argument that is ready to be reduced
+        std::vector<ReduceObject*> ready_batch_; ///< Reduction arguments that are ready to be reduced in a batch
+        const std::size_t batch_size_; ///< Maximum number of arguments reduced in a batch
         Future<result_type> result_; ///< The result of the reduction task
         madness::Spinlock lock_; ///< Task lock
         madness::CallbackInterface* callback_; ///< The completion callback
@@ -667,7 +830,9 @@ namespace TiledArray {
         ReduceTaskImpl(World& world, opT op, madness::CallbackInterface* callback) :
           madness::TaskInterface(1, TaskAttributes::hipri()),
           world_(world), op_(op), ready_result_(std::make_shared<result_type>(op())),
-          ready_object_(nullptr), result_(), lock_(), callback_(callback)
+          ready_object_(nullptr), ready_batch_(),
+          batch_size_(op_batch_size(op, 0)), result_(), lock_(),
+          callback_(callback)
         { }
 
         virtual ~ReduceTaskImpl() { }
@@ -685,6 +850,10 @@ namespace TiledArray {
         /// \param object The reduction object that is ready to be reduced
         void ready(ReduceObject* object) {
           TA_ASSERT(object);
+          if(batch_size_ > 1ul) {
+            ready_batch(object);
+            return;
+          }
           lock_.lock(); // <<< Begin critical section
           if(ready_result_) {
             std::shared_ptr<result_type> ready_result = ready_result_;
@@ -706,6 +875,34 @@ namespace TiledArray {
           }
         }
 
+        /// Place a ready reduction object in the batch of ready arguments
+
+        /// If a result object is ready, the batch is reduced into it.
+        /// Otherwise the batch is held until a result object becomes ready or
+        /// the batch is full, in which case it is reduced into a new result
+        /// object.
+        /// \param object The reduction object that is ready to be reduced
+        void ready_batch(ReduceObject* object) {
+          std::vector<ReduceObject*> objects;
+          lock_.lock(); // <<< Begin critical section
+          ready_batch_.push_back(object);
+          if(ready_result_) {
+            std::shared_ptr<result_type> ready_result = ready_result_;
+            ready_result_.reset();
+            objects.swap(ready_batch_);
+            lock_.unlock(); // <<< End critical section
+            world_.taskq.add(this, & ReduceTaskImpl::reduce_result_batch,
+                ready_result, objects, TaskAttributes::hipri());
+          } else if(ready_batch_.size() >= batch_size_) {
+            objects.swap(ready_batch_);
+            lock_.unlock(); // <<< End critical section
+            world_.taskq.add(this, & ReduceTaskImpl::reduce_new_batch,
+                objects, TaskAttributes::hipri());
+          } else {
+            lock_.unlock(); // <<< End critical section
+          }
+        }
+
         /// Task result accessor
 
         /// \return A future that will hold the result of the reduction task
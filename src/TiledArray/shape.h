@@ -39,6 +39,16 @@ namespace TiledArray {
       public is_dense<typename DistArray<Tile, Policy>::shape_type>
   { };
 
+  /// Type trait to detect array policies with a sparse shape
+
+  /// \tparam Policy The array policy, e.g. \c SparsePolicy or
+  /// \c CompressedSparsePolicy
+  template <typename Policy>
+  struct is_sparse_policy :
+      public std::integral_constant<bool,
+          ! is_dense<typename Policy::shape_type>::value>
+  { };
+
 }  // namespace TiledArray
 
 #endif // TILEDARRAY_SHAPE_H__INCLUDED
@@ -29,12 +29,80 @@
 #include <TiledArray/tensor.h>
 #include <TiledArray/tiled_range.h>
 #include <TiledArray/val_array.h>
+#include <TiledArray/math/sparse_gemm.h>
 #include <TiledArray/tensor/shift_wrapper.h>
 #include <TiledArray/tensor/tensor_interface.h>
+#include <algorithm>
 #include <typeinfo>
+#include <vector>
 
 namespace TiledArray {
 
+  namespace detail {
+
+    /// All-gather the sparse (ordinal, value) pairs of all processes
+
+    /// Each process contributes a segment of pairs, which may be empty. The
+    /// segments are sent to process 0 with point-to-point messages,
+    /// concatenated in rank order, and broadcast to all processes, so the
+    /// size of the messages is proportional to the total number of pairs.
+    /// \tparam T The value type
+    /// \param world The world of the processes
+    /// \param[in,out] ordinals The ordinals of the local pairs, which are
+    /// replaced by the ordinals of all processes
+    /// \param[in,out] values The values of the local pairs, which are
+    /// replaced by the values of all processes
+    /// \return The number of pairs of all processes
+    /// \note This is a collective operation.
+    template <typename T>
+    inline std::size_t allgather_sparse(World& world,
+        std::vector<std::size_t>& ordinals, std::vector<T>& values)
+    {
+      TA_ASSERT(ordinals.size() == values.size());
+      const std::size_t nproc = world.size();
+      if(nproc == 1ul)
+        return ordinals.size();
+      const std::size_t rank = world.rank();
+
+      // Gather the number of pairs held by each process
+      std::vector<std::size_t> counts(nproc, 0ul);
+      counts[rank] = ordinals.size();
+      world.gop.sum(counts.data(), nproc);
+      std::size_t total = 0ul;
+      for(const std::size_t count : counts)
+        total += count;
+      if(total == 0ul)
+        return 0ul;
+
+      // Collect the segments on process 0
+      const auto tag = world.mpi.unique_tag();
+      if(rank == 0ul) {
+        ordinals.resize(total);
+        values.resize(total);
+        for(std::size_t p = 1ul, offset = counts[0]; p < nproc; offset += counts[p++]) {
+          if(counts[p] == 0ul)
+            continue;
+          world.mpi.Recv(ordinals.data() + offset, counts[p], p, tag);
+          world.mpi.Recv(values.data() + offset, counts[p], p, tag);
+        }
+      } else {
+        if(counts[rank]) {
+          world.mpi.Send(ordinals.data(), counts[rank], 0, tag);
+          world.mpi.Send(values.data(), counts[rank], 0, tag);
+        }
+        ordinals.resize(total);
+        values.resize(total);
+      }
+
+      // Distribute the pairs of all processes
+      world.gop.broadcast(ordinals.data(), total * sizeof(std::size_t), 0);
+      world.gop.broadcast(values.data(), total * sizeof(T), 0);
+
+      return total;
+    }
+
+  }  // namespace detail
+
   /// Frobenius-norm-based sparse shape
 
   /// Sparse shape uses a \c Tensor of Frobenius norms to describe the magnitude
@@ -118,6 +186,46 @@ namespace TiledArray {
       return result;
     }
 
+    /// Max-reduce tile norms across all processes
+
+    /// Only the (ordinal, norm) pairs of the non-zero local norms are
+    /// all-gathered (see \c detail::allgather_sparse ), so the communication
+    /// volume is proportional to the number of non-zero norms rather than to
+    /// the number of tiles. When the pairs are larger than the dense norm
+    /// tensor, e.g. when the norms are replicated, the dense tensor is
+    /// max-reduced instead.
+    /// \param world The world where the shape will live
+    /// \param tile_norms The local tile norms, which are replaced by the
+    /// element-wise maximum of the tile norms of all processes
+    static void allreduce_max(World& world, Tensor<value_type>& tile_norms) {
+      if(world.size() == 1)
+        return;
+      const size_type n = tile_norms.size();
+      value_type* MADNESS_RESTRICT const data = tile_norms.data();
+
+      // Collect the non-zero local norms
+      std::vector<size_type> ordinals;
+      std::vector<value_type> norms;
+      for(size_type i = 0ul; i < n; ++i) {
+        if(data[i] != value_type(0)) {
+          ordinals.push_back(i);
+          norms.push_back(data[i]);
+        }
+      }
+
+      // Fall back to the dense reduction when it sends fewer bytes
+      size_type total = ordinals.size();
+      world.gop.sum(total);
+      if(total * (sizeof(size_type) + sizeof(value_type)) >= n * sizeof(value_type)) {
+        world.gop.max(data, n);
+        return;
+      }
+
+      detail::allgather_sparse(world, ordinals, norms);
+      for(size_type i = 0ul; i < ordinals.size(); ++i)
+        data[ordinals[i]] = std::max(data[ordinals[i]], norms[i]);
+    }
+
     enum class ScaleBy { Volume, InverseVolume };
 
     /// scales the contents of \c tile_norms by the corresponding tile's (inverse) volume
@@ -319,8 +427,8 @@ namespace TiledArray {
     /// Collective "dense" constructor
 
     /// This constructor uses tile norms given as a dense tensor.
-    /// The tile norms are max-reduced across all processes (via
-    /// an all reduce).
+    /// The tile norms are max-reduced across all processes; only the
+    /// non-zero norms of each process are exchanged.
     /// Next, the norms are scaled by the inverse of the corresponding tile's volumes.
     /// \param world The world where the shape will live
     /// \param tile_norms The Frobenius norm of tiles by default; expected to contain nonzeros
@@ -336,7 +444,7 @@ namespace TiledArray {
       TA_ASSERT(tile_norms_.range() == trange.tiles_range());
 
       // reduce norm data from all processors
-      world.gop.max(tile_norms_.data(), tile_norms_.size());
+      allreduce_max(world, tile_norms_);
 
       if(!do_not_scale){
         zero_tile_count_ = scale_tile_norms<ScaleBy::InverseVolume>(tile_norms_, size_vectors_.get());;
@@ -349,7 +457,8 @@ namespace TiledArray {
     /// represented as a sequence of {index,value_type} data.
     /// The tile norms are scaled to per-element norms by dividing each
     /// norm by the tile's volume.
-    /// Lastly, the norms are max-reduced across all processors.
+    /// Lastly, the norms are max-reduced across all processors; only the
+    /// non-zero norms of each process are exchanged.
     /// \tparam SparseNormSequence the sequence of \c std::pair<index,value_type> objects,
     ///         where \c index is a directly-addressable sequence of integers.
     /// \param world The world where the shape will live
@@ -361,7 +470,13 @@ namespace TiledArray {
                 const SparseNormSequence& tile_norms,
                 const TiledRange& trange) : SparseShape(tile_norms, trange)
     {
-      world.gop.max(tile_norms_.data(), tile_norms_.size());
+      allreduce_max(world, tile_norms_);
+
+      // Count the zero tiles of the reduced norms
+      zero_tile_count_ = 0ul;
+      for(const value_type norm : tile_norms_)
+        if(norm == value_type(0))
+          ++zero_tile_count_;
     }
 
     /// Copy constructor
@@ -1080,6 +1195,12 @@ namespace TiledArray {
       return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count);
     }
 
+    /// Contract shapes
+
+    /// The norms of the arguments are treated as sparse M-by-K and K-by-N
+    /// matrices, so zero tiles are screened out of the product and the cost
+    /// is proportional to the number of non-zero tile-pair products rather
+    /// than to \f$ M N K \f$ . Large products are evaluated in parallel.
     /// \tparam Factor The scaling factor type
     /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
     template <typename Factor>
@@ -1115,41 +1236,47 @@ namespace TiledArray {
 
       if(k_rank > 0u) {
 
-        // Compute size vector
+        // Compute the squared inner tile sizes, which are used to convert
+        // the per-element norms of the arguments to tile norms.
         const vector_type k_sizes =
             recursive_outer_product(size_vectors_.get() + gemm_helper.left_inner_begin(),
                 k_rank, [] (const vector_type& size_vector) -> const vector_type&
                 { return size_vector; });
-
-        // TODO: Make this faster. It can be done without using temporaries
-        // for the arguments, but requires a custom matrix multiply.
-
-        Tensor<value_type> left(tile_norms_.range());
-        const size_type mk = M * K;
-        auto left_op = [] (const value_type left, const value_type right)
-            { return left * right; };
-        for(size_type i = 0ul; i < mk; i += K)
-          math::vector_op(left_op, K, left.data() + i,
-              tile_norms_.data() + i, k_sizes.data());
-
-        Tensor<value_type> right(other.tile_norms_.range());
-        for(integer i = 0ul, k = 0; k < K; i += N, ++k) {
-          const value_type factor = k_sizes[k];
-          auto right_op = [=] (const value_type arg) { return arg * factor; };
-          math::vector_op(right_op, N, right.data() + i, other.tile_norms_.data() + i);
-        }
-
-        result_norms = left.gemm(right, abs_factor, gemm_helper);
-
-        // Hard zero tiles that are below the zero threshold.
-        result_norms.inplace_unary(
-            [threshold, &zero_tile_count] (value_type& value) {
-              if(value < threshold) {
-                value = value_type(0);
-                ++zero_tile_count;
+        std::vector<value_type> k_weights(k_sizes.size());
+        for(size_type k = 0ul; k < k_weights.size(); ++k)
+          k_weights[k] = k_sizes[k] * k_sizes[k];
+
+        // Compress the non-zero tile norms of the arguments
+        const math::SparseMatrix<value_type> left(M, K, tile_norms_.data(),
+            gemm_helper.left_op() != madness::cblas::NoTrans);
+        const math::SparseMatrix<value_type> right(K, N, other.tile_norms_.data(),
+            gemm_helper.right_op() != madness::cblas::NoTrans);
+
+        // Rows of the result that are not visited are zero
+        std::vector<size_type> partition = math::sparse_gemm_partition(left, right);
+        std::vector<size_type> non_zero_count(partition.size() - 1ul, 0ul);
+        value_type* MADNESS_RESTRICT const result_data = result_norms.data();
+        math::sparse_gemm(left, right, k_weights.data(), partition,
+            [=,&non_zero_count] (const size_type block, const size_type m,
+                const std::vector<size_type>& columns,
+                const value_type* const accumulator)
+            {
+              // Hard zero tiles that are below the zero threshold.
+              value_type* MADNESS_RESTRICT const result_m = result_data + m * N;
+              for(const size_type n : columns) {
+                const value_type norm = accumulator[n] * abs_factor;
+                if(norm >= threshold) {
+                  result_m[n] = norm;
+                  ++non_zero_count[block];
+                }
               }
             });
 
+        size_type non_zero = 0ul;
+        for(const size_type count : non_zero_count)
+          non_zero += count;
+        zero_tile_count = result_norms.size() - non_zero;
+
       } else {
 
         // This is an outer product, so the inputs can be used directly
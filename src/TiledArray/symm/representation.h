@@ -39,6 +39,10 @@ namespace TiledArray {
     /// identity for group of objects of type T
     template <typename T> T identity();
 
+    /// identity for the sign representation, i.e. a group of objects of type int
+    template <>
+    inline int identity<int>() { return 1; }
+
     /// class Representation is a representation of Group in terms of Representatives (typically, (linear) operators)
     /// \tparam Group class describing the group of symmetry transformations
     /// \tparam Representative class describing the group representatives; in TiledArray these will
@@ -0,0 +1,189 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_symmetry.h
+ *  Apr 19, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+#define TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+
+#include <TiledArray/symm/permutation_group.h>
+#include <TiledArray/symm/representation.h>
+#include <TiledArray/permutation.h>
+
+namespace TiledArray {
+  namespace symmetry {
+
+    /// Permutational symmetry of the tiles of an array
+
+    /// The symmetry is a permutation group of the tile (and element) index
+    /// positions, and a representation of the group by the signs \f$ \pm 1 \f$.
+    /// An element \c g of the group with sign \c s maps the element with
+    /// index \c x to the element with index \c g*x (see
+    /// \c operator*(const Permutation&, const std::vector<T, A>&) ), and
+    /// \f$ A(g x) = s A(x) \f$. For example, the antisymmetry of
+    /// \f$ t_{ij}^{ab} \f$, stored as \c t(a,b,i,j) , is described by
+    /// \code
+    /// using TiledArray::symmetry::Permutation;
+    /// TiledArray::symmetry::TileSymmetry symmetry({
+    ///     { Permutation{1, 0, 2, 3}, -1 },
+    ///     { Permutation{0, 1, 3, 2}, -1 } });
+    /// \endcode
+    /// The tiles of an orbit of the group are equal up to the permutation and
+    /// sign, so only the \em canonical tile, which has the lexicographically
+    /// smallest tile index of the orbit, is stored.
+    /// \note The tiles on the diagonal of the group (e.g. \c t(a,a,i,j) ) are
+    /// canonical, and their elements must have the symmetry of the group.
+    class TileSymmetry {
+    public:
+      using Permutation = TiledArray::symmetry::Permutation;
+      using group_type = PermutationGroup;
+      using representation_type = Representation<PermutationGroup, int>;
+
+      /// The canonical tile of a tile index
+      struct Canonical {
+        std::vector<std::size_t> index; ///< The canonical tile index
+        TiledArray::Permutation perm; ///< The permutation of the canonical tile
+        int sign; ///< The sign of the canonical tile
+
+        /// \return \c true if the tile is its own canonical tile
+        bool is_identity() const { return ! perm && (sign == 1); }
+      }; // struct Canonical
+
+    private:
+      representation_type representation_; ///< The group signs
+      std::shared_ptr<group_type> group_; ///< The permutation group
+      std::vector<std::pair<Permutation, int> > elements_; ///< The group elements and signs
+
+    public:
+
+      TileSymmetry() = delete;
+      TileSymmetry(const TileSymmetry&) = default;
+      TileSymmetry(TileSymmetry&&) = default;
+      ~TileSymmetry() = default;
+      TileSymmetry& operator=(const TileSymmetry&) = default;
+      TileSymmetry& operator=(TileSymmetry&&) = default;
+
+      /// Construct a tile symmetry from the group generators
+
+      /// \param generators The generators of the group and their signs
+      /// \throw TiledArray::Exception When a sign is not 1 or -1, or when the
+      /// signs are not a representation of the group
+      TileSymmetry(std::map<Permutation, int> generators) :
+        representation_(std::move(generators)),
+        group_(representation_.group()), elements_()
+      {
+        const auto& signs = representation_.representatives();
+        for(const auto& element : signs) {
+          if(element.second != 1 && element.second != -1)
+            TA_EXCEPTION("The sign of a tile symmetry must be 1 or -1.");
+          elements_.emplace_back(element.first, element.second);
+        }
+
+        // Check that the sign of each product is the product of the signs
+        for(const auto& a : elements_)
+          for(const auto& b : elements_)
+            if(signs.at(a.first * b.first) != a.second * b.second)
+              TA_EXCEPTION("The signs are not a representation of the group.");
+      }
+
+      /// The permutation group accessor
+
+      /// \return A const reference to the permutation group
+      const group_type& group() const { return *group_; }
+
+      /// The order of the group
+
+      /// \return The number of group elements, which is the largest number of
+      /// tiles that share a canonical tile
+      unsigned int order() const { return group_->order(); }
+
+      /// Check that the symmetry is compatible with a tiled range
+
+      /// \tparam TRange The tiled range type
+      /// \param trange The tiled range
+      /// \return \c true if the group only permutes dimensions that have the
+      /// same tiling, otherwise \c false
+      template <typename TRange>
+      bool is_compatible(const TRange& trange) const {
+        const std::size_t rank = trange.data().size();
+        for(const auto& element : elements_) {
+          for(const auto& map : element.first.data()) {
+            if((std::size_t(map.first) >= rank) || (std::size_t(map.second) >= rank))
+              return false;
+            if(trange.data()[map.first] != trange.data()[map.second])
+              return false;
+          }
+        }
+        return true;
+      }
+
+      /// Check for canonical tiles
+
+      /// \tparam Index The tile index type
+      /// \param index The tile index
+      /// \return \c true if \c index is the lexicographically smallest tile
+      /// index of its orbit, otherwise \c false
+      template <typename Index>
+      bool is_canonical(const Index& index) const {
+        return is_lexicographically_smallest(index, *group_);
+      }
+
+      /// Canonical tile of a tile index
+
+      /// The tile at \c index is equal to
+      /// <tt>result.sign * permute(tile(result.index), result.perm)</tt>.
+      /// \tparam Index The tile index type
+      /// \param index The tile index
+      /// \return The canonical tile index, and the permutation and sign that
+      /// map the canonical tile to the tile at \c index
+      template <typename Index>
+      Canonical canonical(const Index& index) const {
+        const std::vector<std::size_t> arg(std::begin(index), std::end(index));
+        Canonical result{arg, TiledArray::Permutation(), 1};
+
+        // Find the group element that maps index to the smallest index
+        const std::pair<Permutation, int>* min_element = nullptr;
+        for(const auto& element : elements_) {
+          std::vector<std::size_t> image = element.first * arg;
+          if(image < result.index) {
+            result.index = std::move(image);
+            min_element = &element;
+          }
+        }
+
+        if(min_element) {
+          // index = g * result.index, where g is the inverse of min_element
+          const Permutation g = min_element->first.inv();
+          std::vector<unsigned int> perm(arg.size());
+          for(unsigned int i = 0u; i < perm.size(); ++i)
+            perm[i] = g[i];
+          result.perm = TiledArray::Permutation(std::move(perm));
+          result.sign = min_element->second;
+        }
+
+        return result;
+      }
+
+    }; // class TileSymmetry
+
+  } // namespace symmetry
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
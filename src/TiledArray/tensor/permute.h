@@ -28,73 +28,323 @@
 
 #include <TiledArray/perm_index.h>
 #include <TiledArray/math/transpose.h>
+#include <deque>
+#include <memory>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
 
 
-    /// Compute the fused dimensions for permutation
-
-    /// This function will compute the fused dimensions of a tensor for use in
-    /// permutation algorithms. The idea is to partition the stride 1 dimensions
-    /// in both the input and output tensor, which yields a forth-order tensor
-    /// (second- and third-order tensors have size of 1 and stride of 0 in the
-    /// unused dimensions).
-    /// \tparam SizeType An unsigned integral type
-    /// \param[out] fused_size An array for the fused size output
-    /// \param[out] fused_weight An array for the fused weight output
-    /// \param[in] size An array that holds the unfused size information of the
-    /// argument tensor
-    /// \param[in] perm The permutation that will be applied to the argument
-    /// tensor(s).
-    template <typename SizeType>
-    inline void fuse_dimensions(SizeType * MADNESS_RESTRICT const fused_size,
-        SizeType * MADNESS_RESTRICT const fused_weight,
-        const SizeType * MADNESS_RESTRICT const size, const Permutation& perm)
-    {
-      const unsigned int ndim1 = perm.dim() - 1u;
+    /// Permutation plan
+
+    /// A permutation plan holds the loop structure of the permutation of a
+    /// tensor with a given extent. Dimensions that are contiguous in both the
+    /// argument and the result are fused, and dimensions of size one are
+    /// dropped. The remaining dimensions are iterated in result order, so the
+    /// result is written in order. When the argument and result stride one
+    /// dimensions differ, the argument stride one dimension is iterated in
+    /// chunks of a few cache lines and each chunk is transposed with the
+    /// unrolled block transpose of \c math::transpose , so every cache line
+    /// of the argument that is loaded is used in full. Large permutations are
+    /// split into slices that are evaluated in parallel.
+    ///
+    /// Plans depend only on the argument extent and the permutation, so they
+    /// are cached and reused by \c get() .
+    class PermutePlan {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+      /// The number of cache lines in a chunk of the argument stride one dimension
+      static constexpr size_type chunk_lines = 4ul;
+
+      /// The minimum volume of a permutation that is evaluated in parallel
+      static constexpr size_type parallel_threshold = 65536ul;
+
+      /// The number of plans that are cached by \c get()
+      static constexpr size_type cache_size = 64ul;
+
+    private:
+      std::vector<size_type> arg_extent_; ///< The unfused argument extent
+      Permutation perm_; ///< The permutation
+      std::vector<size_type> extent_; ///< Fused extents, in result order
+      std::vector<size_type> arg_stride_; ///< Argument strides of the fused dimensions
+      std::vector<size_type> result_stride_; ///< Result strides of the fused dimensions
+      size_type volume_; ///< The number of elements
+      unsigned int arg_inner_; ///< The fused dimension with the smallest argument stride
+
+      /// Evaluate a slice of the permutation
+
+      /// The outer dimensions (all but the result stride one dimension) are
+      /// iterated in result order, with a step of \c chunk in the argument
+      /// stride one dimension.
+      /// \tparam InnerOp The inner operation type, which is called as
+      /// <tt>inner_op(n, result, args...)</tt> where \c n is the size of the
+      /// argument stride one chunk
+      /// \param dim The outer dimension that is sliced
+      /// \param first The first index of the slice
+      /// \param last The end of the slice
+      /// \param chunk The chunk size of the argument stride one dimension
+      template <typename InnerOp, typename Result, typename... Args>
+      void eval_slice(const unsigned int dim, const size_type first,
+          const size_type last, const size_type chunk, const InnerOp& inner_op,
+          Result* const result, const Args* const... args) const
+      {
+        // Tensors without elements
+        if(volume_ == 0ul)
+          return;
+
+        const unsigned int outer = extent_.size() - 1u;
+
+        std::vector<size_type> index(outer), upper(extent_.begin(), extent_.begin() + outer);
+        size_type arg_offset = 0ul, result_offset = 0ul;
+        if(dim < outer) {
+          if(first >= last)
+            return;
+          index[dim] = first;
+          upper[dim] = last;
+          arg_offset = first * arg_stride_[dim];
+          result_offset = first * result_stride_[dim];
+        }
+        const size_type lower = (dim < outer ? first : 0ul);
+
+        while(true) {
+          inner_op((arg_inner_ < outer ?
+              std::min(chunk, upper[arg_inner_] - index[arg_inner_]) : 1ul),
+              result + result_offset, (args + arg_offset)...);
+
+          // Increment the outer index
+          int d = int(outer) - 1;
+          for(; d >= 0; --d) {
+            const size_type step = (unsigned(d) == arg_inner_ ? chunk : 1ul);
+            index[d] += step;
+            arg_offset += step * arg_stride_[d];
+            result_offset += step * result_stride_[d];
+            if(index[d] < upper[d])
+              break;
+
+            const size_type start = (unsigned(d) == dim ? lower : 0ul);
+            arg_offset -= (index[d] - start) * arg_stride_[d];
+            result_offset -= (index[d] - start) * result_stride_[d];
+            index[d] = start;
+          }
+          if(d < 0)
+            break;
+        }
+      }
 
-      int i = ndim1;
-      fused_size[3] = size[i--];
-      while((i >= 0) && (perm[i + 1u] == (perm[i] + 1u)))
-        fused_size[3] *= size[i--];
-      fused_weight[3] = 1u;
+      static madness::Spinlock& cache_mutex() {
+        static madness::Spinlock mutex;
+        return mutex;
+      }
 
+      static std::deque<std::shared_ptr<const PermutePlan> >& cache() {
+        static std::deque<std::shared_ptr<const PermutePlan> > plans;
+        return plans;
+      }
 
-      if((i >= 0) && (perm[i] != ndim1)) {
-        fused_size[2] = size[i--];
-        while((i >= 0) && (perm[i] != ndim1))
-          fused_size[2] *= size[i--];
+    public:
+
+      /// Construct a permutation plan
+
+      /// \param range The range of the argument tensor
+      /// \param perm The permutation applied to the argument tensor
+      PermutePlan(const Range& range, const Permutation& perm) :
+        arg_extent_(range.extent_data(), range.extent_data() + range.rank()),
+        perm_(perm), extent_(), arg_stride_(), result_stride_(),
+        volume_(range.volume()), arg_inner_(0u)
+      {
+        TA_ASSERT(perm.dim() == range.rank());
+        const unsigned int rank = range.rank();
+
+        // Compute the unfused argument and result strides
+        std::vector<size_type> arg_stride(rank), result_extent(rank),
+            result_stride(rank), arg_dim(rank);
+        size_type stride = 1ul;
+        for(int i = int(rank) - 1; i >= 0; --i) {
+          arg_stride[i] = stride;
+          stride *= arg_extent_[i];
+          result_extent[perm[i]] = arg_extent_[i];
+          arg_dim[perm[i]] = i;
+        }
+        stride = 1ul;
+        for(int i = int(rank) - 1; i >= 0; --i) {
+          result_stride[i] = stride;
+          stride *= result_extent[i];
+        }
 
-        fused_weight[2] = fused_size[3];
+        // Fuse result dimensions that are also contiguous in the argument,
+        // and drop dimensions of size one
+        for(unsigned int r = 0u; r < rank; ++r) {
+          if(result_extent[r] == 1ul)
+            continue;
+          const unsigned int i = arg_dim[r];
+          if(! extent_.empty() && (arg_stride_.back() == arg_stride[i] * arg_extent_[i])
+              && (result_stride_.back() == result_stride[r] * result_extent[r])) {
+            extent_.back() *= result_extent[r];
+            arg_stride_.back() = arg_stride[i];
+            result_stride_.back() = result_stride[r];
+          } else {
+            extent_.push_back(result_extent[r]);
+            arg_stride_.push_back(arg_stride[i]);
+            result_stride_.push_back(result_stride[r]);
+          }
+        }
 
-        fused_size[1] = size[i--];
-        while((i >= 0) && (perm[i + 1] == (perm[i] + 1u)))
-          fused_size[1] *= size[i--];
+        for(unsigned int d = 1u; d < extent_.size(); ++d)
+          if(arg_stride_[d] < arg_stride_[arg_inner_])
+            arg_inner_ = d;
+      }
 
-        fused_weight[1] = fused_size[2] * fused_weight[2];
-      } else {
-        fused_size[2] = 1ul;
-        fused_weight[2] = 0ul;
+      /// Get a cached permutation plan
+
+      /// \param range The range of the argument tensor
+      /// \param perm The permutation applied to the argument tensor
+      /// \return A plan for permuting a tensor with the extent of \c range
+      /// by \c perm
+      static std::shared_ptr<const PermutePlan>
+      get(const Range& range, const Permutation& perm) {
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(cache_mutex());
+          for(const auto& plan : cache())
+            if(plan->is_plan_for(range, perm))
+              return plan;
+        }
 
-        fused_size[1] = size[i--];
-        while((i >= 0) && (perm[i + 1] == (perm[i] + 1u)))
-          fused_size[1] *= size[i--];
+        auto plan = std::make_shared<const PermutePlan>(range, perm);
+
+        madness::ScopedMutex<madness::Spinlock> locker(cache_mutex());
+        auto& plans = cache();
+        plans.push_front(plan);
+        if(plans.size() > cache_size)
+          plans.pop_back();
+        return plan;
+      }
 
-        fused_weight[1] = fused_size[3];
+      /// Remove all plans from the cache
+      static void clear_cache() {
+        madness::ScopedMutex<madness::Spinlock> locker(cache_mutex());
+        cache().clear();
       }
 
-      if(i >= 0) {
-        fused_size[0] = size[i--];
-        while(i >= 0)
-          fused_size[0] *= size[i--];
+      /// Check that this plan permutes tensors with a given range and permutation
 
-        fused_weight[0] = fused_size[1] * fused_weight[1];
-      } else {
-        fused_size[0] = 1ul;
-        fused_weight[0] = 0ul;
+      /// \param range The range of the argument tensor
+      /// \param perm The permutation applied to the argument tensor
+      /// \return \c true if this plan was constructed for the extent of
+      /// \c range and \c perm
+      bool is_plan_for(const Range& range, const Permutation& perm) const {
+        return (range.rank() == arg_extent_.size()) && (perm == perm_) &&
+            std::equal(arg_extent_.begin(), arg_extent_.end(), range.extent_data());
       }
-    }
+
+      /// The number of fused dimensions
+
+      /// \return The number of dimensions that are iterated over
+      unsigned int rank() const { return extent_.size(); }
+
+      /// Permute the data of one or more tensors
+
+      /// The expected signature of the input operations is:
+      /// \code
+      /// Result input_op(const Args..)
+      /// \endcode
+      /// The expected signature of the output operations is:
+      /// \code
+      /// void output_op(Result*, const Result)
+      /// \endcode
+      /// \tparam InputOp The input operation type
+      /// \tparam OutputOp The output operation type
+      /// \tparam Result The result element type
+      /// \tparam Args The argument element types
+      /// \param input_op The operation that is used to generate the output value
+      /// from the input arguments
+      /// \param output_op The operation that is used to set the value of the
+      /// result tensor given the element pointer and the result value
+      /// \param result The data of the result tensor
+      /// \param args The data of the argument tensors, which have the same range
+      template <typename InputOp, typename OutputOp, typename Result, typename... Args>
+      void operator()(InputOp&& input_op, OutputOp&& output_op, Result* const result,
+          const Args* const... args) const
+      {
+        // Tensors without elements
+        if(volume_ == 0ul)
+          return;
+
+        if(extent_.empty()) {
+          // Tensors with one element
+          output_op(result, input_op(*args...));
+          return;
+        }
+
+        const unsigned int outer = extent_.size() - 1u;
+        const size_type m = extent_[outer];
+        const size_type arg_stride = arg_stride_[outer];
+        const size_type result_stride = result_stride_[arg_inner_];
+        const size_type chunk = std::max<size_type>(
+            chunk_lines * TILEDARRAY_CACHELINE_SIZE / sizeof(Result),
+            TILEDARRAY_LOOP_UNWIND);
+
+        // Transpose an m x n argument matrix, or copy m contiguous elements
+        // when the stride one dimensions of the argument and result are the same
+        auto inner_op = [&] (const size_type n, Result* const result_block,
+            const Args* const... arg_blocks)
+        {
+          if(arg_inner_ < outer)
+            math::transpose(input_op, output_op, m, n, result_stride,
+                result_block, arg_stride, arg_blocks...);
+          else
+            math::vector_ptr_op_serial(
+                [&] (Result* const r, param_type<Args>... a)
+                { output_op(r, input_op(a...)); },
+                m, result_block, arg_blocks...);
+        };
+
+        // Select the outermost dimension that can be split into enough slices
+        // for parallel evaluation
+        unsigned int dim = outer;
+        size_type units = 1ul;
+        if(volume_ >= parallel_threshold) {
+          for(unsigned int d = 0u; d < outer; ++d) {
+            const size_type units_d = (d == arg_inner_ ?
+                (extent_[d] + chunk - 1ul) / chunk : extent_[d]);
+            if(units_d > units) {
+              dim = d;
+              units = units_d;
+              if(units >= (volume_ / parallel_threshold))
+                break;
+            }
+          }
+        }
+
+        if(units > 1ul) {
+          const size_type step = (dim == arg_inner_ ? chunk : 1ul);
+          auto eval_units = [&] (const size_type first, const size_type last) {
+            eval_slice(dim, first * step, std::min(last * step, extent_[dim]),
+                chunk, inner_op, result, args...);
+          };
+
+#ifdef HAVE_INTEL_TBB
+          tbb::parallel_for(tbb::blocked_range<size_type>(0ul, units),
+              [&] (const tbb::blocked_range<size_type>& range)
+              { eval_units(range.begin(), range.end()); });
+#else
+          const size_type blocks = std::min(math::vector_op_blocks(volume_), units);
+          if(blocks > 1ul) {
+            // Each block evaluates a contiguous range of slices
+            math::vector_op_parallel(volume_, blocks,
+                [&] (const size_type b, const size_type, const size_type)
+                { eval_units((b * units) / blocks, ((b + 1ul) * units) / blocks); });
+          } else {
+            eval_units(0ul, units);
+          }
+#endif
+        } else {
+          eval_slice(outer, 0ul, 0ul, chunk, inner_op, result, args...);
+        }
+      }
+
+    }; // class PermutePlan
 
     /// Construct a permuted tensor copy
 
@@ -122,85 +372,8 @@ namespace TiledArray {
     inline void permute(InputOp&& input_op, OutputOp&& output_op, Result& result,
         const Permutation& perm, const Arg0& arg0, const Args&... args)
     {
-      detail::PermIndex perm_index_op(arg0.range(), perm);
-
-      // Cache constants
-      const unsigned int ndim = arg0.range().rank();
-      const unsigned int ndim1 = ndim - 1;
-      const typename Result::size_type volume = arg0.range().volume();
-
-      // Get pointer to arg extent
-      const auto* MADNESS_RESTRICT const arg0_extent = arg0.range().extent_data();
-
-      if(perm[ndim1] == ndim1) {
-        // This is the simple case where the last dimension is not permuted.
-        // Therefore, it can be shuffled in chunks.
-
-        // Determine which dimensions can be permuted with the least significant
-        // dimension.
-        typename Result::size_type block_size = arg0_extent[ndim1];
-        for(int i = int(ndim1) - 1 ; i >= 0; --i) {
-          if(int(perm[i]) != i)
-            break;
-          block_size *= arg0_extent[i];
-        }
-
-        // Combine the input and output operations
-        auto op = [=] (typename Result::pointer result,
-            typename Arg0::const_reference a0, typename Args::const_reference... as)
-        { output_op(result, input_op(a0, as...)); };
-
-        // Permute the data
-        for(typename Result::size_type index = 0ul; index < volume; index += block_size) {
-          const typename Result::size_type perm_index = perm_index_op(index);
-
-          // Copy the block
-          math::vector_ptr_op(op, block_size, result.data() + perm_index,
-              arg0.data() + index, (args.data() + index)...);
-        }
-
-      } else {
-        // This is the more complicated case. Here we permute in terms of matrix
-        // transposes. The data layout of the input and output matrices are
-        // chosen such that they both contain stride one dimensions.
-
-        // Here we partition the n dimensional index space, I, of the permute
-        // tensor with up to four parts
-        // {I_1, ..., I_i, I_i+1, ..., I_j, I_j+1, ..., I_k, I_k+1, ..., I_n}
-        // where the subrange {I_k+1, ..., I_n} is the (fused) inner dimension
-        // in the input tensor, and the subrange {I_i+1, ..., I_j} is the
-        // (fused) inner dimension in the output tensor that has been mapped to
-        // the input tensor. These ranges are used to form a set of matrices in
-        // the input tensor that are transposed and copied to the output tensor.
-        // The remaining (fused) index ranges {I_1, ..., I_i} and
-        // {I_j+1, ..., I_k} are used to form the outer loop around the matrix
-        // transpose operations. These outer ranges may or may not be zero size.
-        typename Result::size_type other_fused_size[4];
-        typename Result::size_type other_fused_weight[4];
-        fuse_dimensions(other_fused_size, other_fused_weight,
-            arg0.range().extent_data(), perm);
-
-        // Compute the fused stride for the result matrix transpose.
-        const auto* MADNESS_RESTRICT const result_extent = result.range().extent_data();
-        typename Result::size_type  result_outer_stride = 1ul;
-        for(unsigned int i = perm[ndim1] + 1u; i < ndim; ++i)
-          result_outer_stride *= result_extent[i];
-
-        // Copy data from the input to the output matrix via a series of matrix
-        // transposes.
-        for(typename Result::size_type i = 0ul; i < other_fused_size[0]; ++i) {
-          typename Result::size_type index = i * other_fused_weight[0];
-          for(typename Result::size_type j = 0ul; j < other_fused_size[2]; ++j, index += other_fused_weight[2]) {
-            // Compute the ordinal index of the input and output matrices.
-            typename Result::size_type perm_index = perm_index_op(index);
-
-            math::transpose(input_op, output_op,
-                other_fused_size[1], other_fused_size[3],
-                result_outer_stride, result.data() + perm_index,
-                other_fused_weight[1], arg0.data() + index, (args.data() + index)...);
-          }
-        }
-      }
+      const auto plan = PermutePlan::get(arg0.range(), perm);
+      (*plan)(input_op, output_op, result.data(), arg0.data(), args.data()...);
     }
 
 
@@ -22,6 +22,10 @@
 
 #include <TiledArray/math/gemm_helper.h>
 #include <TiledArray/math/blas.h>
+#include <TiledArray/math/batched_gemm.h>
+#include <TiledArray/math/gett.h>
+#include <TiledArray/math/simd.h>
+#include <TiledArray/pool_allocator.h>
 #include <TiledArray/tensor/kernels.h>
 #include <TiledArray/tensor/complex.h>
 
@@ -100,6 +104,27 @@ namespace TiledArray {
       pointer data_; ///< Tensor data
     }; // class Impl
 
+    /// The allocator type of \c Impl objects
+
+    /// \c Impl objects, and their reference counts, are allocated with the
+    /// data allocator when it is the pool allocator, so they are recycled with
+    /// the data; other allocators may place memory in special address spaces,
+    /// so the objects are allocated with the default allocator.
+    typedef typename std::conditional<detail::is_pool_allocator<allocator_type>::value,
+        typename std::allocator_traits<allocator_type>::template rebind_alloc<Impl>,
+        std::allocator<Impl> >::type impl_allocator_type;
+
+    /// Construct a shared \c Impl object
+
+    /// \tparam Args The \c Impl constructor argument types
+    /// \param args The \c Impl constructor arguments
+    /// \return A shared pointer to the new \c Impl object
+    template <typename... Args>
+    static std::shared_ptr<Impl> make_impl(Args&&... args) {
+      return std::allocate_shared<Impl>(impl_allocator_type(),
+          std::forward<Args>(args)...);
+    }
+
     template <typename... Ts>
     struct is_tensor {
       static constexpr bool value =
@@ -114,6 +139,76 @@ namespace TiledArray {
       math::uninitialized_fill_vector(n, U(), u);
     }
 
+    /// Checks if an operation with \c Right and \c Scalar can use the SIMD kernels
+
+    /// The SIMD kernels are used when the elements of this tensor are
+    /// supported by \c math::simd , \c Right is this tensor type, and
+    /// \c Scalar is exactly representable by \c scalar_type .
+    template <typename Right, typename Scalar = scalar_type>
+    using is_simd_op = std::integral_constant<bool,
+        math::simd::is_simd_type<T>::value && std::is_same<Right, Tensor_>::value &&
+        (std::is_same<Scalar, scalar_type>::value || std::is_integral<Scalar>::value)>;
+
+    template <typename Op, typename SimdOp>
+    Tensor_& simd_inplace_unary(Op&& op, SimdOp&&, std::false_type) {
+      return inplace_unary(op);
+    }
+
+    template <typename Op, typename SimdOp>
+    Tensor_& simd_inplace_unary(Op&&, SimdOp&& simd_op, std::true_type) {
+      TA_ASSERT(! empty());
+      simd_op(size(), data());
+      return *this;
+    }
+
+    template <typename Right, typename Op, typename SimdOp>
+    Tensor_& simd_inplace_binary(const Right& right, Op&& op, SimdOp&&, std::false_type) {
+      return inplace_binary(right, op);
+    }
+
+    template <typename Right, typename Op, typename SimdOp>
+    Tensor_& simd_inplace_binary(const Right& right, Op&&, SimdOp&& simd_op, std::true_type) {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! right.empty());
+      TA_ASSERT(range() == right.range());
+      simd_op(size(), data(), right.data());
+      return *this;
+    }
+
+    template <typename SimdOp, typename ReduceOp, typename JoinOp, typename Scalar>
+    decltype(auto) simd_reduce(SimdOp&&, ReduceOp&& reduce_op, JoinOp&& join_op,
+        Scalar identity, std::false_type) const
+    {
+      return reduce(reduce_op, join_op, identity);
+    }
+
+    template <typename SimdOp, typename ReduceOp, typename JoinOp, typename Scalar>
+    Scalar simd_reduce(SimdOp&& simd_op, ReduceOp&&, JoinOp&&, Scalar,
+        std::true_type) const
+    {
+      TA_ASSERT(! empty());
+      return simd_op(size(), data());
+    }
+
+    template <typename Right, typename SimdOp, typename ReduceOp, typename JoinOp,
+        typename Scalar>
+    decltype(auto) simd_reduce(const Right& other, SimdOp&&, ReduceOp&& reduce_op,
+        JoinOp&& join_op, Scalar identity, std::false_type) const
+    {
+      return reduce(other, reduce_op, join_op, identity);
+    }
+
+    template <typename Right, typename SimdOp, typename ReduceOp, typename JoinOp,
+        typename Scalar>
+    Scalar simd_reduce(const Right& other, SimdOp&& simd_op, ReduceOp&&, JoinOp&&,
+        Scalar, std::true_type) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(range() == other.range());
+      return simd_op(size(), data(), other.data());
+    }
+
     std::shared_ptr<Impl> pimpl_; ///< Shared pointer to implementation object
     static const range_type empty_range_; ///< Empty range
 
@@ -139,7 +234,7 @@ namespace TiledArray {
     /// uninitialized.
     /// \param range The range of the tensor
     explicit Tensor(const range_type& range) :
-      pimpl_(std::make_shared<Impl>(range))
+      pimpl_(make_impl(range))
     {
       default_init(range.volume(), pimpl_->data_);
     }
@@ -153,7 +248,7 @@ namespace TiledArray {
         typename std::enable_if<std::is_same<Value, value_type>::value &&
         detail::is_tensor<Value>::value>::type* = nullptr>
     Tensor(const range_type& range, const Value& value) :
-      pimpl_(std::make_shared<Impl>(range))
+      pimpl_(make_impl(range))
     {
       const size_type n = pimpl_->range_.volume();
       pointer MADNESS_RESTRICT const data = pimpl_->data_;
@@ -168,7 +263,7 @@ namespace TiledArray {
     template <typename Value,
         typename std::enable_if<detail::is_numeric_v<Value>>::type* = nullptr>
     Tensor(const range_type& range, const Value& value) :
-      pimpl_(std::make_shared<Impl>(range))
+      pimpl_(make_impl(range))
     {
       detail::tensor_init([value] () -> Value { return value; }, *this);
     }
@@ -178,7 +273,7 @@ namespace TiledArray {
         typename std::enable_if<TiledArray::detail::is_input_iterator<InIter>::value &&
             ! std::is_pointer<InIter>::value>::type* = nullptr>
     Tensor(const range_type& range, InIter it) :
-      pimpl_(std::make_shared<Impl>(range))
+      pimpl_(make_impl(range))
     {
       size_type n = range.volume();
       pointer MADNESS_RESTRICT const data = pimpl_->data_;
@@ -188,7 +283,7 @@ namespace TiledArray {
 
     template <typename U>
     Tensor(const Range& range, const U* u) :
-      pimpl_(std::make_shared<Impl>(range))
+      pimpl_(make_impl(range))
     {
       math::uninitialized_copy_vector(range.volume(), u, pimpl_->data_);
     }
@@ -201,7 +296,7 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<T1>::value &&
             ! std::is_same<T1, Tensor_>::value>::type* = nullptr>
     explicit Tensor(const T1& other) :
-      pimpl_(std::make_shared<Impl>(detail::clone_range(other)))
+      pimpl_(make_impl(detail::clone_range(other)))
     {
       auto op =
           [] (const numeric_t<T1> arg) -> numeric_t<T1>
@@ -218,7 +313,7 @@ namespace TiledArray {
     template <typename T1,
         typename std::enable_if<is_tensor<T1>::value>::type* = nullptr>
     Tensor(const T1& other, const Permutation& perm) :
-      pimpl_(std::make_shared<Impl>(perm * other.range()))
+      pimpl_(make_impl(perm * other.range()))
     {
       auto op =
           [] (const numeric_t<T1> arg) -> numeric_t<T1>
@@ -238,7 +333,7 @@ namespace TiledArray {
                  && ! std::is_same<typename std::decay<Op>::type,
                  Permutation>::value>::type* = nullptr>
     Tensor(const T1& other, Op&& op) :
-      pimpl_(std::make_shared<Impl>(detail::clone_range(other)))
+      pimpl_(make_impl(detail::clone_range(other)))
     {
       detail::tensor_init(op, *this, other);
     }
@@ -252,7 +347,7 @@ namespace TiledArray {
     template <typename T1, typename Op,
         typename std::enable_if<is_tensor<T1>::value>::type* = nullptr>
     Tensor(const T1& other, Op&& op, const Permutation& perm) :
-      pimpl_(std::make_shared<Impl>(perm * other.range()))
+      pimpl_(make_impl(perm * other.range()))
     {
       detail::tensor_init(op, perm, *this, other);
     }
@@ -268,7 +363,7 @@ namespace TiledArray {
     template <typename T1, typename T2, typename Op,
         typename std::enable_if<is_tensor<T1, T2>::value>::type* = nullptr>
     Tensor(const T1& left, const T2& right, Op&& op) :
-      pimpl_(std::make_shared<Impl>(detail::clone_range(left)))
+      pimpl_(make_impl(detail::clone_range(left)))
     {
       detail::tensor_init(op, *this, left, right);
     }
@@ -285,7 +380,7 @@ namespace TiledArray {
     template <typename T1, typename T2, typename Op,
         typename std::enable_if<is_tensor<T1, T2>::value>::type* = nullptr>
     Tensor(const T1& left, const T2& right, Op&& op, const Permutation& perm) :
-      pimpl_(std::make_shared<Impl>(perm * left.range()))
+      pimpl_(make_impl(perm * left.range()))
     {
       detail::tensor_init(op, perm, *this, left, right);
     }
@@ -499,7 +594,7 @@ namespace TiledArray {
       size_type n = 0ul;
       ar & n;
       if(n) {
-        std::shared_ptr<Impl> temp = std::make_shared<Impl>();
+        std::shared_ptr<Impl> temp = make_impl();
         temp->data_ = temp->allocate(n);
         try {
           // need to construct elements of data_ using placement new in case its default ctor is not trivial
@@ -721,7 +816,10 @@ namespace TiledArray {
     template <typename Scalar,
         typename std::enable_if<detail::is_numeric_v<Scalar>>::type* = nullptr>
     Tensor_& scale_to(const Scalar factor) {
-      return inplace_unary([factor] (numeric_type& MADNESS_RESTRICT res) { res *= factor; });
+      return simd_inplace_unary([factor] (numeric_type& MADNESS_RESTRICT res) { res *= factor; },
+          [factor] (const auto n, auto* const data)
+          { math::simd::scale_to(n, factor, data); },
+          is_simd_op<Tensor_, Scalar>());
     }
 
     // Addition operations
@@ -821,8 +919,11 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& add_to(const Right& right) {
-      return inplace_binary(right, [] (numeric_type& MADNESS_RESTRICT l,
-          const numeric_t<Right> r) { l += r; });
+      return simd_inplace_binary(right, [] (numeric_type& MADNESS_RESTRICT l,
+          const numeric_t<Right> r) { l += r; },
+          [] (const auto n, auto* const l, const auto* const r)
+          { math::simd::add_to(n, r, l); },
+          is_simd_op<Right>());
     }
 
     /// Add \c other to this tensor, and scale the result
@@ -836,9 +937,12 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<Right>::value &&
         detail::is_numeric_v<Scalar>>::type* = nullptr>
     Tensor_& add_to(const Right& right, const Scalar factor) {
-      return inplace_binary(right, [factor] (numeric_type& MADNESS_RESTRICT l,
+      return simd_inplace_binary(right, [factor] (numeric_type& MADNESS_RESTRICT l,
           const numeric_t<Right> r)
-          { (l += r) *= factor; });
+          { (l += r) *= factor; },
+          [factor] (const auto n, auto* const l, const auto* const r)
+          { math::simd::add_to(n, r, l, factor); },
+          is_simd_op<Right, Scalar>());
     }
 
     /// Add a constant to this tensor
@@ -943,9 +1047,12 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& subt_to(const Right& right) {
-      return inplace_binary(right, [] (numeric_type& MADNESS_RESTRICT l,
+      return simd_inplace_binary(right, [] (numeric_type& MADNESS_RESTRICT l,
           const numeric_t<Right> r)
-          { l -= r; });
+          { l -= r; },
+          [] (const auto n, auto* const l, const auto* const r)
+          { math::simd::subt_to(n, r, l); },
+          is_simd_op<Right>());
     }
 
     /// Subtract \c right from and scale this tensor
@@ -959,9 +1066,12 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<Right>::value &&
         detail::is_numeric_v<Scalar>>::type* = nullptr>
     Tensor_& subt_to(const Right& right, const Scalar factor) {
-      return inplace_binary(right, [factor] (numeric_type& MADNESS_RESTRICT l,
+      return simd_inplace_binary(right, [factor] (numeric_type& MADNESS_RESTRICT l,
           const numeric_t<Right> r)
-          { (l -= r) *= factor; });
+          { (l -= r) *= factor; },
+          [factor] (const auto n, auto* const l, const auto* const r)
+          { math::simd::subt_to(n, r, l, factor); },
+          is_simd_op<Right, Scalar>());
     }
 
     /// Subtract a constant from this tensor
@@ -1047,9 +1157,12 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& mult_to(const Right& right) {
-      return inplace_binary(right, [] (numeric_type& MADNESS_RESTRICT l,
+      return simd_inplace_binary(right, [] (numeric_type& MADNESS_RESTRICT l,
           const numeric_t<Right> r)
-          { l *= r; });
+          { l *= r; },
+          [] (const auto n, auto* const l, const auto* const r)
+          { math::simd::mult_to(n, r, l); },
+          is_simd_op<Right>());
     }
 
     /// Scale and multiply this tensor by \c right
@@ -1063,9 +1176,12 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<Right>::value &&
         detail::is_numeric_v<Scalar>>::type* = nullptr>
     Tensor_& mult_to(const Right& right, const Scalar factor) {
-      return inplace_binary(right, [factor] (numeric_type& MADNESS_RESTRICT l,
+      return simd_inplace_binary(right, [factor] (numeric_type& MADNESS_RESTRICT l,
           const numeric_t<Right> r)
-          { (l *= r) *= factor; });
+          { (l *= r) *= factor; },
+          [factor] (const auto n, auto* const l, const auto* const r)
+          { math::simd::mult_to(n, r, l, factor); },
+          is_simd_op<Right, Scalar>());
     }
 
     // Negation operations
@@ -1305,6 +1421,169 @@ namespace TiledArray {
       return *this;
     }
 
+    /// Contract a batch of tensor pairs and accumulate the scaled result to this tensor
+
+    /// This is equivalent to calling
+    /// <tt>gemm(*left[i], *right[i], factor, gemm_helper)</tt> for each pair
+    /// in the batch, but small pairs are packed along the contracted
+    /// dimension and evaluated with a single GEMM (see \c math::gemm_batch ).
+    /// The contracted dimensions of the pairs may differ, but the outer
+    /// dimensions of all pairs must match this tensor.
+    /// \tparam U The left-hand tensor element type
+    /// \tparam AU The left-hand tensor allocator type
+    /// \tparam V The right-hand tensor element type
+    /// \tparam AV The right-hand tensor allocator type
+    /// \tparam W The type of the scaling factor
+    /// \param left The left-hand tensors that will be contracted
+    /// \param right The right-hand tensors that will be contracted
+    /// \param factor The contraction results will be scaling by this value, then accumulated into \c this
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A reference to \c this
+    template <
+        typename U, typename AU, typename V, typename AV, typename W,
+        typename std::enable_if<!detail::is_tensor_of_tensor<
+            Tensor_, Tensor<U, AU>, Tensor<V, AV>>::value>::type* = nullptr>
+    Tensor_& gemm(const std::vector<const Tensor<U, AU>*>& left,
+                  const std::vector<const Tensor<V, AV>*>& right,
+                  const W factor, const math::GemmHelper& gemm_helper) {
+      // Check that this tensor is not empty and has the correct rank
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.result_rank());
+      TA_ASSERT(left.size() == right.size());
+
+      if(left.size() == 1ul)
+        return gemm(*left.front(), *right.front(), factor, gemm_helper);
+
+      // Collect the matrix pointers and contracted dimensions of each pair
+      const std::size_t batch = left.size();
+      std::vector<const U*> a(batch);
+      std::vector<const V*> b(batch);
+      std::vector<integer> k(batch);
+      integer m = 1, n = 1;
+      for(std::size_t i = 0ul; i < batch; ++i) {
+        // Check that the arguments are not empty and have the correct ranks
+        TA_ASSERT(!left[i]->empty());
+        TA_ASSERT(left[i]->range().rank() == gemm_helper.left_rank());
+        TA_ASSERT(!right[i]->empty());
+        TA_ASSERT(right[i]->range().rank() == gemm_helper.right_rank());
+
+        // Check that the outer dimensions of the pair match this tensor, and
+        // the inner dimensions of the pair match each other
+        TA_ASSERT(gemm_helper.left_result_congruent(left[i]->range().extent_data(),
+            pimpl_->range_.extent_data()));
+        TA_ASSERT(gemm_helper.right_result_congruent(right[i]->range().extent_data(),
+            pimpl_->range_.extent_data()));
+        TA_ASSERT(gemm_helper.left_right_congruent(left[i]->range().extent_data(),
+            right[i]->range().extent_data()));
+
+        gemm_helper.compute_matrix_sizes(m, n, k[i], left[i]->range(),
+            right[i]->range());
+        a[i] = left[i]->data();
+        b[i] = right[i]->data();
+      }
+
+      math::gemm_batch(gemm_helper.left_op(), gemm_helper.right_op(), m, n,
+          k.data(), batch, factor, a.data(), b.data(), numeric_type(1),
+          pimpl_->data_, n);
+
+      return *this;
+    }
+
+    /// Contract two permuted tensors and accumulate the scaled result to this tensor
+
+    /// This is equivalent to
+    /// <tt>gemm(left.permute(left_perm), right.permute(right_perm), factor, gemm_helper)</tt>,
+    /// but the permuted arguments are never formed. Instead, blocks of the
+    /// arguments are packed directly from their original layout (see
+    /// \c math::gett ). If this tensor is empty, it is initialized with the
+    /// contraction result.
+    /// \tparam U The left-hand tensor element type
+    /// \tparam AU The left-hand tensor allocator type
+    /// \tparam V The right-hand tensor element type
+    /// \tparam AV The right-hand tensor allocator type
+    /// \tparam W The type of the scaling factor
+    /// \param left The left-hand tensor that will be contracted
+    /// \param left_perm The permutation applied to \c left (an empty
+    /// permutation is the identity)
+    /// \param right The right-hand tensor that will be contracted
+    /// \param right_perm The permutation applied to \c right (an empty
+    /// permutation is the identity)
+    /// \param factor The contraction result will be scaling by this value, then accumulated into \c this
+    /// \param gemm_helper The *GEMM operation meta data for the permuted
+    /// arguments
+    /// \return A reference to \c this
+    template <
+        typename U, typename AU, typename V, typename AV, typename W,
+        typename std::enable_if<!detail::is_tensor_of_tensor<
+            Tensor_, Tensor<U, AU>, Tensor<V, AV>>::value>::type* = nullptr>
+    Tensor_& gemm(const Tensor<U, AU>& left, const Permutation& left_perm,
+                  const Tensor<V, AV>& right, const Permutation& right_perm,
+                  const W factor, const math::GemmHelper& gemm_helper) {
+      // Check that the arguments are not empty and have the correct ranks
+      TA_ASSERT(!left.empty());
+      TA_ASSERT(left.range().rank() == gemm_helper.left_rank());
+      TA_ASSERT(!right.empty());
+      TA_ASSERT(right.range().rank() == gemm_helper.right_rank());
+
+      // The ranges of the permuted arguments
+      const range_type left_range =
+          (left_perm ? left_perm * left.range() : left.range());
+      const range_type right_range =
+          (right_perm ? right_perm * right.range() : right.range());
+
+      // Check that the inner dimensions of left and right match
+      TA_ASSERT(gemm_helper.left_right_congruent(left_range.extent_data(),
+          right_range.extent_data()));
+
+      // Initialize an empty result, which does not need to be zeroed
+      numeric_type beta = 1;
+      if(! pimpl_) {
+        *this = Tensor_(gemm_helper.make_result_range<range_type>(left_range,
+            right_range));
+        beta = 0;
+      }
+
+      // Check that this tensor has the correct rank and that the outer
+      // dimensions of left and right match the corresponding dimensions in
+      // result
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.result_rank());
+      TA_ASSERT(gemm_helper.left_result_congruent(left_range.extent_data(),
+          pimpl_->range_.extent_data()));
+      TA_ASSERT(gemm_helper.right_result_congruent(right_range.extent_data(),
+          pimpl_->range_.extent_data()));
+
+      // Compute gemm dimensions
+      integer m, n, k;
+      gemm_helper.compute_matrix_sizes(m, n, k, left_range, right_range);
+
+      // Compute the offsets of the rows and columns of the arguments
+      const unsigned int inner_rank = gemm_helper.num_contract_ranks();
+      const unsigned int left_rank = gemm_helper.left_rank();
+      const unsigned int right_rank = gemm_helper.right_rank();
+      const unsigned int left_outer_rank = left_rank - inner_rank;
+      const unsigned int right_outer_rank = right_rank - inner_rank;
+      std::vector<std::size_t> a_row, a_col, b_row, b_col;
+      if(gemm_helper.left_op() == madness::cblas::NoTrans) {
+        a_row = math::permuted_offsets(left.range(), left_perm, 0u, left_outer_rank);
+        a_col = math::permuted_offsets(left.range(), left_perm, left_outer_rank, left_rank);
+      } else {
+        a_row = math::permuted_offsets(left.range(), left_perm, inner_rank, left_rank);
+        a_col = math::permuted_offsets(left.range(), left_perm, 0u, inner_rank);
+      }
+      if(gemm_helper.right_op() == madness::cblas::NoTrans) {
+        b_row = math::permuted_offsets(right.range(), right_perm, 0u, inner_rank);
+        b_col = math::permuted_offsets(right.range(), right_perm, inner_rank, right_rank);
+      } else {
+        b_row = math::permuted_offsets(right.range(), right_perm, right_outer_rank, right_rank);
+        b_col = math::permuted_offsets(right.range(), right_perm, 0u, right_outer_rank);
+      }
+
+      math::gett(m, n, k, factor, left.data(), a_row.data(), a_col.data(),
+          right.data(), b_row.data(), b_col.data(), beta, pimpl_->data_, n);
+
+      return *this;
+    }
+
     // Reduction operations
 
     /// Generalized tensor trace
@@ -1425,7 +1704,9 @@ namespace TiledArray {
               { res += TiledArray::detail::norm(arg); };
       auto sum_op = [] (scalar_type& MADNESS_RESTRICT res, const scalar_type arg)
               { res += arg; };
-      return reduce(square_op, sum_op, scalar_type(0));
+      return simd_reduce([] (const auto n, const auto* const data)
+          { return math::simd::squared_norm(n, data); },
+          square_op, sum_op, scalar_type(0), is_simd_op<Tensor_>());
     }
 
     /// Vector 2-norm
@@ -1469,7 +1750,10 @@ namespace TiledArray {
               { res = std::min(res, std::abs(arg)); };
       auto min_op = [] (scalar_type& MADNESS_RESTRICT res, const scalar_type arg)
               { res = std::min(res, arg); };
-      return reduce(abs_min_op, min_op, std::numeric_limits<scalar_type>::max());
+      return simd_reduce([] (const auto n, const auto* const data)
+          { return math::simd::abs_min(n, data); },
+          abs_min_op, min_op, std::numeric_limits<scalar_type>::max(),
+          is_simd_op<Tensor_>());
     }
 
     /// Absolute maximum element
@@ -1480,7 +1764,9 @@ namespace TiledArray {
               { res = std::max(res, std::abs(arg)); };
       auto max_op = [] (scalar_type& MADNESS_RESTRICT res, const scalar_type arg)
               { res = std::max(res, arg); };
-      return reduce(abs_max_op, max_op, scalar_type(0));
+      return simd_reduce([] (const auto n, const auto* const data)
+          { return math::simd::abs_max(n, data); },
+          abs_max_op, max_op, scalar_type(0), is_simd_op<Tensor_>());
     }
 
     /// Vector dot (not inner!) product
@@ -1498,7 +1784,9 @@ namespace TiledArray {
                 { res += l * r; };
       auto add_op = [] (numeric_type& MADNESS_RESTRICT res, const numeric_type value)
             { res += value; };
-      return reduce(other, mult_add_op, add_op, numeric_type(0));
+      return simd_reduce(other, [] (const auto n, const auto* const l,
+          const auto* const r) { return math::simd::dot(n, l, r); },
+          mult_add_op, add_op, numeric_type(0), is_simd_op<Right>());
     }
 
     /// Vector inner product
@@ -136,6 +136,19 @@ namespace TiledArray {
     template <typename ... Ts>
     constexpr const bool is_tensor_of_tensor_v = is_tensor_of_tensor<Ts...>::value;
 
+    // Test if a tensor has numeric elements of a different type than a result
+    // tensor, e.g. a single precision argument of a double precision result.
+    // Such tensors are converted to the result type before they are used.
+
+    template <typename T, typename Result>
+    struct is_mixed_precision : public std::false_type { };
+
+    template <typename T, typename A, typename U, typename B>
+    struct is_mixed_precision<Tensor<T, A>, Tensor<U, B> > :
+        public std::integral_constant<bool, is_numeric_v<T> && is_numeric_v<U>
+            && ! std::is_same<T, U>::value>
+    { };
+
     // Test if the tensor is contiguous
 
     template <typename T>
@@ -1017,6 +1017,39 @@ namespace TiledArray {
     return result;
   }
 
+  /// Contract and scale a batch of tile pairs to the result tile
+
+  /// The contraction is done via GEMM operations with fused indices as
+  /// defined by \c gemm_config.
+  /// \tparam Result The result tile type
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \param result The contracted result
+  /// \param left The left-hand arguments to be contracted
+  /// \param right The right-hand arguments to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \return A tile that is equal to
+  /// <tt>result = sum_i (left[i] * right[i]) * factor</tt>
+  template <typename Result, typename Left, typename Right, typename Scalar,
+      typename std::enable_if<detail::is_numeric_v<Scalar>>::type* = nullptr>
+  inline Tile<Result>& gemm(Tile<Result>& result,
+      const std::vector<const Tile<Left>*>& left,
+      const std::vector<const Tile<Right>*>& right, const Scalar factor,
+      const math::GemmHelper& gemm_config)
+  {
+    std::vector<const Left*> left_tensors;
+    std::vector<const Right*> right_tensors;
+    left_tensors.reserve(left.size());
+    right_tensors.reserve(right.size());
+    for(const auto* tile : left)
+      left_tensors.push_back(& tile->tensor());
+    for(const auto* tile : right)
+      right_tensors.push_back(& tile->tensor());
+    gemm(result.tensor(), left_tensors, right_tensors, factor, gemm_config);
+    return result;
+  }
+
 
   // Reduction operations ------------------------------------------------------
 
@@ -0,0 +1,481 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_codec.h
+ *  Apr 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_CODEC_H__INCLUDED
+#define TILEDARRAY_TILE_CODEC_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/tensor.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Tile compression codecs
+
+  /// A codec may be selected for each array with \c DistArray::set_codec() .
+  /// It compresses the tiles that are sent to other processes by remote
+  /// gets and sets, and by the broadcasts of contractions.
+  enum class TileCodec {
+    none, ///< Tiles are sent uncompressed
+    lossless, ///< Byte shuffle followed by LZ compression
+    lossy ///< Precision truncation to an absolute error bound, then \c lossless
+  }; // enum class TileCodec
+
+  /// Tile transport compression settings
+  struct CodecSettings {
+    TileCodec codec = TileCodec::none; ///< The codec
+    double tolerance = 0.0; ///< The absolute element error bound of \c TileCodec::lossy
+
+    /// Check for an active codec
+
+    /// \return \c true if tiles are compressed
+    bool enabled() const { return codec != TileCodec::none; }
+  }; // struct CodecSettings
+
+  /// Tile compression statistics
+
+  /// The counters accumulate over all arrays from the start of the program,
+  /// or from the last call to \c codec_reset_statistics() .
+  struct CodecStatistics {
+    std::size_t tiles = 0ul; ///< The number of tiles encoded
+    std::size_t raw_bytes = 0ul; ///< The size of the encoded tile data
+    std::size_t compressed_bytes = 0ul; ///< The size of the compressed tile data
+    double encode_seconds = 0.0; ///< The time spent encoding tiles
+    double decode_seconds = 0.0; ///< The time spent decoding tiles
+
+    /// Compression ratio
+
+    /// \return The ratio of the raw and compressed sizes, or 1 when no tile
+    /// was encoded
+    double ratio() const {
+      return (compressed_bytes ? double(raw_bytes) / double(compressed_bytes) : 1.0);
+    }
+  }; // struct CodecStatistics
+
+  namespace detail {
+
+    /// Codec statistics counters of this process
+    class CodecCounters {
+      std::atomic<std::size_t> tiles_{0ul};
+      std::atomic<std::size_t> raw_bytes_{0ul};
+      std::atomic<std::size_t> compressed_bytes_{0ul};
+      std::atomic<std::uint64_t> encode_ns_{0ul};
+      std::atomic<std::uint64_t> decode_ns_{0ul};
+
+    public:
+
+      /// The counters instance
+      static CodecCounters& instance() {
+        static CodecCounters counters;
+        return counters;
+      }
+
+      void encoded(const std::size_t raw, const std::size_t compressed,
+          const std::uint64_t ns)
+      {
+        ++tiles_;
+        raw_bytes_ += raw;
+        compressed_bytes_ += compressed;
+        encode_ns_ += ns;
+      }
+
+      void decoded(const std::uint64_t ns) { decode_ns_ += ns; }
+
+      CodecStatistics statistics() const {
+        CodecStatistics result;
+        result.tiles = tiles_;
+        result.raw_bytes = raw_bytes_;
+        result.compressed_bytes = compressed_bytes_;
+        result.encode_seconds = double(encode_ns_) * 1.0e-9;
+        result.decode_seconds = double(decode_ns_) * 1.0e-9;
+        return result;
+      }
+
+      void reset() {
+        tiles_ = 0ul;
+        raw_bytes_ = 0ul;
+        compressed_bytes_ = 0ul;
+        encode_ns_ = 0ul;
+        decode_ns_ = 0ul;
+      }
+    }; // class CodecCounters
+
+    /// Nanoseconds elapsed since \c start
+    inline std::uint64_t elapsed_ns(const std::chrono::steady_clock::time_point start) {
+      return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start).count());
+    }
+
+    /// Group the bytes of an array by their position in the elements
+
+    /// The first byte of every element is followed by the second byte of
+    /// every element, and so on. The bytes of floating point numbers that
+    /// are close in magnitude, e.g. the sign and exponent bytes, are then
+    /// adjacent, which makes them compressible.
+    /// \param in The elements
+    /// \param n The number of elements
+    /// \param size The element size in bytes
+    /// \param[out] out The shuffled bytes, <tt>n * size</tt> bytes
+    inline void byte_shuffle(const unsigned char* const in, const std::size_t n,
+        const std::size_t size, unsigned char* const out)
+    {
+      for(std::size_t i = 0ul; i < n; ++i)
+        for(std::size_t b = 0ul; b < size; ++b)
+          out[b * n + i] = in[i * size + b];
+    }
+
+    /// Restore the bytes reordered by \c byte_shuffle()
+
+    /// \param in The shuffled bytes
+    /// \param n The number of elements
+    /// \param size The element size in bytes
+    /// \param[out] out The elements, <tt>n * size</tt> bytes
+    inline void byte_unshuffle(const unsigned char* const in, const std::size_t n,
+        const std::size_t size, unsigned char* const out)
+    {
+      for(std::size_t b = 0ul; b < size; ++b)
+        for(std::size_t i = 0ul; i < n; ++i)
+          out[i * size + b] = in[b * n + i];
+    }
+
+    /// Append an unsigned integer with a variable length encoding
+    inline void lz_put_varint(std::vector<unsigned char>& out, std::size_t value) {
+      while(value >= 0x80ul) {
+        out.push_back((unsigned char)(value | 0x80ul));
+        value >>= 7;
+      }
+      out.push_back((unsigned char)(value));
+    }
+
+    /// Read an unsigned integer written by \c lz_put_varint()
+    inline std::size_t lz_get_varint(const unsigned char*& p,
+        const unsigned char* const end)
+    {
+      std::size_t value = 0ul;
+      for(unsigned int shift = 0u; ; shift += 7u) {
+        if((p == end) || (shift >= 64u))
+          TA_EXCEPTION("Corrupt compressed tile data.");
+        const unsigned char byte = *p++;
+        value |= std::size_t(byte & 0x7fu) << shift;
+        if(byte < 0x80u)
+          return value;
+      }
+    }
+
+    /// Compress a buffer with a fast LZ77 coder
+
+    /// The data is encoded as a sequence of literal runs and matches of at
+    /// least 4 bytes, which are found with a single-probe hash table, in the
+    /// manner of LZ4. A run is a varint <tt>(length << 1)</tt> followed by
+    /// the literal bytes, and a match is a varint
+    /// <tt>((length - 4) << 1) | 1</tt> followed by a varint offset.
+    /// \param in The data
+    /// \param n The number of bytes
+    /// \return The compressed data
+    inline std::vector<unsigned char> lz_compress(const unsigned char* const in,
+        const std::size_t n)
+    {
+      constexpr unsigned int hash_bits = 14u;
+      constexpr std::size_t min_match = 4ul;
+      std::vector<unsigned char> out;
+      out.reserve(n / 2ul + 16ul);
+
+      auto load32 = [in] (const std::size_t i) {
+        std::uint32_t value;
+        std::memcpy(&value, in + i, sizeof(value));
+        return value;
+      };
+      auto hash = [] (const std::uint32_t value) {
+        return (value * 2654435761u) >> (32u - hash_bits);
+      };
+      auto put_literals = [&out, in] (const std::size_t first, const std::size_t last) {
+        if(first < last) {
+          lz_put_varint(out, (last - first) << 1);
+          out.insert(out.end(), in + first, in + last);
+        }
+      };
+
+      std::vector<std::size_t> table(std::size_t(1ul) << hash_bits, n);
+      std::size_t anchor = 0ul;
+      std::size_t i = 0ul;
+      while(i + min_match <= n) {
+        const std::uint32_t value = load32(i);
+        std::size_t& entry = table[hash(value)];
+        const std::size_t candidate = entry;
+        entry = i;
+        if((candidate < i) && (load32(candidate) == value)) {
+          std::size_t length = min_match;
+          while((i + length < n) && (in[candidate + length] == in[i + length]))
+            ++length;
+          put_literals(anchor, i);
+          lz_put_varint(out, ((length - min_match) << 1) | 1ul);
+          lz_put_varint(out, i - candidate);
+          i += length;
+          anchor = i;
+        } else {
+          ++i;
+        }
+      }
+      put_literals(anchor, n);
+
+      return out;
+    }
+
+    /// Decompress a buffer written by \c lz_compress()
+
+    /// \param in The compressed data
+    /// \param n The number of compressed bytes
+    /// \param[out] out The data
+    /// \param size The number of bytes of the data
+    /// \throw TiledArray::Exception When the compressed data is corrupt
+    inline void lz_decompress(const unsigned char* in, const std::size_t n,
+        unsigned char* const out, const std::size_t size)
+    {
+      const unsigned char* const end = in + n;
+      std::size_t i = 0ul;
+      while(in != end) {
+        const std::size_t token = lz_get_varint(in, end);
+        if(token & 1ul) {
+          const std::size_t length = (token >> 1) + 4ul;
+          const std::size_t offset = lz_get_varint(in, end);
+          if((offset == 0ul) || (offset > i) || (length > size - i))
+            TA_EXCEPTION("Corrupt compressed tile data.");
+          // Matches may overlap the output, so copy byte by byte
+          for(std::size_t j = 0ul; j < length; ++j, ++i)
+            out[i] = out[i - offset];
+        } else {
+          const std::size_t length = token >> 1;
+          if((length > std::size_t(end - in)) || (length > size - i))
+            TA_EXCEPTION("Corrupt compressed tile data.");
+          std::memcpy(out + i, in, length);
+          in += length;
+          i += length;
+        }
+      }
+      if(i != size)
+        TA_EXCEPTION("Corrupt compressed tile data.");
+    }
+
+    /// Truncate the precision of floating point numbers
+
+    /// Elements with a magnitude not greater than \c tolerance are set to
+    /// zero, and the other elements keep only the mantissa bits needed to
+    /// represent them with an absolute error smaller than \c tolerance . The
+    /// cleared bits and zeros are then removed by the lossless codec.
+    /// \tparam T A floating point type
+    /// \param[in,out] data The elements
+    /// \param n The number of elements
+    /// \param tolerance The absolute error bound
+    template <typename T>
+    inline void truncate_precision(T* const data, const std::size_t n,
+        const double tolerance)
+    {
+      static_assert(std::is_floating_point<T>::value,
+          "Precision truncation requires floating point elements.");
+      typedef typename std::conditional<sizeof(T) == 8ul, std::uint64_t,
+          std::uint32_t>::type bits_type;
+      static_assert(sizeof(bits_type) == sizeof(T) &&
+          std::numeric_limits<T>::is_iec559,
+          "Precision truncation requires IEEE floating point elements.");
+      constexpr int mantissa_bits = std::numeric_limits<T>::digits - 1;
+
+      if(! (tolerance > 0.0))
+        return;
+
+      // 2^(tolerance_exp - 1) <= tolerance
+      int tolerance_exp = 0;
+      std::frexp(tolerance, &tolerance_exp);
+
+      for(std::size_t i = 0ul; i < n; ++i) {
+        const T x = data[i];
+        if(std::abs(x) <= tolerance) {
+          data[i] = T(0);
+        } else if(std::isfinite(x)) {
+          // The spacing of x with k mantissa bits is 2^(exp - 1 - k)
+          int exp = 0;
+          std::frexp(x, &exp);
+          const int drop = std::min(std::max(mantissa_bits - (exp - tolerance_exp),
+              0), mantissa_bits);
+          bits_type bits;
+          std::memcpy(&bits, &data[i], sizeof(T));
+          bits &= ~((bits_type(1) << drop) - bits_type(1));
+          std::memcpy(&data[i], &bits, sizeof(T));
+        }
+      }
+    }
+
+    /// Tiles that can be compressed
+
+    /// A tile type can be compressed if it stores its elements contiguously
+    /// and the elements are arithmetic types.
+    template <typename T>
+    struct is_compressible_tile : public std::false_type { };
+
+    template <typename T, typename A>
+    struct is_compressible_tile<Tensor<T, A> > :
+        public std::is_arithmetic<T> { };
+
+    /// A compressed tile
+
+    /// The serialized form of a tile with a codec. It holds the range of the
+    /// tile and its element data, shuffled and LZ compressed, or raw when
+    /// compression would not reduce its size.
+    /// \tparam Tile A tile type for which \c is_compressible_tile is true
+    template <typename Tile>
+    class CompressedTile {
+      static_assert(is_compressible_tile<Tile>::value,
+          "The tile type cannot be compressed.");
+
+    public:
+      typedef CompressedTile<Tile> CompressedTile_; ///< This class type
+      typedef Tile tile_type; ///< The tile type
+      typedef typename Tile::value_type value_type; ///< Tile element type
+      typedef typename Tile::range_type range_type; ///< Tile range type
+
+    private:
+      range_type range_; ///< The tile range
+      bool compressed_ = false; ///< \c true if \c data_ is compressed
+      std::vector<unsigned char> data_; ///< The element data
+      bool empty_ = true; ///< \c true if the tile is empty
+
+    public:
+
+      CompressedTile() = default;
+      CompressedTile(const CompressedTile_&) = default;
+      CompressedTile(CompressedTile_&&) = default;
+      ~CompressedTile() = default;
+      CompressedTile_& operator=(const CompressedTile_&) = default;
+      CompressedTile_& operator=(CompressedTile_&&) = default;
+
+      /// Encode a tile
+
+      /// \param tile The tile
+      /// \param settings The codec settings; \c TileCodec::lossy is
+      /// equivalent to \c TileCodec::lossless for integral elements
+      CompressedTile(const Tile& tile, const CodecSettings& settings) {
+        if(tile.empty())
+          return;
+
+        const auto start = std::chrono::steady_clock::now();
+        empty_ = false;
+        range_ = tile.range();
+        const std::size_t n = tile.size();
+        const std::size_t raw_bytes = n * sizeof(value_type);
+        const unsigned char* raw =
+            reinterpret_cast<const unsigned char*>(tile.data());
+
+        std::vector<value_type> truncated;
+        if(settings.codec == TileCodec::lossy)
+          raw = truncate(tile, settings.tolerance, truncated,
+              std::is_floating_point<value_type>());
+
+        if(settings.enabled()) {
+          std::vector<unsigned char> shuffled(raw_bytes);
+          byte_shuffle(raw, n, sizeof(value_type), shuffled.data());
+          data_ = lz_compress(shuffled.data(), raw_bytes);
+          compressed_ = (data_.size() < raw_bytes);
+        }
+        if(! compressed_)
+          data_.assign(raw, raw + raw_bytes);
+
+        CodecCounters::instance().encoded(raw_bytes, data_.size(),
+            elapsed_ns(start));
+      }
+
+      /// Decode the tile
+
+      /// \return A copy of the encoded tile
+      Tile decode() const {
+        if(empty_)
+          return Tile();
+
+        const auto start = std::chrono::steady_clock::now();
+        Tile result(range_);
+        unsigned char* const raw = reinterpret_cast<unsigned char*>(result.data());
+        const std::size_t raw_bytes = result.size() * sizeof(value_type);
+        if(compressed_) {
+          std::vector<unsigned char> shuffled(raw_bytes);
+          lz_decompress(data_.data(), data_.size(), shuffled.data(), raw_bytes);
+          byte_unshuffle(shuffled.data(), result.size(), sizeof(value_type), raw);
+        } else {
+          if(data_.size() != raw_bytes)
+            TA_EXCEPTION("Corrupt compressed tile data.");
+          std::memcpy(raw, data_.data(), raw_bytes);
+        }
+        CodecCounters::instance().decoded(elapsed_ns(start));
+
+        return result;
+      }
+
+      /// The size of the encoded element data
+
+      /// \return The number of bytes of element data that are sent
+      std::size_t size() const { return data_.size(); }
+
+      /// Serialize the compressed tile
+
+      /// \tparam Archive The archive type
+      /// \param ar The archive
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & empty_ & range_ & compressed_ & data_; }
+
+    private:
+
+      static const unsigned char* truncate(const Tile& tile,
+          const double tolerance, std::vector<value_type>& truncated,
+          std::true_type)
+      {
+        truncated.assign(tile.data(), tile.data() + tile.size());
+        truncate_precision(truncated.data(), truncated.size(), tolerance);
+        return reinterpret_cast<const unsigned char*>(truncated.data());
+      }
+
+      static const unsigned char* truncate(const Tile& tile, const double,
+          std::vector<value_type>&, std::false_type)
+      { return reinterpret_cast<const unsigned char*>(tile.data()); }
+
+    }; // class CompressedTile
+
+  } // namespace detail
+
+  /// Tile compression statistics
+
+  /// \return The codec statistics of this process
+  inline CodecStatistics codec_statistics() {
+    return detail::CodecCounters::instance().statistics();
+  }
+
+  /// Reset the tile compression statistics of this process
+  inline void codec_reset_statistics() {
+    detail::CodecCounters::instance().reset();
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_CODEC_H__INCLUDED
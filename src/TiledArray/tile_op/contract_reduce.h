@@ -32,6 +32,8 @@
 #include "../tile_interface/add.h"
 #include "../tile_interface/permute.h"
 #include <TiledArray/tensor/complex.h>
+#include <algorithm>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
@@ -61,9 +63,11 @@ namespace TiledArray {
             const madness::cblas::CBLAS_TRANSPOSE right_op,
             const scalar_type alpha, const unsigned int result_rank,
             const unsigned int left_rank, const unsigned int right_rank,
-            const Permutation& perm = Permutation()) :
+            const Permutation& perm, const std::size_t batch_size,
+            const Permutation& left_perm, const Permutation& right_perm) :
           gemm_helper_(left_op, right_op, result_rank, left_rank, right_rank),
-          alpha_(alpha), perm_(perm)
+          alpha_(alpha), perm_(perm), batch_size_(batch_size),
+          left_perm_(left_perm), right_perm_(right_perm)
         { }
 
         math::GemmHelper gemm_helper_; ///< Gemm helper object
@@ -71,12 +75,30 @@ namespace TiledArray {
             ///< the left- and right-hand arguments
         Permutation perm_; ///< Permutation that is applied to the final result
             ///< tensor
+        std::size_t batch_size_; ///< Maximum number of tile pairs that are
+            ///< contracted together
+        Permutation left_perm_; ///< Permutation that is applied to the
+            ///< left-hand tiles during the contraction
+        Permutation right_perm_; ///< Permutation that is applied to the
+            ///< right-hand tiles during the contraction
       };
 
       std::shared_ptr<Impl> pimpl_;
 
     public:
 
+      /// The default maximum number of tile pairs contracted in one batch
+      static constexpr std::size_t default_batch_size = 8ul;
+
+      /// Permuted argument flag
+
+      /// \c true if permuted argument tiles are contracted directly from
+      /// their original layout, without forming the permuted tiles. When
+      /// this is \c false , argument permutations must be applied to the
+      /// argument tiles before they are contracted.
+      static constexpr bool fuse_permute =
+          has_member_gemm_permuted<Result, Left, Right, int>::value;
+
       // Compiler generated defaults are fine
       
       ContractReduceBase() = default;
@@ -96,14 +118,27 @@ namespace TiledArray {
       /// \param right_rank The rank of the right-hand tensor
       /// \param perm The permutation to be applied to the result tensor
       /// (default = no permute)
+      /// \param batch_size The maximum number of tile pairs that are
+      /// contracted together (default = \c default_batch_size )
+      /// \param left_perm The permutation that is applied to the left-hand
+      /// tiles during the contraction (default = no permute)
+      /// \param right_perm The permutation that is applied to the right-hand
+      /// tiles during the contraction (default = no permute)
+      /// \note Argument permutations require \c fuse_permute .
       ContractReduceBase(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op,
           const scalar_type alpha, const unsigned int result_rank,
           const unsigned int left_rank, const unsigned int right_rank,
-          const Permutation& perm = Permutation()) :
+          const Permutation& perm = Permutation(),
+          const std::size_t batch_size = default_batch_size,
+          const Permutation& left_perm = Permutation(),
+          const Permutation& right_perm = Permutation()) :
         pimpl_(std::make_shared<Impl>(left_op, right_op, alpha, result_rank, left_rank,
-            right_rank, perm))
-      { }
+            right_rank, perm, std::max<std::size_t>(batch_size, 1ul), left_perm,
+            right_perm))
+      {
+        TA_ASSERT(fuse_permute || ! (left_perm || right_perm));
+      }
 
 
       /// Gemm meta data accessor
@@ -123,6 +158,24 @@ namespace TiledArray {
       }
 
 
+      /// Left-hand argument permutation accessor
+
+      /// \return A const reference to the permutation that is applied to the
+      /// left-hand tiles during the contraction
+      const Permutation& left_perm() const {
+        TA_ASSERT(pimpl_);
+        return pimpl_->left_perm_;
+      }
+
+      /// Right-hand argument permutation accessor
+
+      /// \return A const reference to the permutation that is applied to the
+      /// right-hand tiles during the contraction
+      const Permutation& right_perm() const {
+        TA_ASSERT(pimpl_);
+        return pimpl_->right_perm_;
+      }
+
       /// Scaling factor accessor
 
       /// \return The scaling factor for this operation
@@ -131,6 +184,15 @@ namespace TiledArray {
         return pimpl_->alpha_;
       }
 
+      /// Batch size accessor
+
+      /// \return The maximum number of tile pairs that are contracted
+      /// together by this operation
+      std::size_t batch_size() const {
+        TA_ASSERT(pimpl_);
+        return pimpl_->batch_size_;
+      }
+
       //-------------- these are only used for unit tests -----------------
       
       /// Compute the number of contracted ranks
@@ -165,8 +227,99 @@ namespace TiledArray {
         return pimpl_->gemm_helper_.right_rank();
       }
 
+    protected:
+
+      /// Contract a pair of tiles and add to a target tile
+
+      /// \tparam R The result tile type
+      /// \tparam S The scaling factor type
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] right The right-hand tile to be contracted
+      /// \param[in] factor The scaling factor applied to the pair
+      template <typename R, typename S>
+      void contract(R& result, const Left& left, const Right& right,
+          const S factor) const
+      {
+        contract(result, left, right, factor,
+            std::integral_constant<bool, fuse_permute>());
+      }
+
+    private:
+
+      template <typename R, typename S>
+      void contract(R& result, const Left& left, const Right& right,
+          const S factor, std::true_type) const
+      {
+        using TiledArray::gemm;
+        if(left_perm() || right_perm())
+          gemm(result, left, left_perm(), right, right_perm(), factor,
+              gemm_helper());
+        else
+          contract(result, left, right, factor, std::false_type());
+      }
+
+      template <typename R, typename S>
+      void contract(R& result, const Left& left, const Right& right,
+          const S factor, std::false_type) const
+      {
+        using TiledArray::empty;
+        using TiledArray::gemm;
+        if(empty(result))
+          result = gemm(left, right, factor, gemm_helper());
+        else
+          gemm(result, left, right, factor, gemm_helper());
+      }
+
+    protected:
+
+      /// Contract a batch of tile pairs and add to a target tile
+
+      /// \tparam R The result tile type
+      /// \tparam S The scaling factor type
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tiles to be contracted
+      /// \param[in] right The right-hand tiles to be contracted
+      /// \param[in] factor The scaling factor applied to each pair
+      template <typename R, typename S>
+      void contract_batch(R& result, const std::vector<const Left*>& left,
+          const std::vector<const Right*>& right, const S factor) const
+      {
+        using TiledArray::empty;
+        using TiledArray::gemm;
+        TA_ASSERT(left.size() == right.size());
+        if(left.empty())
+          return;
+
+        if(left_perm() || right_perm()) {
+          // Permuted pairs are packed by each contraction
+          for(std::size_t i = 0ul; i < left.size(); ++i)
+            contract(result, *left[i], *right[i], factor);
+          return;
+        }
+
+        if(empty(result)) {
+          result = gemm(*left.front(), *right.front(), factor, gemm_helper());
+          if(left.size() > 1ul)
+            gemm(result, std::vector<const Left*>(left.begin() + 1, left.end()),
+                std::vector<const Right*>(right.begin() + 1, right.end()),
+                factor, gemm_helper());
+        } else {
+          gemm(result, left, right, factor, gemm_helper());
+        }
+      }
+
     }; // class ContractReduceBase
 
+    template <typename Result, typename Left, typename Right, typename Scalar>
+    constexpr std::size_t
+    ContractReduceBase<Result, Left, Right, Scalar>::default_batch_size;
+
+    template <typename Result, typename Left, typename Right, typename Scalar>
+    constexpr bool ContractReduceBase<Result, Left, Right, Scalar>::fuse_permute;
+
     /// Contract and (sum) reduce operation
     
     /// This encodes a binary tensor contraction mapped to a GEMM, as well as the sum reduction and post-processing.
@@ -209,13 +362,22 @@ namespace TiledArray {
       /// \param right_rank The rank of the right-hand tensor
       /// \param perm The permutation to be applied to the result tensor
       /// (default = no permute)
+      /// \param batch_size The maximum number of tile pairs that are
+      /// contracted together
+      /// \param left_perm The permutation that is applied to the left-hand
+      /// tiles during the contraction (default = no permute)
+      /// \param right_perm The permutation that is applied to the right-hand
+      /// tiles during the contraction (default = no permute)
       ContractReduce(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op,
           const scalar_type alpha, const unsigned int result_rank,
           const unsigned int left_rank, const unsigned int right_rank,
-          const Permutation& perm = Permutation()) :
+          const Permutation& perm = Permutation(),
+          const std::size_t batch_size = ContractReduceBase_::default_batch_size,
+          const Permutation& left_perm = Permutation(),
+          const Permutation& right_perm = Permutation()) :
         ContractReduceBase_(left_op, right_op, alpha, result_rank, left_rank,
-            right_rank, perm)
+            right_rank, perm, batch_size, left_perm, right_perm)
       { }
 
 
@@ -259,14 +421,24 @@ namespace TiledArray {
       void operator()(result_type& result, first_argument_type left,
           second_argument_type right) const
       {
-        using TiledArray::empty;
-        using TiledArray::gemm;
-        if(empty(result))
-          result = gemm(left, right, ContractReduceBase_::factor(),
-              ContractReduceBase_::gemm_helper());
-        else
-          gemm(result, left, right, ContractReduceBase_::factor(),
-              ContractReduceBase_::gemm_helper());
+        ContractReduceBase_::contract(result, left, right,
+            ContractReduceBase_::factor());
+      }
+
+      /// Contract a batch of tile pairs and add to a target tile
+
+      /// This is equivalent to contracting each pair with
+      /// <tt>(*this)(result, *left[i], *right[i])</tt>, but small pairs may
+      /// be contracted together with a single GEMM.
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tiles to be contracted
+      /// \param[in] right The right-hand tiles to be contracted
+      void operator()(result_type& result, const std::vector<const Left*>& left,
+          const std::vector<const Right*>& right) const
+      {
+        ContractReduceBase_::contract_batch(result, left, right,
+            ContractReduceBase_::factor());
       }
 
     }; // class ContractReduce
@@ -319,13 +491,22 @@ namespace TiledArray {
       /// \param right_rank The rank of the right-hand tensor
       /// \param perm The permutation to be applied to the result tensor
       /// (default = no permute)
+      /// \param batch_size The maximum number of tile pairs that are
+      /// contracted together
+      /// \param left_perm The permutation that is applied to the left-hand
+      /// tiles during the contraction (default = no permute)
+      /// \param right_perm The permutation that is applied to the right-hand
+      /// tiles during the contraction (default = no permute)
       ContractReduce(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op,
           const scalar_type alpha, const unsigned int result_rank,
           const unsigned int left_rank, const unsigned int right_rank,
-          const Permutation& perm = Permutation()) :
+          const Permutation& perm = Permutation(),
+          const std::size_t batch_size = ContractReduceBase_::default_batch_size,
+          const Permutation& left_perm = Permutation(),
+          const Permutation& right_perm = Permutation()) :
         ContractReduceBase_(left_op, right_op, alpha, result_rank, left_rank,
-            right_rank, perm)
+            right_rank, perm, batch_size, left_perm, right_perm)
       { }
 
 
@@ -371,12 +552,21 @@ namespace TiledArray {
       void operator()(result_type& result, first_argument_type left,
           second_argument_type right) const
       {
-        using TiledArray::empty;
-        using TiledArray::gemm;
-        if(empty(result))
-          result = gemm(left, right, 1, ContractReduceBase_::gemm_helper());
-        else
-          gemm(result, left, right, 1, ContractReduceBase_::gemm_helper());
+        ContractReduceBase_::contract(result, left, right, 1);
+      }
+
+      /// Contract a batch of tile pairs and add to a target tile
+
+      /// See the primary template; the conjugate is applied by the post
+      /// processing step.
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tiles to be contracted
+      /// \param[in] right The right-hand tiles to be contracted
+      void operator()(result_type& result, const std::vector<const Left*>& left,
+          const std::vector<const Right*>& right) const
+      {
+        ContractReduceBase_::contract_batch(result, left, right, 1);
       }
 
     }; // class ContractReduce
@@ -430,13 +620,22 @@ namespace TiledArray {
       /// \param right_rank The rank of the right-hand tensor
       /// \param perm The permutation to be applied to the result tensor
       /// (default = no permute)
+      /// \param batch_size The maximum number of tile pairs that are
+      /// contracted together
+      /// \param left_perm The permutation that is applied to the left-hand
+      /// tiles during the contraction (default = no permute)
+      /// \param right_perm The permutation that is applied to the right-hand
+      /// tiles during the contraction (default = no permute)
       ContractReduce(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op,
           const scalar_type alpha, const unsigned int result_rank,
           const unsigned int left_rank, const unsigned int right_rank,
-          const Permutation& perm = Permutation()) :
+          const Permutation& perm = Permutation(),
+          const std::size_t batch_size = ContractReduceBase_::default_batch_size,
+          const Permutation& left_perm = Permutation(),
+          const Permutation& right_perm = Permutation()) :
         ContractReduceBase_(left_op, right_op, alpha, result_rank, left_rank,
-            right_rank, perm)
+            right_rank, perm, batch_size, left_perm, right_perm)
       { }
 
 
@@ -483,12 +682,21 @@ namespace TiledArray {
       void operator()(result_type& result, first_argument_type left,
           second_argument_type right) const
       {
-        using TiledArray::empty;
-        using TiledArray::gemm;
-        if(empty(result))
-          result = gemm(left, right, 1, ContractReduceBase_::gemm_helper());
-        else
-          gemm(result, left, right, 1, ContractReduceBase_::gemm_helper());
+        ContractReduceBase_::contract(result, left, right, 1);
+      }
+
+      /// Contract a batch of tile pairs and add to a target tile
+
+      /// See the primary template; the conjugate and the scaling factor are
+      /// applied by the post processing step.
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tiles to be contracted
+      /// \param[in] right The right-hand tiles to be contracted
+      void operator()(result_type& result, const std::vector<const Left*>& left,
+          const std::vector<const Right*>& right) const
+      {
+        ContractReduceBase_::contract_batch(result, left, right, 1);
       }
 
     }; // class ContractReduce
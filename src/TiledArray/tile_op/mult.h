@@ -27,6 +27,7 @@
 #define TILEDARRAY_TILE_OP_MULT_H__INCLUDED
 
 #include <TiledArray/error.h>
+#include <TiledArray/tensor/type_traits.h>
 #include <TiledArray/tile_op/tile_interface.h>
 #include <TiledArray/zero_tensor.h>
 
@@ -45,7 +46,10 @@ namespace TiledArray {
     /// \tparam RightConsumable If `true`, the right-hand tile is a temporary
     /// and may be consumed
     /// \note Input tiles can be consumed only if their type matches the result
-    /// type.
+    /// type. When the arguments are tensors with a different element type than
+    /// the result, the left-hand tile is converted to the result type before
+    /// it is multiplied, e.g. so single precision arguments are multiplied in
+    /// double precision.
     template <typename Result, typename Left, typename Right,
         bool LeftConsumable, bool RightConsumable>
     class Mult {
@@ -65,6 +69,30 @@ namespace TiledArray {
 
     private:
 
+      // Indicates whether the arguments are multiplied as they are
+      typedef std::integral_constant<bool,
+          ! is_mixed_precision<left_type, result_type>::value> same_precision;
+
+      // Multiply the arguments. When the left-hand tile is a tensor with a
+      // different element type than the result, it is converted to the result
+      // type first, so the product is evaluated in the precision of the result.
+
+      template <typename... Args>
+      static result_type product(std::true_type, const left_type& first,
+          const right_type& second, const Args&... args)
+      {
+        using TiledArray::mult;
+        return mult(first, second, args...);
+      }
+
+      template <typename... Args>
+      static result_type product(std::false_type, const left_type& first,
+          const right_type& second, const Args&... args)
+      {
+        using TiledArray::mult;
+        return mult(result_type(first), second, args...);
+      }
+
       // Permuting tile evaluation function
       // These operations cannot consume the argument tile since this operation
       // requires temporary storage space.
@@ -72,8 +100,7 @@ namespace TiledArray {
       static result_type eval(const left_type& first, const right_type& second,
           const Permutation& perm)
       {
-        using TiledArray::mult;
-        return mult(first, second, perm);
+        return product(same_precision(), first, second, perm);
       }
 
       static result_type eval(ZeroTensor, const right_type& second,
@@ -98,8 +125,7 @@ namespace TiledArray {
           typename std::enable_if<!(LC || RC)>::type* = nullptr>
       static result_type
       eval(const left_type& first, const right_type& second) {
-        using TiledArray::mult;
-        return mult(first, second);
+        return product(same_precision(), first, second);
       }
 
       template <bool LC, bool RC,
@@ -227,7 +253,10 @@ namespace TiledArray {
     /// \tparam RightConsumable If `true`, the right-hand tile is a temporary
     /// and may be consumed
     /// \note Input tiles can be consumed only if their type matches the result
-    /// type.
+    /// type. When the arguments are tensors with a different element type than
+    /// the result, the left-hand tile is converted to the result type before
+    /// it is multiplied, e.g. so single precision arguments are multiplied in
+    /// double precision.
     template <typename Result, typename Left, typename Right, typename Scalar,
         bool LeftConsumable, bool RightConsumable>
     class ScalMult {
@@ -251,6 +280,30 @@ namespace TiledArray {
 
       scalar_type factor_; ///< The scaling factor
 
+      // Indicates whether the arguments are multiplied as they are
+      typedef std::integral_constant<bool,
+          ! is_mixed_precision<left_type, result_type>::value> same_precision;
+
+      // Multiply the arguments. When the left-hand tile is a tensor with a
+      // different element type than the result, it is converted to the result
+      // type first, so the product is evaluated in the precision of the result.
+
+      template <typename... Args>
+      static result_type product(std::true_type, const left_type& first,
+          const right_type& second, const Args&... args)
+      {
+        using TiledArray::mult;
+        return mult(first, second, args...);
+      }
+
+      template <typename... Args>
+      static result_type product(std::false_type, const left_type& first,
+          const right_type& second, const Args&... args)
+      {
+        using TiledArray::mult;
+        return mult(result_type(first), second, args...);
+      }
+
       // Permuting tile evaluation function
       // These operations cannot consume the argument tile since this operation
       // requires temporary storage space.
@@ -258,8 +311,7 @@ namespace TiledArray {
       result_type eval(const left_type& first, const right_type& second,
           const Permutation& perm) const
       {
-        using TiledArray::mult;
-        return mult(first, second, factor_, perm);
+        return product(same_precision(), first, second, factor_, perm);
       }
 
       result_type eval(ZeroTensor, const right_type& second,
@@ -283,8 +335,7 @@ namespace TiledArray {
       template <bool LC, bool RC,
           typename std::enable_if<!(LC || RC)>::type* = nullptr>
       result_type eval(const left_type& first, const right_type& second) const {
-        using TiledArray::mult;
-        return mult(first, second, factor_);
+        return product(same_precision(), first, second, factor_);
       }
 
       template <bool LC, bool RC,
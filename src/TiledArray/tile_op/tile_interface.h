@@ -27,6 +27,7 @@
 #define TILEDARRAY_NONINTRUSIVE_API_TENSOR_H__INCLUDED
 
 #include <TiledArray/type_traits.h>
+#include "../tile_interface/permute.h"
 #include <iterator>
 #include <vector>
 
@@ -653,6 +654,151 @@ namespace TiledArray {
   }
 
 
+  namespace detail {
+
+    /// Contract a batch of tile pairs with the batched gemm member of \c Result
+    template <typename Result, typename Left, typename Right, typename Scalar>
+    inline auto gemm_batch(Result& result, const std::vector<const Left*>& left,
+        const std::vector<const Right*>& right, const Scalar factor,
+        const math::GemmHelper& gemm_config, int) ->
+        decltype(result.gemm(left, right, factor, gemm_config))
+    { return result.gemm(left, right, factor, gemm_config); }
+
+    /// Contract a batch of tile pairs one pair at a time
+    template <typename Result, typename Left, typename Right, typename Scalar>
+    inline Result& gemm_batch(Result& result, const std::vector<const Left*>& left,
+        const std::vector<const Right*>& right, const Scalar factor,
+        const math::GemmHelper& gemm_config, long)
+    {
+      using TiledArray::gemm;
+      for(std::size_t i = 0ul; i < left.size(); ++i)
+        gemm(result, *left[i], *right[i], factor, gemm_config);
+      return result;
+    }
+
+  } // namespace detail
+
+  /// Contract and scale a batch of tile pairs to the result tile
+
+  /// The contraction is done via GEMM operations with fused indices as
+  /// defined by \c gemm_config. Tiles that provide a batched \c gemm member
+  /// may evaluate several pairs with one GEMM, otherwise each pair is
+  /// contracted separately.
+  /// \tparam Result The result tile type
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Scalar A scalar type
+  /// \param result The contracted result
+  /// \param left The left-hand arguments to be contracted
+  /// \param right The right-hand arguments to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \return A tile that is equal to
+  /// <tt>result = sum_i (left[i] * right[i]) * factor</tt>
+  template <typename Result, typename Left, typename Right, typename Scalar,
+      std::enable_if_t<TiledArray::detail::is_numeric_v<Scalar>>* = nullptr>
+  inline Result& gemm(Result& result, const std::vector<const Left*>& left,
+      const std::vector<const Right*>& right, const Scalar factor,
+      const math::GemmHelper& gemm_config)
+  {
+    detail::gemm_batch(result, left, right, factor, gemm_config, 0);
+    return result;
+  }
+
+  namespace detail {
+
+    /// Check for a permuting gemm member of \c Result
+
+    /// \c value is \c true if \c Result can contract permuted \c Left and
+    /// \c Right tiles without forming the permuted tiles.
+    template <typename Result, typename Left, typename Right, typename Scalar,
+        typename Enabler = void>
+    struct has_member_gemm_permuted : public std::false_type { };
+
+    template <typename Result, typename Left, typename Right, typename Scalar>
+    struct has_member_gemm_permuted<Result, Left, Right, Scalar,
+        void_t<decltype(std::declval<Result&>().gemm(std::declval<const Left&>(),
+            std::declval<const Permutation&>(), std::declval<const Right&>(),
+            std::declval<const Permutation&>(), std::declval<Scalar>(),
+            std::declval<const math::GemmHelper&>()))> > :
+        public std::true_type
+    { };
+
+    /// Contract permuted tile arguments with the permuting gemm member of \c Result
+    template <typename Result, typename Left, typename Right, typename Scalar>
+    inline auto gemm_permuted(Result& result, const Left& left,
+        const Permutation& left_perm, const Right& right,
+        const Permutation& right_perm, const Scalar factor,
+        const math::GemmHelper& gemm_config, int) ->
+        decltype(result.gemm(left, left_perm, right, right_perm, factor, gemm_config))
+    { return result.gemm(left, left_perm, right, right_perm, factor, gemm_config); }
+
+    /// Permute tile arguments and then contract them
+    template <typename Result, typename Left, typename Right, typename Scalar>
+    inline Result& gemm_permuted(Result& result, const Left& left,
+        const Permutation& left_perm, const Right& right,
+        const Permutation& right_perm, const Scalar factor,
+        const math::GemmHelper& gemm_config, long)
+    {
+      using TiledArray::empty;
+      using TiledArray::gemm;
+      using TiledArray::permute;
+
+      auto contract = [&] (const auto& l, const auto& r) {
+        if(empty(result))
+          result = gemm(l, r, factor, gemm_config);
+        else
+          gemm(result, l, r, factor, gemm_config);
+      };
+
+      if(left_perm && right_perm)
+        contract(permute(left, left_perm), permute(right, right_perm));
+      else if(left_perm)
+        contract(permute(left, left_perm), right);
+      else if(right_perm)
+        contract(left, permute(right, right_perm));
+      else
+        contract(left, right);
+
+      return result;
+    }
+
+  } // namespace detail
+
+  /// Contract and scale permuted tile arguments to the result tile
+
+  /// This is equivalent to contracting <tt>permute(left, left_perm)</tt>
+  /// and <tt>permute(right, right_perm)</tt>, where an empty permutation is
+  /// the identity. Tiles that provide a permuting \c gemm member contract
+  /// the arguments without forming the permuted tiles, otherwise the
+  /// arguments are permuted first. An empty \c result is initialized with
+  /// the contraction.
+  /// \tparam Result The result tile type
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Scalar A scalar type
+  /// \param result The contracted result
+  /// \param left The left-hand argument to be contracted
+  /// \param left_perm The permutation applied to \c left
+  /// \param right The right-hand argument to be contracted
+  /// \param right_perm The permutation applied to \c right
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations of
+  /// the permuted arguments
+  /// \return A tile that is equal to
+  /// <tt>result = (permute(left, left_perm) * permute(right, right_perm)) * factor</tt>
+  template <typename Result, typename Left, typename Right, typename Scalar,
+      std::enable_if_t<TiledArray::detail::is_numeric_v<Scalar>>* = nullptr>
+  inline Result& gemm(Result& result, const Left& left,
+      const Permutation& left_perm, const Right& right,
+      const Permutation& right_perm, const Scalar factor,
+      const math::GemmHelper& gemm_config)
+  {
+    detail::gemm_permuted(result, left, left_perm, right, right_perm, factor,
+        gemm_config, 0);
+    return result;
+  }
+
   template <typename... T>
   using result_of_gemm_t = decltype(gemm(std::declval<T>()...));
 
@@ -164,7 +164,14 @@ namespace TiledArray {
     /// \return The constructed range object
     range_type make_tile_range(const size_type& i) const {
       TA_ASSERT(tiles_range().includes(i));
-      return make_tile_range(tiles_range().idx(i));
+      const size_type* MADNESS_RESTRICT const lower = range_.lobound_data();
+      const size_type* MADNESS_RESTRICT const extent = range_.extent_data();
+      size_type ord = i;
+      return make_tile_range_impl([=,&ord] (const int d) {
+        const size_type index_d = (ord % extent[d]) + lower[d];
+        ord /= extent[d];
+        return index_d;
+      });
     }
 
     /// Construct a range for the tile indexed by the given index.
@@ -189,21 +196,10 @@ namespace TiledArray {
     template <typename Index>
     typename std::enable_if<! std::is_integral<Index>::value, range_type>::type
     make_tile_range(const Index& index) const {
-      const auto rank = range_.rank();
-      TA_ASSERT(index.size() == rank);
+      TA_ASSERT(index.size() == range_.rank());
       TA_ASSERT(range_.includes(index));
-      typename range_type::index lower;
-      typename range_type::index upper;
-      lower.reserve(rank);
-      upper.reserve(rank);
-      unsigned d = 0;
-      for(const auto& index_d: index) {
-        lower.push_back(data()[d].tile(index_d).first);
-        upper.push_back(data()[d].tile(index_d).second);
-        ++d;
-      }
-
-      return range_type(lower, upper);
+      const auto* MADNESS_RESTRICT const index_data = detail::data(index);
+      return make_tile_range_impl([=] (const int d) { return index_data[d]; });
     }
 
     /// Construct a range for the tile indexed by the given index.
@@ -287,6 +283,35 @@ namespace TiledArray {
     }
 
    private:
+
+    /// Construct the range of a tile
+
+    /// \tparam TileIndex A function type that returns the tile index of a
+    /// dimension
+    /// \param tile_index The tile index of each dimension, which is called in
+    /// order of decreasing dimension
+    /// \return The constructed range object
+    template <typename TileIndex>
+    range_type make_tile_range_impl(TileIndex&& tile_index) const {
+      const unsigned int rank = range_.rank();
+
+      // Store the tile bounds on the stack for small ranks
+      size_type buffer[range_type::max_inline_rank << 1];
+      std::unique_ptr<size_type[]> heap(rank > range_type::max_inline_rank ?
+          new size_type[rank << 1] : nullptr);
+      size_type* const lower = (heap ? heap.get() : buffer);
+      size_type* const upper = lower + rank;
+
+      for(int d = int(rank) - 1; d >= 0; --d) {
+        const auto& bounds = ranges_[d].tile(tile_index(d));
+        lower[d] = bounds.first;
+        upper[d] = bounds.second;
+      }
+
+      return range_type(detail::SizeArray<const size_type>(lower, rank),
+          detail::SizeArray<const size_type>(upper, rank));
+    }
+
     range_type range_; ///< Stores information on tile indexing for the range.
     range_type elements_range_; ///< Stores information on element indexing for the range.
     Ranges ranges_; ///< Stores tile boundaries for each dimension.
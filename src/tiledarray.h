@@ -28,14 +28,20 @@
 // Array class
 #include <TiledArray/tensor.h>
 #include <TiledArray/tile.h>
+#include <TiledArray/tile_codec.h>
+#include <TiledArray/symm/tile_symmetry.h>
 
 // Array policy classes
 #include <TiledArray/policies/dense_policy.h>
 #include <TiledArray/policies/sparse_policy.h>
+#include <TiledArray/policies/compressed_sparse_policy.h>
 
 // Expression functionality
 #include <TiledArray/expressions/scal_expr.h>
 #include <TiledArray/expressions/tsr_expr.h>
+#include <TiledArray/expressions/expr_plan.h>
+#include <TiledArray/expressions/expr_batch.h>
+#include <TiledArray/expressions/product_plan.h>
 #include <TiledArray/conversions/sparse_to_dense.h>
 #include <TiledArray/conversions/dense_to_sparse.h>
 #include <TiledArray/conversions/to_new_tile_type.h>
@@ -47,11 +53,13 @@
 #include <TiledArray/special/diagonal_array.h>
 
 // Process maps
+#include <TiledArray/pmap/balanced_pmap.h>
 #include <TiledArray/pmap/hash_pmap.h>
 #include <TiledArray/pmap/replicated_pmap.h>
 
 // Utility functionality
 #include <TiledArray/conversions/eigen.h>
+#include <TiledArray/array_file.h>
 
 // Linear algebra
 #include <TiledArray/algebra/conjgrad.h>
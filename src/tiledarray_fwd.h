@@ -36,11 +36,15 @@ namespace TiledArray {
   // TiledArray Policy
   class DensePolicy;
   class SparsePolicy;
+  class CompressedSparsePolicy;
 
   // TiledArray Tensors
   template<typename, typename>
   class Tensor;
 
+  template <typename>
+  class pool_allocator;
+
   typedef Tensor<double, Eigen::aligned_allocator<double> > TensorD;
   typedef Tensor<int, Eigen::aligned_allocator<int> > TensorI;
   typedef Tensor<float, Eigen::aligned_allocator<float> > TensorF;
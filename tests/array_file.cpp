@@ -0,0 +1,164 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  array_file.cpp
+ *  Apr 16, 2018
+ *
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TiledArray/array_file.h"
+#include "TiledArray/pmap/hash_pmap.h"
+#include "array_fixture.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct ArrayFileFixture : public ArrayFixture {
+
+  ArrayFileFixture() {
+    std::strcpy(file_name, "tmp.XXXXXX");
+    if(world.rank() == 0)
+      mktemp(file_name);
+    world.gop.broadcast(file_name, sizeof(file_name), 0);
+  }
+
+  ~ArrayFileFixture() {
+    world.gop.fence();
+    if(world.rank() == 0)
+      std::remove(file_name);
+  }
+
+  /// Check that the local tiles of \c result match the tiles of \c array
+  template <typename Array, typename Op>
+  static void check_tiles(const Array& result, const Array& array,
+      const Op& array_ord)
+  {
+    for(auto it = result.begin(); it != result.end(); ++it) {
+      const auto tile = result.find(it.ordinal()).get();
+      const auto expected = array.find(array_ord(it.ordinal())).get();
+      BOOST_CHECK_EQUAL(tile.range().volume(), expected.range().volume());
+      BOOST_CHECK_EQUAL_COLLECTIONS(tile.begin(), tile.end(),
+          expected.begin(), expected.end());
+    }
+  }
+
+  char file_name[11];
+}; // ArrayFileFixture
+
+BOOST_FIXTURE_TEST_SUITE( array_file_suite, ArrayFileFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  write_array_file(a, file_name);
+
+  ArrayFile file(file_name);
+  BOOST_CHECK_EQUAL(file.trange(), a.trange());
+
+  // Read with the default process map
+  ArrayN aread = file.read<ArrayN>(world);
+  BOOST_CHECK_EQUAL(aread.trange(), a.trange());
+  check_tiles(aread, a, [] (const std::size_t ord) { return ord; });
+
+  // Read with a different process map
+  auto pmap = std::make_shared<detail::HashPmap>(world, a.size(), 42ul);
+  ArrayN ahash = file.read<ArrayN>(world, pmap);
+  BOOST_CHECK(ahash.pmap() == pmap);
+  check_tiles(ahash, a, [] (const std::size_t ord) { return ord; });
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  write_array_file(b, file_name);
+
+  ArrayFile file(file_name);
+  BOOST_CHECK(file.shape<SpArrayN::shape_type>() == b.shape());
+  SpArrayN bread = file.read<SpArrayN>(world);
+  BOOST_REQUIRE(bread.shape() == b.shape());
+  check_tiles(bread, b, [] (const std::size_t ord) { return ord; });
+
+  // Tiles can be viewed in place
+  for(std::size_t ord = 0ul; ord < b.size(); ++ord) {
+    BOOST_CHECK_EQUAL(file.is_zero(ord), b.is_zero(ord));
+    if(! b.is_zero(ord) && b.is_local(ord)) {
+      const auto view = file.tile<SpArrayN::element_type>(ord);
+      const auto expected = b.find(ord).get();
+      BOOST_CHECK_EQUAL(view.range(), expected.range());
+      for(std::size_t i = 0ul; i < expected.size(); ++i)
+        BOOST_CHECK_EQUAL(view[i], expected[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( block )
+{
+  write_array_file(b, file_name);
+
+  ArrayFile file(file_name);
+  std::vector<std::size_t> lower(GlobalFixture::dim, 1ul);
+  std::vector<std::size_t> upper(GlobalFixture::dim, 3ul);
+  SpArrayN block = file.read_block<SpArrayN>(world, lower, upper);
+
+  const auto& block_tiles = block.trange().tiles_range();
+  const auto& tiles = b.trange().tiles_range();
+  BOOST_CHECK_EQUAL(block_tiles.volume(), 1ul << GlobalFixture::dim);
+  BOOST_CHECK_EQUAL(block.trange().data()[0].elements_range().first, 0ul);
+
+  auto array_ord = [&] (const std::size_t ord) {
+    auto index = block_tiles.idx(ord);
+    for(std::size_t d = 0ul; d < index.size(); ++d)
+      index[d] += lower[d];
+    return tiles.ordinal(index);
+  };
+  for(std::size_t ord = 0ul; ord < block.size(); ++ord)
+    BOOST_CHECK_EQUAL(block.is_zero(ord), b.is_zero(array_ord(ord)));
+  check_tiles(block, b, array_ord);
+}
+
+BOOST_AUTO_TEST_CASE( truncated )
+{
+  write_array_file(a, file_name);
+
+  // Remove the end of the data of the last tile, which is followed by less
+  // than one alignment unit of padding
+  if(world.rank() == 0) {
+    struct stat st;
+    BOOST_REQUIRE_EQUAL(::stat(file_name, &st), 0);
+    BOOST_REQUIRE_EQUAL(::truncate(file_name,
+        st.st_size - off_t(detail::ArrayFileHeader::alignment)), 0);
+  }
+  world.gop.fence();
+
+  ArrayFile file(file_name);
+  BOOST_CHECK_NO_THROW(file.tile<ArrayN::element_type>(0ul));
+  BOOST_CHECK_THROW(file.tile<ArrayN::element_type>(a.size() - 1ul),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( write_error )
+{
+  // All processes throw when rank 0 cannot create the file
+  BOOST_CHECK_THROW(write_array_file(a, "no_such_directory/array"),
+      TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,224 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include "TiledArray/pmap/balanced_pmap.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+#include "sparse_shape_fixture.h"
+
+using namespace TiledArray;
+
+struct BalancedPmapFixture : public SparseShapeFixture {
+
+  BalancedPmapFixture() { }
+
+  /// Random tile costs, where about half of the tiles are zero
+  static std::vector<double> make_costs(const std::size_t tiles) {
+    std::vector<double> costs(tiles, 0.0);
+    GlobalFixture::world->srand(tiles);
+    for(std::size_t tile = 0ul; tile < tiles; ++tile)
+      if(GlobalFixture::world->rand() % 2)
+        costs[tile] = 1 + GlobalFixture::world->rand() % 100;
+    return costs;
+  }
+
+};
+
+
+// =============================================================================
+// BalancedPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( balanced_pmap_suite, BalancedPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    BOOST_REQUIRE_NO_THROW(TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, make_costs(tiles)));
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, make_costs(tiles));
+    BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+    BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+    BOOST_CHECK_EQUAL(pmap.size(), tiles);
+  }
+
+  // Construct a process map from a shape
+  BOOST_REQUIRE_NO_THROW(TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, tr, sparse_shape));
+  TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, tr, sparse_shape);
+  BOOST_CHECK_EQUAL(pmap.size(), tr.tiles_range().volume());
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  // Check various pmap sizes
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, make_costs(tiles));
+
+    for(std::size_t tile = 0; tile < tiles; ++tile) {
+      std::fill_n(p_owner, size, 0);
+      p_owner[rank] = pmap.owner(tile);
+      // check that the value is in range
+      BOOST_CHECK_LT(p_owner[rank], size);
+      GlobalFixture::world->gop.sum(p_owner, size);
+
+      // Make sure everyone agrees on who owns what.
+      for(std::size_t p = 0ul; p < size; ++p)
+        BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+    }
+  }
+
+  delete [] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE( local_size )
+{
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, make_costs(tiles));
+
+    std::size_t total_size = pmap.local_size();
+    GlobalFixture::world->gop.sum(total_size);
+
+    // Check that the total number of elements in all local groups is equal to
+    // the number of tiles in the map.
+    BOOST_CHECK_EQUAL(total_size, tiles);
+    BOOST_CHECK(pmap.empty() == (pmap.local_size() == 0ul));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, make_costs(tiles));
+
+    // Check that all local elements map to this rank
+    for(detail::BalancedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+    }
+
+    std::fill_n(tile_owners, tiles, 0);
+    for(detail::BalancedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      tile_owners[*it] += GlobalFixture::world->rank();
+    }
+
+    GlobalFixture::world->gop.sum(tile_owners, tiles);
+    for(std::size_t tile = 0; tile < tiles; ++tile) {
+      BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+    }
+
+  }
+}
+
+BOOST_AUTO_TEST_CASE( balance )
+{
+  const double procs = GlobalFixture::world->size();
+
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    const std::vector<double> costs = make_costs(tiles);
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, costs);
+
+    // Check that the loads of the processes are the costs of their tiles
+    std::vector<double> loads(GlobalFixture::world->size(), 0.0);
+    double total = 0.0;
+    for(std::size_t tile = 0ul; tile < tiles; ++tile) {
+      loads[pmap.owner(tile)] += costs[tile];
+      total += costs[tile];
+    }
+    for(std::size_t p = 0ul; p < loads.size(); ++p)
+      BOOST_CHECK_CLOSE(pmap.load(p) + 1.0, loads[p] + 1.0, 1.0e-8);
+    BOOST_CHECK_CLOSE(pmap.imbalance(), detail::load_imbalance(pmap, costs), 1.0e-8);
+
+    // Each process load differs from the average by one tile at most
+    const double max_cost = *std::max_element(costs.begin(), costs.end());
+    for(std::size_t p = 0ul; p < loads.size(); ++p)
+      BOOST_CHECK_LE(pmap.load(p), total / procs + max_cost + 1.0e-8);
+  }
+
+  // Check that a process map with zero costs is the same as a blocked map
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world,
+        std::vector<double>(tiles, 0.0));
+    TiledArray::detail::BlockedPmap blocked_pmap(* GlobalFixture::world, tiles);
+    BOOST_CHECK_EQUAL(pmap.imbalance(), 1.0);
+    for(std::size_t tile = 0ul; tile < tiles; ++tile)
+      BOOST_CHECK_EQUAL(pmap.owner(tile), blocked_pmap.owner(tile));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( default_pmap )
+{
+  // The cost of a tile of a sparse array is the volume of the non-zero tiles
+  std::vector<double> costs(tr.tiles_range().volume(), 0.0);
+  for(std::size_t tile = 0ul; tile < costs.size(); ++tile)
+    if(! sparse_shape.is_zero(tile))
+      costs[tile] = double(tr.make_tile_range(tile).volume());
+  const double total = std::accumulate(costs.begin(), costs.end(), 0.0);
+  const double max_cost = *std::max_element(costs.begin(), costs.end());
+  BOOST_REQUIRE_GT(total, 0.0);
+
+  // Check that sparse arrays are balanced by default, i.e. the cost of each
+  // process differs from the average by the cost of one tile at most
+  DistArray<Tensor<int>, SparsePolicy> array(* GlobalFixture::world, tr, sparse_shape);
+  const double procs = GlobalFixture::world->size();
+  const double imbalance = detail::load_imbalance(*array.pmap(), costs);
+  BOOST_CHECK_LE(imbalance, 1.0 + procs * max_cost / total + 1.0e-12);
+}
+
+BOOST_AUTO_TEST_CASE( store_load )
+{
+  World& world = * GlobalFixture::world;
+  DistArray<Tensor<int>, SparsePolicy> array(world, tr, sparse_shape);
+  array.init_elements([] (const Range::index& i) {
+    return int(std::accumulate(i.begin(), i.end(), 0ul));
+  });
+
+  // Each process is an I/O node, which reads back the tiles that it wrote,
+  // so the loaded array must have the default process map of the shape
+  const int nio = world.size();
+  char archive_file_name[] = "tmp.XXXXXX";
+  if(world.rank() == 0)
+    mktemp(archive_file_name);
+  world.gop.broadcast(archive_file_name, sizeof(archive_file_name), 0);
+  madness::save(array, archive_file_name, nio);
+
+  DistArray<Tensor<int>, SparsePolicy> aread(world, tr, sparse_shape);
+  BOOST_REQUIRE_NO_THROW(madness::load(aread, archive_file_name, nio));
+  BOOST_CHECK(std::dynamic_pointer_cast<detail::BalancedPmap>(aread.pmap()));
+  BOOST_REQUIRE(aread.shape() == array.shape());
+  for(std::size_t tile = 0ul; tile < tr.tiles_range().volume(); ++tile)
+    BOOST_CHECK_EQUAL(aread.owner(tile), array.owner(tile));
+  for(auto it = aread.begin(); it != aread.end(); ++it) {
+    const Tensor<int> tile = it->get();
+    const Tensor<int> expected = array.find(it.ordinal()).get();
+    BOOST_CHECK_EQUAL_COLLECTIONS(tile.begin(), tile.end(),
+        expected.begin(), expected.end());
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
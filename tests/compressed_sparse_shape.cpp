@@ -0,0 +1,211 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2019  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  compressed_sparse_shape.cpp
+ *  Oct 17, 2019
+ *
+ */
+
+#include "TiledArray/compressed_sparse_shape.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "sparse_shape_fixture.h"
+
+using namespace TiledArray;
+
+struct CompressedSparseShapeFixture : public SparseShapeFixture {
+
+  CompressedSparseShapeFixture() :
+    compressed_shape(sparse_shape, tr),
+    compressed_left(left, tr),
+    compressed_right(right, tr)
+  { }
+
+  ~CompressedSparseShapeFixture() { }
+
+  /// Check that a compressed shape holds the same norms as a sparse shape
+  static void check(const CompressedSparseShape<float>& result,
+      const SparseShape<float>& expected, const float tol)
+  {
+    BOOST_REQUIRE(result.validate(expected.data().range()));
+    for(std::size_t i = 0ul; i < expected.data().size(); ++i) {
+      BOOST_CHECK_CLOSE(result[i], expected[i], tol);
+      BOOST_CHECK_EQUAL(result.is_zero(i), expected.is_zero(i));
+    }
+    BOOST_CHECK_CLOSE(result.sparsity(), expected.sparsity(), tol);
+  }
+
+  /// Fill the non-zero tiles of an array with the same data for any policy
+  template <typename Policy>
+  static void fill(DistArray<TensorD, Policy>& array) {
+    for(auto index : *array.pmap()) {
+      if(array.is_zero(index))
+        continue;
+      TensorD tile(array.trange().make_tile_range(index));
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        tile[i] = double((index + i) % 7ul + 1ul);
+      array.set(index, tile);
+    }
+  }
+
+  /// Check that a compressed array holds the same tiles as a sparse array
+  static void check(const DistArray<TensorD, CompressedSparsePolicy>& result,
+      const TSpArrayD& expected)
+  {
+    BOOST_REQUIRE(result.trange() == expected.trange());
+    const TArrayD result_dense = to_dense(result);
+    const TArrayD expected_dense = to_dense(expected);
+    for(auto index : *expected_dense.pmap()) {
+      BOOST_CHECK_EQUAL(result.is_zero(index), expected.is_zero(index));
+      const TensorD result_tile = result_dense.find(index).get();
+      const TensorD expected_tile = expected_dense.find(index).get();
+      for(std::size_t i = 0ul; i < expected_tile.size(); ++i)
+        BOOST_CHECK_CLOSE(result_tile[i], expected_tile[i], 1.0e-10);
+    }
+  }
+
+  CompressedSparseShape<float> compressed_shape;
+  CompressedSparseShape<float> compressed_left;
+  CompressedSparseShape<float> compressed_right;
+}; // CompressedSparseShapeFixture
+
+BOOST_FIXTURE_TEST_SUITE( compressed_sparse_shape_suite, CompressedSparseShapeFixture )
+
+BOOST_AUTO_TEST_CASE( default_constructor )
+{
+  BOOST_CHECK_NO_THROW(CompressedSparseShape<float> x);
+  CompressedSparseShape<float> x;
+  BOOST_CHECK(x.empty());
+  BOOST_CHECK(! x.is_dense());
+  BOOST_CHECK(! x.validate(tr.tiles_range()));
+}
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  Tensor<float> norms = make_norm_tensor(tr, 0.3, 42);
+  SparseShape<float> expected(norms, tr);
+  CompressedSparseShape<float> result(norms, tr);
+
+  check(result, expected, tolerance);
+  BOOST_CHECK_EQUAL(result.nnz(),
+      std::size_t((1.0f - expected.sparsity()) * norms.size() + 0.5f));
+  BOOST_CHECK_EQUAL(result.data(), expected.data());
+}
+
+BOOST_AUTO_TEST_CASE( comm_constructor )
+{
+  Tensor<float> norms = make_norm_tensor(tr, 0.3, 42);
+  SparseShape<float> expected(*GlobalFixture::world, norms, tr);
+  CompressedSparseShape<float> result(*GlobalFixture::world, norms, tr);
+
+  check(result, expected, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( permute )
+{
+  check(compressed_shape.perm(perm), sparse_shape.perm(perm), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( block )
+{
+  std::vector<std::size_t> lower(tr.tiles_range().rank(), 1ul);
+  std::vector<std::size_t> upper(tr.tiles_range().upbound().begin(),
+      tr.tiles_range().upbound().end());
+
+  check(compressed_shape.block(lower, upper),
+      sparse_shape.block(lower, upper), tolerance);
+  check(compressed_shape.block(lower, upper, -2.1, perm),
+      sparse_shape.block(lower, upper, -2.1, perm), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( scale )
+{
+  check(compressed_shape.scale(-4.1), sparse_shape.scale(-4.1), tolerance);
+  check(compressed_shape.scale(-4.1, perm), sparse_shape.scale(-4.1, perm),
+      tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( add )
+{
+  check(compressed_left.add(compressed_right), left.add(right), tolerance);
+  check(compressed_left.add(compressed_right, -2.2, perm),
+      left.add(right, -2.2, perm), tolerance);
+  check(compressed_left.add(3.1f), left.add(3.1f), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( mult )
+{
+  check(compressed_left.mult(compressed_right), left.mult(right), tolerance);
+  check(compressed_left.mult(compressed_right, -2.2, perm),
+      left.mult(right, -2.2, perm), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( mask )
+{
+  check(compressed_left.mask(compressed_right), left.mask(right), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+
+  check(compressed_left.gemm(compressed_right, -7.2, gemm_helper),
+      left.gemm(right, -7.2, gemm_helper), 0.01);
+}
+
+BOOST_AUTO_TEST_CASE( policy )
+{
+  typedef DistArray<TensorD, CompressedSparsePolicy> TCSpArrayD;
+  World& world = *GlobalFixture::world;
+
+  // Construct a sparse and a compressed array that hold the same tiles
+  TSpArrayD s(world, tr, sparse_shape);
+  TCSpArrayD c(world, tr, compressed_shape);
+  fill(s);
+  fill(c);
+  world.gop.fence();
+  check(c, s);
+
+  // Check that expressions use the compressed shape
+  TSpArrayD s_sum;
+  TCSpArrayD c_sum;
+  BOOST_REQUIRE_NO_THROW(s_sum("a,b,c") = 2 * s("a,b,c") - s("c,b,a"));
+  BOOST_REQUIRE_NO_THROW(c_sum("a,b,c") = 2 * c("a,b,c") - c("c,b,a"));
+  check(c_sum, s_sum);
+
+  TSpArrayD s_prod;
+  TCSpArrayD c_prod;
+  BOOST_REQUIRE_NO_THROW(s_prod("a,b") = s("a,i,j") * s("b,i,j"));
+  BOOST_REQUIRE_NO_THROW(c_prod("a,b") = c("a,i,j") * c("b,i,j"));
+  check(c_prod, s_prod);
+
+  // Check the array conversions
+  auto scale = [] (TensorD& result, const TensorD& arg) -> float {
+    result = arg.scale(2.0);
+    return result.norm();
+  };
+  check(foreach(c, scale), foreach(s, scale));
+
+  BOOST_REQUIRE_NO_THROW(c.truncate());
+  s.truncate();
+  check(c, s);
+
+  check(to_sparse<CompressedSparsePolicy>(to_dense(c)), to_sparse(to_dense(s)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -287,6 +287,50 @@ BOOST_AUTO_TEST_CASE( make_replicated )
   }
 }
 
+BOOST_AUTO_TEST_CASE( out_of_core )
+{
+  ArrayN c(world, tr);
+  c.enable_out_of_core(".", 1ul); // keep only the newest tile in memory
+  std::size_t local_tiles = 0ul;
+  for(ArrayN::range_type::const_iterator it = c.range().begin(); it != c.range().end(); ++it)
+    if(c.is_local(*it)) {
+      c.set(*it, world.rank() + 1);
+      ++local_tiles;
+    }
+  world.gop.fence();
+
+  OutOfCoreStatistics stats = c.out_of_core_statistics();
+  BOOST_CHECK_GT(stats.bytes_written, 0ul);
+  BOOST_CHECK_EQUAL(stats.bytes_read, 0ul);
+
+  // Tiles are read back from the file, with prefetch hints one tile ahead
+  for(auto it = c.begin(); it != c.end(); ++it) {
+    auto next = it;
+    if(++next != c.end())
+      c.prefetch(next.ordinal());
+    const ArrayN::value_type tile = c.find(it.ordinal()).get();
+    BOOST_CHECK_EQUAL(tile.range(), c.trange().make_tile_range(it.ordinal()));
+    for(auto value : tile)
+      BOOST_CHECK_EQUAL(value, world.rank() + 1);
+  }
+
+  // Each request is counted once, whether or not its tile was prefetched
+  stats = c.out_of_core_statistics();
+  BOOST_CHECK_EQUAL(stats.hits + stats.misses, local_tiles);
+  if(local_tiles > 1ul)
+    BOOST_CHECK_GT(stats.bytes_read, 0ul);
+
+  // Out-of-core arrays can be used in expressions
+  std::string vars = "i0";
+  for(unsigned int i = 1u; i < GlobalFixture::dim; ++i)
+    vars += ",i" + std::to_string(i);
+  ArrayN d;
+  d(vars) = 2 * c(vars);
+  for(auto it = d.begin(); it != d.end(); ++it)
+    for(auto value : it->get())
+      BOOST_CHECK_EQUAL(value, 2 * (world.rank() + 1));
+}
+
 BOOST_AUTO_TEST_CASE( serialization_by_tile )
 {
   decltype(a) acopy(a.world(), a.trange(), a.shape());
@@ -414,5 +458,34 @@ BOOST_AUTO_TEST_CASE( parallel_sparse_serialization )
   BOOST_CHECK_EQUAL_COLLECTIONS(bread.begin(), bread.end(), b.begin(), b.end());
 }
 
+BOOST_AUTO_TEST_CASE( parallel_serialization_statistics )
+{
+  // use an I/O node per rank
+  const int nio = world.size();
+  char archive_file_name[] = "tmp.XXXXXX";
+  mktemp(archive_file_name);
+
+  std::size_t nonzero_tiles = 0ul;
+  for(std::size_t i = 0ul; i < b.size(); ++i)
+    if(! b.is_zero(i))
+      ++nonzero_tiles;
+
+  const IOStatistics store_stats =
+      madness::save(b, archive_file_name, nio).reduce(world);
+  BOOST_CHECK_EQUAL(store_stats.tiles, nonzero_tiles);
+  BOOST_CHECK_GT(store_stats.bytes, 0ul);
+  BOOST_CHECK_GE(store_stats.bandwidth(), 0.0);
+
+  decltype(b) bread(world, b.trange(), b.shape());
+  const IOStatistics load_stats =
+      madness::load(bread, archive_file_name, nio).reduce(world);
+  BOOST_CHECK_EQUAL(load_stats.tiles, store_stats.tiles);
+  BOOST_CHECK_EQUAL(load_stats.bytes, store_stats.bytes);
+
+  BOOST_CHECK_EQUAL(bread.trange(), b.trange());
+  BOOST_REQUIRE(bread.shape() == b.shape());
+  BOOST_CHECK_EQUAL_COLLECTIONS(bread.begin(), bread.end(), b.begin(), b.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -362,6 +362,104 @@ BOOST_AUTO_TEST_CASE( perm_eval )
 
 }
 
+BOOST_AUTO_TEST_CASE( memory_budget_eval )
+{
+  // Limit the broadcast buffers so only one SUMMA iteration can be in flight
+  const std::size_t budget = summa_memory_budget();
+  set_summa_memory_budget(1ul);
+  reset_summa_stats();
+
+  auto contract = make_contract_eval(left_arg, right_arg,
+      left_arg.world(), DenseShape(), pmap, Permutation(), make_contract(2u,
+      left_arg.trange().tiles_range().rank(), right_arg.trange().tiles_range().rank()));
+  using dist_eval_type = decltype(contract);
+
+  // Check evaluation
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+
+  // Compute the reference contraction
+  const matrix_type l = copy_to_matrix(left, 1),
+                    r = copy_to_matrix(right, GlobalFixture::dim - 1);
+  const matrix_type reference = l * r;
+
+  // Check that the throttled contraction is correct
+  for(auto index : *contract.pmap()) {
+    dist_eval_type::eval_type eval_tile;
+    BOOST_REQUIRE_NO_THROW(eval_tile = contract.get(index).get());
+    BOOST_CHECK_EQUAL(eval_tile.range(), contract.trange().make_tile_range(index));
+    BOOST_CHECK(eigen_map(eval_tile) == reference.block(eval_tile.range().lobound(0),
+        eval_tile.range().lobound(1), eval_tile.range().extent(0), eval_tile.range().extent(1)));
+  }
+  GlobalFixture::world->gop.fence();
+
+  // Check the depth and buffer statistics
+  const SummaStats stats = summa_stats();
+  BOOST_CHECK_EQUAL(stats.memory_budget, 1ul);
+  if(stats.steps > 0ul) {
+    BOOST_CHECK_EQUAL(stats.initial_depth, 1ul);
+    BOOST_CHECK_EQUAL(stats.max_depth, 1ul);
+    BOOST_CHECK_EQUAL(stats.depth, 1ul);
+    BOOST_CHECK_GT(stats.peak_bytes, 0ul);
+    BOOST_CHECK_GE(stats.node_peak_bytes, stats.peak_bytes);
+  }
+
+  set_summa_memory_budget(budget);
+}
+
+BOOST_AUTO_TEST_CASE( memory_budget_depth )
+{
+  // Compute the broadcast buffer size of one SUMMA iteration of this process
+  const std::size_t tile_bytes =
+      (tr.elements_range().volume() / tr.tiles_range().volume()) * sizeof(int);
+  const std::size_t iteration_bytes =
+      tile_bytes * proc_grid.local_rows() + tile_bytes * proc_grid.local_cols();
+
+  // Limit the broadcast buffers so that two SUMMA iterations can be in flight
+  const std::size_t budget = summa_memory_budget();
+  set_summa_memory_budget(2ul * iteration_bytes);
+  reset_summa_stats();
+
+  auto contract = make_contract_eval(left_arg, right_arg,
+      left_arg.world(), DenseShape(), pmap, Permutation(), make_contract(2u,
+      left_arg.trange().tiles_range().rank(), right_arg.trange().tiles_range().rank()));
+  using dist_eval_type = decltype(contract);
+
+  // Check evaluation
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+
+  // Compute the reference contraction
+  const matrix_type l = copy_to_matrix(left, 1),
+                    r = copy_to_matrix(right, GlobalFixture::dim - 1);
+  const matrix_type reference = l * r;
+
+  // Check that the throttled contraction is correct
+  for(auto index : *contract.pmap()) {
+    dist_eval_type::eval_type eval_tile;
+    BOOST_REQUIRE_NO_THROW(eval_tile = contract.get(index).get());
+    BOOST_CHECK(eigen_map(eval_tile) == reference.block(eval_tile.range().lobound(0),
+        eval_tile.range().lobound(1), eval_tile.range().extent(0), eval_tile.range().extent(1)));
+  }
+  GlobalFixture::world->gop.fence();
+
+  // Check that the initial depth is the optimal depth bounded by the budget
+  const SummaStats stats = summa_stats();
+  BOOST_CHECK_EQUAL(stats.memory_budget, 2ul * iteration_bytes);
+  if(proc_grid.local_size() > 0ul) {
+    const std::size_t k = tr.tiles_range().volume() / tr.tiles_range().extent(0);
+    const std::size_t optimal_depth = std::min(k, std::max(std::size_t(2),
+        std::min(proc_grid.proc_rows(), proc_grid.proc_cols())));
+    BOOST_CHECK_EQUAL(stats.initial_depth, std::min(optimal_depth, std::size_t(2)));
+    BOOST_CHECK_EQUAL(stats.steps, k);
+    BOOST_CHECK_GE(stats.min_depth, 1ul);
+    BOOST_CHECK_LE(stats.min_depth, stats.initial_depth);
+    BOOST_CHECK_GE(stats.max_depth, stats.initial_depth);
+  }
+
+  set_summa_memory_budget(budget);
+}
+
 BOOST_AUTO_TEST_CASE( sparse_eval )
 {
   auto do_sparse_eval = [&](bool force_shape) -> void {
@@ -121,5 +121,112 @@ BOOST_AUTO_TEST_CASE( array_operator )
 #endif // TA_EXCEPTION_ERROR
 }
 
+BOOST_AUTO_TEST_CASE( remote_cache )
+{
+  for(std::size_t i = 0; i < t.max_size(); ++i)
+    if(t.is_local(i))
+      t.set(i, i);
+  world.gop.fence();
+
+  t.enable_remote_cache(1024ul);
+  BOOST_CHECK_EQUAL(t.remote_cache_max_bytes(), 1024ul);
+
+  // Fetch every remote element twice; the second request must be a hit.
+  std::size_t nremote = 0ul;
+  for(std::size_t i = 0; i < t.max_size(); ++i) {
+    if(t.is_local(i))
+      continue;
+    ++nremote;
+    Storage::future first = t.get(i);
+    Storage::future second = t.get(i);
+    BOOST_CHECK_EQUAL(first.get(), int(i));
+    BOOST_CHECK_EQUAL(second.get(), int(i));
+  }
+
+  BOOST_CHECK_EQUAL(t.remote_cache_misses(), nremote);
+  BOOST_CHECK_EQUAL(t.remote_cache_hits(), nremote);
+  BOOST_CHECK_EQUAL(t.remote_cache_bytes(), nremote * sizeof(int));
+
+  // Clearing the cache keeps it enabled
+  t.clear_remote_cache();
+  BOOST_CHECK_EQUAL(t.remote_cache_bytes(), 0ul);
+  BOOST_CHECK_EQUAL(t.remote_cache_max_bytes(), 1024ul);
+  for(std::size_t i = 0; i < t.max_size(); ++i)
+    if(! t.is_local(i))
+      BOOST_CHECK_EQUAL(t.get(i).get(), int(i));
+  BOOST_CHECK_EQUAL(t.remote_cache_misses(), 2ul * nremote);
+  BOOST_CHECK_EQUAL(t.remote_cache_bytes(), nremote * sizeof(int));
+
+  // The cache is discarded at a fence
+  world.gop.fence();
+  BOOST_CHECK_EQUAL(t.remote_cache_bytes(), 0ul);
+  BOOST_CHECK_EQUAL(t.remote_cache_max_bytes(), 1024ul);
+
+  t.disable_remote_cache();
+  BOOST_CHECK_EQUAL(t.remote_cache_max_bytes(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( remote_cache_fence )
+{
+  for(std::size_t i = 0; i < t.max_size(); ++i)
+    if(t.is_local(i))
+      t.set(i, i);
+  world.gop.fence();
+
+  // Cache every remote element
+  t.enable_remote_cache(1024ul);
+  for(std::size_t i = 0; i < t.max_size(); ++i)
+    if(! t.is_local(i))
+      BOOST_CHECK_EQUAL(t.get(i).get(), int(i));
+  world.gop.fence();
+
+  // Modify the local elements in place on their owner
+  for(std::size_t i = 0; i < t.max_size(); ++i) {
+    if(t.is_local(i)) {
+      Storage::future value = t.get(i);
+      value.get() += 100;
+    }
+  }
+  world.gop.fence();
+
+  // Other processes must read the modified elements, not the cached ones
+  for(std::size_t i = 0; i < t.max_size(); ++i)
+    BOOST_CHECK_EQUAL(t.get(i).get(), int(i) + 100);
+
+  t.disable_remote_cache();
+}
+
+BOOST_AUTO_TEST_CASE( remote_cache_eviction )
+{
+  typedef detail::RemoteCache<int> Cache;
+  std::shared_ptr<Cache> cache = std::make_shared<Cache>(2ul * sizeof(int));
+
+  // Insert three elements into a cache that holds two
+  for(std::size_t i = 0ul; i < 3ul; ++i) {
+    Cache::future value;
+    BOOST_CHECK(! cache->find_or_insert(i, value));
+    Cache::track(cache, i, value);
+    BOOST_CHECK_EQUAL(cache->bytes(), 0ul); // in flight
+    value.set(int(i));
+    if(i == 0ul) {
+      // A second request shares the future of the first
+      Cache::future shared;
+      BOOST_CHECK(cache->find_or_insert(i, shared));
+      BOOST_CHECK_EQUAL(shared.get(), 0);
+    }
+  }
+
+  // The least recently used element was evicted
+  BOOST_CHECK_EQUAL(cache->size(), 2ul);
+  BOOST_CHECK_EQUAL(cache->bytes(), 2ul * sizeof(int));
+  Cache::future value;
+  BOOST_CHECK(! cache->find_or_insert(0ul, value));
+  BOOST_CHECK(cache->find_or_insert(2ul, value));
+  BOOST_CHECK_EQUAL(value.get(), 2);
+
+  // Invalidated elements are removed
+  cache->invalidate(2ul);
+  BOOST_CHECK(! cache->find_or_insert(2ul, value));
+}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -144,6 +144,20 @@ struct ExpressionsFixture : public TiledRangeFixture {
     return tile;
   }
 
+  /// Check that an array is equal to a reference array, tile by tile
+  static void check_equal(const TArray& x, const TArray& x_ref) {
+    BOOST_CHECK_EQUAL(x.trange(), x_ref.trange());
+    for (std::size_t i = 0ul; i < x.size(); ++i) {
+      BOOST_CHECK_EQUAL(x.is_zero(i), x_ref.is_zero(i));
+      if (!x.is_zero(i) && x.is_local(i)) {
+        auto tile = x.find(i).get();
+        auto tile_ref = x_ref.find(i).get();
+        for (std::size_t j = 0ul; j < tile.size(); ++j)
+          BOOST_CHECK_EQUAL(tile[j], tile_ref[j]);
+      }
+    }
+  }
+
   static void rand_fill_matrix_and_array(Matrix& matrix, TArray& array,
                                          int seed = 42) {
     TA_ASSERT(std::size_t(matrix.size()) ==
@@ -2527,6 +2527,163 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_non_uniform2, F, Fixtures, F) {
   }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_layers, F, Fixtures, F) {
+  // Construct the tiled range
+  std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
+  std::array<std::size_t, 2> tiling2 = {{0, 40}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  TiledRange1 tr1_2(tiling2.begin(), tiling2.end());
+  std::array<TiledRange1, 4> tiling4 = {{tr1_1, tr1_2, tr1_1, tr1_1}};
+  TiledRange trange(tiling4.begin(), tiling4.end());
+
+  const std::size_t m = 5;
+  const std::size_t k = 40 * 5 * 5;
+  const std::size_t n = 5;
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(m, k);
+  typename F::Matrix right_ref(n, k);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = 5 * left_ref * right_ref.transpose();
+
+  // Compute the result with an explicit number of process grid layers; the
+  // number of layers is limited by the number of processes.
+  for (unsigned int layers = 1u; layers <= 3u; ++layers) {
+    typename F::TArray result;
+    BOOST_REQUIRE_NO_THROW(
+        result("x,y") = (5 * left("x,i,j,k") * right("y,i,j,k"))
+                            .set_contraction_layers(layers));
+
+    // Check that the layers are limited by the number of processes, and that
+    // the result tiles are owned by the processes of the first layer
+    const TiledArray::detail::ProcGrid grid(*GlobalFixture::world, 5u, 5u, m,
+                                            n, layers);
+    const std::size_t nprocs = GlobalFixture::world->size();
+    BOOST_CHECK_EQUAL(grid.layers(), std::min<std::size_t>(layers, nprocs));
+    BOOST_CHECK_LE(grid.layers() * grid.layer_stride(), nprocs);
+    const auto grid_pmap = grid.make_pmap();
+    for (std::size_t i = 0ul; i < result.size(); ++i) {
+      BOOST_CHECK_EQUAL(std::size_t(result.owner(i)), grid_pmap->owner(i));
+      BOOST_CHECK_LT(std::size_t(result.owner(i)), grid.layer_stride());
+    }
+
+    // Check the result
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      typename F::TArray::value_type tile = *it;
+      for (Range::const_iterator rit = tile.range().begin();
+           rit != tile.range().end(); ++rit) {
+        const std::size_t elem_index = result.elements_range().ordinal(*rit);
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+      }
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_layers_outer, F, Fixtures, F) {
+  // Construct a tiled range where the result has more tiles than both
+  // arguments combined, so the layer reduction keys must not overlap the
+  // result tile keys.
+  std::array<std::size_t, 21> tiling1;
+  for (std::size_t i = 0ul; i < tiling1.size(); ++i) tiling1[i] = i;
+  std::array<std::size_t, 4> tiling2 = {{0, 4, 8, 12}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  TiledRange1 tr1_2(tiling2.begin(), tiling2.end());
+  std::array<TiledRange1, 2> tiling = {{tr1_1, tr1_2}};
+  TiledRange trange(tiling.begin(), tiling.end());
+
+  const std::size_t m = 20;
+  const std::size_t k = 12;
+  const std::size_t n = 20;
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(m, k);
+  typename F::Matrix right_ref(n, k);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = 5 * left_ref * right_ref.transpose();
+
+  for (unsigned int layers = 1u; layers <= 3u; ++layers) {
+    typename F::TArray result;
+    BOOST_REQUIRE_NO_THROW(result("x,y") = (5 * left("x,i") * right("y,i"))
+                                               .set_contraction_layers(layers));
+    BOOST_CHECK_GT(result.size(), left.size() + right.size());
+
+    // Check the result
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      typename F::TArray::value_type tile = *it;
+      for (Range::const_iterator rit = tile.range().begin();
+           rit != tile.range().end(); ++rit) {
+        const std::size_t elem_index = result.elements_range().ordinal(*rit);
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+      }
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_batch_size, F, Fixtures, F) {
+  // Construct the tiled range
+  std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
+  std::array<std::size_t, 2> tiling2 = {{0, 40}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  TiledRange1 tr1_2(tiling2.begin(), tiling2.end());
+  std::array<TiledRange1, 4> tiling4 = {{tr1_1, tr1_2, tr1_1, tr1_1}};
+  TiledRange trange(tiling4.begin(), tiling4.end());
+
+  const std::size_t m = 5;
+  const std::size_t k = 40 * 5 * 5;
+  const std::size_t n = 5;
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(m, k);
+  typename F::Matrix right_ref(n, k);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = 5 * left_ref * right_ref.transpose();
+
+  // Compute the result with and without batched tile contractions
+  for (unsigned int batch_size : {1u, 2u, 16u}) {
+    typename F::TArray result;
+    BOOST_REQUIRE_NO_THROW(
+        result("x,y") = (5 * left("x,i,j,k") * right("y,i,j,k"))
+                            .set_contraction_batch_size(batch_size));
+
+    // Check the result
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      typename F::TArray::value_type tile = *it;
+      for (Range::const_iterator rit = tile.range().begin();
+           rit != tile.range().end(); ++rit) {
+        const std::size_t elem_index = result.elements_range().ordinal(*rit);
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+      }
+    }
+  }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_plus_reduce, F, Fixtures, F) {
   // Construct the tiled range
   std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
@@ -2876,6 +3033,220 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(inner_product, F, Fixtures, F) {
   BOOST_CHECK_EQUAL(result, expected);
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(plan, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& c = F::c;
+  auto& w = F::w;
+
+  // Compile the expressions once
+  auto plan_c = make_plan(c("a,b,c"), 2 * (a("c,b,a") + b("a,b,c")));
+  auto plan_w = make_plan(w("i,j"), a("i,b,c") * (3 * b("j,c,b")));
+
+  typename F::TArray c_ref, w_ref;
+  for (int iter = 0; iter < 3; ++iter) {
+    // Replace the arguments with new data, and new shapes for sparse arrays
+    if (iter > 0) {
+      a = F::make_array(F::tr);
+      b = F::make_array(F::tr);
+      F::random_fill(a);
+      F::random_fill(b);
+      GlobalFixture::world->gop.fence();
+    }
+
+    BOOST_REQUIRE_NO_THROW(plan_c.eval());
+    BOOST_REQUIRE_NO_THROW(plan_w.eval());
+    c_ref("a,b,c") = 2 * (a("c,b,a") + b("a,b,c"));
+    w_ref("i,j") = a("i,b,c") * (3 * b("j,c,b"));
+    BOOST_CHECK(w.pmap() == plan_w.pmap());
+
+    // Check the results
+    F::check_equal(c, c_ref);
+    F::check_equal(w, w_ref);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(assign_async, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& c = F::c;
+  auto& w = F::w;
+
+  // Start independent assignments, then wait for them
+  Future<bool> c_done, w_done;
+  BOOST_REQUIRE_NO_THROW(c_done =
+      c("a,b,c").assign_async(2 * (a("c,b,a") + b("a,b,c"))));
+  BOOST_REQUIRE_NO_THROW(w_done =
+      w("i,j").assign_async(a("i,b,c") * b("j,b,c")));
+  BOOST_CHECK(c.is_initialized());
+  BOOST_CHECK(w.is_initialized());
+  BOOST_CHECK(c_done.get());
+  BOOST_CHECK(w_done.get());
+
+  typename F::TArray c_ref, w_ref;
+  c_ref("a,b,c") = 2 * (a("c,b,a") + b("a,b,c"));
+  w_ref("i,j") = a("i,b,c") * b("j,b,c");
+
+  F::check_equal(c, c_ref);
+  F::check_equal(w, w_ref);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(batch, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& c = F::c;
+  auto& w = F::w;
+  typename F::TArray x;
+
+  // Compute the reference results in program order
+  typename F::TArray a_ref = a, b_ref = b, c_ref, w_ref, x_ref;
+  c_ref("a,b,c") = a_ref("c,b,a") + b_ref("a,b,c");
+  w_ref("i,j") = a_ref("i,b,c") * b_ref("j,b,c");
+  x_ref("a,b,c") = 2 * c_ref("a,b,c");
+  a_ref("a,b,c") = b_ref("c,b,a");
+
+  expressions::ExprBatch batch;
+  batch.add(c("a,b,c"), a("c,b,a") + b("a,b,c"));
+  batch.add(w("i,j"), a("i,b,c") * b("j,b,c"));
+  batch.add(x("a,b,c"), 2 * c("a,b,c"));  // reads c
+  batch.add(a("a,b,c"), b("c,b,a"));      // overwrites a, which is read above
+  BOOST_CHECK_EQUAL(batch.size(), 4ul);
+
+  const std::vector<std::size_t> levels = batch.levels();
+  const std::vector<std::size_t> levels_ref = {0ul, 0ul, 1ul, 1ul};
+  BOOST_CHECK_EQUAL_COLLECTIONS(levels.begin(), levels.end(),
+                                levels_ref.begin(), levels_ref.end());
+
+  BOOST_CHECK_EQUAL(batch.eval(), 4ul);
+  BOOST_CHECK(batch.empty());
+
+  F::check_equal(c, c_ref);
+  F::check_equal(w, w_ref);
+  F::check_equal(x, x_ref);
+  F::check_equal(a, a_ref);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(product_plan, F, Fixtures, F) {
+  auto& u = F::u;
+  typename F::TArray s, x, y, su, x_ref, y_ref;
+
+  // A square matrix with the tiling of u
+  TiledRange trange2 = F::trange2;
+  auto w = F::make_array(trange2);
+  F::random_fill(w);
+  GlobalFixture::world->gop.fence();
+  s("i,j") = w("i,k") * w("j,k");
+
+  // s * (s * u) is cheaper than (s * s) * u
+  auto plan = expressions::make_product_plan(x("i"),
+                                             s("i,j") * s("j,k") * u("k"));
+  BOOST_CHECK(plan.is_valid());
+  BOOST_CHECK(plan.is_beneficial());
+  BOOST_CHECK_LT(plan.cost(), plan.default_cost());
+  BOOST_CHECK_EQUAL(plan.intermediates(), 1ul);
+
+  BOOST_REQUIRE_NO_THROW(x("i") = s("i,j") * s("j,k") * u("k"));
+  su("j") = s("j,k") * u("k");
+  x_ref("i") = s("i,j") * su("j");
+  F::check_equal(x, x_ref);
+
+  // A product shared by two terms is evaluated once
+  auto cse_plan = expressions::make_product_plan(
+      y("i,j"), s("i,k") * s("k,j") + 2 * (s("i,k") * s("k,j")));
+  BOOST_CHECK(cse_plan.is_beneficial());
+  BOOST_CHECK_EQUAL(cse_plan.reused(), 1ul);
+
+  BOOST_REQUIRE_NO_THROW(y("i,j") =
+                             s("i,k") * s("k,j") + 2 * (s("i,k") * s("k,j")));
+  y_ref("i,j") = 3 * (s("i,k") * s("k,j"));
+  F::check_equal(y, y_ref);
+
+  // The result may be an argument
+  x_ref("i") = x_ref("i") + u("i");
+  BOOST_REQUIRE_NO_THROW(u("i") = s("i,j") * s("j,k") * u("k") + u("i"));
+  F::check_equal(u, x_ref);
+
+  // Products that sum variables used by later products are evaluated as
+  // written
+  BOOST_CHECK(!expressions::make_product_plan(
+                   y("i,j"), s("i,j") * s("j,k") * s("j,k"))
+                   .is_valid());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(sum_of_terms, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& c = F::c;
+  typename F::TArray s, t, x_ref, y, y_ref;
+
+  // A sum of more than two terms is accumulated by a single N-ary sum
+  auto plan = expressions::make_product_plan(
+      c("a,b,c"),
+      a("a,b,c") + 2 * b("c,b,a") - 3 * a("b,a,c") + b("a,b,c"));
+  BOOST_CHECK(plan.is_beneficial());
+  BOOST_CHECK_EQUAL(plan.terms(), 4ul);
+
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c") + 2 * b("c,b,a") -
+                                      3 * a("b,a,c") + b("a,b,c"));
+  x_ref("a,b,c") = a("a,b,c") + 2 * b("c,b,a");
+  x_ref("a,b,c") = x_ref("a,b,c") - 3 * a("b,a,c");
+  x_ref("a,b,c") = x_ref("a,b,c") + b("a,b,c");
+  F::check_equal(c, x_ref);
+
+  // Sums of products and arrays
+  TiledRange trange2 = F::trange2;
+  auto w = F::make_array(trange2);
+  F::random_fill(w);
+  GlobalFixture::world->gop.fence();
+  s("i,j") = w("i,k") * w("j,k");
+  BOOST_REQUIRE_NO_THROW(y("i,j") = s("i,k") * s("k,j") + s("i,j") -
+                                    2 * s("j,i") + s("j,k") * s("k,i"));
+  y_ref("i,j") = s("i,k") * s("k,j");
+  y_ref("i,j") = y_ref("i,j") + s("i,j");
+  y_ref("i,j") = y_ref("i,j") - 2 * s("j,i");
+  t("i,j") = s("j,k") * s("k,i");
+  y_ref("i,j") = y_ref("i,j") + t("i,j");
+  F::check_equal(y, y_ref);
+
+  // The result may be an argument
+  x_ref("a,b,c") = a("a,b,c") + b("a,b,c");
+  x_ref("a,b,c") = x_ref("a,b,c") + b("c,b,a");
+  BOOST_REQUIRE_NO_THROW(a("a,b,c") =
+                             a("a,b,c") + b("a,b,c") + b("c,b,a"));
+  F::check_equal(a, x_ref);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(accumulate_contraction, F, Fixtures, F) {
+  auto& u = F::u;
+  typename F::TArray s, x, x_ref, y, y_ref;
+
+  // A square matrix with the tiling of u
+  TiledRange trange2 = F::trange2;
+  auto w = F::make_array(trange2);
+  F::random_fill(w);
+  GlobalFixture::world->gop.fence();
+  s("i,j") = w("i,k") * w("j,k");
+
+  // The contraction is added to the tiles of x
+  x("i") = 2 * u("i");
+  x_ref("i") = x("i") + s("i,j") * u("j");
+  BOOST_REQUIRE_NO_THROW(x("i") += s("i,j") * u("j"));
+  F::check_equal(x, x_ref);
+
+  // The tiles of a copy of x are not modified
+  y = x;
+  y_ref("i") = y("i");
+  x_ref("i") = x("i") + s("i,j") * u("j");
+  BOOST_REQUIRE_NO_THROW(x("i") += s("i,j") * u("j"));
+  F::check_equal(x, x_ref);
+  F::check_equal(y, y_ref);
+
+  // x may be an argument
+  x_ref("i") = x("i") + s("i,j") * x("j");
+  BOOST_REQUIRE_NO_THROW(x("i") += s("i,j") * x("j"));
+  F::check_equal(x, x_ref);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif  // TILEDARRAY_TEST_EXPRESSIONS_IMPL_H
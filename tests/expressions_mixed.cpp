@@ -242,4 +242,34 @@ BOOST_AUTO_TEST_CASE( outer_product_factories )
   }
 }
 
+BOOST_AUTO_TEST_CASE( mixed_precision_mult )
+{
+  // Single precision values, so the double precision arrays hold the same
+  // elements as the single precision arrays
+  auto init = [] (const Range::index& index) {
+    return double(float(1.0 / double(1ul + index[0] + 2ul * index[1])));
+  };
+  TArrayF af(*GlobalFixture::world, trange2e), bf(*GlobalFixture::world, trange2e);
+  TArrayD ad(*GlobalFixture::world, trange2e), bd(*GlobalFixture::world, trange2e);
+  af.init_elements(init);
+  bf.init_elements(init);
+  ad.init_elements(init);
+  bd.init_elements(init);
+
+  // Contraction of single precision arrays accumulated in double precision
+  TArrayD c, r;
+  BOOST_REQUIRE_NO_THROW(c("i,j") = result_as<TensorD>(af("i,k") * bf("k,j")));
+  r("i,j") = ad("i,k") * bd("k,j");
+  BOOST_CHECK_SMALL((c("i,j") - r("i,j")).norm().get(), 1.0e-12);
+
+  // Scaled and permuted contraction
+  BOOST_REQUIRE_NO_THROW(c("j,i") = result_as<TensorD>(-2.0 * (af("i,k") * bf("k,j"))));
+  BOOST_CHECK_SMALL((c("j,i") + 2.0 * r("i,j")).norm().get(), 1.0e-12);
+
+  // Hadamard product
+  BOOST_REQUIRE_NO_THROW(c("i,j") = result_as<TensorD>(af("i,j") * bf("j,i")));
+  r("i,j") = ad("i,j") * bd("j,i");
+  BOOST_CHECK_SMALL((c("i,j") - r("i,j")).norm().get(), 1.0e-12);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
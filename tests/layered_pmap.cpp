@@ -0,0 +1,167 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/layered_pmap.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct LayeredPmapFixture {
+
+  LayeredPmapFixture() { }
+
+  /// Construct a pmap for each valid layer count, process grid, and split
+  template <typename Op>
+  static void for_each_pmap(const std::size_t x, const std::size_t y, const Op& op) {
+    const std::size_t nprocs = GlobalFixture::world->size();
+    for(std::size_t layers = 1ul; layers <= nprocs; ++layers) {
+      const std::size_t layer_stride = nprocs / layers;
+      for(std::size_t p_rows = 1ul; p_rows <= layer_stride; ++p_rows) {
+        const std::size_t p_cols = layer_stride / p_rows;
+        if(layers <= y)
+          op(detail::LayeredPmap(* GlobalFixture::world, x, y, p_rows, p_cols,
+              layers, layer_stride, true));
+        if(layers <= x)
+          op(detail::LayeredPmap(* GlobalFixture::world, x, y, p_rows, p_cols,
+              layers, layer_stride, false));
+      }
+    }
+  }
+
+};
+
+
+// =============================================================================
+// LayeredPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( layered_pmap_suite, LayeredPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  const std::size_t size = GlobalFixture::world->size();
+
+  BOOST_REQUIRE_NO_THROW(detail::LayeredPmap pmap(* GlobalFixture::world, 10ul, 10ul, 1, 1, 1, size, true));
+  detail::LayeredPmap pmap(* GlobalFixture::world, 10ul, 10ul, 1, 1, 1, size, true);
+  BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+  BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+  BOOST_CHECK_EQUAL(pmap.size(), 100ul);
+  BOOST_CHECK_EQUAL(pmap.nlayers(), 1ul);
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(detail::LayeredPmap pmap(* GlobalFixture::world, 0ul, 10ul, 1, 1, 1, size, true), TiledArray::Exception);
+  BOOST_CHECK_THROW(detail::LayeredPmap pmap(* GlobalFixture::world, 10ul, 10ul, 0, 1, 1, size, true), TiledArray::Exception);
+  BOOST_CHECK_THROW(detail::LayeredPmap pmap(* GlobalFixture::world, 10ul, 10ul, 1, 1, 0, size, true), TiledArray::Exception);
+  BOOST_CHECK_THROW(detail::LayeredPmap pmap(* GlobalFixture::world, 10ul, 10ul, 1, 1, 2, size, true), TiledArray::Exception);
+  BOOST_CHECK_THROW(detail::LayeredPmap pmap(* GlobalFixture::world, 10ul, 2ul, 1, 1, 3, 1, true), TiledArray::Exception);
+  BOOST_CHECK_THROW(detail::LayeredPmap pmap(* GlobalFixture::world, 10ul, 10ul, size + 1, 1, 1, size, true), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( slab )
+{
+  // Check that each inner index is assigned to exactly one slab
+  for(std::size_t n = 1ul; n < 20ul; ++n) {
+    for(std::size_t layers = 1ul; layers <= n; ++layers) {
+      for(std::size_t i = 0ul; i < n; ++i) {
+        const std::size_t layer = detail::LayeredPmap::slab(i, layers, n);
+        BOOST_CHECK_LT(layer, layers);
+        BOOST_CHECK_LE(detail::LayeredPmap::slab_begin(layer, layers, n), i);
+        BOOST_CHECK_GT(detail::LayeredPmap::slab_begin(layer + 1ul, layers, n), i);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  // Check various pmap sizes
+  for(std::size_t x = 1ul; x < 10ul; ++x) {
+    for(std::size_t y = 1ul; y < 10ul; ++y) {
+      for_each_pmap(x, y, [&] (const detail::LayeredPmap& pmap) {
+        for(std::size_t tile = 0; tile < x * y; ++tile) {
+          std::fill_n(p_owner, size, 0);
+          p_owner[rank] = pmap.owner(tile);
+          // check that the value is in range
+          BOOST_CHECK_LT(p_owner[rank], size);
+          GlobalFixture::world->gop.sum(p_owner, size);
+
+          // Make sure everyone agrees on who owns what.
+          for(std::size_t p = 0ul; p < size; ++p)
+            BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+        }
+      });
+    }
+  }
+
+  delete [] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE( local_size )
+{
+  for(std::size_t x = 1ul; x < 10ul; ++x) {
+    for(std::size_t y = 1ul; y < 10ul; ++y) {
+      for_each_pmap(x, y, [&] (const detail::LayeredPmap& pmap) {
+        std::size_t total_size = pmap.local_size();
+        GlobalFixture::world->gop.sum(total_size);
+
+        // Check that the total number of elements in all local groups is equal to
+        // the number of tiles in the map.
+        BOOST_CHECK_EQUAL(total_size, x * y);
+        BOOST_CHECK(pmap.empty() == (pmap.local_size() == 0ul));
+      });
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+
+  for(std::size_t x = 1ul; x < 10ul; ++x) {
+    for(std::size_t y = 1ul; y < 10ul; ++y) {
+      for_each_pmap(x, y, [&] (const detail::LayeredPmap& pmap) {
+        // Check that all local elements map to this rank
+        std::size_t count = 0ul;
+        for(detail::LayeredPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it, ++count) {
+          BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+        }
+        BOOST_CHECK_EQUAL(count, pmap.local_size());
+
+        std::fill_n(tile_owners, x * y, 0);
+        for(detail::LayeredPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+          tile_owners[*it] += GlobalFixture::world->rank();
+        }
+
+        GlobalFixture::world->gop.sum(tile_owners, x * y);
+        for(std::size_t tile = 0; tile < x * y; ++tile) {
+          BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+        }
+      });
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,182 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  math_simd.cpp
+ *  Mar 19, 2018
+ *
+ */
+
+#include "TiledArray/math/simd.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+using math::simd::Level;
+
+struct SimdFixture {
+
+  SimdFixture() : a(n), b(n), fa(n), fb(n), za(n), zb(n),
+      level(math::simd::level())
+  {
+    // Small integer values, so all results are exact in any order
+    GlobalFixture::world->srand(27);
+    for(std::size_t i = 0ul; i < n; ++i) {
+      a[i] = double(GlobalFixture::world->rand() % 21) - 10.0;
+      b[i] = double(GlobalFixture::world->rand() % 21) - 10.0;
+      fa[i] = float(a[i]);
+      fb[i] = float(b[i]);
+      za[i] = std::complex<double>(a[i], b[i]);
+      zb[i] = std::complex<double>(b[i], 3.0);
+    }
+  }
+
+  ~SimdFixture() { math::simd::set_level(level); }
+
+  /// The levels that are supported by this process
+  static std::vector<Level> levels() {
+    std::vector<Level> result;
+    for(Level l : { Level::generic, Level::neon, Level::avx2, Level::avx512 })
+      if(math::simd::supported(l) && (l <= math::simd::max_level()))
+        result.push_back(l);
+    return result;
+  }
+
+  // Large enough to be evaluated in parallel, with a partial vector at the end
+  static const std::size_t n = 100003ul;
+
+  std::vector<double> a;
+  std::vector<double> b;
+  std::vector<float> fa;
+  std::vector<float> fb;
+  std::vector<std::complex<double> > za;
+  std::vector<std::complex<double> > zb;
+  const Level level;
+}; // SimdFixture
+
+const std::size_t SimdFixture::n;
+
+BOOST_FIXTURE_TEST_SUITE( simd_suite, SimdFixture )
+
+BOOST_AUTO_TEST_CASE( set_level )
+{
+  BOOST_CHECK(math::simd::supported(Level::generic));
+  BOOST_CHECK(math::simd::supported(math::simd::max_level()));
+
+  BOOST_CHECK_EQUAL(int(math::simd::set_level(Level::generic)), int(Level::generic));
+  BOOST_CHECK_EQUAL(int(math::simd::level()), int(Level::generic));
+
+  // Unsupported levels fall back to a supported level
+  const Level l = math::simd::set_level(Level::avx512);
+  BOOST_CHECK(math::simd::supported(l));
+  BOOST_CHECK(l <= math::simd::max_level());
+  BOOST_CHECK_EQUAL(int(math::simd::level()), int(l));
+}
+
+BOOST_AUTO_TEST_CASE( element_wise )
+{
+  for(Level l : levels()) {
+    math::simd::set_level(l);
+
+    std::vector<double> result = a;
+    math::simd::scale_to(n, 3.0, result.data());
+    math::simd::axpy(n, 2.0, b.data(), result.data());
+    math::simd::add_to(n, b.data(), result.data());
+    math::simd::add_to(n, b.data(), result.data(), 2.0);
+    math::simd::subt_to(n, a.data(), result.data());
+    math::simd::subt_to(n, a.data(), result.data(), -1.0);
+    math::simd::mult_to(n, b.data(), result.data());
+    math::simd::mult_to(n, b.data(), result.data(), 0.5);
+
+    std::vector<float> fresult = fa;
+    math::simd::add_to(n, fb.data(), fresult.data(), 2.0f);
+    math::simd::mult_to(n, fb.data(), fresult.data());
+
+    for(std::size_t i = 0ul; i < n; ++i) {
+      double reference = a[i] * 3.0;
+      reference += 2.0 * b[i];
+      reference += b[i];
+      reference = (reference + b[i]) * 2.0;
+      reference -= a[i];
+      reference = (reference - a[i]) * -1.0;
+      reference *= b[i];
+      reference = (reference * b[i]) * 0.5;
+      BOOST_CHECK_EQUAL(result[i], reference);
+      BOOST_CHECK_EQUAL(fresult[i], ((fa[i] + fb[i]) * 2.0f) * fb[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( reductions )
+{
+  double squared_norm = 0.0, dot = 0.0, abs_max = 0.0;
+  double abs_min = std::numeric_limits<double>::max();
+  for(std::size_t i = 0ul; i < n; ++i) {
+    squared_norm += a[i] * a[i];
+    dot += a[i] * b[i];
+    abs_max = std::max(abs_max, std::abs(a[i]));
+    abs_min = std::min(abs_min, std::abs(a[i] + 10.5));
+  }
+
+  std::vector<double> shifted = a;
+  for(auto& x : shifted)
+    x += 10.5;
+
+  for(Level l : levels()) {
+    math::simd::set_level(l);
+
+    BOOST_CHECK_EQUAL(math::simd::squared_norm(n, a.data()), squared_norm);
+    BOOST_CHECK_EQUAL(math::simd::dot(n, a.data(), b.data()), dot);
+    BOOST_CHECK_EQUAL(math::simd::abs_max(n, a.data()), abs_max);
+    BOOST_CHECK_EQUAL(math::simd::abs_min(n, shifted.data()), abs_min);
+    BOOST_CHECK_EQUAL(math::simd::squared_norm(n, fa.data()), float(squared_norm));
+    BOOST_CHECK_EQUAL(math::simd::dot(n, fa.data(), fb.data()), float(dot));
+
+    // Partial vectors only
+    BOOST_CHECK_EQUAL(math::simd::squared_norm(3ul, a.data()),
+        a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+    BOOST_CHECK_EQUAL(math::simd::abs_max(0ul, a.data()), 0.0);
+    BOOST_CHECK_EQUAL(math::simd::abs_min(0ul, a.data()),
+        std::numeric_limits<double>::max());
+  }
+}
+
+BOOST_AUTO_TEST_CASE( complex )
+{
+  double squared_norm = 0.0, abs_max = 0.0;
+  std::complex<double> dot(0.0, 0.0);
+  for(std::size_t i = 0ul; i < n; ++i) {
+    squared_norm += std::norm(za[i]);
+    dot += za[i] * zb[i];
+    abs_max = std::max(abs_max, std::abs(za[i]));
+  }
+
+  for(Level l : levels()) {
+    math::simd::set_level(l);
+
+    std::vector<std::complex<double> > result = za;
+    math::simd::scale_to(n, 2.0, result.data());
+    math::simd::add_to(n, zb.data(), result.data(), 3.0);
+    math::simd::mult_to(n, zb.data(), result.data());
+    for(std::size_t i = 0ul; i < n; ++i)
+      BOOST_CHECK_EQUAL(result[i], ((za[i] * 2.0 + zb[i]) * 3.0) * zb[i]);
+
+    BOOST_CHECK_EQUAL(math::simd::squared_norm(n, za.data()), squared_norm);
+    BOOST_CHECK_EQUAL(math::simd::dot(n, za.data(), zb.data()), dot);
+    BOOST_CHECK_CLOSE(math::simd::abs_max(n, za.data()), abs_max, 1e-12);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,154 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  math_sparse_gemm.cpp
+ *  Mar 2, 2018
+ *
+ */
+
+#include "TiledArray/math/sparse_gemm.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct SparseGemmFixture {
+
+  SparseGemmFixture() :
+    a(m * k, 0.0), b(k * n, 0.0), w(k, 0.0)
+  {
+    GlobalFixture::world->srand(27);
+    for(std::size_t i = 0ul; i < a.size(); ++i)
+      if(GlobalFixture::world->rand() % 3 == 0)
+        a[i] = GlobalFixture::world->rand() % 101;
+    for(std::size_t i = 0ul; i < b.size(); ++i)
+      if(GlobalFixture::world->rand() % 3 == 0)
+        b[i] = GlobalFixture::world->rand() % 101;
+    for(std::size_t i = 0ul; i < w.size(); ++i)
+      w[i] = 1 + GlobalFixture::world->rand() % 5;
+  }
+
+  ~SparseGemmFixture() { }
+
+  const std::size_t m = 23;
+  const std::size_t n = 17;
+  const std::size_t k = 19;
+
+  /// Reference product, c = a * diag(w) * b
+  std::vector<double> reference() const {
+    std::vector<double> c(m * n, 0.0);
+    for(std::size_t i = 0ul; i < m; ++i)
+      for(std::size_t l = 0ul; l < k; ++l)
+        for(std::size_t j = 0ul; j < n; ++j)
+          c[i * n + j] += a[i * k + l] * w[l] * b[l * n + j];
+    return c;
+  }
+
+  /// Transpose a row-major matrix
+  static std::vector<double> transpose(const std::vector<double>& x,
+      const std::size_t rows, const std::size_t cols)
+  {
+    std::vector<double> result(x.size());
+    for(std::size_t i = 0ul; i < rows; ++i)
+      for(std::size_t j = 0ul; j < cols; ++j)
+        result[j * rows + i] = x[i * cols + j];
+    return result;
+  }
+
+  /// Evaluate the sparse product and store it in a dense matrix
+  static std::vector<double> eval(const math::SparseMatrix<double>& left,
+      const math::SparseMatrix<double>& right, const double* weights,
+      const std::vector<std::size_t>& partition)
+  {
+    std::vector<double> c(left.rows() * right.cols(), 0.0);
+    const std::size_t cols = right.cols();
+    math::sparse_gemm(left, right, weights, partition,
+        [&c,cols] (const std::size_t, const std::size_t i,
+            const std::vector<std::size_t>& columns, const double* const row)
+        {
+          for(const std::size_t j : columns)
+            c[i * cols + j] = row[j];
+        });
+    return c;
+  }
+
+  std::vector<double> a;
+  std::vector<double> b;
+  std::vector<double> w;
+}; // SparseGemmFixture
+
+BOOST_FIXTURE_TEST_SUITE( math_sparse_gemm_suite, SparseGemmFixture )
+
+BOOST_AUTO_TEST_CASE( sparse_matrix )
+{
+  const math::SparseMatrix<double> x(m, k, a.data(), false);
+  const math::SparseMatrix<double> xt(m, k, transpose(a, m, k).data(), true);
+
+  BOOST_CHECK_EQUAL(x.rows(), m);
+  BOOST_CHECK_EQUAL(x.cols(), k);
+  BOOST_CHECK_EQUAL(x.nnz(), std::size_t(std::count_if(a.begin(), a.end(),
+      [] (const double value) { return value != 0.0; })));
+  BOOST_CHECK_EQUAL(xt.nnz(), x.nnz());
+
+  // Check that only the non-zero elements are stored, in row order
+  for(std::size_t i = 0ul; i < m; ++i) {
+    BOOST_CHECK_EQUAL(xt.row_nnz(i), x.row_nnz(i));
+    for(auto it = x.row_begin(i); it != x.row_end(i); ++it)
+      BOOST_CHECK_EQUAL(it->second, a[i * k + it->first]);
+    for(auto it = xt.row_begin(i); it != xt.row_end(i); ++it)
+      BOOST_CHECK_EQUAL(it->second, a[i * k + it->first]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  const std::vector<double> expected = reference();
+  const std::vector<double> at = transpose(a, m, k);
+  const std::vector<double> bt = transpose(b, k, n);
+
+  for(int trans = 0; trans < 4; ++trans) {
+    const bool left_trans = trans & 1;
+    const bool right_trans = trans & 2;
+    const math::SparseMatrix<double> left(m, k,
+        (left_trans ? at.data() : a.data()), left_trans);
+    const math::SparseMatrix<double> right(k, n,
+        (right_trans ? bt.data() : b.data()), right_trans);
+
+    // Evaluate with the default partition and with several row blocks
+    std::vector<std::vector<std::size_t> > partitions = {
+        math::sparse_gemm_partition(left, right), {0ul, 5ul, 6ul, 16ul, m} };
+    for(const auto& partition : partitions) {
+      const std::vector<double> c = eval(left, right, w.data(), partition);
+      for(std::size_t i = 0ul; i < c.size(); ++i)
+        BOOST_CHECK_EQUAL(c[i], expected[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( partition )
+{
+  const math::SparseMatrix<double> left(m, k, a.data(), false);
+  const math::SparseMatrix<double> right(k, n, b.data(), false);
+
+  const std::vector<std::size_t> partition = math::sparse_gemm_partition(left, right);
+  BOOST_REQUIRE_GE(partition.size(), 2ul);
+  BOOST_CHECK_EQUAL(partition.front(), 0ul);
+  BOOST_CHECK_EQUAL(partition.back(), m);
+  for(std::size_t i = 1ul; i < partition.size(); ++i)
+    BOOST_CHECK_LT(partition[i - 1ul], partition[i]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  math_vector_op.cpp
+ *  Mar 14, 2018
+ *
+ */
+
+#include "TiledArray/math/vector_op.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct VectorOpFixture {
+
+  VectorOpFixture() : a(n), b(n), x(n), result(n), reference(n) {
+    GlobalFixture::world->srand(31);
+    for(std::size_t i = 0ul; i < n; ++i) {
+      a[i] = GlobalFixture::world->rand() % 101;
+      b[i] = GlobalFixture::world->rand() % 101;
+      x[i] = double(GlobalFixture::world->rand() % 1001) / 1000.0;
+    }
+  }
+
+  ~VectorOpFixture() { }
+
+  // Large enough to be split into blocks that are evaluated in parallel,
+  // with a partial block at the end
+  static const std::size_t n = 1000003ul;
+
+  std::vector<int> a;
+  std::vector<int> b;
+  std::vector<double> x;
+  std::vector<int> result;
+  std::vector<int> reference;
+}; // VectorOpFixture
+
+const std::size_t VectorOpFixture::n;
+
+BOOST_FIXTURE_TEST_SUITE( vector_op_suite, VectorOpFixture )
+
+BOOST_AUTO_TEST_CASE( inplace_vector_op )
+{
+  const auto op = [] (int& r, const int l) { r = 2 * r + l; };
+  result = a;
+  reference = a;
+
+  math::inplace_vector_op(op, n, result.data(), b.data());
+  math::inplace_vector_op_serial(op, n, reference.data(), b.data());
+
+  BOOST_CHECK(result == reference);
+}
+
+BOOST_AUTO_TEST_CASE( vector_op )
+{
+  const auto op = [] (const int l, const int r) { return l * r - l; };
+
+  math::vector_op(op, n, result.data(), a.data(), b.data());
+  math::vector_op_serial(op, n, reference.data(), a.data(), b.data());
+
+  BOOST_CHECK(result == reference);
+}
+
+BOOST_AUTO_TEST_CASE( vector_ptr_op )
+{
+  const auto op = [] (int* const r, const int l) { new(r) int(l + 3); };
+
+  math::vector_ptr_op(op, n, result.data(), a.data());
+  math::vector_ptr_op_serial(op, n, reference.data(), a.data());
+
+  BOOST_CHECK(result == reference);
+}
+
+BOOST_AUTO_TEST_CASE( reduce_op )
+{
+  // Integer reductions are exact
+  const auto sum_op = [] (long& r, const int l, const int m) { r += l * m; };
+  const auto join_op = [] (long& r, const long s) { r += s; };
+  long sum = 1l, sum_reference = 1l;
+  math::reduce_op(sum_op, join_op, 0l, n, sum, a.data(), b.data());
+  math::reduce_op_serial(sum_op, n, sum_reference, a.data(), b.data());
+  BOOST_CHECK_EQUAL(sum, sum_reference);
+
+  const auto max_op = [] (int& r, const int l) { r = std::max(r, l); };
+  int max = 0, max_reference = 0;
+  math::reduce_op(max_op, max_op, 0, n, max, b.data());
+  math::reduce_op_serial(max_op, n, max_reference, b.data());
+  BOOST_CHECK_EQUAL(max, max_reference);
+
+  // Floating-point reductions may differ by rounding
+  const auto sq_op = [] (double& r, const double l) { r += l * l; };
+  const auto plus_op = [] (double& r, const double s) { r += s; };
+  double norm2 = 0.0, norm2_reference = 0.0;
+  math::reduce_op(sq_op, plus_op, 0.0, n, norm2, x.data());
+  math::reduce_op_serial(sq_op, n, norm2_reference, x.data());
+  BOOST_CHECK_CLOSE(norm2, norm2_reference, 1.0e-8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,232 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  pool_allocator.cpp
+ *  Apr 3, 2018
+ *
+ */
+
+#include "TiledArray/pool_allocator.h"
+#include "TiledArray/tensor.h"
+#include "unit_test_config.h"
+#include <thread>
+
+using namespace TiledArray;
+using detail::MemoryPool;
+
+struct PoolAllocatorFixture {
+
+  PoolAllocatorFixture() : max_retained(MemoryPool::instance().max_retained()) {
+    pool_trim();
+    pool_reset_statistics();
+  }
+
+  ~PoolAllocatorFixture() {
+    pool_set_max_retained(max_retained);
+    pool_trim();
+  }
+
+  typedef Tensor<double, pool_allocator<double> > TensorP;
+
+  static const std::size_t max_size = MemoryPool::max_size;
+  static const unsigned int num_classes = MemoryPool::num_classes;
+
+  const std::size_t max_retained;
+}; // PoolAllocatorFixture
+
+const std::size_t PoolAllocatorFixture::max_size;
+const unsigned int PoolAllocatorFixture::num_classes;
+
+BOOST_FIXTURE_TEST_SUITE( pool_allocator_suite, PoolAllocatorFixture )
+
+BOOST_AUTO_TEST_CASE( size_classes )
+{
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(1ul), 0u);
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(64ul), 0u);
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(65ul), 1u);
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(max_size),
+      num_classes - 1u);
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(max_size + 1ul),
+      num_classes);
+
+  // Each size fits in its class, and not in the previous class
+  for(std::size_t bytes = 1ul; bytes <= 100000ul; bytes += 7ul) {
+    const unsigned int c = MemoryPool::size_class(bytes);
+    BOOST_CHECK_GE(MemoryPool::class_size(c), bytes);
+    if(c > 0u)
+      BOOST_CHECK_LT(MemoryPool::class_size(c - 1u), bytes);
+  }
+
+  // Blocks are at most 25% larger than requested
+  for(unsigned int c = 1u; c < num_classes; ++c)
+    BOOST_CHECK_LE(MemoryPool::class_size(c) * 4ul,
+        MemoryPool::class_size(c - 1u) * 5ul + 4ul);
+}
+
+BOOST_AUTO_TEST_CASE( reuse )
+{
+  pool_allocator<double> alloc;
+
+  double* p = alloc.allocate(1000ul);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % 16ul, 0ul);
+  std::fill_n(p, 1000ul, 1.0);
+  alloc.deallocate(p, 1000ul);
+  BOOST_CHECK_EQUAL(pool_statistics().retained_bytes,
+      MemoryPool::class_size(MemoryPool::size_class(8000ul)));
+
+  // The block is reused by an allocation of the same size class
+  double* q = alloc.allocate(990ul);
+  BOOST_CHECK_EQUAL(q, p);
+  BOOST_CHECK_EQUAL(pool_statistics().retained_bytes, 0ul);
+  alloc.deallocate(q, 990ul);
+
+  // Memory is shared by rebound allocators
+  pool_allocator<char> char_alloc(alloc);
+  BOOST_CHECK(char_alloc == alloc);
+  char* r = char_alloc.allocate(8000ul);
+  BOOST_CHECK_EQUAL(static_cast<void*>(r), static_cast<void*>(p));
+  char_alloc.deallocate(r, 8000ul);
+
+  const PoolStatistics stats = pool_statistics();
+  BOOST_CHECK_EQUAL(stats.requests, 3ul);
+  BOOST_CHECK_EQUAL(stats.hits, 2ul);
+  BOOST_CHECK_EQUAL(stats.misses, 1ul);
+  BOOST_CHECK_EQUAL(stats.large, 0ul);
+  BOOST_CHECK_CLOSE(stats.hit_rate(), 2.0 / 3.0, 1e-12);
+
+  pool_reset_statistics();
+  BOOST_CHECK_EQUAL(pool_statistics().requests, 0ul);
+  BOOST_CHECK_EQUAL(pool_statistics().hit_rate(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( large )
+{
+  pool_allocator<char> alloc;
+  char* p = alloc.allocate(max_size + 1ul);
+  alloc.deallocate(p, max_size + 1ul);
+
+  const PoolStatistics stats = pool_statistics();
+  BOOST_CHECK_EQUAL(stats.requests, 1ul);
+  BOOST_CHECK_EQUAL(stats.large, 1ul);
+  BOOST_CHECK_EQUAL(stats.retained_bytes, 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( trim )
+{
+  pool_allocator<double> alloc;
+  std::vector<double*> blocks;
+  for(std::size_t i = 1ul; i <= 100ul; ++i)
+    blocks.push_back(alloc.allocate(i * 100ul));
+  std::size_t retained = 0ul;
+  for(std::size_t i = 1ul; i <= 100ul; ++i) {
+    alloc.deallocate(blocks[i - 1ul], i * 100ul);
+    retained += MemoryPool::class_size(MemoryPool::size_class(i * 800ul));
+  }
+  BOOST_CHECK_EQUAL(pool_statistics().retained_bytes, retained);
+
+  BOOST_CHECK_EQUAL(pool_trim(), retained);
+  BOOST_CHECK_EQUAL(pool_statistics().retained_bytes, 0ul);
+  BOOST_CHECK_EQUAL(pool_trim(), 0ul);
+
+  // Blocks freed beyond the retained limit are returned to the system
+  pool_set_max_retained(10000ul);
+  BOOST_CHECK_EQUAL(pool_statistics().max_retained_bytes, 10000ul);
+  double* p = alloc.allocate(1000ul);
+  double* q = alloc.allocate(1000ul);
+  alloc.deallocate(p, 1000ul);
+  alloc.deallocate(q, 1000ul);
+  BOOST_CHECK_EQUAL(pool_statistics().retained_bytes,
+      MemoryPool::class_size(MemoryPool::size_class(8000ul)));
+}
+
+BOOST_AUTO_TEST_CASE( threads )
+{
+  // Blocks freed by one thread are reused by another
+  pool_allocator<double> alloc;
+  std::vector<double*> blocks(2000ul);
+  std::thread producer([&] () {
+    for(auto& p : blocks)
+      p = alloc.allocate(512ul);
+  });
+  producer.join();
+
+  std::thread consumer([&] () {
+    for(auto p : blocks)
+      alloc.deallocate(p, 512ul);
+  });
+  consumer.join();
+
+  std::size_t found = 0ul;
+  std::vector<double*> reused(blocks.size());
+  for(auto& p : reused) {
+    p = alloc.allocate(512ul);
+    found += std::count(blocks.begin(), blocks.end(), p);
+  }
+  BOOST_CHECK_EQUAL(found, blocks.size());
+  for(auto p : reused)
+    alloc.deallocate(p, 512ul);
+
+  const PoolStatistics stats = pool_statistics();
+  BOOST_CHECK_EQUAL(stats.requests, 2 * blocks.size());
+  BOOST_CHECK_EQUAL(stats.hits, blocks.size());
+}
+
+BOOST_AUTO_TEST_CASE( thread_exit )
+{
+  // A thread-local object that is constructed before the thread cache is
+  // destroyed after it, so its memory is freed without the thread cache
+  std::thread thread([] () {
+    static thread_local std::vector<double, pool_allocator<double> > data;
+    data.resize(1000ul);
+  });
+  thread.join();
+
+  // The block is returned to the shared lists and reused by this thread
+  const PoolStatistics stats = pool_statistics();
+  BOOST_CHECK_EQUAL(stats.requests, 1ul);
+  BOOST_CHECK_EQUAL(stats.retained_bytes,
+      MemoryPool::class_size(MemoryPool::size_class(8000ul)));
+
+  pool_allocator<double> alloc;
+  double* p = alloc.allocate(1000ul);
+  BOOST_CHECK_EQUAL(pool_statistics().hits, 1ul);
+  alloc.deallocate(p, 1000ul);
+}
+
+BOOST_AUTO_TEST_CASE( tensor )
+{
+  const Range r(std::vector<std::size_t>{ 11ul, 13ul, 17ul });
+  TensorP a(r, 2.0);
+  TensorP b(r, 3.0);
+  const TensorP c = a.add(b);
+  BOOST_CHECK_EQUAL(c.range(), r);
+  for(std::size_t i = 0ul; i < c.size(); ++i)
+    BOOST_CHECK_EQUAL(c[i], 5.0);
+
+  // The data and the implementation objects of temporary tensors are
+  // recycled
+  pool_reset_statistics();
+  for(int i = 0; i < 10; ++i) {
+    TensorP t = a.mult(b);
+    BOOST_CHECK_EQUAL(t[0], 6.0);
+  }
+  const PoolStatistics stats = pool_statistics();
+  BOOST_CHECK_EQUAL(stats.requests, 20ul);
+  BOOST_CHECK_GE(stats.hits, 18ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
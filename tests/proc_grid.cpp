@@ -193,6 +193,67 @@ BOOST_AUTO_TEST_CASE( make_groups )
   }
 }
 
+BOOST_AUTO_TEST_CASE( layered_constructor_test )
+{
+  const ProcessID nprocs = 64;
+  const std::size_t rows = 13;
+  const std::size_t cols = 11;
+  const std::size_t inner = 17;
+
+  for(std::size_t layers = 1ul; layers <= 4ul; ++layers) {
+    std::vector<int> products(rows * cols * inner, 0);
+    const std::size_t layer_stride = nprocs / layers;
+
+    for(ProcessID rank = 0; rank < nprocs; ++rank) {
+      TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, rank, nprocs,
+          rows, cols, rows * 10, cols * 10, layers);
+
+      BOOST_CHECK_EQUAL(proc_grid.layers(), layers);
+      BOOST_CHECK_EQUAL(proc_grid.layer_stride(), layer_stride);
+      BOOST_CHECK_LE(proc_grid.proc_size(), layer_stride);
+
+      if(proc_grid.local_size() == 0ul)
+        continue;
+
+      // Check that the process is in the correct layer
+      BOOST_CHECK_EQUAL(proc_grid.rank_layer(), ProcessID(rank / layer_stride));
+      BOOST_CHECK_EQUAL(proc_grid.map_layer(proc_grid.rank_layer()), rank);
+      BOOST_CHECK_EQUAL(proc_grid.map_row(proc_grid.rank_row()), rank);
+      BOOST_CHECK_EQUAL(proc_grid.map_col(proc_grid.rank_col()), rank);
+
+      // Accumulate the tile products evaluated by this process
+      for(std::size_t k = proc_grid.layer_inner_begin(inner);
+          k < proc_grid.layer_inner_end(inner); ++k)
+        for(std::size_t i = proc_grid.rank_row(); i < rows; i += proc_grid.proc_rows())
+          for(std::size_t j = proc_grid.rank_col(); j < cols; j += proc_grid.proc_cols())
+            ++products[(i * cols + j) * inner + k];
+    }
+
+    // Check that each tile product is evaluated exactly once
+    for(std::size_t x = 0ul; x < products.size(); ++x)
+      BOOST_CHECK_EQUAL(products[x], 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( optimal_layers )
+{
+  // Small process counts use the 2D grid
+  for(std::size_t nprocs = 1ul; nprocs < 8ul; ++nprocs)
+    BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::optimal_layers(nprocs,
+        64, 64, 64, 64 * 256, 64 * 256, 64 * 256), 1ul);
+
+  // A large inner dimension favors more layers
+  const std::size_t layers =
+      TiledArray::detail::ProcGrid::optimal_layers(512, 8, 8, 512, 8 * 256,
+          8 * 256, 512 * 256);
+  BOOST_CHECK_GT(layers, 1ul);
+  BOOST_CHECK_LE(layers, 8ul);
+
+  // There can be no more layers than inner tiles
+  BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::optimal_layers(4096, 8, 8, 1,
+      8 * 256, 8 * 256, 256), 1ul);
+}
+
 #if 0
 // This test case us used to evaluate distribute statistics. This unit test
 // should only be enabled when changes are made to the ProcGrid algorithm, and
@@ -391,4 +391,60 @@ BOOST_AUTO_TEST_CASE( swap )
   BOOST_CHECK_EQUAL(r.volume(), volume);
 }
 
+BOOST_AUTO_TEST_CASE( inline_storage )
+{
+  // Ranges with and without inline data
+  const unsigned int small_rank = Range::max_inline_rank;
+  const unsigned int large_rank = Range::max_inline_rank + 2u;
+  const Range small(Range::index(small_rank, 1), Range::index(small_rank, 3));
+  const Range large(Range::index(large_rank, 1), Range::index(large_rank, 2));
+  BOOST_CHECK_EQUAL(small.volume(), 1ul << small_rank);
+  BOOST_CHECK_EQUAL(large.volume(), 1ul);
+
+  // Copy and move
+  Range r1(small);
+  Range r2(large);
+  BOOST_CHECK_EQUAL(r1, small);
+  BOOST_CHECK(r1.lobound_data() != small.lobound_data());
+  BOOST_CHECK_EQUAL(r2, large);
+  Range r3(std::move(r1));
+  Range r4(std::move(r2));
+  BOOST_CHECK_EQUAL(r3, small);
+  BOOST_CHECK_EQUAL(r4, large);
+  BOOST_CHECK_EQUAL(r1.rank(), 0u);
+  BOOST_CHECK_EQUAL(r2.rank(), 0u);
+
+  // Assignment between ranges with and without inline data
+  r1 = large;
+  r2 = small;
+  BOOST_CHECK_EQUAL(r1, large);
+  BOOST_CHECK_EQUAL(r2, small);
+  r1 = std::move(r2);
+  BOOST_CHECK_EQUAL(r1, small);
+  r2 = std::move(r4);
+  BOOST_CHECK_EQUAL(r2, large);
+
+  // Swap
+  r1.swap(r2);
+  BOOST_CHECK_EQUAL(r1, large);
+  BOOST_CHECK_EQUAL(r2, small);
+  r2.swap(r3);
+  BOOST_CHECK_EQUAL(r2, small);
+  BOOST_CHECK_EQUAL(r3, small);
+
+  // Permutation
+  std::vector<unsigned int> p(large_rank);
+  std::iota(p.rbegin(), p.rend(), 0u);
+  const Permutation perm(p.begin(), p.end());
+  Range r5 = perm * large;
+  r5 *= perm;
+  BOOST_CHECK_EQUAL(r5, large);
+
+  // Resize to a rank that does not fit inline, and back
+  r3.resize(large.lobound(), large.upbound());
+  BOOST_CHECK_EQUAL(r3, large);
+  r3.resize(small.lobound(), small.upbound());
+  BOOST_CHECK_EQUAL(r3, small);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -43,6 +43,23 @@ struct plus {
 };
 
 
+template <typename T>
+struct batch_plus : public plus<T> {
+  typedef typename plus<T>::result_type result_type;
+  typedef typename plus<T>::argument_type argument_type;
+  using plus<T>::operator();
+
+  std::size_t batch_size() const { return 4ul; }
+
+  void operator()(result_type& result,
+      const std::vector<const argument_type*>& args) const
+  {
+    for(const argument_type* arg : args)
+      result += *arg;
+  }
+};
+
+
 struct ReduceTaskFixture {
 
   ReduceTaskFixture() : world(*GlobalFixture::world), rt(world) {
@@ -79,6 +96,20 @@ struct ReduceOp {
   }
 }; // struct ReduceOp
 
+struct BatchReduceOp : public ReduceOp {
+  using ReduceOp::operator();
+
+  std::size_t batch_size() const { return 4ul; }
+
+  void operator()(result_type& result,
+      const std::vector<const first_argument_type*>& first,
+      const std::vector<const second_argument_type*>& second) const
+  {
+    for(std::size_t i = 0ul; i < first.size(); ++i)
+      result += *first[i] * *second[i];
+  }
+}; // struct BatchReduceOp
+
 struct ReducePairTaskFixture {
 
   ReducePairTaskFixture() : world(*GlobalFixture::world), rt(world) {
@@ -137,6 +168,34 @@ BOOST_AUTO_TEST_CASE( reduce_future )
 
 }
 
+BOOST_AUTO_TEST_CASE( reduce_batch_future )
+{
+  ReduceTask<batch_plus<int> > batch_rt(world);
+  std::vector<Future<int> > fut_vec;
+
+  for(int i = 0; i < 100; ++i) {
+    Future<int> f;
+    fut_vec.push_back(f);
+    batch_rt.add(f);
+  }
+
+  Future<int> result = batch_rt.submit();
+
+  // Set the arguments out of order so that they are ready in batches
+  int sum = 0;
+  for(int i = 0; i < 100; i += 2) {
+    sum += i;
+    fut_vec[i].set(i);
+  }
+  for(int i = 1; i < 100; i += 2) {
+    BOOST_CHECK(!(result.probe()));
+    sum += i;
+    fut_vec[i].set(i);
+  }
+
+  BOOST_CHECK_EQUAL(result.get(), sum);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -228,4 +287,31 @@ BOOST_AUTO_TEST_CASE( reduce_zero )
   BOOST_CHECK_EQUAL(result.get(), 0);
 }
 
+BOOST_AUTO_TEST_CASE( reduce_batch_future )
+{
+  ReducePairTask<BatchReduceOp> batch_rt(world);
+  std::vector<Future<int> > fut1_vec;
+  std::vector<Future<int> > fut2_vec;
+
+  for(int i = 0; i < 100; ++i) {
+    Future<int> f1;
+    Future<int> f2;
+    fut1_vec.push_back(f1);
+    fut2_vec.push_back(f2);
+    batch_rt.add(f1, f2);
+  }
+
+  Future<int> result = batch_rt.submit();
+
+  int sum = 0;
+  for(int i = 0; i < 100; ++i) {
+    BOOST_CHECK(!(result.probe()));
+    sum += i * i;
+    fut1_vec[i].set(i);
+    fut2_vec[i].set(i);
+  }
+
+  BOOST_CHECK_EQUAL(result.get(), sum);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -208,9 +208,42 @@ BOOST_AUTO_TEST_CASE( comm_constructor )
     for(Tensor<float>::size_type i = 0ul; i < tile_norms.size(); ++i) {
       BOOST_CHECK_CLOSE(x[i], x_sp[i], tolerance);
     }
+    BOOST_CHECK_CLOSE(x_sp.sparsity(), x.sparsity(), tolerance);
   }
 }
 
+BOOST_AUTO_TEST_CASE( comm_constructor_sparse )
+{
+  // Construct tile norms with few non-zero tiles, so only the non-zero
+  // norms are exchanged
+  Tensor<float> tile_norms_ref(tr.tiles_range(), 0.0f);
+  for(Tensor<float>::size_type i = 0ul; i < tile_norms_ref.size(); i += 7ul)
+    tile_norms_ref[i] = 1000.0f + float(i);
+
+  // Each process has the norms of its local tiles
+  TiledArray::detail::BlockedPmap pmap(*GlobalFixture::world, tr.tiles_range().volume());
+  Tensor<float> tile_norms = tile_norms_ref.clone();
+  for(Tensor<float>::size_type i = 0ul; i < tile_norms.size(); ++i)
+    if(! pmap.is_local(i))
+      tile_norms[i] = 0.0f;
+
+  SparseShape<float> x(*GlobalFixture::world, tile_norms, tr);
+
+  // Replicated norms give the same shape
+  SparseShape<float> y(*GlobalFixture::world, tile_norms_ref, tr);
+
+  size_type zero_tile_count = 0ul;
+  for(Tensor<float>::size_type i = 0ul; i < tile_norms.size(); ++i) {
+    const float expected = tile_norms_ref[i] / float(tr.make_tile_range(i).volume());
+    BOOST_CHECK_CLOSE(x[i], expected, tolerance);
+    BOOST_CHECK_CLOSE(y[i], expected, tolerance);
+    if(expected == 0.0f)
+      ++zero_tile_count;
+  }
+  BOOST_CHECK_CLOSE(x.sparsity(),
+      float(zero_tile_count) / float(tr.tiles_range().volume()), tolerance);
+}
+
 
 BOOST_AUTO_TEST_CASE( copy_constructor )
 {
@@ -1245,4 +1278,39 @@ BOOST_AUTO_TEST_CASE( gemm_perm )
   BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(result_norms.size()), tolerance);
 }
 
+BOOST_AUTO_TEST_CASE( gemm_trans )
+{
+  // Contracting transposed arguments must give the same result as the
+  // equivalent contraction of the untransposed arguments.
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  const SparseShape<float> reference = left.gemm(right, -7.2, gemm_helper);
+
+  // Move the outer dimension of the arguments to the other end
+  const Permutation left_perm({2,0,1});
+  const Permutation right_perm({1,2,0});
+  const SparseShape<float> left_t = left.perm(left_perm);
+  const SparseShape<float> right_t = right.perm(right_perm);
+
+  std::array<madness::cblas::CBLAS_TRANSPOSE, 2> ops = {{ madness::cblas::NoTrans,
+      madness::cblas::Trans }};
+  for(auto left_op : ops) {
+    for(auto right_op : ops) {
+      math::GemmHelper gemm_helper_t(left_op, right_op, 2u,
+          left.data().range().rank(), right.data().range().rank());
+      SparseShape<float> result;
+      BOOST_REQUIRE_NO_THROW(result =
+          (left_op == madness::cblas::NoTrans ? left : left_t).gemm(
+          (right_op == madness::cblas::NoTrans ? right : right_t), -7.2, gemm_helper_t));
+
+      BOOST_CHECK_EQUAL(result.data().range(), reference.data().range());
+      for(std::size_t i = 0ul; i < reference.data().size(); ++i) {
+        BOOST_CHECK_CLOSE(result[i], reference[i], tolerance);
+        BOOST_CHECK_EQUAL(result.is_zero(i), reference.is_zero(i));
+      }
+      BOOST_CHECK_CLOSE(result.sparsity(), reference.sparsity(), tolerance);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
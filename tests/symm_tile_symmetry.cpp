@@ -0,0 +1,209 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  symm_tile_symmetry.cpp
+ *  Apr 19, 2018
+ *
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "TiledArray/symm/tile_symmetry.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+using TiledArray::symmetry::TileSymmetry;
+
+struct TileSymmetryFixture {
+
+  TileSymmetryFixture() :
+    tr{{0, 2, 5, 8}, {0, 2, 5, 8}},
+    antisymmetric({{symmetry::Permutation{1, 0}, -1}}),
+    symmetric({{symmetry::Permutation{1, 0}, 1}})
+  { }
+
+  // An antisymmetric matrix
+  static double element(const std::size_t i, const std::size_t j) {
+    return std::sin(double(i + 2ul * j)) - std::sin(double(j + 2ul * i));
+  }
+
+  TiledRange tr;
+  TileSymmetry antisymmetric;
+  TileSymmetry symmetric;
+}; // TileSymmetryFixture
+
+BOOST_FIXTURE_TEST_SUITE( tile_symmetry_suite, TileSymmetryFixture )
+
+BOOST_AUTO_TEST_CASE( canonical )
+{
+  // t(a,b,i,j) = -t(b,a,i,j) = -t(a,b,j,i)
+  TileSymmetry s({
+      { symmetry::Permutation{1, 0, 2, 3}, -1 },
+      { symmetry::Permutation{0, 1, 3, 2}, -1 } });
+  BOOST_CHECK_EQUAL(s.order(), 4u);
+
+  const std::vector<std::size_t> index = {2, 1, 0, 3};
+  BOOST_CHECK(! s.is_canonical(index));
+  TileSymmetry::Canonical c = s.canonical(index);
+  BOOST_CHECK(c.index == std::vector<std::size_t>({1, 2, 0, 3}));
+  BOOST_CHECK_EQUAL(c.perm, (Permutation{1, 0, 2, 3}));
+  BOOST_CHECK_EQUAL(c.sign, -1);
+  BOOST_CHECK(s.is_canonical(c.index));
+
+  c = s.canonical(std::vector<std::size_t>{2, 1, 3, 0});
+  BOOST_CHECK(c.index == std::vector<std::size_t>({1, 2, 0, 3}));
+  BOOST_CHECK_EQUAL(c.perm, (Permutation{1, 0, 3, 2}));
+  BOOST_CHECK_EQUAL(c.sign, 1);
+
+  c = s.canonical(std::vector<std::size_t>{1, 2, 0, 3});
+  BOOST_CHECK(c.is_identity());
+
+  // The signs must be a representation of the group
+  BOOST_CHECK_THROW(TileSymmetry({{symmetry::Permutation{1, 2, 0}, -1}}),
+      TiledArray::Exception);
+  BOOST_CHECK_THROW(TileSymmetry({{symmetry::Permutation{1, 0}, 2}}),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( packed_storage )
+{
+  World& world = *GlobalFixture::world;
+
+  TArrayD a(world, tr);
+  a.set_symmetry(antisymmetric);
+  BOOST_CHECK(a.symmetry());
+  a.init_elements([] (const Range::index& i) { return element(i[0], i[1]); });
+
+  // Only the canonical tiles are stored
+  for(auto it = a.begin(); it != a.end(); ++it)
+    BOOST_CHECK(a.is_canonical(it.index()));
+  BOOST_CHECK(a.is_canonical(std::vector<std::size_t>{0, 2}));
+  BOOST_CHECK(! a.is_canonical(std::vector<std::size_t>{2, 0}));
+
+  // The other tiles are permuted copies of the canonical tiles
+  for(std::size_t i = 0ul; i < a.size(); ++i) {
+    const TensorD tile = a.find(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), tr.make_tile_range(i));
+    for(const auto& idx : tile.range())
+      BOOST_CHECK_EQUAL(tile[idx], element(idx[0], idx[1]));
+  }
+
+  // The tiled range must have the symmetry
+  TArrayD b(world, TiledRange{{0, 2, 5, 8}, {0, 4, 8}});
+  BOOST_CHECK_THROW(b.set_symmetry(antisymmetric), TiledArray::Exception);
+
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( conversions )
+{
+  World& world = *GlobalFixture::world;
+
+  TArrayD a(world, tr);
+  a.set_symmetry(antisymmetric);
+  a.init_elements([] (const Range::index& i) { return element(i[0], i[1]); });
+
+  // Check that all tiles of an array, including the tiles that are not
+  // canonical in a, have the elements of a
+  auto check_elements = [] (const auto& array) {
+    for(std::size_t i = 0ul; i < array.size(); ++i) {
+      if(array.is_zero(i))
+        continue;
+      const TensorD tile = array.find(i).get();
+      BOOST_CHECK_EQUAL(tile.range(), array.trange().make_tile_range(i));
+      for(const auto& idx : tile.range())
+        BOOST_CHECK_EQUAL(tile[idx], element(idx[0], idx[1]));
+    }
+  };
+
+  // The sparse array keeps the symmetry, and its shape has the norms of the
+  // tiles that are not canonical
+  TSpArrayD sparse = to_sparse(a);
+  BOOST_CHECK(sparse.symmetry());
+  for(std::size_t i = 0ul; i < sparse.size(); ++i) {
+    const auto canonical = a.symmetry()->canonical(tr.tiles_range().idx(i));
+    BOOST_CHECK_CLOSE(sparse.shape()[i], sparse.shape()[canonical.index], 1.0e-4);
+  }
+  check_elements(sparse);
+
+  // Serialization writes all local tiles
+  char archive_file_name[] = "tmp.XXXXXX";
+  if(world.rank() == 0)
+    mktemp(archive_file_name);
+  world.gop.broadcast(archive_file_name, sizeof(archive_file_name), 0);
+  const std::string local_file_name = std::string(archive_file_name) + "."
+      + std::to_string(world.rank());
+  {
+    madness::archive::BinaryFstreamOutputArchive oar(local_file_name.c_str());
+    a.serialize(oar);
+    oar.close();
+    madness::archive::BinaryFstreamInputArchive iar(local_file_name.c_str());
+    TArrayD aread;
+    aread.serialize(iar);
+    iar.close();
+    world.gop.fence();
+    check_elements(aread);
+    std::remove(local_file_name.c_str());
+  }
+  {
+    madness::archive::ParallelOutputArchive oar(world, archive_file_name, 1);
+    oar & a;
+    oar.close();
+    madness::archive::ParallelInputArchive iar(world, archive_file_name, 1);
+    TArrayD aread;
+    aread.load(world, iar);
+    check_elements(aread);
+  }
+
+  // Array files hold all tiles
+  write_array_file(a, archive_file_name);
+  {
+    ArrayFile file(archive_file_name);
+    check_elements(file.read<TArrayD>(world));
+  }
+
+  world.gop.fence();
+  if(world.rank() == 0)
+    std::remove(archive_file_name);
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  World& world = *GlobalFixture::world;
+
+  TArrayD a(world, tr);
+  a.init_elements([] (const Range::index& i) {
+    return std::cos(double(3ul * i[0] + i[1]));
+  });
+  TArrayD ref;
+  ref("i,j") = a("i,k") * a("j,k");
+
+  // Only the canonical tiles of a symmetric result are computed
+  TArrayD c(world, tr);
+  c.set_symmetry(symmetric);
+  c("i,j") = a("i,k") * a("j,k");
+  BOOST_CHECK(c.symmetry());
+  for(auto it = c.begin(); it != c.end(); ++it)
+    BOOST_CHECK(c.is_canonical(it.index()));
+
+  BOOST_CHECK_SMALL((c("i,j") - ref("i,j")).norm().get(), 1.0e-12);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
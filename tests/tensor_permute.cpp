@@ -0,0 +1,119 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tensor_permute.cpp
+ *  Mar 26, 2018
+ *
+ */
+
+#include "TiledArray/tensor.h"
+#include "unit_test_config.h"
+#include <algorithm>
+#include <numeric>
+
+using namespace TiledArray;
+
+struct TensorPermuteFixture {
+
+  TensorPermuteFixture() { }
+
+  ~TensorPermuteFixture() { }
+
+  static Tensor<int> make_tensor(const Range& range) {
+    Tensor<int> t(range);
+    for(std::size_t i = 0ul; i < t.size(); ++i)
+      t[i] = int(i);
+    return t;
+  }
+
+  /// Check the unary and binary permutation of \c t by all permutations
+  static void check_all_permutations(const Tensor<int>& t) {
+    std::vector<unsigned int> p(t.range().rank());
+    std::iota(p.begin(), p.end(), 0u);
+    do {
+      Permutation perm(p.begin(), p.end());
+      Tensor<int> result = t.permute(perm);
+      Tensor<int> sum = t.add(t, perm);
+      BOOST_CHECK_EQUAL(result.range(), perm * t.range());
+
+      for(std::size_t i = 0ul; i < t.size(); ++i) {
+        const auto index = perm * t.range().idx(i);
+        BOOST_CHECK_EQUAL(result(index), t[i]);
+        BOOST_CHECK_EQUAL(sum(index), 2 * t[i]);
+      }
+    } while(std::next_permutation(p.begin(), p.end()));
+  }
+
+}; // TensorPermuteFixture
+
+BOOST_FIXTURE_TEST_SUITE( tensor_permute_suite, TensorPermuteFixture )
+
+BOOST_AUTO_TEST_CASE( permute_small )
+{
+  // Odd extents and dimensions of size one
+  check_all_permutations(make_tensor(Range(3, 5, 7, 2)));
+  check_all_permutations(make_tensor(Range(1, 9, 1, 17)));
+  check_all_permutations(make_tensor(Range(33, 1, 65, 3)));
+  check_all_permutations(make_tensor(Range(129, 3, 70)));
+  check_all_permutations(make_tensor(Range(300, 257)));
+  check_all_permutations(make_tensor(Range(1, 1)));
+}
+
+BOOST_AUTO_TEST_CASE( permute_empty )
+{
+  // Tensors with a dimension of size zero have no elements to permute
+  const Tensor<int> t(Range(0, 5, 3));
+  Tensor<int> result;
+  BOOST_REQUIRE_NO_THROW(result = t.permute(Permutation{1, 0, 2}));
+  BOOST_CHECK_EQUAL(result.range(), Range(5, 0, 3));
+  BOOST_CHECK_EQUAL(result.size(), 0ul);
+  check_all_permutations(t);
+  check_all_permutations(make_tensor(Range(4, 0)));
+}
+
+BOOST_AUTO_TEST_CASE( permute_large )
+{
+  // Large enough to be evaluated in parallel
+  check_all_permutations(make_tensor(Range(24, 17, 40, 9)));
+}
+
+BOOST_AUTO_TEST_CASE( plan_cache )
+{
+  detail::PermutePlan::clear_cache();
+
+  const Range range(10, 20, 30);
+  const Permutation perm{2, 0, 1};
+  auto plan = detail::PermutePlan::get(range, perm);
+  BOOST_CHECK(plan->is_plan_for(range, perm));
+  BOOST_CHECK(! plan->is_plan_for(Range(10, 20, 31), perm));
+  BOOST_CHECK(! plan->is_plan_for(range, Permutation{1, 2, 0}));
+
+  // Plans are reused for ranges with the same extent
+  BOOST_CHECK_EQUAL(detail::PermutePlan::get(range, perm), plan);
+  BOOST_CHECK_EQUAL(detail::PermutePlan::get(Range({1, 2, 3}, {11, 22, 33}), perm), plan);
+  BOOST_CHECK_NE(detail::PermutePlan::get(range, Permutation{1, 2, 0}), plan);
+
+  // Contiguous dimensions are fused
+  BOOST_CHECK_EQUAL(plan->rank(), 2u);
+  BOOST_CHECK_EQUAL(detail::PermutePlan(range, Permutation{0, 1, 2}).rank(), 1u);
+  BOOST_CHECK_EQUAL(detail::PermutePlan(range, Permutation{2, 1, 0}).rank(), 3u);
+
+  detail::PermutePlan::clear_cache();
+  BOOST_CHECK_NE(detail::PermutePlan::get(range, perm), plan);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
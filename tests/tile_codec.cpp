@@ -0,0 +1,238 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_codec.cpp
+ *  Apr 18, 2018
+ *
+ */
+
+#include "TiledArray/tile_codec.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include <cmath>
+
+using namespace TiledArray;
+using detail::CompressedTile;
+
+struct TileCodecFixture {
+
+  TileCodecFixture() :
+    t(Range(std::vector<std::size_t>{17, 23}))
+  {
+    // A tile with many zeros and elements of varying magnitude
+    for(std::size_t i = 0ul; i < t.size(); ++i)
+      t[i] = (i % 3ul ? 0.0 : std::sin(double(i)) * std::pow(10.0, double(i % 7ul) - 3.0));
+    codec_reset_statistics();
+  }
+
+  static CodecSettings settings(const TileCodec codec, const double tolerance = 0.0) {
+    CodecSettings result;
+    result.codec = codec;
+    result.tolerance = tolerance;
+    return result;
+  }
+
+  static double max_error(const Tensor<double>& a, const Tensor<double>& b) {
+    double result = 0.0;
+    for(std::size_t i = 0ul; i < a.size(); ++i)
+      result = std::max(result, std::abs(a[i] - b[i]));
+    return result;
+  }
+
+  Tensor<double> t;
+}; // TileCodecFixture
+
+BOOST_FIXTURE_TEST_SUITE( tile_codec_suite, TileCodecFixture )
+
+BOOST_AUTO_TEST_CASE( lz )
+{
+  std::vector<unsigned char> data;
+  for(unsigned int i = 0u; i < 5000u; ++i)
+    data.push_back((i % 5u == 0u) ? (unsigned char)(i * 131u) : (unsigned char)(i / 100u));
+
+  const std::vector<unsigned char> compressed =
+      detail::lz_compress(data.data(), data.size());
+  BOOST_CHECK_LT(compressed.size(), data.size());
+
+  std::vector<unsigned char> result(data.size());
+  detail::lz_decompress(compressed.data(), compressed.size(), result.data(),
+      result.size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), data.begin(),
+      data.end());
+
+  // Corrupt data is detected
+  BOOST_CHECK_THROW(detail::lz_decompress(compressed.data(), compressed.size(),
+      result.data(), result.size() - 1ul), TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( byte_shuffle )
+{
+  const std::vector<unsigned char> data = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  std::vector<unsigned char> shuffled(data.size());
+  detail::byte_shuffle(data.data(), 3ul, 4ul, shuffled.data());
+  const std::vector<unsigned char> expected = {0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11};
+  BOOST_CHECK_EQUAL_COLLECTIONS(shuffled.begin(), shuffled.end(),
+      expected.begin(), expected.end());
+
+  std::vector<unsigned char> result(data.size());
+  detail::byte_unshuffle(shuffled.data(), 3ul, 4ul, result.data());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), data.begin(),
+      data.end());
+}
+
+BOOST_AUTO_TEST_CASE( lossless )
+{
+  CompressedTile<Tensor<double> > c(t, settings(TileCodec::lossless));
+  BOOST_CHECK_LT(c.size(), t.size() * sizeof(double));
+
+  const Tensor<double> result = c.decode();
+  BOOST_CHECK_EQUAL(result.range(), t.range());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), t.begin(), t.end());
+
+  // Integral elements are always compressed without loss
+  Tensor<int> ti(Range(std::vector<std::size_t>{100}));
+  for(int i = 0; i < 100; ++i)
+    ti[i] = i % 13;
+  const Tensor<int> ri = CompressedTile<Tensor<int> >(ti,
+      settings(TileCodec::lossy, 0.5)).decode();
+  BOOST_CHECK_EQUAL_COLLECTIONS(ri.begin(), ri.end(), ti.begin(), ti.end());
+
+  // Empty tiles
+  BOOST_CHECK(CompressedTile<Tensor<double> >(Tensor<double>(),
+      settings(TileCodec::lossless)).decode().empty());
+}
+
+BOOST_AUTO_TEST_CASE( lossy )
+{
+  const std::size_t lossless_size =
+      CompressedTile<Tensor<double> >(t, settings(TileCodec::lossless)).size();
+
+  for(const double tolerance : {1.0e-2, 1.0e-6, 1.0e-10}) {
+    CompressedTile<Tensor<double> > c(t, settings(TileCodec::lossy, tolerance));
+    BOOST_CHECK_LE(c.size(), lossless_size);
+    const Tensor<double> result = c.decode();
+    BOOST_CHECK_EQUAL(result.range(), t.range());
+    BOOST_CHECK_LT(max_error(result, t), tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( serialize )
+{
+  CompressedTile<Tensor<double> > c(t, settings(TileCodec::lossless));
+
+  std::vector<unsigned char> buffer(2ul * t.size() * sizeof(double) + 1024ul);
+  madness::archive::BufferOutputArchive oar(buffer.data(), buffer.size());
+  oar & c;
+
+  CompressedTile<Tensor<double> > result;
+  madness::archive::BufferInputArchive iar(buffer.data(), buffer.size());
+  iar & result;
+
+  const Tensor<double> tile = result.decode();
+  BOOST_CHECK_EQUAL(tile.range(), t.range());
+  BOOST_CHECK_EQUAL_COLLECTIONS(tile.begin(), tile.end(), t.begin(), t.end());
+}
+
+BOOST_AUTO_TEST_CASE( statistics )
+{
+  CompressedTile<Tensor<double> > c(t, settings(TileCodec::lossless));
+  c.decode();
+
+  const CodecStatistics stats = codec_statistics();
+  BOOST_CHECK_EQUAL(stats.tiles, 1ul);
+  BOOST_CHECK_EQUAL(stats.raw_bytes, t.size() * sizeof(double));
+  BOOST_CHECK_EQUAL(stats.compressed_bytes, c.size());
+  BOOST_CHECK_GT(stats.ratio(), 1.0);
+
+  codec_reset_statistics();
+  BOOST_CHECK_EQUAL(codec_statistics().tiles, 0ul);
+  BOOST_CHECK_EQUAL(codec_statistics().ratio(), 1.0);
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  World& world = *GlobalFixture::world;
+  const TiledRange tr{{0, 4, 8, 12, 16}, {0, 4, 8, 12, 16}};
+  auto init = [] (TArrayD& array) {
+    array.init_elements([] (const auto& index) {
+      const std::size_t i = index[0], j = index[1];
+      return ((i + 2ul * j) % 3ul ? 0.0 : std::cos(double(i * 16ul + j)));
+    });
+  };
+
+  TArrayD a(world, tr), b(world, tr);
+  init(a);
+  init(b);
+  TArrayD c;
+  c("i,j") = a("i,k") * b("k,j");
+
+  // Lossless compression gives the same result
+  TArrayD al(world, tr), bl(world, tr);
+  al.set_codec(TileCodec::lossless);
+  bl.set_codec(TileCodec::lossless);
+  BOOST_CHECK(al.codec().codec == TileCodec::lossless);
+  init(al);
+  init(bl);
+  TArrayD cl;
+  cl("i,j") = al("i,k") * bl("k,j");
+  BOOST_CHECK_SMALL((cl("i,j") - c("i,j")).norm().get(), 1.0e-12);
+
+  // Only the tiles that are sent to other processes are compressed
+  codec_reset_statistics();
+  world.gop.fence();
+  std::size_t sent = 0ul;
+  if(world.rank() == 1) {
+    std::size_t i = 0ul;
+    while(i < al.size() && al.is_local(i))
+      ++i;
+    if(i < al.size()) {
+      const Tensor<double> tile = al.find(i).get();
+      BOOST_CHECK_EQUAL(tile.range(), al.trange().make_tile_range(i));
+      sent = 1ul;
+    }
+  }
+  world.gop.fence();
+  std::size_t tiles = codec_statistics().tiles;
+  world.gop.sum(sent);
+  world.gop.sum(tiles);
+  BOOST_CHECK_EQUAL(tiles, sent);
+
+  // Lossy compression is accurate to the tolerance
+  const double tolerance = 1.0e-6;
+  TArrayD ay(world, tr), by(world, tr);
+  ay.set_codec(TileCodec::lossy, tolerance);
+  by.set_codec(TileCodec::lossy, tolerance);
+  BOOST_CHECK_EQUAL(ay.codec().tolerance, tolerance);
+  init(ay);
+  init(by);
+  TArrayD cy;
+  cy("i,j") = ay("i,k") * by("k,j");
+  BOOST_CHECK_SMALL((cy("i,j") - c("i,j")).norm().get(),
+      16.0 * 16.0 * 2.0 * tolerance);
+
+  // The default lossy tolerance is the shape threshold
+  TArrayD ad(world, tr);
+  ad.set_codec(TileCodec::lossy);
+  BOOST_CHECK_EQUAL(ad.codec().tolerance,
+      double(SparseShape<float>::threshold()));
+  TSpArrayD as(world, tr, SparseShape<float>(1.0f, tr));
+  as.set_codec(TileCodec::lossy);
+  BOOST_CHECK_EQUAL(as.codec().tolerance,
+      double(TSpArrayD::shape_type::threshold()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
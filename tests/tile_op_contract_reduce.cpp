@@ -471,5 +471,139 @@ BOOST_AUTO_TEST_CASE( tensor_contract2 )
   BOOST_CHECK_EQUAL(result_map, C);
 }
 
+BOOST_AUTO_TEST_CASE( batch_matrix_multiply )
+{
+  // Set dimension constants, including a pair that is too large to be packed
+  const std::size_t m = 18, n = 36;
+  const std::size_t k[] = { 3, 17, 5, 1500, 7, 11 };
+  const std::size_t batch = sizeof(k) / sizeof(k[0]);
+
+  const madness::cblas::CBLAS_TRANSPOSE ops[] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+
+  for(auto left_op : ops) {
+    for(auto right_op : ops) {
+      // Construct the argument tensors
+      std::vector<TensorI> left, right;
+      for(std::size_t i = 0ul; i < batch; ++i) {
+        left.push_back(left_op == madness::cblas::NoTrans ?
+            make_tensor(0, 0, m, k[i]) : make_tensor(0, 0, k[i], m));
+        right.push_back(right_op == madness::cblas::NoTrans ?
+            make_tensor(0, 0, k[i], n) : make_tensor(0, 0, n, k[i]));
+      }
+      std::vector<const TensorI*> left_ptrs, right_ptrs;
+      for(std::size_t i = 0ul; i < batch; ++i) {
+        left_ptrs.push_back(& left[i]);
+        right_ptrs.push_back(& right[i]);
+      }
+
+      ContractReduce<TensorI, TensorI, TensorI, int>
+      op(left_op, right_op, 3, 2u, 2u, 2u);
+
+      // Compute the reference values one pair at a time
+      TensorI reference;
+      for(std::size_t i = 0ul; i < batch; ++i)
+        op(reference, left[i], right[i]);
+
+      // Contract the whole batch into an empty result
+      TensorI result;
+      BOOST_REQUIRE_NO_THROW(op(result, left_ptrs, right_ptrs));
+      BOOST_CHECK_EQUAL(result.range(), reference.range());
+      BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+          reference.begin(), reference.end());
+
+      // Contract the batch again, accumulating into the existing result
+      for(std::size_t i = 0ul; i < batch; ++i)
+        op(reference, left[i], right[i]);
+      BOOST_REQUIRE_NO_THROW(op(result, left_ptrs, right_ptrs));
+      BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+          reference.begin(), reference.end());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( permuted_arguments )
+{
+  // C[a,b,c,d] = A[a,i,b,j] * B[j,c,i,d], which requires both arguments to
+  // be permuted.
+  const std::size_t a = 17, b = 19, c = 5, d = 3, i = 20, j = 15;
+  const Permutation left_perm{0, 2, 1, 3}, right_perm{1, 2, 0, 3};
+
+  std::vector<TensorI> left, right;
+  for(std::size_t x = 0ul; x < 2ul; ++x) {
+    left.emplace_back(TensorI::range_type(a, i, b, j));
+    rand_fill(left.back());
+    right.emplace_back(TensorI::range_type(j, c, i, d));
+    rand_fill(right.back());
+  }
+
+  ContractReduce<TensorI, TensorI, TensorI, int>
+  op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 4u, 4u, 4u,
+      Permutation(), ContractReduce<TensorI, TensorI, TensorI, int>::default_batch_size,
+      left_perm, right_perm);
+  ContractReduce<TensorI, TensorI, TensorI, int>
+  reference_op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 4u, 4u, 4u);
+
+  BOOST_CHECK(op.fuse_permute);
+  BOOST_CHECK_EQUAL(op.left_perm(), left_perm);
+  BOOST_CHECK_EQUAL(op.right_perm(), right_perm);
+
+  // Compute the reference values with permuted copies of the arguments
+  TensorI reference;
+  for(std::size_t x = 0ul; x < 2ul; ++x)
+    reference_op(reference, left[x].permute(left_perm), right[x].permute(right_perm));
+
+  // Contract one pair at a time
+  TensorI result;
+  BOOST_REQUIRE_NO_THROW(op(result, left[0], right[0]));
+  BOOST_REQUIRE_NO_THROW(op(result, left[1], right[1]));
+  BOOST_CHECK_EQUAL(result.range(), reference.range());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+      reference.begin(), reference.end());
+
+  // Contract a batch
+  TensorI batch_result;
+  BOOST_REQUIRE_NO_THROW(op(batch_result, std::vector<const TensorI*>{& left[0], & left[1]},
+      std::vector<const TensorI*>{& right[0], & right[1]}));
+  BOOST_CHECK_EQUAL_COLLECTIONS(batch_result.begin(), batch_result.end(),
+      reference.begin(), reference.end());
+
+  // Permute only the left-hand argument, and transpose the right-hand argument
+  // C[a,b,c,d] = A[a,i,b,j] * B[c,d,i,j]
+  TensorI right_trans(TensorI::range_type(c, d, i, j));
+  rand_fill(right_trans);
+  ContractReduce<TensorI, TensorI, TensorI, int>
+  trans_op(madness::cblas::NoTrans, madness::cblas::Trans, 1, 4u, 4u, 4u,
+      Permutation(), ContractReduce<TensorI, TensorI, TensorI, int>::default_batch_size,
+      left_perm);
+  ContractReduce<TensorI, TensorI, TensorI, int>
+  trans_reference_op(madness::cblas::NoTrans, madness::cblas::Trans, 1, 4u, 4u, 4u);
+
+  TensorI trans_result, trans_reference;
+  trans_op(trans_result, left[0], right_trans);
+  trans_reference_op(trans_reference, left[0].permute(left_perm), right_trans);
+  BOOST_CHECK_EQUAL(trans_result.range(), trans_reference.range());
+  BOOST_CHECK_EQUAL_COLLECTIONS(trans_result.begin(), trans_result.end(),
+      trans_reference.begin(), trans_reference.end());
+
+  // Contract arguments whose fused extents span more than one packed block in
+  // every blocked dimension (m, n > gett_pack_limit / gett_k_block and
+  // k > 2 * gett_k_block)
+  const std::size_t big_a = 33, big_b = 33, big_c = 35, big_d = 31,
+      big_i = 35, big_j = 31;
+  BOOST_REQUIRE_GT(big_a * big_b, std::size_t(math::gett_pack_limit / math::gett_k_block));
+  BOOST_REQUIRE_GT(big_c * big_d, std::size_t(math::gett_pack_limit / math::gett_k_block));
+  BOOST_REQUIRE_GT(big_i * big_j, std::size_t(2 * math::gett_k_block));
+  TensorI big_left(TensorI::range_type(big_a, big_i, big_b, big_j));
+  rand_fill(big_left);
+  TensorI big_right(TensorI::range_type(big_j, big_c, big_i, big_d));
+  rand_fill(big_right);
+
+  TensorI big_result, big_reference;
+  BOOST_REQUIRE_NO_THROW(op(big_result, big_left, big_right));
+  reference_op(big_reference, big_left.permute(left_perm), big_right.permute(right_perm));
+  BOOST_CHECK_EQUAL(big_result.range(), big_reference.range());
+  BOOST_CHECK(std::equal(big_result.begin(), big_result.end(), big_reference.begin()));
+}
 
 BOOST_AUTO_TEST_SUITE_END()